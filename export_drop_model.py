@@ -0,0 +1,161 @@
+"""Train the drop classifier on the new_project.cc dataset and export it for ns-3.
+
+The decision tree or random forest of new_proj_ml_models.py is flattened into the
+node layout of scenario-support's TreeEnsemble: the two children of every internal
+node get consecutive slots, so a step down the tree is child + (x > threshold), and
+leaves point into a table of normalized class probabilities.
+
+  python3 export_drop_model.py --data scratch/dataset.txt --model forest --trees 20 \
+      --max-depth 12 --output drop_model.txt --header drop_model.h
+
+The text model is loaded at run time (new_project.cc --dropModel=drop_model.txt); the
+header holds the same arrays for a scenario that wants the model compiled in. Classes
+are balanced with class weights rather than by oversampling before the split, so the
+test report is not inflated by duplicated rows.
+
+Every dataset column but the status is a feature by default, including the sliding-window
+link and node context; --features restricts the model to a comma-separated subset.
+"""
+import argparse
+from collections import deque
+
+import numpy as np
+import pandas as pd
+from sklearn.ensemble import RandomForestClassifier
+from sklearn.metrics import classification_report
+from sklearn.model_selection import train_test_split
+from sklearn.tree import DecisionTreeClassifier
+
+def load(path):
+    df = pd.read_csv(path, skipinitialspace=True)
+    df.columns = [c.strip() for c in df.columns]
+    # datasets written before the header typo was fixed
+    df = df.rename(columns={'rertransmission_count': 'retransmission_count'})
+    df['status'] = df['status'].str.strip()
+    df = df[df['status'] != 'Unknown']
+    return df.dropna()
+
+
+def flatten(trees):
+    """Lay every tree out breadth first; returns roots, feature, threshold, child, leaves."""
+    roots, feature, threshold, child, leaves = [], [], [], [], []
+
+    def allocate():
+        feature.append(-1)
+        threshold.append(0.0)
+        child.append(0)
+        return len(feature) - 1
+
+    for estimator in trees:
+        tree = estimator.tree_
+        roots.append(allocate())
+        queue = deque([(0, roots[-1])])
+        while queue:
+            node, slot = queue.popleft()
+            left, right = tree.children_left[node], tree.children_right[node]
+            if left == -1:
+                value = np.asarray(tree.value[node][0], dtype=float)
+                child[slot] = len(leaves)
+                leaves.append(value / value.sum())
+                continue
+            feature[slot] = int(tree.feature[node])
+            threshold[slot] = float(tree.threshold[node])
+            child[slot] = len(feature)
+            queue.append((left, allocate()))
+            queue.append((right, allocate()))
+    return roots, feature, threshold, child, leaves
+
+
+def predict(flat, X):
+    """Reference traversal of the flat layout, as TreeEnsemble::Predict does it."""
+    roots, feature, threshold, child, leaves = flat
+    X = np.asarray(X, dtype=np.float32).astype(np.float64)
+    proba = np.zeros((len(X), len(leaves[0])))
+    for i, x in enumerate(X):
+        for root in roots:
+            node = root
+            while feature[node] >= 0:
+                node = child[node] + int(x[feature[node]] > threshold[node])
+            proba[i] += leaves[child[node]]
+    return proba.argmax(axis=1)
+
+
+def write_text(path, classes, features, flat):
+    roots, feature, threshold, child, leaves = flat
+    with open(path, 'w') as out:
+        out.write('tree-ensemble 1\n')
+        out.writelines('class %s\n' % c for c in classes)
+        out.writelines('feature %s\n' % f for f in features)
+        out.writelines('root %d\n' % r for r in roots)
+        for f, t, c in zip(feature, threshold, child):
+            out.write('node %d %.17g %d\n' % (f, t, c))
+        for leaf in leaves:
+            out.write('leaf %s\n' % ' '.join('%.17g' % p for p in leaf))
+
+
+def write_header(path, classes, features, flat):
+    roots, feature, threshold, child, leaves = flat
+
+    def array(values, fmt):
+        return (',\n' + ' ' * 20).join(', '.join(fmt % v for v in values[i:i + 8])
+                                        for i in range(0, len(values), 8))
+
+    def strings(values):
+        return ', '.join('"%s"' % v for v in values)
+
+    probabilities = [p for leaf in leaves for p in leaf]
+    with open(path, 'w') as out:
+        out.write('// Generated by export_drop_model.py, do not edit\n\n')
+        out.write('#include "tree-ensemble.h"\n\n')
+        out.write('namespace drop_model\n{\n\n')
+        out.write('inline ns3::TreeEnsemble\nMake()\n{\n')
+        out.write('    ns3::TreeEnsemble model;\n')
+        out.write('    model.SetModel({%s},\n' % strings(classes))
+        out.write('                   {%s},\n' % strings(features))
+        out.write('                   {%s},\n' % array(roots, '%d'))
+        out.write('                   {%s},\n' % array(feature, '%d'))
+        out.write('                   {%s},\n' % array(threshold, '%.17g'))
+        out.write('                   {%s},\n' % array(child, '%d'))
+        out.write('                   {%s});\n' % array(probabilities, '%.17g'))
+        out.write('    return model;\n}\n\n} // namespace drop_model\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--data', default='dataset.csv', help='dataset written by new_project.cc')
+    parser.add_argument('--model', choices=['tree', 'forest'], default='forest')
+    parser.add_argument('--trees', type=int, default=100, help='forest size')
+    parser.add_argument('--max-depth', type=int, default=None, help='depth limit of every tree')
+    parser.add_argument('--output', default='drop_model.txt', help='text model for TreeEnsemble::Load')
+    parser.add_argument('--header', default='', help='also write the model as a C++ header')
+    parser.add_argument('--features', default='', help='comma-separated feature columns, all by default')
+    args = parser.parse_args()
+
+    df = load(args.data)
+    classes = sorted(df['status'].unique())
+    features = args.features.split(',') if args.features else [c for c in df.columns if c != 'status']
+    X = df[features].to_numpy(dtype=np.float32)
+    y = df['status'].map({c: i for i, c in enumerate(classes)}).to_numpy()
+    X_train, X_test, y_train, y_test = train_test_split(X, y, test_size=0.3, random_state=42)
+
+    if args.model == 'tree':
+        model = DecisionTreeClassifier(class_weight='balanced', max_depth=args.max_depth,
+                                       random_state=42)
+    else:
+        model = RandomForestClassifier(n_estimators=args.trees, class_weight='balanced',
+                                       max_depth=args.max_depth, random_state=42)
+    model.fit(X_train, y_train)
+    print(classification_report(y_test, model.predict(X_test), target_names=classes))
+
+    flat = flatten([model] if args.model == 'tree' else model.estimators_)
+    mismatches = int((predict(flat, X_test) != model.predict(X_test)).sum())
+    print('%d trees, %d nodes, %d leaves; %d/%d test predictions differ from scikit-learn'
+          % (len(flat[0]), len(flat[1]), len(flat[4]), mismatches, len(X_test)))
+
+    write_text(args.output, classes, features, flat)
+    if args.header:
+        write_header(args.header, classes, features, flat)
+
+
+if __name__ == '__main__':
+    main()
@@ -5,10 +5,10 @@ et=ET.parse(sys.argv[1])
 bitrates=[]
 losses=[]
 delays=[]
+# index the classifier once; the native flow-results tool does the same in one pass
+tuples={tpl.get('flowId'):tpl for tpl in et.findall("Ipv4FlowClassifier/Flow")}
 for flow in et.findall("FlowStats/Flow"):
- for tpl in et.findall("Ipv4FlowClassifier/Flow"):
-  if tpl.get('flowId')==flow.get('flowId'):
-   break
+ tpl=tuples[flow.get('flowId')]
  if tpl.get('destinationPort')=='9':
   continue
  losses.append(int(flow.get('lostPackets')))
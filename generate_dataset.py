@@ -0,0 +1,79 @@
+"""Generate a class-balanced drop dataset from many new_project runs in parallel.
+
+Every shard is one run of new_project with its own RngRun and topology variation
+(number of vehicles, vehicle speed), writing its own file. With --quota, each run keeps
+a reservoir sample of that many rows per status class and stops as soon as every class
+reached it, so the merged dataset is balanced at the source and needs no resampling or
+SMOTE.
+
+  python3 generate_dataset.py --ns3 ./ns3 --shards 32 --jobs 8 --quota 2000 \
+      --vehicles 50,75,100 --speeds 1,5,10 --output dataset.csv
+"""
+import argparse
+import collections
+import itertools
+import os
+import subprocess
+import sys
+from concurrent.futures import ThreadPoolExecutor
+
+
+def run_shard(args, index, vehicles, speed):
+    shard = os.path.join(args.shard_dir, 'shard_%03d_v%d_s%g.csv' % (index, vehicles, speed))
+    program = '%s --RngRun=%d --vehicles=%d --speed=%g --quota=%d --simulationTime=%s --dataset=%s' % (
+        args.program, args.first_run + index, vehicles, speed, args.quota, args.max_time,
+        os.path.abspath(shard))
+    result = subprocess.run([args.ns3, 'run', '--no-build', program],
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout)
+        raise RuntimeError('shard %d failed with code %d' % (index, result.returncode))
+    return shard
+
+
+def merge(shards, output):
+    counts = collections.Counter()
+    with open(output, 'w') as out:
+        for i, shard in enumerate(shards):
+            with open(shard) as lines:
+                header = next(lines)
+                if i == 0:
+                    out.write(header)
+                for line in lines:
+                    counts[line.rsplit(',', 1)[-1].strip()] += 1
+                    out.write(line)
+    return counts
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--ns3', default='./ns3', help='ns3 driver script')
+    parser.add_argument('--program', default='scratch/new_project', help='scenario to run')
+    parser.add_argument('--shards', type=int, default=16, help='number of runs')
+    parser.add_argument('--jobs', type=int, default=os.cpu_count(), help='parallel runs')
+    parser.add_argument('--quota', type=int, default=2000, help='rows per status class and shard')
+    parser.add_argument('--max-time', default='150s', help='simulated time limit of a run')
+    parser.add_argument('--first-run', type=int, default=1, help='RngRun of the first shard')
+    parser.add_argument('--vehicles', default='75', help='comma-separated vehicle counts')
+    parser.add_argument('--speeds', default='1', help='comma-separated vehicle speeds (m/s)')
+    parser.add_argument('--shard-dir', default='shards', help='directory of the shard files')
+    parser.add_argument('--output', default='dataset.csv', help='merged dataset')
+    args = parser.parse_args()
+
+    os.makedirs(args.shard_dir, exist_ok=True)
+    # Build once up front, the runs themselves must not race on the build tree
+    subprocess.run([args.ns3, 'build'], check=True)
+
+    variations = itertools.cycle(itertools.product(
+        [int(v) for v in args.vehicles.split(',')], [float(s) for s in args.speeds.split(',')]))
+    plan = [(i,) + next(variations) for i in range(args.shards)]
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        shards = list(pool.map(lambda p: run_shard(args, *p), plan))
+
+    counts = merge(shards, args.output)
+    for status, count in sorted(counts.items()):
+        print('%s\t%d' % (status, count))
+
+
+if __name__ == '__main__':
+    main()
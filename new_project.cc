@@ -29,7 +29,15 @@
 #include "ns3/applications-module.h"
 #include "ns3/wifi-phy-common.h"
 #include "ns3/wifi-module.h"
+#include "flow-delay-monitor.h"
+#include "link-feature-extractor.h"
+#include "stratified-reservoir.h"
+#include "tree-ensemble.h"
+#include <algorithm>
+#include <chrono>
 #include <fstream>
+#include <memory>
+#include <sstream>
 
 NS_LOG_COMPONENT_DEFINE("proj");
 enum e_WifiPhyRxFailureReason {
@@ -60,9 +68,6 @@ std::ofstream throughputFile;
 std::vector<double> nodeEnergyConsumed;
 int number_of_vehicles = 75;
 int sink_count= 1;
-double lastArrivalTime = 0.0; // Variable to store the last arrival time
-double totalJitter = 0.0; // Variable to accumulate total jitter
-int packetCount = 0; // To count packets for average jitter calculation
 std::map<double, uint32_t> transmissionTimes;
 
 std::string fileName = "_75_1.txt";
@@ -71,6 +76,53 @@ std::map<uint32_t, double> snrMap;
 std::map<uint32_t, double> rssiMap;
 std::map<uint32_t, double> retransmissionCount;
 std::map<uint32_t,double> delay;
+std::map<uint32_t, Mac48Address> transmitterMap;
+
+// Columns of the dataset, in the order they are written; the drop model may use any subset.
+// Every record ends with the sliding-window context of its link and receiving node.
+const std::vector<std::string> datasetColumns = [] {
+    std::vector<std::string> columns = {"timestamp", "packet_dropped", "payload_size", "snr", "rssi", "retransmission_count", "retransmission_delay"};
+    std::vector<std::string> features = LinkFeatureExtractor::GetFeatureNames();
+    columns.insert(columns.end(), features.begin(), features.end());
+    return columns;
+}();
+Ptr<LinkFeatureExtractor> featureExtractor;
+TreeEnsemble dropModel;                   // trained drop classifier, empty without --dropModel
+std::vector<size_t> dropModelColumns;     // dataset column of every model feature
+std::map<std::string, std::map<std::string, uint32_t>> dropConfusion; // PHY reason label -> predicted class
+std::vector<float> dropFeatures;          // model inputs kept for the inference benchmark
+double dropInferenceNs = 0.0;
+uint32_t dropInferences = 0;
+uint32_t predictedBitErrors = 0;
+uint32_t predictedCongestion = 0;
+int dataMcs = 7;
+int maxDataMcs = 7;
+double loadScale = 1.0;
+std::vector<std::pair<Ptr<OnOffApplication>, DataRate>> onOffBaseRates;
+std::unique_ptr<StratifiedReservoir> reservoir; // class-balanced sample, only with --quota
+
+// Every sample goes straight to the dataset, or through the class-balanced reservoir
+void WriteSample(const std::vector<double>& row, const std::string& status) {
+    std::ostringstream line;
+    for (size_t i = 0; i < datasetColumns.size(); ++i) {
+        line << row[i] << ", ";
+    }
+    line << status;
+    if (reservoir) {
+        reservoir->Offer(status, line.str());
+    } else {
+        outputFile << line.str() << "\n";
+    }
+}
+
+void StopWhenBalanced() {
+    if (reservoir->IsComplete()) {
+        NS_LOG_INFO("Every class reached its quota at " << Simulator::Now().As(Time::S));
+        Simulator::Stop();
+        return;
+    }
+    Simulator::Schedule(Seconds(1.0), &StopWhenBalanced);
+}
 
 void
 CalculateThroughput()
@@ -113,7 +165,69 @@ for (int i = number_of_vehicles / 2; i < number_of_vehicles; i++) {
     mob->SetVelocity(Vector(-speedx, speedy, 0.0));
 }
 }
-void SnifferRxCallback(Ptr<const Packet> packet, uint16_t channelFreqMhz, WifiTxVector txVector, MpduInfo aMpdu, SignalNoiseDbm sn,unsigned short rateIndex) {
+void ClassifyDrop(const std::vector<double>& row, const std::string& dropType) {
+    static std::vector<float> x;
+    x.resize(dropModelColumns.size());
+    for (size_t i = 0; i < dropModelColumns.size(); ++i) {
+        x[i] = static_cast<float>(row[dropModelColumns[i]]);
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    uint32_t predicted = dropModel.Predict(x.data());
+    dropInferenceNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    dropInferences++;
+
+    const std::string& predictedName = dropModel.GetClassName(predicted);
+    dropConfusion[dropType][predictedName]++;
+    if (predictedName == "Bit Error") {
+        predictedBitErrors++;
+    } else if (predictedName == "Congestion Loss") {
+        predictedCongestion++;
+    }
+    if (dropFeatures.size() < 100000 * x.size()) {
+        dropFeatures.insert(dropFeatures.end(), x.begin(), x.end());
+    }
+}
+
+// Once a second: step the MCS down when the classifier blames bit errors, back the offered
+// load off when it blames congestion, and recover one step after a quiet second
+void ReactToDrops(uint32_t minDrops) {
+    if (predictedBitErrors + predictedCongestion < minDrops) {
+        dataMcs = std::min(dataMcs + 1, maxDataMcs);
+        loadScale = std::min(loadScale * 2, 1.0);
+    } else if (predictedBitErrors > predictedCongestion) {
+        dataMcs = std::max(dataMcs - 1, 0);
+    } else {
+        loadScale = std::max(loadScale / 2, 1.0 / 16);
+    }
+    NS_LOG_INFO(Simulator::Now().As(Time::S) << ": " << predictedBitErrors << " bit errors, " << predictedCongestion
+                << " congestion losses -> HtMcs" << dataMcs << ", load x" << loadScale);
+
+    Config::Set("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/RemoteStationManager/$ns3::ConstantRateWifiManager/DataMode",
+                StringValue("HtMcs" + std::to_string(dataMcs)));
+    for (auto& app : onOffBaseRates) {
+        app.first->SetAttribute("DataRate", DataRateValue(DataRate(static_cast<uint64_t>(app.second.GetBitRate() * loadScale))));
+    }
+    predictedBitErrors = 0;
+    predictedCongestion = 0;
+    Simulator::Schedule(Seconds(1.0), &ReactToDrops, minDrops);
+}
+
+// Id of the node a "/NodeList/<id>/..." trace context belongs to
+uint32_t ContextNodeId(const std::string& context) {
+    return std::stoul(context.substr(std::string("/NodeList/").size()));
+}
+
+// The link of a record, with the context of the receiving node at the time of the record
+std::vector<double> MakeRow(std::initializer_list<double> values, const std::string& context, uint32_t uid) {
+    std::vector<double> row(values);
+    auto transmitter = transmitterMap.find(uid);
+    featureExtractor->AppendFeatures(row, ContextNodeId(context),
+                                     transmitter != transmitterMap.end() ? transmitter->second : Mac48Address());
+    return row;
+}
+
+void SnifferRxCallback(std::string context, Ptr<const Packet> packet, uint16_t channelFreqMhz, WifiTxVector txVector, MpduInfo aMpdu, SignalNoiseDbm sn,unsigned short rateIndex) {
     double signalPowerDbm = sn.signal;
     double noisePowerDbm = sn.noise;
 
@@ -124,9 +238,13 @@ void SnifferRxCallback(Ptr<const Packet> packet, uint16_t channelFreqMhz, WifiTx
     // Store SNR in a map using packet ID
     snrMap[packet->GetUid()] = snr;
     rssiMap[packet->GetUid()] = rssi;
+    Mac48Address transmitter;
+    if (LinkFeatureExtractor::GetTransmitter(packet, aMpdu, transmitter)) {
+        transmitterMap[packet->GetUid()] = transmitter;
+    }
 }
 
-void RxDropCallback(Ptr<const Packet> p, WifiPhyRxfailureReason reason) {
+void RxDropCallback(std::string context, Ptr<const Packet> p, WifiPhyRxfailureReason reason) {
     std::string dropType;
 
     // Classify based on the reason (Bit Error or Congestion Loss)
@@ -182,21 +300,19 @@ void RxDropCallback(Ptr<const Packet> p, WifiPhyRxfailureReason reason) {
         rssiMap.erase(it2);
         snrMap.erase(it); // Remove entry after using it
 
+        // Timestamp, packet dropped (1 for drop), payload size, SNR, RSSI, retransmissions, delay
+        std::vector<double> row = MakeRow({Simulator::Now().GetSeconds(), 1.0, static_cast<double>(p->GetSize()), snr, rssi,
+                                           retransmissionCount[p->GetUid()], delay[p->GetUid()]}, context, p->GetUid());
+        transmitterMap.erase(p->GetUid());
+        WriteSample(row, dropType);
 
-        outputFile << Simulator::Now().GetSeconds() << ", " // Timestamp in seconds
-           << "1, " // Packet dropped (1 for drop)
-           << p->GetSize() << ", " // Payload size
-           << snr << ", " // SNR
-           << rssi << ", "// RSSI
-           << retransmissionCount[p->GetUid()] << ", "
-           << delay[p->GetUid()] << ", "
-           << dropType 
-           << std::endl;
-        outputFile.flush();
+        if (dropModel.GetNTrees() > 0) {
+            ClassifyDrop(row, dropType);
+        }
     }
 }
 
-void PacketReceivedCallback(Ptr<const Packet> packet) {
+void PacketReceivedCallback(std::string context, Ptr<const Packet> packet) {
     auto it = snrMap.find(packet->GetUid());
     auto it2 = rssiMap.find(packet->GetUid());
     if (it != snrMap.end()) {
@@ -214,16 +330,10 @@ void PacketReceivedCallback(Ptr<const Packet> packet) {
             d = delay[packet->GetUid()];
         }
         retransmissionCount.erase(packet->GetUid());
-        outputFile << Simulator::Now().GetSeconds() << ", " // Timestamp in seconds
-           << "0, " // Packet dropped (0 for success)
-           << packet->GetSize() << ", " 
-           << snr << ", " 
-           << rssi << ", "
-           << rtc << ", "
-           << d << ", "
-           << "success"
-           << std::endl;
-        outputFile.flush();
+        std::vector<double> row = MakeRow({Simulator::Now().GetSeconds(), 0.0, static_cast<double>(packet->GetSize()), snr, rssi, rtc, d},
+                                          context, packet->GetUid());
+        transmitterMap.erase(packet->GetUid());
+        WriteSample(row, "success");
     }
 }
 
@@ -233,17 +343,16 @@ void PacketReceivedCallback(Ptr<const Packet> packet) {
 
 int
 main(int argc, char *argv[]){
-    outputFile.open("scratch/dataset.txt",std::ios::out);
-    if(!outputFile){
-        std::cout<<"Could not open file\n";
-    }
-
-    outputFile << "timestamp, packet_dropped, payload_size, snr, rssi, rertransmission_count, retransmission_delay, status" << std::endl;
-
 
     std::string tcpVariant{"TcpNewReno"}; /* TCP variant type. */
     std::string phyRate{"HtMcs7"};        /* Physical layer bitrate. */
     Time simulationTime{"150s"};           /* Simulation time. */
+    std::string dropModelFile{""};        /* Drop classifier exported by export_drop_model.py. */
+    bool react{false};                    /* Adapt MCS and load to the classified drops. */
+    uint32_t reactMinDrops{10};           /* Drops per second below which the network is quiet. */
+    std::string datasetFile{"scratch/dataset.txt"}; /* Dataset (or shard) output. */
+    uint32_t quota{0};                    /* Rows kept per status class, 0 to keep every row. */
+    double speed{1.0};                    /* Vehicle speed in m/s. */
 
     /* Command line argument parser setup. */
     CommandLine cmd(__FILE__);
@@ -254,7 +363,42 @@ main(int argc, char *argv[]){
                  tcpVariant);
     cmd.AddValue("phyRate", "Physical layer bitrate", phyRate);
     cmd.AddValue("simulationTime", "Simulation time in seconds", simulationTime);
+    cmd.AddValue("dropModel", "Drop classifier exported by export_drop_model.py, empty to disable", dropModelFile);
+    cmd.AddValue("react", "Adapt the MCS and the offered load to the classified drops", react);
+    cmd.AddValue("reactMinDrops", "Drops per second below which the network counts as quiet", reactMinDrops);
+    cmd.AddValue("dataset", "Dataset (or shard) output file", datasetFile);
+    cmd.AddValue("quota", "Rows kept per status class, stopping once every class has them; 0 keeps every row", quota);
+    cmd.AddValue("vehicles", "Number of vehicles", number_of_vehicles);
+    cmd.AddValue("speed", "Vehicle speed in m/s", speed);
     cmd.Parse(argc, argv);
+
+    outputFile.open(datasetFile, std::ios::out);
+    if(!outputFile){
+        std::cout<<"Could not open file\n";
+    }
+
+    for (const auto& column : datasetColumns) {
+        outputFile << column << ", ";
+    }
+    outputFile << "status" << std::endl;
+    if (quota > 0) {
+        reservoir = std::make_unique<StratifiedReservoir>(quota, std::vector<std::string>{"Bit Error", "Congestion Loss", "success"});
+    }
+
+    if (!dropModelFile.empty()) {
+        dropModel.Load(dropModelFile);
+        for (uint32_t i = 0; i < dropModel.GetNFeatures(); ++i) {
+            auto column = std::find(datasetColumns.begin(), datasetColumns.end(), dropModel.GetFeatureName(i));
+            NS_ABORT_MSG_IF(column == datasetColumns.end(), "Unknown drop model feature " << dropModel.GetFeatureName(i));
+            dropModelColumns.push_back(column - datasetColumns.begin());
+        }
+    }
+    NS_ABORT_MSG_IF(react && dropModelFile.empty(), "--react needs a --dropModel");
+    NS_ABORT_MSG_IF(react && phyRate.rfind("HtMcs", 0) != 0, "--react steps HtMcs data modes, not " << phyRate);
+    if (react) {
+        maxDataMcs = std::stoi(phyRate.substr(5));
+        dataMcs = maxDataMcs;
+    }
     std::string tcpName = tcpVariant;
 
     tcpVariant = std::string("ns3::") + tcpVariant;
@@ -313,15 +457,18 @@ main(int argc, char *argv[]){
     wifiMac.SetType("ns3::StaWifiMac","Ssid",SsidValue(ssid));
 
     // Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/Phy/PhyRxDrop", MakeCallback (&RxDrop));
-    Config::ConnectWithoutContext("/NodeList/*/DeviceList/*/Phy/PhyRxDrop", MakeCallback(&RxDropCallback));
-    Config::ConnectWithoutContext("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/MonitorSnifferRx",MakeCallback(&SnifferRxCallback));
-    Config::ConnectWithoutContext("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/MacRx",MakeCallback(&PacketReceivedCallback));
+    Config::Connect("/NodeList/*/DeviceList/*/Phy/PhyRxDrop", MakeCallback(&RxDropCallback));
+    Config::Connect("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/MonitorSnifferRx",MakeCallback(&SnifferRxCallback));
+    Config::Connect("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/MacRx",MakeCallback(&PacketReceivedCallback));
     
     NetDeviceContainer smartVehicleDevices;
     smartVehicleDevices = wifiHelper.Install(wifiPhy,wifiMac,smartVehicleNodes);
     
     NetDeviceContainer sinkDevices;
     sinkDevices = wifiHelper.Install(wifiPhy,wifiMac,sinkNodes);
+
+    featureExtractor = CreateObject<LinkFeatureExtractor>();
+    featureExtractor->Install(NetDeviceContainer(NetDeviceContainer(apDevice, smartVehicleDevices), sinkDevices));
     
     MobilityHelper apMobility;
     Ptr<ListPositionAllocator> apPositionAlloc = CreateObject<ListPositionAllocator>();
@@ -337,7 +484,7 @@ main(int argc, char *argv[]){
     sinkMobility.SetPositionAllocator(sinkPositionAlloc);
     sinkMobility.Install(sinkNodes);
     
-    setVehicleMobility(smartVehicleNodes,0.0,0.0,1.0,0.0, 20.0, 10.0);
+    setVehicleMobility(smartVehicleNodes,0.0,0.0,speed,0.0, 20.0, 10.0);
      
     AodvHelper aodv;
     InternetStackHelper stack;
@@ -386,6 +533,12 @@ main(int argc, char *argv[]){
     largePktServer.SetAttribute("DataRate", DataRateValue(DataRate("20Mb/s")));
     ApplicationContainer largePktServerApp = largePktServer.Install(smartVehicleNodes);
     
+    Ptr<FlowDelayMonitor> delayMonitor = CreateObject<FlowDelayMonitor>();
+    delayMonitor->AddTrafficClass("small", smallPktServerApp);
+    delayMonitor->AddTrafficClass("mid", midPktServerApp);
+    delayMonitor->AddTrafficClass("large", largePktServerApp);
+    delayMonitor->AddSink(sink);
+
     sinkApp.Start(Seconds(0.0));
 
 
@@ -394,10 +547,69 @@ main(int argc, char *argv[]){
     largePktServerApp.Start(Seconds(1.3));
     
     Simulator::Schedule(Seconds(1.0), &CalculateThroughput);
+
+    if (react) {
+        for (const auto& apps : {smallPktServerApp, midPktServerApp, largePktServerApp}) {
+            for (uint32_t i = 0; i < apps.GetN(); ++i) {
+                Ptr<OnOffApplication> app = DynamicCast<OnOffApplication>(apps.Get(i));
+                DataRateValue rate;
+                app->GetAttribute("DataRate", rate);
+                onOffBaseRates.emplace_back(app, rate.Get());
+            }
+        }
+        Simulator::Schedule(Seconds(2.0), &ReactToDrops, reactMinDrops);
+    }
     
+    if (reservoir) {
+        Simulator::Schedule(Seconds(1.0), &StopWhenBalanced);
+    }
+
     Simulator::Stop(simulationTime);
     Simulator :: Run();
 
+    if (reservoir) {
+        reservoir->Write(outputFile);
+        std::cout << "status\toffered\tkept" << std::endl;
+        for (const std::string status : {"Bit Error", "Congestion Loss", "success"}) {
+            std::cout << status << "\t" << reservoir->GetOffered(status) << "\t" << reservoir->GetKept(status) << std::endl;
+        }
+    }
     outputFile.close();
+
+    std::cout << "class\ttx\trx\tmean_ms\tp50_ms\tp95_ms\tp99_ms\tmax_ms\tjitter_ms" << std::endl;
+    delayMonitor->WriteClassStats(std::cout, "");
+
+    if (dropInferences > 0 && !dropModelColumns.empty()) {
+        // Replay the recorded drops in a tight loop: the in-simulation figure also pays for
+        // the cache misses caused by the rest of the simulator
+        size_t nFeatures = dropModelColumns.size();
+        size_t nSamples = dropFeatures.size() / nFeatures;
+        uint64_t checksum = 0;
+        uint64_t replayed = 0;
+        auto begin = std::chrono::steady_clock::now();
+        while (replayed < 1000000) {
+            for (size_t i = 0; i < nSamples; ++i) {
+                checksum += dropModel.Predict(&dropFeatures[i * nFeatures]);
+            }
+            replayed += nSamples;
+        }
+        double isolatedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / replayed;
+
+        std::cout << "\nDrop classifier: " << dropModel.GetNTrees() << " trees, " << dropModel.GetNNodes() << " nodes, "
+                  << dropInferenceNs / dropInferences << " ns/drop in simulation, " << isolatedNs
+                  << " ns/drop isolated (checksum " << checksum << ")" << std::endl;
+        std::cout << "reason";
+        for (uint32_t c = 0; c < dropModel.GetNClasses(); ++c) {
+            std::cout << "\t" << dropModel.GetClassName(c);
+        }
+        std::cout << std::endl;
+        for (auto& row : dropConfusion) {
+            std::cout << row.first;
+            for (uint32_t c = 0; c < dropModel.GetNClasses(); ++c) {
+                std::cout << "\t" << row.second[dropModel.GetClassName(c)];
+            }
+            std::cout << std::endl;
+        }
+    }
     return 0;
 }
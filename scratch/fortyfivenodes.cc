@@ -25,17 +25,17 @@
 #include "ns3/aodv-module.h"
 #include "ns3/three-gpp-propagation-loss-model.h"
 
+#include "scenario-common.h"
+#include "throughput-monitor.h"
 
 #include <fstream>
+#include <numeric>
 
 NS_LOG_COMPONENT_DEFINE("proj");
 
 using namespace ns3;
 
 Ptr<PacketSink> sink;
-uint64_t lastTotalRx = 0;
-std::ofstream throughputFile;
-double totalEnergyConsumed = 0.0;
 std::vector<double> nodeEnergyConsumed;
 int number_of_vehicles = 45;
 int sink_count= 1;
@@ -43,63 +43,6 @@ int sink_count= 1;
 std::string fileName = "_45_1.txt";
 
 
-void
-CalculateThroughput()
-{
-    Time now = Simulator::Now(); /* Return the simulator's virtual time. */
-    double cur = (sink->GetTotalRx() - lastTotalRx) * 8.0 /(5*1e6); /* Convert Application RX Packets to MBits. */
-                
-    throughputFile << now.GetSeconds() << "\t" << cur << std::endl;
-    
-
-    lastTotalRx = sink->GetTotalRx();
-    std::cout << now.GetSeconds();
-    Simulator::Schedule(MilliSeconds(5000), &CalculateThroughput);
-}
-void CalculateEnergyConsumption(NodeContainer smartVehicleNodes) {
-    totalEnergyConsumed = 0.0;
-    for (size_t i = 0; i < nodeEnergyConsumed.size(); ++i) {
-        Ptr<ns3::energy::BasicEnergySource> energySource = DynamicCast<ns3::energy::BasicEnergySource>(smartVehicleNodes.Get(i)->GetObject<ns3::energy::EnergySourceContainer>()->Get(0));
-        if (energySource) {
-            nodeEnergyConsumed[i] = energySource->GetInitialEnergy() - energySource->GetRemainingEnergy();
-            totalEnergyConsumed += nodeEnergyConsumed[i];
-        } else {
-            NS_LOG_WARN("Energy source not found for node " << i);
-        }
-    }
-}
-
-void setVehicleMobility(NodeContainer smartVehicleNodes, double minx, double miny,double speedx,double speedy, double delx, double dely){
- 
-MobilityHelper smartVehicleMobility;
-// First half with RowFirst layout
-smartVehicleMobility.SetMobilityModel("ns3::ConstantVelocityMobilityModel");
-smartVehicleMobility.SetPositionAllocator("ns3::GridPositionAllocator",
-                                           "MinX", DoubleValue(minx),
-                                           "MinY", DoubleValue(miny),
-                                           "DeltaX", DoubleValue(10.0),
-                                           "DeltaY", DoubleValue(20.0),
-                                           "GridWidth", UintegerValue(16),
-                                           "LayoutType", StringValue("RowFirst"));
-// Install the mobility models
-smartVehicleMobility.Install(smartVehicleNodes);
-
-
-// Assign velocities
-for (int i = 0; i < number_of_vehicles / 2; i++) {
-    Ptr<Node> node = smartVehicleNodes.Get(i);
-    Ptr<ConstantVelocityMobilityModel> mob = node->GetObject<ConstantVelocityMobilityModel>();
-    mob->SetVelocity(Vector(speedx, speedy, 0.0));
-}
-
-for (int i = number_of_vehicles / 2; i < number_of_vehicles; i++) {
-    Ptr<Node> node = smartVehicleNodes.Get(i);
-    Ptr<ConstantVelocityMobilityModel> mob = node->GetObject<ConstantVelocityMobilityModel>();
-    mob->SetVelocity(Vector(-speedx, speedy, 0.0));
-}
-}
-
-
 int
 main(int argc, char *argv[]){
     std::string tcpVariant{"TcpLedbat"}; /* TCP variant type. */
@@ -198,7 +141,7 @@ main(int argc, char *argv[]){
     sinkMobility.SetPositionAllocator(sinkPositionAlloc);
     sinkMobility.Install(sinkNodes);
     
-    setVehicleMobility(smartVehicleNodes,0.0,0.0,1.0,0.0, 20.0, 10.0);
+    ScenarioCommon::InstallVehicleMobility(smartVehicleNodes,0.0,0.0,1.0,0.0);
      
     AodvHelper aodv;
     InternetStackHelper stack;
@@ -256,7 +199,10 @@ main(int argc, char *argv[]){
     
     std :: string throughputFileName = "throughput/throughput_" + tcpName + fileName;
     
-    throughputFile.open(throughputFileName);
+    Ptr<ThroughputMonitor> throughputMonitor = CreateObject<ThroughputMonitor>();
+    throughputMonitor->SetAttribute("Window", TimeValue(Seconds(5)));
+    throughputMonitor->AddSink(sink, "sink");
+    throughputMonitor->EnableOutput(throughputFileName);
     AnimationInterface anim("45_proj_netanim.xml");
     anim.SetMaxPktsPerTraceFile(3145728);
    
@@ -283,26 +229,14 @@ main(int argc, char *argv[]){
     midPktServerApp.Start(Seconds(1.2));
     largePktServerApp.Start(Seconds(1.3));
     
-    BasicEnergySourceHelper basicSourceHelper;
-    basicSourceHelper.Set("BasicEnergySourceInitialEnergyJ", DoubleValue(1000.0));
-    basicSourceHelper.Set("BasicEnergySupplyVoltageV", DoubleValue(12.0));
-    
-    WifiRadioEnergyModelHelper radioEnergyHelper;
-    
-    radioEnergyHelper.Set("TxCurrentA",DoubleValue(0.017));
-    radioEnergyHelper.Set("RxCurrentA",DoubleValue(0.0197));
-    radioEnergyHelper.Set("IdleCurrentA",DoubleValue(0.273));
-    radioEnergyHelper.Set("SleepCurrentA",DoubleValue(0.033));
-    
-    ns3::energy::EnergySourceContainer sources = basicSourceHelper.Install(smartVehicleNodes);
-    ns3::energy::DeviceEnergyModelContainer deviceModels = radioEnergyHelper.Install(smartVehicleDevices, sources);
-
-    nodeEnergyConsumed.resize(smartVehicleNodes.GetN(), 0.0);
+    ScenarioCommon::InstallRadioEnergy(smartVehicleNodes, smartVehicleDevices);
 
-    Simulator::Schedule(Seconds(99.0), &CalculateEnergyConsumption, smartVehicleNodes);
+    Simulator::Schedule(Seconds(99.0), [smartVehicleNodes]() {
+        nodeEnergyConsumed = ScenarioCommon::GetEnergyConsumed(smartVehicleNodes);
+    });
    
     
-    Simulator::Schedule(Seconds(1.1), &CalculateThroughput);
+    throughputMonitor->Start(Seconds(1.1));
     
     
     
@@ -318,10 +252,10 @@ main(int argc, char *argv[]){
     Simulator::Stop(simulationTime);
     Simulator :: Run();
     
-	double averageEnergyConsumption = totalEnergyConsumed / smartVehicleNodes.GetN();
+	double averageEnergyConsumption = std::accumulate(nodeEnergyConsumed.begin(), nodeEnergyConsumed.end(), 0.0) / smartVehicleNodes.GetN();
     std::cout << "Average energy consumption: " << averageEnergyConsumption << " J" << std::endl;
     
-    throughputFile.close();
+    throughputMonitor->Stop();
     
     auto averageThroughput =
         (static_cast<double>(sink->GetTotalRx() * 8  ) / simulationTime.GetMicroSeconds());
@@ -331,51 +265,20 @@ main(int argc, char *argv[]){
     //Flow monitor code
     monitor->CheckForLostPackets();
     Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier> (flowmon.GetClassifier());
-    std::map<FlowId, FlowMonitor::FlowStats> stats = monitor->GetFlowStats();
 
-    std::ofstream flowStatsFile;
-    
     std::string flowFileName = "flowstats/flow_stats_" + tcpName +fileName;
-     
-    flowStatsFile.open(flowFileName);
-    
-    int total_tx = 0;
-    int total_rx = 0;
-    double delaySum = 0;
-    
-    // Print Flow Monitor statistics for flows terminating at the sink
-    for (std::map<FlowId, FlowMonitor::FlowStats>::const_iterator i = stats.begin (); i != stats.end (); ++i)
-    {
-        Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow (i->first);
-        if (t.destinationAddress == sinkInterface.GetAddress (0))
-        {
-            total_tx+= i->second.txPackets;
-            total_rx+= i->second.rxPackets;
-            delaySum +=  i->second.timeLastRxPacket.GetSeconds()-i->second.timeFirstTxPacket.GetSeconds();
-            flowStatsFile << i->first << "\t"
-                          << t.sourceAddress << "\t"
-                          << t.destinationAddress << "\t"
-                          << i->second.txBytes << "\t"
-                          << i->second.rxBytes << "\t"
-                          << i->second.txPackets << "\t"
-                          << i->second.rxPackets << "\t"
-                          << i->second.lostPackets << "\t"
-                          << i->second.rxBytes * 8.0 / (i->second.timeLastRxPacket.GetSeconds() - i->second.timeFirstTxPacket.GetSeconds()) / 1024 / 1024<< std::endl;
-            
-       
-        }
-    }
     
-    
-    
-
-    flowStatsFile.close();
+    // Per-flow table of the flows terminating at the sink
+    ScenarioCommon::FlowTotals flowTotals = ScenarioCommon::WriteFlowStats(monitor, classifier, sinkInterface.GetAddress(0), flowFileName);
+    uint64_t total_tx = flowTotals.txPackets;
+    uint64_t total_rx = flowTotals.rxPackets;
+    double delaySum = flowTotals.delaySum;
     
     std::ofstream delayFile;
     
     delayFile.open("flowstats/delay.txt",std::ios::app);
     
-    delayFile << number_of_vehicles <<"\t" <<sink_count<<"\t"<< tcpName << "\t" << delaySum << std::endl;
+    delayFile << number_of_vehicles <<"\t" <<sink_count<<"\t"<< tcpName << "\t" << (total_rx > 0 ? delaySum / total_rx : 0.0) << std::endl;
     
     delayFile.close();
     
@@ -26,6 +26,9 @@
 #include "ns3/three-gpp-propagation-loss-model.h"
 
 
+#include "scenario-common.h"
+#include "throughput-monitor.h"
+
 #include <fstream>
 
 NS_LOG_COMPONENT_DEFINE("proj");
@@ -35,25 +38,11 @@ using namespace ns3;
 Ptr<PacketSink> sink;
 Ptr<PacketSink> sink2;
 Ptr<PacketSink> sink3;
-uint64_t lastTotalRx = 0;
-std::ofstream throughputFile;
 double totalEnergyConsumed = 0.0;
 std::vector<double> nodeEnergyConsumed;
 int number_of_vehicles = 30;
 
 
-void
-CalculateThroughput()
-{
-    Time now = Simulator::Now(); /* Return the simulator's virtual time. */
-    double cur = (sink->GetTotalRx() - lastTotalRx) * 8.0 /1e6; /* Convert Application RX Packets to MBits. */
-                
-    throughputFile << now.GetSeconds() << "\t" << cur << std::endl;
-    
-
-    lastTotalRx = sink->GetTotalRx();
-    Simulator::Schedule(MilliSeconds(1000), &CalculateThroughput);
-}
 void CalculateEnergyConsumption(NodeContainer smartVehicleNodes) {
     totalEnergyConsumed = 0.0;
     for (size_t i = 0; i < nodeEnergyConsumed.size(); ++i) {
@@ -297,7 +286,11 @@ main(int argc, char *argv[]){
     
     std :: string throughputFileName = "throughput/throughput_" + tcpName + std:: string {".txt"};
     
-    throughputFile.open(throughputFileName);
+    Ptr<ThroughputMonitor> throughputMonitor = CreateObject<ThroughputMonitor>();
+    throughputMonitor->AddSink(sink, "ap0");
+    throughputMonitor->AddSink(sink2, "ap1");
+    throughputMonitor->AddSink(sink3, "ap2");
+    throughputMonitor->EnableOutput(throughputFileName);
     AnimationInterface anim("proj_netanim.xml");
     anim.SetMaxPktsPerTraceFile(3145728);
    
@@ -322,34 +315,16 @@ main(int argc, char *argv[]){
     midPktServerApp3.Start(Seconds(1.1));
     largePktServerApp3.Start(Seconds(1.1));
     
-    BasicEnergySourceHelper basicSourceHelper;
-    basicSourceHelper.Set("BasicEnergySourceInitialEnergyJ", DoubleValue(1000.0));
-    basicSourceHelper.Set("BasicEnergySupplyVoltageV", DoubleValue(12.0));
-    
-    WifiRadioEnergyModelHelper radioEnergyHelper;
-    
-    radioEnergyHelper.Set("TxCurrentA",DoubleValue(0.017));
-    radioEnergyHelper.Set("RxCurrentA",DoubleValue(0.0197));
-    radioEnergyHelper.Set("IdleCurrentA",DoubleValue(0.273));
-    radioEnergyHelper.Set("SleepCurrentA",DoubleValue(0.033));
-    
-    ns3::energy::EnergySourceContainer sources = basicSourceHelper.Install(smartVehicleNodes);
-    ns3::energy::DeviceEnergyModelContainer deviceModels = radioEnergyHelper.Install(smartVehicleDevices, sources);
-
-
-    ns3::energy::EnergySourceContainer sources2 = basicSourceHelper.Install(smartVehicleNodes2);
-    ns3::energy::DeviceEnergyModelContainer deviceModels2 = radioEnergyHelper.Install(smartVehicleDevices2, sources2);
-
-
-    ns3::energy::EnergySourceContainer sources3 = basicSourceHelper.Install(smartVehicleNodes3);
-    ns3::energy::DeviceEnergyModelContainer deviceModels3 = radioEnergyHelper.Install(smartVehicleDevices3, sources3);
+    ScenarioCommon::InstallRadioEnergy(smartVehicleNodes, smartVehicleDevices);
+    ScenarioCommon::InstallRadioEnergy(smartVehicleNodes2, smartVehicleDevices2);
+    ScenarioCommon::InstallRadioEnergy(smartVehicleNodes3, smartVehicleDevices3);
 
     nodeEnergyConsumed.resize(smartVehicleNodes.GetN(), 0.0);
 
     Simulator::Schedule(Seconds(1.0), &CalculateEnergyConsumption,smartVehicleNodes);
    
     
-    Simulator::Schedule(Seconds(1.1), &CalculateThroughput);
+    throughputMonitor->Start(Seconds(1.1));
     
     
     
@@ -379,7 +354,7 @@ main(int argc, char *argv[]){
 	double averageEnergyConsumption = totalEnergyConsumed / smartVehicleNodes.GetN();
     std::cout << "Average energy consumption: " << averageEnergyConsumption << " J" << std::endl;
     
-    throughputFile.close();
+    throughputMonitor->Stop();
     
     auto averageThroughput =
         (static_cast<double>(sink->GetTotalRx() * 8  ) / simulationTime.GetMicroSeconds());
@@ -0,0 +1,250 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Searches AP positions and counts for a JSON scenario from the link budget alone
+// (ApPlacementOptimizer), so only the best few layouts need a full simulation.
+//
+// ./ns3 run "ap-placement --scenario=scratch/scenario-support/scenarios/sensor-network.json
+//            --minAps=3 --maxAps=5 --objective=min-snr --top=3 --output=placement/ap"
+//
+// The scenario is built once for the node positions at time 0, the propagation loss
+// chain of its channel and the transmission power and channel width of the AP group.
+// Candidates are a grid over the bounding box of the nodes. Every kept layout is written
+// to <output>-<count>-<rank>.txt, and <output>-jobs.txt holds one scenario-runner job
+// per layout, which swaps the AP group for it:
+//
+// ./ns3 run "scenario-runner --scenario=scratch/scenario-support/scenarios/sensor-network.json
+//            --jobs=placement/ap-jobs.txt"
+//
+// Traffic "toIndex" and sink "index" values that address the AP group must stay below the
+// AP count for those jobs to run, so --minAps is raised to the smallest count they allow.
+
+#include "ap-placement-optimizer.h"
+#include "json-value.h"
+#include "scenario-builder.h"
+#include "topology-generator.h"
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-model.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("ApPlacementTool");
+
+/**
+ * \param description the scenario
+ * \param group name of a group
+ * \return the smallest size of the group that its traffic and sink indices allow
+ */
+static uint32_t
+GetMinGroupSize(const JsonValue& description, const std::string& group)
+{
+    uint64_t size = 1;
+    const JsonValue& traffic = description["traffic"];
+    for (uint32_t i = 0; i < traffic.GetSize(); ++i)
+    {
+        if (traffic[i]["to"].AsString() == group)
+        {
+            size = std::max(size, traffic[i]["toIndex"].AsUint(0) + 1);
+        }
+    }
+    const JsonValue& sinks = description["sinks"];
+    for (uint32_t i = 0; i < sinks.GetSize(); ++i)
+    {
+        if (sinks[i]["group"].AsString() == group)
+        {
+            size = std::max(size, sinks[i]["index"].AsUint(0) + 1);
+        }
+    }
+    return static_cast<uint32_t>(size);
+}
+
+/**
+ * \param nodes the nodes
+ * \return their positions
+ */
+static std::vector<Vector>
+GetPositions(const NodeContainer& nodes)
+{
+    std::vector<Vector> positions;
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        Ptr<MobilityModel> mobility = nodes.Get(i)->GetObject<MobilityModel>();
+        NS_ABORT_MSG_UNLESS(mobility, "Node " << nodes.Get(i)->GetId() << " has no mobility");
+        positions.push_back(mobility->GetPosition());
+    }
+    return positions;
+}
+
+/**
+ * \brief Print one row of the placement table.
+ * \param name placement name
+ * \param placement the placement
+ */
+static void
+PrintPlacement(const std::string& name, const ApPlacementOptimizer::Placement& placement)
+{
+    std::cout << std::left << std::setw(16) << name << std::right << std::setw(5)
+              << placement.aps.size() << std::setw(10) << placement.score << std::setw(10)
+              << placement.minSnr << std::setw(10) << placement.meanSnr << std::setw(11)
+              << placement.capacity << std::setw(10) << placement.unserved << "  ";
+    for (const auto& ap : placement.aps)
+    {
+        std::cout << "(" << ap.x << "," << ap.y << ") ";
+    }
+    std::cout << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string scenarioFile;
+    std::string overrides;
+    std::string apGroup = "ap";
+    uint32_t minAps = 1;
+    uint32_t maxAps = 4;
+    double spacing = 5;
+    double margin = 0;
+    double height = -1;
+    std::string objective = "capacity";
+    uint32_t top = 3;
+    uint32_t restarts = 20;
+    double noiseFigure = 7;
+    double minSnr = 5;
+    std::string output = "placement";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("scenario", "JSON scenario description", scenarioFile);
+    cmd.AddValue("set", "path=value;... overrides of the description", overrides);
+    cmd.AddValue("apGroup", "Group whose positions are optimized", apGroup);
+    cmd.AddValue("minAps", "Smallest AP count", minAps);
+    cmd.AddValue("maxAps", "Largest AP count", maxAps);
+    cmd.AddValue("spacing", "Candidate grid spacing (m)", spacing);
+    cmd.AddValue("margin", "Candidate grid extent beyond the bounding box of the nodes", margin);
+    cmd.AddValue("height", "AP height, that of the first current AP if negative", height);
+    cmd.AddValue("objective", "min-snr or capacity", objective);
+    cmd.AddValue("top", "Layouts kept per AP count", top);
+    cmd.AddValue("restarts",
+                 "Random starting layouts per AP count, besides the greedy one",
+                 restarts);
+    cmd.AddValue("noiseFigure", "Receiver noise figure (dB)", noiseFigure);
+    cmd.AddValue("minSnr", "SNR below which a node is not served (dB)", minSnr);
+    cmd.AddValue("output", "Prefix of the layout files and of the jobs file", output);
+    cmd.Parse(argc, argv);
+    NS_ABORT_MSG_IF(scenarioFile.empty(), "--scenario is required");
+    NS_ABORT_MSG_UNLESS(objective == "min-snr" || objective == "capacity",
+                        "Unknown objective " << objective);
+
+    JsonValue description = JsonValue::Load(scenarioFile);
+    description.ApplyOverrides(JsonValue::ParseAssignments(overrides));
+    uint32_t minGroupSize = GetMinGroupSize(description, apGroup);
+    if (minAps < minGroupSize)
+    {
+        std::cerr << "Traffic or sinks address AP " << minGroupSize - 1 << " of group "
+                  << apGroup << ", raising --minAps to " << minGroupSize << std::endl;
+        minAps = minGroupSize;
+    }
+    NS_ABORT_MSG_IF(maxAps < minAps, "--maxAps must be at least " << minAps);
+    ScenarioBuilder scenario(description);
+    scenario.Build();
+
+    // The AP group gives the radio, every other group with devices the nodes to serve
+    const ScenarioBuilder::Group& aps = scenario.GetGroup(apGroup);
+    ScenarioBuilder::Radio radio = scenario.GetRadio(apGroup);
+
+    std::vector<Vector> nodes;
+    uint32_t apIndex = 0;
+    const auto& groups = scenario.GetGroups();
+    for (uint32_t g = 0; g < groups.size(); ++g)
+    {
+        if (groups[g].name == apGroup)
+        {
+            apIndex = g;
+        }
+        else if (groups[g].devices.GetN() > 0)
+        {
+            std::vector<Vector> positions = GetPositions(groups[g].nodes);
+            nodes.insert(nodes.end(), positions.begin(), positions.end());
+        }
+    }
+    NS_ABORT_MSG_IF(nodes.empty(), "No node to serve");
+    std::vector<Vector> current = GetPositions(aps.nodes);
+
+    Vector min = nodes.front();
+    Vector max = nodes.front();
+    for (const auto& p : nodes)
+    {
+        min = Vector(std::min(min.x, p.x), std::min(min.y, p.y), 0);
+        max = Vector(std::max(max.x, p.x), std::max(max.y, p.y), 0);
+    }
+    min = Vector(min.x - margin, min.y - margin, 0);
+    max = Vector(max.x + margin, max.y + margin, 0);
+
+    ApPlacementOptimizer optimizer;
+    optimizer.SetNodes(nodes);
+    optimizer.SetCandidateGrid(min, max, spacing, height >= 0 ? height : current.front().z);
+    optimizer.SetLossModel(radio.loss);
+    optimizer.SetRadio(radio.phy->GetTxPowerStart(),
+                       radio.phy->GetChannelWidth() * 1e6,
+                       noiseFigure,
+                       minSnr);
+    optimizer.SetObjective(objective == "min-snr" ? ApPlacementOptimizer::MIN_SNR
+                                                  : ApPlacementOptimizer::CAPACITY);
+    optimizer.AssignStreams(RngSeedManager::GetRun());
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<ApPlacementOptimizer::Placement> placements =
+        optimizer.Optimize(minAps, maxAps, top, restarts);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << nodes.size() << " nodes, " << optimizer.GetCandidates().size()
+              << " candidates, " << placements.size() << " layouts in " << elapsed.count()
+              << " s" << std::endl;
+
+    std::cout << std::left << std::setw(16) << "layout" << std::right << std::setw(5) << "aps"
+              << std::setw(10) << "score" << std::setw(10) << "minSnr" << std::setw(10)
+              << "meanSnr" << std::setw(11) << "Mb/s" << std::setw(10) << "unserved"
+              << "  positions" << std::endl;
+    PrintPlacement("current", optimizer.Evaluate(current));
+
+    std::ofstream jobs(output + "-jobs.txt");
+    NS_ABORT_MSG_UNLESS(jobs.is_open(), "Could not open " << output << "-jobs.txt");
+    uint32_t rank = 0;
+    for (std::size_t i = 0; i < placements.size(); ++i)
+    {
+        uint32_t count = placements[i].aps.size();
+        rank = (i > 0 && placements[i - 1].aps.size() == count) ? rank + 1 : 0;
+        std::string name = std::to_string(count) + "-" + std::to_string(rank);
+        std::string fileName = output + "-" + name + ".txt";
+        TopologyGenerator::Layout layout;
+        layout.positions = placements[i].aps;
+        TopologyGenerator::Write(layout, fileName);
+        PrintPlacement(name, placements[i]);
+
+        jobs << "run=" << RngSeedManager::GetRun() << ";groups." << apIndex
+             << ".count=" << count << ";groups." << apIndex
+             << ".mobility={\"layout\": \"file\", \"file\": \"" << fileName
+             << "\"};outputs.parameters.placement=" << name << std::endl;
+    }
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,511 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Summarizes FlowMonitor results in a single streaming pass.
+//
+// The input is either the XML written by FlowMonitor::SerializeToXmlFile or the
+// binary dump written by FlowStatsFile::Write; the format is detected from the
+// file signature. In the XML case the FlowStats/Flow and Ipv4FlowClassifier/Flow
+// elements are hash-joined on flowId as they are read, so the cost is linear in
+// the number of flows whatever order the two sections come in.
+//
+// Output, for --output=<prefix>:
+//  - <prefix>_flows.txt    one row per flow: tuple, packets, loss, bit rate, delay, jitter
+//  - <prefix>_bitrate.txt  histogram of the flow bit rates (kb/s)
+//  - <prefix>_loss.txt     histogram of the lost packets per flow
+//  - <prefix>_delay.txt    histogram of the mean flow delays (s)
+//  - <prefix>.plt          gnuplot script drawing the three histograms to <prefix>.pdf
+//
+// Flow selection and the histograms follow flow.py: flows to --skipPort are left
+// out (-1 keeps every flow), and flows without received packets count as a zero
+// bit rate and are left out of the delay histogram.
+//
+// ./ns3 run "flow-results --input=flowstats/flowmon_TcpHybla.bin --output=results"
+
+#include "flow-stats-file.h"
+
+#include "ns3/core-module.h"
+#include "ns3/ipv4-address.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("FlowResults");
+
+namespace
+{
+
+/// A flow, assembled from its statistics and its classifier tuple
+struct Flow
+{
+    bool hasStats = false;    //!< FlowStats entry seen
+    bool hasTuple = false;    //!< classifier entry seen
+    std::string source;       //!< source address
+    std::string destination;  //!< destination address
+    uint32_t protocol = 0;    //!< IP protocol
+    int32_t sourcePort = 0;   //!< source port
+    int32_t destinationPort = 0; //!< destination port
+    double timeFirstRx = 0;   //!< s
+    double timeLastRx = 0;    //!< s
+    double delaySum = 0;      //!< s
+    double jitterSum = 0;     //!< s
+    uint64_t txBytes = 0;     //!< transmitted bytes
+    uint64_t rxBytes = 0;     //!< received bytes
+    uint64_t txPackets = 0;   //!< transmitted packets
+    uint64_t rxPackets = 0;   //!< received packets
+    uint64_t lostPackets = 0; //!< lost packets
+};
+
+/// Fixed-bin histogram over [min, max] of the values, as numpy/matplotlib bin them
+struct Histogram
+{
+    double start = 0;             //!< left edge of the first bin
+    double width = 0;             //!< bin width
+    std::vector<uint64_t> counts; //!< per-bin counts
+};
+
+Histogram
+MakeHistogram(const std::vector<double>& values, uint32_t bins)
+{
+    Histogram h;
+    h.counts.assign(bins, 0);
+    if (values.empty())
+    {
+        h.width = 1.0 / bins;
+        return h;
+    }
+    auto [minIt, maxIt] = std::minmax_element(values.begin(), values.end());
+    double lo = *minIt;
+    double hi = *maxIt;
+    if (lo == hi)
+    {
+        lo -= 0.5;
+        hi += 0.5;
+    }
+    h.start = lo;
+    h.width = (hi - lo) / bins;
+    for (double v : values)
+    {
+        auto bin = static_cast<uint32_t>((v - lo) / h.width);
+        h.counts[std::min(bin, bins - 1)]++;
+    }
+    return h;
+}
+
+/**
+ * Parse an ns-3 Time as printed by operator<< ("+1.5e+09ns", "+2.1s", ...).
+ * \param text the attribute value
+ * \return the time in seconds
+ */
+double
+ParseTime(std::string_view text)
+{
+    std::string value(text);
+    char* end = nullptr;
+    double number = std::strtod(value.c_str(), &end);
+    std::string_view unit(end);
+    if (unit == "ns")
+    {
+        return number * 1e-9;
+    }
+    if (unit == "us")
+    {
+        return number * 1e-6;
+    }
+    if (unit == "ms")
+    {
+        return number * 1e-3;
+    }
+    if (unit == "ps")
+    {
+        return number * 1e-12;
+    }
+    if (unit == "fs")
+    {
+        return number * 1e-15;
+    }
+    if (unit == "min")
+    {
+        return number * 60;
+    }
+    if (unit == "h")
+    {
+        return number * 3600;
+    }
+    if (unit == "d")
+    {
+        return number * 86400;
+    }
+    return number; // "s" or no unit
+}
+
+uint64_t
+ParseInteger(std::string_view text)
+{
+    return std::strtoull(std::string(text).c_str(), nullptr, 10);
+}
+
+/**
+ * Call f(name, value) for every name="value" attribute of a start tag.
+ * \param tag the tag text, without the enclosing angle brackets
+ * \param f attribute handler
+ */
+template <typename F>
+void
+ForEachAttribute(std::string_view tag, F f)
+{
+    size_t pos = tag.find_first_of(" \t\r\n");
+    while (pos != std::string_view::npos)
+    {
+        size_t nameStart = tag.find_first_not_of(" \t\r\n", pos);
+        if (nameStart == std::string_view::npos)
+        {
+            return;
+        }
+        size_t eq = tag.find('=', nameStart);
+        if (eq == std::string_view::npos || eq + 1 >= tag.size())
+        {
+            return;
+        }
+        char quote = tag[eq + 1];
+        size_t valueEnd = tag.find(quote, eq + 2);
+        if (valueEnd == std::string_view::npos)
+        {
+            return;
+        }
+        std::string_view name = tag.substr(nameStart, eq - nameStart);
+        while (!name.empty() && (name.back() == ' ' || name.back() == '\t'))
+        {
+            name.remove_suffix(1);
+        }
+        f(name, tag.substr(eq + 2, valueEnd - eq - 2));
+        pos = valueEnd + 1;
+    }
+}
+
+/// Stream the FlowMonitor XML and join both Flow sections into flows
+void
+ReadXml(std::istream& in, std::unordered_map<uint32_t, Flow>& flows)
+{
+    enum Section
+    {
+        NONE,
+        STATS,
+        CLASSIFIER,
+        OTHER
+    };
+
+    Section section = NONE;
+    std::string chunk;
+    while (std::getline(in, chunk, '>'))
+    {
+        size_t open = chunk.rfind('<');
+        if (open == std::string::npos || open + 1 >= chunk.size())
+        {
+            continue;
+        }
+        std::string_view tag(chunk);
+        tag.remove_prefix(open + 1);
+        if (tag[0] == '?' || tag[0] == '!')
+        {
+            continue;
+        }
+        if (tag[0] == '/')
+        {
+            std::string_view name = tag.substr(1);
+            if (name == "FlowStats" || name == "Ipv4FlowClassifier" ||
+                name == "Ipv6FlowClassifier" || name == "FlowProbes")
+            {
+                section = NONE;
+            }
+            continue;
+        }
+
+        bool selfClosing = tag.back() == '/';
+        std::string_view name = tag.substr(0, tag.find_first_of(" \t\r\n/"));
+        if (name == "FlowStats")
+        {
+            section = selfClosing ? NONE : STATS;
+        }
+        else if (name == "Ipv4FlowClassifier" || name == "Ipv6FlowClassifier")
+        {
+            section = selfClosing ? NONE : CLASSIFIER;
+        }
+        else if (name == "FlowProbes")
+        {
+            section = selfClosing ? NONE : OTHER;
+        }
+        else if (name == "Flow" && (section == STATS || section == CLASSIFIER))
+        {
+            Flow parsed;
+            uint32_t flowId = 0;
+            bool stats = section == STATS;
+            ForEachAttribute(tag, [&](std::string_view key, std::string_view value) {
+                if (key == "flowId")
+                {
+                    flowId = ParseInteger(value);
+                }
+                else if (stats)
+                {
+                    if (key == "timeFirstRxPacket")
+                    {
+                        parsed.timeFirstRx = ParseTime(value);
+                    }
+                    else if (key == "timeLastRxPacket")
+                    {
+                        parsed.timeLastRx = ParseTime(value);
+                    }
+                    else if (key == "delaySum")
+                    {
+                        parsed.delaySum = ParseTime(value);
+                    }
+                    else if (key == "jitterSum")
+                    {
+                        parsed.jitterSum = ParseTime(value);
+                    }
+                    else if (key == "txBytes")
+                    {
+                        parsed.txBytes = ParseInteger(value);
+                    }
+                    else if (key == "rxBytes")
+                    {
+                        parsed.rxBytes = ParseInteger(value);
+                    }
+                    else if (key == "txPackets")
+                    {
+                        parsed.txPackets = ParseInteger(value);
+                    }
+                    else if (key == "rxPackets")
+                    {
+                        parsed.rxPackets = ParseInteger(value);
+                    }
+                    else if (key == "lostPackets")
+                    {
+                        parsed.lostPackets = ParseInteger(value);
+                    }
+                }
+                else if (key == "sourceAddress")
+                {
+                    parsed.source = value;
+                }
+                else if (key == "destinationAddress")
+                {
+                    parsed.destination = value;
+                }
+                else if (key == "protocol")
+                {
+                    parsed.protocol = ParseInteger(value);
+                }
+                else if (key == "sourcePort")
+                {
+                    parsed.sourcePort = ParseInteger(value);
+                }
+                else if (key == "destinationPort")
+                {
+                    parsed.destinationPort = ParseInteger(value);
+                }
+            });
+
+            // Hash join: whichever half of the flow arrives second completes the entry
+            Flow& flow = flows[flowId];
+            if (stats)
+            {
+                parsed.hasTuple = flow.hasTuple;
+                parsed.source = std::move(flow.source);
+                parsed.destination = std::move(flow.destination);
+                parsed.protocol = flow.protocol;
+                parsed.sourcePort = flow.sourcePort;
+                parsed.destinationPort = flow.destinationPort;
+                parsed.hasStats = true;
+                flow = std::move(parsed);
+            }
+            else
+            {
+                flow.hasTuple = true;
+                flow.source = std::move(parsed.source);
+                flow.destination = std::move(parsed.destination);
+                flow.protocol = parsed.protocol;
+                flow.sourcePort = parsed.sourcePort;
+                flow.destinationPort = parsed.destinationPort;
+            }
+        }
+    }
+}
+
+/// Read a FlowStatsFile dump, which already carries the joined flows
+void
+ReadBinary(std::istream& in, std::unordered_map<uint32_t, Flow>& flows)
+{
+    uint32_t count = FlowStatsFile::ReadHeader(in);
+    flows.reserve(count);
+    FlowStatsFile::Record record;
+    for (uint32_t i = 0; i < count && FlowStatsFile::ReadRecord(in, record); ++i)
+    {
+        Flow& flow = flows[record.flowId];
+        flow.hasStats = true;
+        flow.hasTuple = true;
+        std::ostringstream address;
+        address << Ipv4Address(record.sourceAddress);
+        flow.source = address.str();
+        address.str("");
+        address << Ipv4Address(record.destinationAddress);
+        flow.destination = address.str();
+        flow.protocol = record.protocol;
+        flow.sourcePort = record.sourcePort;
+        flow.destinationPort = record.destinationPort;
+        flow.timeFirstRx = record.timeFirstRxPacket * 1e-9;
+        flow.timeLastRx = record.timeLastRxPacket * 1e-9;
+        flow.delaySum = record.delaySum * 1e-9;
+        flow.jitterSum = record.jitterSum * 1e-9;
+        flow.txBytes = record.txBytes;
+        flow.rxBytes = record.rxBytes;
+        flow.txPackets = record.txPackets;
+        flow.rxPackets = record.rxPackets;
+        flow.lostPackets = record.lostPackets;
+    }
+}
+
+void
+WriteHistogram(const std::string& fileName, const Histogram& h)
+{
+    std::ofstream out(fileName);
+    NS_ABORT_MSG_UNLESS(out.is_open(), "Could not open " << fileName);
+    out << "# binStart\tbinEnd\tcount\n";
+    for (size_t i = 0; i < h.counts.size(); ++i)
+    {
+        out << h.start + i * h.width << "\t" << h.start + (i + 1) * h.width << "\t"
+            << h.counts[i] << "\n";
+    }
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output = "results";
+    int32_t skipPort = 9;
+    uint32_t bins = 40;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "FlowMonitor XML or binary flow statistics file", input);
+    cmd.AddValue("output", "Prefix of the output files", output);
+    cmd.AddValue("skipPort", "Leave out flows to this destination port (-1: keep all)", skipPort);
+    cmd.AddValue("bins", "Number of histogram bins", bins);
+    cmd.Parse(argc, argv);
+
+    NS_ABORT_MSG_IF(input.empty(), "--input is required");
+    NS_ABORT_MSG_IF(bins == 0, "--bins must be positive");
+    std::ifstream in(input, std::ios::binary);
+    NS_ABORT_MSG_UNLESS(in.is_open(), "Could not open " << input);
+
+    std::unordered_map<uint32_t, Flow> flows;
+    if (FlowStatsFile::IsFlowStatsFile(in))
+    {
+        ReadBinary(in, flows);
+    }
+    else
+    {
+        ReadXml(in, flows);
+    }
+
+    std::vector<uint32_t> ids;
+    ids.reserve(flows.size());
+    for (const auto& entry : flows)
+    {
+        ids.push_back(entry.first);
+    }
+    std::sort(ids.begin(), ids.end());
+
+    std::ofstream table(output + "_flows.txt");
+    NS_ABORT_MSG_UNLESS(table.is_open(), "Could not open " << output << "_flows.txt");
+    table << "# flowId\tsource\tdestination\tprotocol\tsourcePort\tdestinationPort\ttxPackets"
+             "\trxPackets\tlostPackets\tlossRatio\tbitrate(kb/s)\tmeanDelay(s)\tmeanJitter(s)\n";
+
+    std::vector<double> bitrates;
+    std::vector<double> losses;
+    std::vector<double> delays;
+    uint32_t unmatched = 0;
+    for (uint32_t id : ids)
+    {
+        const Flow& flow = flows[id];
+        if (!flow.hasStats || !flow.hasTuple)
+        {
+            ++unmatched;
+            continue;
+        }
+        if (skipPort >= 0 && flow.destinationPort == skipPort)
+        {
+            continue;
+        }
+
+        double duration = flow.timeLastRx - flow.timeFirstRx;
+        double bitrate =
+            flow.rxPackets > 0 && duration > 0 ? 8.0 * flow.rxBytes / duration * 1e-3 : 0.0;
+        double delay = flow.rxPackets > 0 ? flow.delaySum / flow.rxPackets : 0.0;
+        double jitter = flow.rxPackets > 1 ? flow.jitterSum / (flow.rxPackets - 1) : 0.0;
+        double lossRatio =
+            flow.txPackets > 0 ? static_cast<double>(flow.lostPackets) / flow.txPackets : 0.0;
+
+        bitrates.push_back(bitrate);
+        losses.push_back(flow.lostPackets);
+        if (flow.rxPackets > 0)
+        {
+            delays.push_back(delay);
+        }
+
+        table << id << "\t" << flow.source << "\t" << flow.destination << "\t" << flow.protocol
+              << "\t" << flow.sourcePort << "\t" << flow.destinationPort << "\t" << flow.txPackets
+              << "\t" << flow.rxPackets << "\t" << flow.lostPackets << "\t" << lossRatio << "\t"
+              << bitrate << "\t" << delay << "\t" << jitter << "\n";
+    }
+    if (unmatched > 0)
+    {
+        std::cerr << unmatched << " flows have statistics or a classifier entry, but not both"
+                  << std::endl;
+    }
+
+    WriteHistogram(output + "_bitrate.txt", MakeHistogram(bitrates, bins));
+    WriteHistogram(output + "_loss.txt", MakeHistogram(losses, bins));
+    WriteHistogram(output + "_delay.txt", MakeHistogram(delays, bins));
+
+    std::ofstream plot(output + ".plt");
+    NS_ABORT_MSG_UNLESS(plot.is_open(), "Could not open " << output << ".plt");
+    plot << "set terminal pdfcairo size 8in,10in\n"
+         << "set output \"" << output << ".pdf\"\n"
+         << "set multiplot layout 3,1\n"
+         << "set style fill solid 0.8\n"
+         << "set ylabel 'Number of Flows'\n"
+         << "set xlabel 'Flow Bit Rates (kb/s)'\n"
+         << "plot \"" << output << "_bitrate.txt\" using (($1+$2)/2):3:($2-$1) with boxes notitle\n"
+         << "set xlabel 'No of Lost Packets'\n"
+         << "plot \"" << output << "_loss.txt\" using (($1+$2)/2):3:($2-$1) with boxes notitle\n"
+         << "set xlabel 'Delay in Seconds'\n"
+         << "plot \"" << output << "_delay.txt\" using (($1+$2)/2):3:($2-$1) with boxes notitle\n"
+         << "unset multiplot\n";
+
+    std::cout << bitrates.size() << " flows written to " << output << "_flows.txt" << std::endl;
+    return 0;
+}
@@ -0,0 +1,407 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ap-placement-optimizer.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ApPlacementOptimizer");
+
+ApPlacementOptimizer::ApPlacementOptimizer()
+    : m_txPower(16.0206),
+      m_bandwidth(20e6),
+      m_minSnr(5.0),
+      m_objective(CAPACITY)
+{
+    SetRadio(m_txPower, m_bandwidth, 7.0, m_minSnr);
+    m_uniform = CreateObject<UniformRandomVariable>();
+}
+
+void
+ApPlacementOptimizer::SetNodes(const std::vector<Vector>& nodes)
+{
+    m_nodes = nodes;
+    m_cost.clear();
+}
+
+void
+ApPlacementOptimizer::SetCandidates(const std::vector<Vector>& candidates)
+{
+    m_candidates = candidates;
+    m_cost.clear();
+}
+
+void
+ApPlacementOptimizer::SetCandidateGrid(Vector min, Vector max, double spacing, double z)
+{
+    NS_LOG_FUNCTION(this << min << max << spacing << z);
+    NS_ABORT_MSG_UNLESS(spacing > 0, "Candidate spacing must be positive");
+    std::vector<Vector> candidates;
+    for (double y = min.y; y <= max.y + 1e-9; y += spacing)
+    {
+        for (double x = min.x; x <= max.x + 1e-9; x += spacing)
+        {
+            candidates.emplace_back(x, y, z);
+        }
+    }
+    SetCandidates(candidates);
+}
+
+void
+ApPlacementOptimizer::SetLossModel(Ptr<PropagationLossModel> model)
+{
+    m_budget.SetLossModel(model);
+    m_cost.clear();
+}
+
+void
+ApPlacementOptimizer::SetRadio(double txPower, double bandwidth, double noiseFigure, double minSnr)
+{
+    NS_LOG_FUNCTION(this << txPower << bandwidth << noiseFigure << minSnr);
+    NS_ABORT_MSG_UNLESS(bandwidth > 0, "Bandwidth must be positive");
+    m_txPower = txPower;
+    m_bandwidth = bandwidth;
+    // Thermal noise at 290 K is -174 dBm/Hz
+    m_noise = -174.0 + 10.0 * std::log10(bandwidth) + noiseFigure;
+    m_minSnr = minSnr;
+    m_cost.clear();
+}
+
+void
+ApPlacementOptimizer::SetObjective(Objective objective)
+{
+    m_objective = objective;
+    m_cost.clear();
+}
+
+const std::vector<Vector>&
+ApPlacementOptimizer::GetCandidates() const
+{
+    return m_candidates;
+}
+
+int64_t
+ApPlacementOptimizer::AssignStreams(int64_t stream)
+{
+    m_uniform->SetStream(stream);
+    return 1;
+}
+
+void
+ApPlacementOptimizer::ComputeSnr(const Vector& ap, double* snr) const
+{
+    const std::size_t n = m_nodes.size();
+    m_budget.CalcRxPower(m_txPower, ap, m_nodes.data(), n, snr);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        snr[i] -= m_noise;
+    }
+}
+
+void
+ApPlacementOptimizer::ComputeCost(const double* snr, float* cost) const
+{
+    const std::size_t n = m_nodes.size();
+    if (m_objective == MIN_SNR)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            cost[i] = -snr[i];
+        }
+        return;
+    }
+    const double mbps = m_bandwidth / 1e6;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        cost[i] = snr[i] < m_minSnr ? std::numeric_limits<float>::infinity()
+                                    : 1.0 / (mbps * std::log2(1.0 + std::pow(10.0, snr[i] / 10)));
+    }
+}
+
+double
+ApPlacementOptimizer::Score(const std::vector<float>& cost) const
+{
+    if (cost.empty())
+    {
+        return 0.0;
+    }
+    if (m_objective == MIN_SNR)
+    {
+        double worst = -std::numeric_limits<double>::infinity();
+        double sum = 0.0;
+        for (float c : cost)
+        {
+            worst = std::max<double>(worst, c);
+            sum += c;
+        }
+        return -worst - 1e-3 * sum / cost.size();
+    }
+    uint32_t served = 0;
+    double airtime = 0.0;
+    for (float c : cost)
+    {
+        if (std::isfinite(c))
+        {
+            ++served;
+            airtime += c;
+        }
+    }
+    // Coverage first: one more served node outweighs any capacity, which maps to [0, 1)
+    double capacity = served > 0 ? served / airtime : 0.0;
+    return served + capacity / (capacity + 100.0);
+}
+
+double
+ApPlacementOptimizer::ScoreCandidates(const std::vector<uint32_t>& chosen) const
+{
+    const std::size_t n = m_nodes.size();
+    std::vector<float> best(n, std::numeric_limits<float>::infinity());
+    for (uint32_t c : chosen)
+    {
+        const float* row = &m_cost[c * n];
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            best[i] = std::min(best[i], row[i]);
+        }
+    }
+    return Score(best);
+}
+
+double
+ApPlacementOptimizer::LocalSearch(std::vector<uint32_t>& chosen) const
+{
+    const std::size_t n = m_nodes.size();
+    const uint32_t nCandidates = m_candidates.size();
+    double score = ScoreCandidates(chosen);
+    std::vector<float> others(n);
+    std::vector<float> trial(n);
+
+    bool improved = true;
+    while (improved)
+    {
+        improved = false;
+        for (std::size_t k = 0; k < chosen.size(); ++k)
+        {
+            // Best cost of every node without AP k, so a swap costs one pass over the nodes
+            std::fill(others.begin(), others.end(), std::numeric_limits<float>::infinity());
+            for (std::size_t j = 0; j < chosen.size(); ++j)
+            {
+                if (j == k)
+                {
+                    continue;
+                }
+                const float* row = &m_cost[chosen[j] * n];
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    others[i] = std::min(others[i], row[i]);
+                }
+            }
+
+            uint32_t bestCandidate = chosen[k];
+            double bestScore = score;
+            for (uint32_t c = 0; c < nCandidates; ++c)
+            {
+                if (std::find(chosen.begin(), chosen.end(), c) != chosen.end())
+                {
+                    continue;
+                }
+                const float* row = &m_cost[c * n];
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    trial[i] = std::min(others[i], row[i]);
+                }
+                double s = Score(trial);
+                if (s > bestScore + 1e-9 * std::abs(bestScore))
+                {
+                    bestScore = s;
+                    bestCandidate = c;
+                }
+            }
+            if (bestCandidate != chosen[k])
+            {
+                chosen[k] = bestCandidate;
+                score = bestScore;
+                improved = true;
+            }
+        }
+    }
+    return score;
+}
+
+std::vector<ApPlacementOptimizer::Placement>
+ApPlacementOptimizer::Optimize(uint32_t minAps, uint32_t maxAps, uint32_t top, uint32_t restarts)
+{
+    NS_LOG_FUNCTION(this << minAps << maxAps << top << restarts);
+    NS_ABORT_MSG_IF(m_nodes.empty(), "No nodes to serve");
+    NS_ABORT_MSG_UNLESS(minAps >= 1 && minAps <= maxAps, "Invalid AP count range");
+    NS_ABORT_MSG_UNLESS(maxAps <= m_candidates.size(),
+                        "Only " << m_candidates.size() << " candidates for " << maxAps << " APs");
+    const std::size_t n = m_nodes.size();
+    const uint32_t nCandidates = m_candidates.size();
+
+    if (m_cost.size() != nCandidates * n)
+    {
+        m_cost.resize(nCandidates * n);
+        std::vector<double> snr(n);
+        for (uint32_t c = 0; c < nCandidates; ++c)
+        {
+            ComputeSnr(m_candidates[c], snr.data());
+            ComputeCost(snr.data(), &m_cost[c * n]);
+        }
+    }
+
+    std::vector<Placement> placements;
+    for (uint32_t count = minAps; count <= maxAps; ++count)
+    {
+        std::set<std::vector<uint32_t>> seen;
+        std::vector<std::pair<double, std::vector<uint32_t>>> optima;
+
+        for (uint32_t start = 0; start <= restarts; ++start)
+        {
+            std::vector<uint32_t> chosen;
+            if (start == 0)
+            {
+                // Greedy: add the candidate that raises the score most, one at a time
+                std::vector<float> best(n, std::numeric_limits<float>::infinity());
+                std::vector<float> trial(n);
+                while (chosen.size() < count)
+                {
+                    uint32_t bestCandidate = 0;
+                    double bestScore = -std::numeric_limits<double>::infinity();
+                    for (uint32_t c = 0; c < nCandidates; ++c)
+                    {
+                        if (std::find(chosen.begin(), chosen.end(), c) != chosen.end())
+                        {
+                            continue;
+                        }
+                        const float* row = &m_cost[c * n];
+                        for (std::size_t i = 0; i < n; ++i)
+                        {
+                            trial[i] = std::min(best[i], row[i]);
+                        }
+                        double s = Score(trial);
+                        if (s > bestScore)
+                        {
+                            bestScore = s;
+                            bestCandidate = c;
+                        }
+                    }
+                    chosen.push_back(bestCandidate);
+                    const float* row = &m_cost[bestCandidate * n];
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        best[i] = std::min(best[i], row[i]);
+                    }
+                }
+            }
+            else
+            {
+                while (chosen.size() < count)
+                {
+                    uint32_t c = m_uniform->GetInteger(0, nCandidates - 1);
+                    if (std::find(chosen.begin(), chosen.end(), c) == chosen.end())
+                    {
+                        chosen.push_back(c);
+                    }
+                }
+            }
+
+            double score = LocalSearch(chosen);
+            std::sort(chosen.begin(), chosen.end());
+            if (seen.insert(chosen).second)
+            {
+                optima.emplace_back(score, chosen);
+            }
+        }
+
+        std::stable_sort(optima.begin(), optima.end(), [](const auto& a, const auto& b) {
+            return a.first > b.first;
+        });
+        for (std::size_t r = 0; r < optima.size() && r < top; ++r)
+        {
+            std::vector<Vector> aps;
+            for (uint32_t c : optima[r].second)
+            {
+                aps.push_back(m_candidates[c]);
+            }
+            placements.push_back(Evaluate(aps));
+            if (r == 0)
+            {
+                NS_LOG_INFO(count << " APs: " << optima.size() << " distinct optima, best "
+                                  << placements.back().score << ", "
+                                  << placements.back().unserved << " nodes unserved");
+            }
+        }
+    }
+    return placements;
+}
+
+ApPlacementOptimizer::Placement
+ApPlacementOptimizer::Evaluate(const std::vector<Vector>& aps) const
+{
+    NS_LOG_FUNCTION(this << aps.size());
+    const std::size_t n = m_nodes.size();
+    std::vector<double> best(n, -std::numeric_limits<double>::infinity());
+    std::vector<double> snr(n);
+    for (const auto& ap : aps)
+    {
+        ComputeSnr(ap, snr.data());
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            best[i] = std::max(best[i], snr[i]);
+        }
+    }
+
+    Placement placement;
+    placement.aps = aps;
+    if (n == 0)
+    {
+        return placement;
+    }
+    std::vector<float> cost(n);
+    ComputeCost(best.data(), cost.data());
+    placement.score = Score(cost);
+
+    placement.minSnr = *std::min_element(best.begin(), best.end());
+    double sum = 0.0;
+    double airtime = 0.0;
+    uint32_t served = 0;
+    const double mbps = m_bandwidth / 1e6;
+    for (double s : best)
+    {
+        sum += s;
+        if (s < m_minSnr)
+        {
+            ++placement.unserved;
+            continue;
+        }
+        ++served;
+        airtime += 1.0 / (mbps * std::log2(1.0 + std::pow(10.0, s / 10)));
+    }
+    placement.meanSnr = sum / n;
+    placement.capacity = served > 0 ? served / airtime : 0.0;
+    return placement;
+}
+
+} // namespace ns3
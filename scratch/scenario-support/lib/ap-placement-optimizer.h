@@ -0,0 +1,203 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef AP_PLACEMENT_OPTIMIZER_H
+#define AP_PLACEMENT_OPTIMIZER_H
+
+#include "link-budget.h"
+
+#include "ns3/propagation-loss-model.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/vector.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Searches AP positions that serve a node layout best, from the link budget alone.
+ *
+ * The SNR of every node from every candidate AP position is computed once into a
+ * candidate-major matrix: downlink received power through the propagation loss model
+ * over the thermal noise of the channel plus a noise figure. LinkBudget evaluates chains
+ * of the common models in closed form over the whole row, Nakagami fading by its mean;
+ * any other chain goes through PropagationLossModel::CalcRxPower, once per pair, so its
+ * random models are sampled once.
+ *
+ * A node associates with the AP it hears best. Two objectives are supported:
+ *  - MIN_SNR: the SNR of the worst-served node, for coverage; ties are broken by the
+ *    mean SNR (score = min + 0.001 mean).
+ *  - CAPACITY: the number of served nodes (SNR above the minimum) first, then the
+ *    aggregate Shannon rate C (Mb/s) of those nodes when they share the airtime
+ *    packet-fairly, N / sum(1 / r_i): score = N + C / (C + 100). Dropping a slow node
+ *    would otherwise raise C. All APs are taken to share one channel, as ScenarioBuilder
+ *    puts every device on one, so a placement only gains by raising the rates of the
+ *    nodes; interference is not modelled.
+ *
+ * For each AP count, Optimize starts from a greedy placement and from random ones, and
+ * improves each by swapping one AP for another candidate while the score improves. A
+ * swap is scored in one pass over the nodes against the best SNR of the other APs, so
+ * the search is linear in the number of nodes; the matrix takes 4 bytes per node and
+ * candidate. The best distinct local optima of each count are returned, to be validated
+ * by full simulations.
+ */
+class ApPlacementOptimizer
+{
+  public:
+    /// What a placement maximizes
+    enum Objective
+    {
+        MIN_SNR, //!< SNR of the worst-served node
+        CAPACITY //!< aggregate rate under airtime sharing
+    };
+
+    /// A set of AP positions and how it serves the nodes
+    struct Placement
+    {
+        std::vector<Vector> aps; //!< AP positions
+        double score{0.0};       //!< value of the objective
+        double minSnr{0.0};      //!< SNR of the worst-served node (dB)
+        double meanSnr{0.0};     //!< mean SNR of the nodes (dB)
+        double capacity{0.0};    //!< aggregate rate estimate (Mb/s)
+        uint32_t unserved{0};    //!< nodes below the minimum SNR
+    };
+
+    ApPlacementOptimizer();
+
+    /**
+     * \param nodes positions of the nodes to serve
+     */
+    void SetNodes(const std::vector<Vector>& nodes);
+
+    /**
+     * \param candidates candidate AP positions
+     */
+    void SetCandidates(const std::vector<Vector>& candidates);
+
+    /**
+     * \brief Candidate AP positions on a grid covering a box.
+     * \param min lower corner
+     * \param max upper corner
+     * \param spacing grid spacing
+     * \param z height of the candidates
+     */
+    void SetCandidateGrid(Vector min, Vector max, double spacing, double z);
+
+    /**
+     * \param model propagation loss from an AP to a node, with its chain
+     */
+    void SetLossModel(Ptr<PropagationLossModel> model);
+
+    /**
+     * \param txPower AP transmission power (dBm)
+     * \param bandwidth channel width (Hz)
+     * \param noiseFigure receiver noise figure (dB)
+     * \param minSnr SNR below which a node is not served (dB)
+     */
+    void SetRadio(double txPower, double bandwidth, double noiseFigure, double minSnr);
+
+    /**
+     * \param objective what placements maximize
+     */
+    void SetObjective(Objective objective);
+
+    /**
+     * \return the candidate AP positions
+     */
+    const std::vector<Vector>& GetCandidates() const;
+
+    /**
+     * \brief Search placements of minAps to maxAps APs among the candidates.
+     * \param minAps smallest AP count
+     * \param maxAps largest AP count
+     * \param top placements kept per AP count
+     * \param restarts random starting placements per AP count, besides the greedy one
+     * \return for each count in increasing order, its best placements, best first
+     */
+    std::vector<Placement> Optimize(uint32_t minAps,
+                                    uint32_t maxAps,
+                                    uint32_t top,
+                                    uint32_t restarts);
+
+    /**
+     * \brief Score given AP positions, e.g. a hand-picked layout.
+     * \param aps the AP positions
+     * \return the placement and its scores
+     */
+    Placement Evaluate(const std::vector<Vector>& aps) const;
+
+    /**
+     * \brief Set the stream of the random starting placements.
+     * \param stream first stream index
+     * \return the number of streams used
+     */
+    int64_t AssignStreams(int64_t stream);
+
+  private:
+    /**
+     * \brief SNR of every node from one AP position.
+     * \param ap the AP position
+     * \param snr the SNRs (dB), one per node
+     */
+    void ComputeSnr(const Vector& ap, double* snr) const;
+
+    /**
+     * \brief Per-node cost of an SNR row: the lower, the better the node is served.
+     *
+     * -SNR for MIN_SNR, the inverse rate (s/Mbit, infinite below the minimum SNR) for
+     * CAPACITY, so a placement serves each node at the minimum cost over its APs.
+     *
+     * \param snr the SNRs (dB)
+     * \param cost the costs
+     */
+    void ComputeCost(const double* snr, float* cost) const;
+
+    /**
+     * \param cost the cost of every node under a placement
+     * \return the objective of that placement
+     */
+    double Score(const std::vector<float>& cost) const;
+
+    /**
+     * \brief Score the placement of m_cost rows.
+     * \param chosen candidate indices
+     * \return the objective
+     */
+    double ScoreCandidates(const std::vector<uint32_t>& chosen) const;
+
+    /**
+     * \brief Swap APs for other candidates while the score improves.
+     * \param chosen candidate indices, improved in place
+     * \return the final score
+     */
+    double LocalSearch(std::vector<uint32_t>& chosen) const;
+
+    std::vector<Vector> m_nodes;          //!< nodes to serve
+    std::vector<Vector> m_candidates;     //!< candidate AP positions
+    LinkBudget m_budget;                  //!< propagation loss chain
+    double m_txPower;                     //!< AP power (dBm)
+    double m_bandwidth;                   //!< channel width (Hz)
+    double m_noise;                       //!< noise power (dBm)
+    double m_minSnr;                      //!< SNR threshold of a served node (dB)
+    Objective m_objective;                //!< what placements maximize
+    std::vector<float> m_cost;            //!< candidate-major node costs
+    Ptr<UniformRandomVariable> m_uniform; //!< random starting placements
+};
+
+} // namespace ns3
+
+#endif /* AP_PLACEMENT_OPTIMIZER_H */
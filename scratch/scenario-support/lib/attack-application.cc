@@ -0,0 +1,204 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "attack-application.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("AttackApplication");
+
+NS_OBJECT_ENSURE_REGISTERED(AttackTag);
+NS_OBJECT_ENSURE_REGISTERED(AttackApplication);
+
+TypeId
+AttackTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::AttackTag")
+                            .SetParent<Tag>()
+                            .AddConstructor<AttackTag>();
+    return tid;
+}
+
+TypeId
+AttackTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+AttackTag::AttackTag()
+    : m_type(FLOOD),
+      m_attacker(0)
+{
+}
+
+AttackTag::AttackTag(Type type, uint32_t attacker)
+    : m_type(type),
+      m_attacker(attacker)
+{
+}
+
+AttackTag::Type
+AttackTag::GetType() const
+{
+    return m_type;
+}
+
+uint32_t
+AttackTag::GetAttacker() const
+{
+    return m_attacker;
+}
+
+bool
+AttackTag::IsAttack(Ptr<const Packet> packet)
+{
+    AttackTag tag;
+    return packet->FindFirstMatchingByteTag(tag);
+}
+
+uint32_t
+AttackTag::GetSerializedSize() const
+{
+    return 5;
+}
+
+void
+AttackTag::Serialize(TagBuffer i) const
+{
+    i.WriteU8(m_type);
+    i.WriteU32(m_attacker);
+}
+
+void
+AttackTag::Deserialize(TagBuffer i)
+{
+    m_type = static_cast<Type>(i.ReadU8());
+    m_attacker = i.ReadU32();
+}
+
+void
+AttackTag::Print(std::ostream& os) const
+{
+    os << "attack=" << static_cast<uint32_t>(m_type) << " attacker=" << m_attacker;
+}
+
+TypeId
+AttackApplication::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::AttackApplication")
+            .SetParent<Application>()
+            .AddAttribute("Intensity",
+                          "Fraction of the nominal attack rate once ramped up.",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&AttackApplication::m_intensity),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("InitialIntensity",
+                          "Fraction of the nominal attack rate at start.",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&AttackApplication::m_initialIntensity),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("RampTime",
+                          "Time to go from InitialIntensity to Intensity after a start.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&AttackApplication::m_rampTime),
+                          MakeTimeChecker())
+            .AddTraceSource("Tx",
+                            "An attack packet was emitted.",
+                            MakeTraceSourceAccessor(&AttackApplication::m_txTrace),
+                            "ns3::Packet::TracedCallback");
+    return tid;
+}
+
+AttackApplication::AttackApplication()
+    : m_running(false),
+      m_txPackets(0),
+      m_txBytes(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+AttackApplication::~AttackApplication()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+double
+AttackApplication::GetIntensity() const
+{
+    if (!m_running)
+    {
+        return 0.0;
+    }
+    Time elapsed = Simulator::Now() - m_startedAt;
+    if (!m_rampTime.IsStrictlyPositive() || elapsed >= m_rampTime)
+    {
+        return m_intensity;
+    }
+    double progress = elapsed.GetSeconds() / m_rampTime.GetSeconds();
+    return m_initialIntensity + (m_intensity - m_initialIntensity) * progress;
+}
+
+bool
+AttackApplication::IsRunning() const
+{
+    return m_running;
+}
+
+uint64_t
+AttackApplication::GetTxPackets() const
+{
+    return m_txPackets;
+}
+
+uint64_t
+AttackApplication::GetTxBytes() const
+{
+    return m_txBytes;
+}
+
+void
+AttackApplication::Label(Ptr<Packet> packet)
+{
+    packet->AddByteTag(AttackTag(GetAttackType(), GetNode()->GetId()));
+    m_txPackets++;
+    m_txBytes += packet->GetSize();
+    m_txTrace(packet);
+}
+
+void
+AttackApplication::StartApplication()
+{
+    NS_LOG_FUNCTION(this);
+    m_running = true;
+    m_startedAt = Simulator::Now();
+    StartAttack();
+}
+
+void
+AttackApplication::StopApplication()
+{
+    NS_LOG_FUNCTION(this);
+    m_running = false;
+    StopAttack();
+}
+
+} // namespace ns3
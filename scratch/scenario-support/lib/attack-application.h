@@ -0,0 +1,164 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ATTACK_APPLICATION_H
+#define ATTACK_APPLICATION_H
+
+#include "ns3/application.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/tag.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3
+{
+
+/**
+ * \brief Ground truth label carried by every packet an attack emits.
+ *
+ * The tag is a byte tag, so it survives TCP segmentation and IP forwarding and can be
+ * read back at any receiver or drop trace with AttackTag::IsAttack.
+ */
+class AttackTag : public Tag
+{
+  public:
+    /// Kind of attack that produced the packet
+    enum Type : uint8_t
+    {
+        FLOOD = 1,                //!< TCP or UDP flood
+        SYN_FLOOD = 2,            //!< TCP SYN flood
+        SELECTIVE_FORWARDING = 3, //!< forwarded packets dropped by a compromised node
+        JAMMING = 4               //!< reactive jamming frame
+    };
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+
+    AttackTag();
+
+    /**
+     * \param type attack kind
+     * \param attacker id of the attacking node
+     */
+    AttackTag(Type type, uint32_t attacker);
+
+    /**
+     * \return the attack kind
+     */
+    Type GetType() const;
+
+    /**
+     * \return the id of the attacking node
+     */
+    uint32_t GetAttacker() const;
+
+    /**
+     * \param packet a packet
+     * \return true if any byte of the packet was emitted by an attack
+     */
+    static bool IsAttack(Ptr<const Packet> packet);
+
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer i) const override;
+    void Deserialize(TagBuffer i) override;
+    void Print(std::ostream& os) const override;
+
+  private:
+    Type m_type;         //!< attack kind
+    uint32_t m_attacker; //!< attacking node id
+};
+
+/**
+ * \brief Base class of the attack applications.
+ *
+ * An attack is a single long-lived application: it is scheduled with the usual StartTime
+ * and StopTime attributes, and its intensity (a fraction of the attack's nominal rate or
+ * probability) ramps linearly from InitialIntensity to Intensity during the first
+ * RampTime after each start. Every packet the attack emits goes through Label, which
+ * tags it with an AttackTag and fires the Tx trace, so the traffic is labeled at the
+ * source.
+ */
+class AttackApplication : public Application
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    AttackApplication();
+    ~AttackApplication() override;
+
+    /**
+     * \return the current intensity, in [0, 1]
+     */
+    double GetIntensity() const;
+
+    /**
+     * \return true between start and stop
+     */
+    bool IsRunning() const;
+
+    /**
+     * \return the number of attack packets emitted so far
+     */
+    uint64_t GetTxPackets() const;
+
+    /**
+     * \return the number of attack bytes emitted so far
+     */
+    uint64_t GetTxBytes() const;
+
+  protected:
+    /**
+     * \return the label put on the packets of this attack
+     */
+    virtual AttackTag::Type GetAttackType() const = 0;
+
+    /// Called when the application starts
+    virtual void StartAttack() = 0;
+
+    /// Called when the application stops
+    virtual void StopAttack() = 0;
+
+    /**
+     * \brief Tag a packet as attack traffic and account for it.
+     * \param packet the packet about to be sent
+     */
+    void Label(Ptr<Packet> packet);
+
+  private:
+    void StartApplication() override;
+    void StopApplication() override;
+
+    double m_intensity;        //!< intensity once ramped up
+    double m_initialIntensity; //!< intensity at start
+    Time m_rampTime;           //!< duration of the ramp
+    Time m_startedAt;          //!< time of the last start
+    bool m_running;            //!< between start and stop
+    uint64_t m_txPackets;      //!< emitted packets
+    uint64_t m_txBytes;        //!< emitted bytes
+
+    TracedCallback<Ptr<const Packet>> m_txTrace; //!< attack packets, as emitted
+};
+
+} // namespace ns3
+
+#endif /* ATTACK_APPLICATION_H */
@@ -0,0 +1,83 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "attack-helper.h"
+
+#include "flood-attack.h"
+#include "reactive-jammer.h"
+#include "selective-forwarding-attack.h"
+#include "syn-flood-attack.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/udp-socket-factory.h"
+
+namespace ns3
+{
+
+AttackHelper::AttackHelper(const std::string& attack, const Address& remote)
+    : ApplicationHelper(GetAttackTypeId(attack))
+{
+    if (attack == "tcp-flood")
+    {
+        SetAttribute("Protocol", TypeIdValue(TcpSocketFactory::GetTypeId()));
+    }
+    else if (attack == "udp-flood")
+    {
+        SetAttribute("Protocol", TypeIdValue(UdpSocketFactory::GetTypeId()));
+    }
+    else if (attack == "blackhole")
+    {
+        SetAttribute("DropProbability", DoubleValue(1.0));
+    }
+    else if (attack == "selective-forwarding")
+    {
+        SetAttribute("DropProbability", DoubleValue(0.5));
+    }
+
+    if (attack == "tcp-flood" || attack == "udp-flood" || attack == "syn-flood")
+    {
+        SetAttribute("Remote", AddressValue(remote));
+    }
+}
+
+bool
+AttackHelper::IsValidName(const std::string& attack)
+{
+    return attack == "tcp-flood" || attack == "udp-flood" || attack == "syn-flood" ||
+           attack == "selective-forwarding" || attack == "blackhole" || attack == "jammer";
+}
+
+TypeId
+AttackHelper::GetAttackTypeId(const std::string& attack)
+{
+    NS_ABORT_MSG_UNLESS(IsValidName(attack), "Unknown attack " << attack);
+    if (attack == "syn-flood")
+    {
+        return SynFloodAttack::GetTypeId();
+    }
+    if (attack == "selective-forwarding" || attack == "blackhole")
+    {
+        return SelectiveForwardingAttack::GetTypeId();
+    }
+    if (attack == "jammer")
+    {
+        return ReactiveJammer::GetTypeId();
+    }
+    return FloodAttack::GetTypeId();
+}
+
+} // namespace ns3
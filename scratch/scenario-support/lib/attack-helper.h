@@ -0,0 +1,60 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ATTACK_HELPER_H
+#define ATTACK_HELPER_H
+
+#include "ns3/address.h"
+#include "ns3/application-helper.h"
+
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \brief Installs one of the attack applications, selected by name.
+ *
+ * Names: "tcp-flood", "udp-flood" (FloodAttack), "syn-flood" (SynFloodAttack),
+ * "selective-forwarding", "blackhole" (SelectiveForwardingAttack, the latter with
+ * DropProbability 1) and "jammer" (ReactiveJammer). Further attributes are set with
+ * SetAttribute as for any ApplicationHelper.
+ */
+class AttackHelper : public ApplicationHelper
+{
+  public:
+    /**
+     * \param attack attack name
+     * \param remote target of the floods, ignored by the other attacks
+     */
+    AttackHelper(const std::string& attack, const Address& remote = Address());
+
+    /**
+     * \param attack attack name
+     * \return true if the name is known
+     */
+    static bool IsValidName(const std::string& attack);
+
+  private:
+    /**
+     * \param attack attack name
+     * \return the TypeId of the application implementing it
+     */
+    static TypeId GetAttackTypeId(const std::string& attack);
+};
+
+} // namespace ns3
+
+#endif /* ATTACK_HELPER_H */
@@ -0,0 +1,141 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "backhaul-helper.h"
+
+#include "ns3/abort.h"
+#include "ns3/csma-helper.h"
+#include "ns3/error-model.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/log.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BackhaulHelper");
+
+BackhaulHelper::BackhaulHelper()
+    : m_type("p2p"),
+      m_rate("1Gbps"),
+      m_delay(MilliSeconds(10)),
+      m_loss(0.0),
+      m_network("10.1.0.0"),
+      m_mask("255.255.255.0")
+{
+}
+
+void
+BackhaulHelper::SetType(const std::string& type)
+{
+    NS_ABORT_MSG_UNLESS(type == "p2p" || type == "csma", "Unknown backhaul type " << type);
+    m_type = type;
+}
+
+void
+BackhaulHelper::SetDataRate(const std::string& rate)
+{
+    m_rate = rate;
+}
+
+void
+BackhaulHelper::SetDelay(Time delay)
+{
+    m_delay = delay;
+}
+
+void
+BackhaulHelper::SetLoss(double loss)
+{
+    NS_ABORT_MSG_UNLESS(loss >= 0.0 && loss <= 1.0, "Backhaul loss must be in [0, 1]");
+    m_loss = loss;
+}
+
+void
+BackhaulHelper::SetNetwork(const std::string& network, const std::string& mask)
+{
+    m_network = network;
+    m_mask = mask;
+}
+
+BackhaulHelper::Backhaul
+BackhaulHelper::Install(Ptr<Node> gateway, const NodeContainer& servers) const
+{
+    NS_LOG_FUNCTION(this << gateway->GetId() << servers.GetN() << m_type);
+    NS_ABORT_MSG_UNLESS(gateway->GetObject<Ipv4>(), "Install the Internet stack first");
+    NS_ABORT_MSG_IF(servers.GetN() == 0, "A backhaul needs at least one server");
+
+    Backhaul backhaul;
+    backhaul.servers = servers;
+    Ipv4AddressHelper address;
+    address.SetBase(m_network.c_str(), m_mask.c_str());
+    if (m_type == "p2p")
+    {
+        PointToPointHelper p2p;
+        p2p.SetDeviceAttribute("DataRate", StringValue(m_rate));
+        p2p.SetChannelAttribute("Delay", TimeValue(m_delay));
+        for (uint32_t i = 0; i < servers.GetN(); ++i)
+        {
+            NetDeviceContainer link = p2p.Install(gateway, servers.Get(i));
+            Ipv4InterfaceContainer interfaces = address.Assign(link);
+            address.NewNetwork();
+            backhaul.gatewayDevices.Add(link.Get(0));
+            backhaul.serverDevices.Add(link.Get(1));
+            backhaul.gatewayInterfaces.Add(interfaces.Get(0));
+            backhaul.serverInterfaces.Add(interfaces.Get(1));
+        }
+    }
+    else
+    {
+        CsmaHelper csma;
+        csma.SetChannelAttribute("DataRate", StringValue(m_rate));
+        csma.SetChannelAttribute("Delay", TimeValue(m_delay));
+        NodeContainer lan(gateway);
+        lan.Add(servers);
+        NetDeviceContainer devices = csma.Install(lan);
+        Ipv4InterfaceContainer interfaces = address.Assign(devices);
+        backhaul.gatewayDevices.Add(devices.Get(0));
+        backhaul.gatewayInterfaces.Add(interfaces.Get(0));
+        for (uint32_t i = 1; i < devices.GetN(); ++i)
+        {
+            backhaul.serverDevices.Add(devices.Get(i));
+            backhaul.serverInterfaces.Add(interfaces.Get(i));
+        }
+    }
+
+    if (m_loss > 0.0)
+    {
+        InstallLoss(backhaul.gatewayDevices);
+        InstallLoss(backhaul.serverDevices);
+    }
+    return backhaul;
+}
+
+void
+BackhaulHelper::InstallLoss(const NetDeviceContainer& devices) const
+{
+    for (uint32_t i = 0; i < devices.GetN(); ++i)
+    {
+        Ptr<RateErrorModel> error = CreateObject<RateErrorModel>();
+        error->SetUnit(RateErrorModel::ERROR_UNIT_PACKET);
+        error->SetRate(m_loss);
+        devices.Get(i)->SetAttribute("ReceiveErrorModel", PointerValue(error));
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,111 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BACKHAUL_HELPER_H
+#define BACKHAUL_HELPER_H
+
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \brief Wired segment between a gateway (the AP) and a tier of server nodes.
+ *
+ * "p2p" gives every server its own point-to-point link to the gateway, each in its own
+ * subnet; "csma" puts the gateway and all servers on one CSMA LAN and subnet. Every link
+ * has the same rate and one-way delay, and each receiving device drops packets with the
+ * given probability (RateErrorModel per packet), so both directions see the loss.
+ *
+ * The gateway and the servers must have an Internet stack; packets only reach the
+ * servers once the wireless nodes have routes to them (AODV on every node, or
+ * Ipv4GlobalRoutingHelper::PopulateRoutingTables after Install).
+ */
+class BackhaulHelper
+{
+  public:
+    /// Devices and interfaces of an installed backhaul
+    struct Backhaul
+    {
+        NodeContainer servers;                    //!< the server nodes
+        NetDeviceContainer gatewayDevices;        //!< gateway side, one per link
+        NetDeviceContainer serverDevices;         //!< one per server
+        Ipv4InterfaceContainer gatewayInterfaces; //!< gateway side, one per link
+        Ipv4InterfaceContainer serverInterfaces;  //!< one per server
+    };
+
+    BackhaulHelper();
+
+    /**
+     * \param type "p2p" or "csma"
+     */
+    void SetType(const std::string& type);
+
+    /**
+     * \param rate link rate, e.g. "1Gbps"
+     */
+    void SetDataRate(const std::string& rate);
+
+    /**
+     * \param delay one-way propagation delay of every link
+     */
+    void SetDelay(Time delay);
+
+    /**
+     * \param loss probability that a receiving device drops a packet
+     */
+    void SetLoss(double loss);
+
+    /**
+     * \brief Address the links from a base network.
+     *
+     * Point-to-point links take consecutive networks of that mask.
+     *
+     * \param network first network, e.g. "10.1.0.0"
+     * \param mask network mask, e.g. "255.255.255.0"
+     */
+    void SetNetwork(const std::string& network, const std::string& mask);
+
+    /**
+     * \brief Connect the servers to the gateway.
+     * \param gateway the gateway node
+     * \param servers the server nodes
+     * \return the devices and interfaces
+     */
+    Backhaul Install(Ptr<Node> gateway, const NodeContainer& servers) const;
+
+  private:
+    /**
+     * \brief Drop a fraction of the packets received by the devices.
+     * \param devices the devices
+     */
+    void InstallLoss(const NetDeviceContainer& devices) const;
+
+    std::string m_type;    //!< "p2p" or "csma"
+    std::string m_rate;    //!< link rate
+    Time m_delay;          //!< one-way delay
+    double m_loss;         //!< packet loss probability
+    std::string m_network; //!< first network
+    std::string m_mask;    //!< network mask
+};
+
+} // namespace ns3
+
+#endif /* BACKHAUL_HELPER_H */
@@ -0,0 +1,315 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "connectivity-monitor.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ConnectivityMonitor");
+
+NS_OBJECT_ENSURE_REGISTERED(ConnectivityMonitor);
+
+/**
+ * \param cx cell index along x
+ * \param cy cell index along y
+ * \return the sort key of the cell
+ */
+static uint64_t
+CellKey(int64_t cx, int64_t cy)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) |
+           static_cast<uint32_t>(cy);
+}
+
+TypeId
+ConnectivityMonitor::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::ConnectivityMonitor")
+                            .SetParent<Object>()
+                            .AddConstructor<ConnectivityMonitor>()
+                            .AddAttribute("Interval",
+                                          "Time between snapshots.",
+                                          TimeValue(Seconds(1.0)),
+                                          MakeTimeAccessor(&ConnectivityMonitor::m_interval),
+                                          MakeTimeChecker(TimeStep(1)))
+                            .AddAttribute("Range",
+                                          "Distance (m) under which two nodes are linked.",
+                                          DoubleValue(100.0),
+                                          MakeDoubleAccessor(&ConnectivityMonitor::m_range),
+                                          MakeDoubleChecker<double>(0.0));
+    return tid;
+}
+
+ConnectivityMonitor::ConnectivityMonitor()
+    : m_root(-1)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ConnectivityMonitor::~ConnectivityMonitor()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+ConnectivityMonitor::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Stop();
+    m_nodes.clear();
+    m_db = nullptr;
+    Object::DoDispose();
+}
+
+void
+ConnectivityMonitor::AddNodes(const NodeContainer& nodes)
+{
+    NS_LOG_FUNCTION(this << nodes.GetN());
+    NS_ABORT_MSG_IF(m_sampleEvent.IsPending(), "Nodes must be added before Start");
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        Ptr<MobilityModel> mobility = nodes.Get(i)->GetObject<MobilityModel>();
+        NS_ABORT_MSG_UNLESS(mobility, "Node " << nodes.Get(i)->GetId() << " has no mobility");
+        m_nodes.push_back(mobility);
+        m_nodeIds.push_back(nodes.Get(i)->GetId());
+    }
+}
+
+void
+ConnectivityMonitor::SetRoot(Ptr<Node> root)
+{
+    NS_LOG_FUNCTION(this << root);
+    auto it = std::find(m_nodeIds.begin(), m_nodeIds.end(), root->GetId());
+    if (it == m_nodeIds.end())
+    {
+        AddNodes(NodeContainer(root));
+        it = m_nodeIds.end() - 1;
+    }
+    m_root = it - m_nodeIds.begin();
+}
+
+void
+ConnectivityMonitor::EnableOutput(const std::string& fileName)
+{
+    NS_LOG_FUNCTION(this << fileName);
+    m_output.open(fileName);
+    NS_ABORT_MSG_UNLESS(m_output.is_open(), "Could not open " << fileName);
+    m_output << "# time\tlinks\tcomponents\tlargest\tisolated\treachable\tmeanHops\tmaxHops"
+                "\tmeanDegree\n";
+}
+
+void
+ConnectivityMonitor::EnableDatabase(Ptr<ResultsDatabase> db, const std::string& prefix)
+{
+    NS_LOG_FUNCTION(this << db << prefix);
+    m_db = db;
+    m_seriesPrefix = prefix;
+}
+
+void
+ConnectivityMonitor::Start(Time start)
+{
+    NS_LOG_FUNCTION(this << start);
+    m_sampleEvent.Cancel();
+    m_snapshots.clear();
+    m_sampleEvent = Simulator::Schedule(start, &ConnectivityMonitor::Sample, this);
+}
+
+void
+ConnectivityMonitor::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    m_sampleEvent.Cancel();
+    if (m_output.is_open())
+    {
+        m_output.flush();
+    }
+}
+
+const std::vector<ConnectivityMonitor::Snapshot>&
+ConnectivityMonitor::GetSnapshots() const
+{
+    return m_snapshots;
+}
+
+Time
+ConnectivityMonitor::GetFirstPartitionTime() const
+{
+    for (const auto& snapshot : m_snapshots)
+    {
+        if (m_root >= 0 && snapshot.reachable + 1 < m_nodes.size())
+        {
+            return Seconds(snapshot.time);
+        }
+    }
+    return Seconds(-1);
+}
+
+void
+ConnectivityMonitor::BuildGraph()
+{
+    const uint32_t n = m_nodes.size();
+    m_positions.resize(n);
+    m_cells.resize(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        m_positions[i] = m_nodes[i]->GetPosition();
+        m_cells[i] = {CellKey(std::floor(m_positions[i].x / m_range),
+                              std::floor(m_positions[i].y / m_range)),
+                      i};
+    }
+    std::sort(m_cells.begin(), m_cells.end());
+
+    const double range2 = m_range * m_range;
+    m_offsets.assign(n + 1, 0);
+    m_neighbors.clear();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        m_offsets[i] = m_neighbors.size();
+        int64_t cx = std::floor(m_positions[i].x / m_range);
+        int64_t cy = std::floor(m_positions[i].y / m_range);
+        for (int64_t dx = -1; dx <= 1; ++dx)
+        {
+            for (int64_t dy = -1; dy <= 1; ++dy)
+            {
+                uint64_t key = CellKey(cx + dx, cy + dy);
+                for (auto it = std::lower_bound(m_cells.begin(),
+                                                m_cells.end(),
+                                                std::make_pair(key, uint32_t(0)));
+                     it != m_cells.end() && it->first == key;
+                     ++it)
+                {
+                    uint32_t j = it->second;
+                    if (j != i &&
+                        CalculateDistanceSquared(m_positions[i], m_positions[j]) <= range2)
+                    {
+                        m_neighbors.push_back(j);
+                    }
+                }
+            }
+        }
+    }
+    m_offsets[n] = m_neighbors.size();
+}
+
+ConnectivityMonitor::Snapshot
+ConnectivityMonitor::Analyze()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_UNLESS(m_range > 0, "Range must be positive");
+    BuildGraph();
+    const uint32_t n = m_nodes.size();
+    Snapshot snapshot;
+    snapshot.time = Simulator::Now().GetSeconds();
+    snapshot.links = m_neighbors.size() / 2;
+    snapshot.meanDegree = n > 0 ? double(m_neighbors.size()) / n : 0.0;
+
+    // Components: breadth-first search from every node not labeled yet
+    std::vector<int32_t> hops(n, -1);
+    std::vector<uint32_t> queue;
+    queue.reserve(n);
+    for (uint32_t s = 0; s < n; ++s)
+    {
+        if (m_offsets[s] == m_offsets[s + 1])
+        {
+            ++snapshot.isolated;
+        }
+        if (hops[s] >= 0)
+        {
+            continue;
+        }
+        ++snapshot.components;
+        queue.clear();
+        queue.push_back(s);
+        hops[s] = 0;
+        for (std::size_t head = 0; head < queue.size(); ++head)
+        {
+            uint32_t u = queue[head];
+            for (uint32_t e = m_offsets[u]; e < m_offsets[u + 1]; ++e)
+            {
+                if (hops[m_neighbors[e]] < 0)
+                {
+                    hops[m_neighbors[e]] = 0;
+                    queue.push_back(m_neighbors[e]);
+                }
+            }
+        }
+        snapshot.largest = std::max<uint32_t>(snapshot.largest, queue.size());
+    }
+
+    // Hop counts from the root
+    if (m_root >= 0)
+    {
+        std::fill(hops.begin(), hops.end(), -1);
+        queue.clear();
+        queue.push_back(m_root);
+        hops[m_root] = 0;
+        uint64_t hopSum = 0;
+        for (std::size_t head = 0; head < queue.size(); ++head)
+        {
+            uint32_t u = queue[head];
+            for (uint32_t e = m_offsets[u]; e < m_offsets[u + 1]; ++e)
+            {
+                uint32_t v = m_neighbors[e];
+                if (hops[v] < 0)
+                {
+                    hops[v] = hops[u] + 1;
+                    hopSum += hops[v];
+                    snapshot.maxHops = hops[v];
+                    queue.push_back(v);
+                }
+            }
+        }
+        snapshot.reachable = queue.size() - 1;
+        snapshot.meanHops = snapshot.reachable > 0 ? double(hopSum) / snapshot.reachable : 0.0;
+    }
+    return snapshot;
+}
+
+void
+ConnectivityMonitor::Sample()
+{
+    NS_LOG_FUNCTION(this);
+    Snapshot s = Analyze();
+    m_snapshots.push_back(s);
+    if (m_output.is_open())
+    {
+        m_output << s.time << "\t" << s.links << "\t" << s.components << "\t" << s.largest
+                 << "\t" << s.isolated << "\t" << s.reachable << "\t" << s.meanHops << "\t"
+                 << s.maxHops << "\t" << s.meanDegree << "\n";
+    }
+    if (m_db)
+    {
+        m_db->AddSample(m_seriesPrefix + "components", s.time, s.components);
+        m_db->AddSample(m_seriesPrefix + "largest", s.time, s.largest);
+        m_db->AddSample(m_seriesPrefix + "isolated", s.time, s.isolated);
+        m_db->AddSample(m_seriesPrefix + "reachable", s.time, s.reachable);
+        m_db->AddSample(m_seriesPrefix + "meanHops", s.time, s.meanHops);
+        m_db->AddSample(m_seriesPrefix + "meanDegree", s.time, s.meanDegree);
+    }
+    m_sampleEvent = Simulator::Schedule(m_interval, &ConnectivityMonitor::Sample, this);
+}
+
+} // namespace ns3
@@ -0,0 +1,157 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CONNECTIVITY_MONITOR_H
+#define CONNECTIVITY_MONITOR_H
+
+#include "results-database.h"
+
+#include "ns3/event-id.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Periodic snapshots of the neighbor graph of mobile nodes, to see partitions.
+ *
+ * Every Interval the monitor reads the node positions and links every pair closer than
+ * Range. Pairs are found through a uniform grid of Range-sized cells, the nodes sorted
+ * by cell: a node is only compared with the nodes of its own and the 8 surrounding
+ * cells, so a snapshot is O(n log n) in nodes plus linear in links, not quadratic. The
+ * links go into a compressed adjacency array, on which a breadth-first search labels the
+ * connected components and another, from the root node (the AP), gives its reachable
+ * set and the hop count of every reachable node.
+ *
+ * Range stands for the radio range; it is a disk model, with no fading or interference.
+ * Each snapshot is written as one line, and to a ResultsDatabase as the series
+ * "<prefix>components", "largest", "isolated", "reachable", "meanHops" and "meanDegree".
+ */
+class ConnectivityMonitor : public Object
+{
+  public:
+    /// One snapshot of the graph
+    struct Snapshot
+    {
+        double time{0.0};       //!< simulation time (s)
+        uint32_t links{0};      //!< links within range
+        uint32_t components{0}; //!< connected components
+        uint32_t largest{0};    //!< nodes in the largest component
+        uint32_t isolated{0};   //!< nodes without any link
+        uint32_t reachable{0};  //!< nodes reachable from the root, root excluded
+        double meanHops{0.0};   //!< mean hop count of the reachable nodes
+        uint32_t maxHops{0};    //!< hop count of the farthest reachable node
+        double meanDegree{0.0}; //!< mean number of links per node
+    };
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    ConnectivityMonitor();
+    ~ConnectivityMonitor() override;
+
+    /**
+     * \brief Add nodes to the graph. Nodes must be added before Start.
+     * \param nodes nodes with a mobility model
+     */
+    void AddNodes(const NodeContainer& nodes);
+
+    /**
+     * \brief Set the node whose reachable set is tracked, adding it if needed.
+     * \param root the root node, usually the AP
+     */
+    void SetRoot(Ptr<Node> root);
+
+    /**
+     * \brief Write one line per snapshot to the given file.
+     * \param fileName output file
+     */
+    void EnableOutput(const std::string& fileName);
+
+    /**
+     * \brief Also store the snapshots in a results database.
+     * \param db the results database of the run
+     * \param prefix series name prefix
+     */
+    void EnableDatabase(Ptr<ResultsDatabase> db, const std::string& prefix = "connectivity/");
+
+    /**
+     * \brief Start taking snapshots.
+     * \param start time of the first snapshot
+     */
+    void Start(Time start);
+
+    /// Stop taking snapshots
+    void Stop();
+
+    /**
+     * \brief Analyze the graph at the current time, without recording it.
+     * \return the snapshot
+     */
+    Snapshot Analyze();
+
+    /**
+     * \return every recorded snapshot, in time order
+     */
+    const std::vector<Snapshot>& GetSnapshots() const;
+
+    /**
+     * \return the time of the first snapshot in which a node was out of reach of the
+     *         root, or a negative time if there was none
+     */
+    Time GetFirstPartitionTime() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Take one snapshot and reschedule
+    void Sample();
+
+    /**
+     * \brief Build the adjacency arrays of the current positions.
+     */
+    void BuildGraph();
+
+    Time m_interval;                          //!< time between snapshots
+    double m_range;                           //!< link range (m)
+    std::vector<Ptr<MobilityModel>> m_nodes;  //!< graph nodes
+    std::vector<uint32_t> m_nodeIds;          //!< node ids, to find the root
+    int64_t m_root;                           //!< index of the root, -1 for none
+    std::vector<Vector> m_positions;          //!< positions of the current snapshot
+    std::vector<std::pair<uint64_t, uint32_t>> m_cells; //!< (cell, node), sorted
+    std::vector<uint32_t> m_offsets;          //!< first neighbor of each node
+    std::vector<uint32_t> m_neighbors;        //!< neighbors, grouped by node
+    std::vector<Snapshot> m_snapshots;        //!< recorded snapshots
+    std::ofstream m_output;                   //!< snapshot output
+    Ptr<ResultsDatabase> m_db;                //!< snapshot database, if any
+    std::string m_seriesPrefix;               //!< database series name prefix
+    EventId m_sampleEvent;                    //!< next snapshot
+};
+
+} // namespace ns3
+
+#endif /* CONNECTIVITY_MONITOR_H */
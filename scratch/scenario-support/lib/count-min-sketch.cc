@@ -0,0 +1,159 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "count-min-sketch.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ns3
+{
+
+namespace
+{
+
+/**
+ * \param state generator state, advanced by the call
+ * \return the next splitmix64 value
+ */
+uint64_t
+SplitMix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+CountMinSketch::CountMinSketch(uint32_t width,
+                               uint32_t depth,
+                               uint32_t heavyHitters,
+                               uint64_t seed)
+    : m_width(std::max<uint32_t>(width, 1)),
+      m_depth(std::max<uint32_t>(depth, 1)),
+      m_counters(static_cast<size_t>(m_width) * m_depth, 0),
+      m_heavyCapacity(heavyHitters),
+      m_total(0)
+{
+    uint64_t state = seed;
+    for (uint32_t row = 0; row < m_depth; ++row)
+    {
+        // Odd multipliers keep the multiply-shift family universal
+        uint64_t multiplier = SplitMix64(state) | 1;
+        m_hashes.emplace_back(multiplier, SplitMix64(state));
+    }
+    m_heavy.reserve(m_heavyCapacity);
+}
+
+uint32_t
+CountMinSketch::GetColumn(uint32_t row, uint64_t key) const
+{
+    const auto& hash = m_hashes[row];
+    auto h = static_cast<uint32_t>((hash.first * key + hash.second) >> 32);
+    // Maps h uniformly onto [0, width) without a division
+    return static_cast<uint32_t>((static_cast<uint64_t>(h) * m_width) >> 32);
+}
+
+uint64_t
+CountMinSketch::Add(uint64_t key, uint64_t count)
+{
+    m_total += count;
+    uint64_t estimate = Estimate(key) + count;
+    for (uint32_t row = 0; row < m_depth; ++row)
+    {
+        uint64_t& counter = m_counters[static_cast<size_t>(row) * m_width + GetColumn(row, key)];
+        counter = std::max(counter, estimate);
+    }
+    UpdateHeavyHitters(key, estimate);
+    return estimate;
+}
+
+uint64_t
+CountMinSketch::Estimate(uint64_t key) const
+{
+    uint64_t estimate = std::numeric_limits<uint64_t>::max();
+    for (uint32_t row = 0; row < m_depth; ++row)
+    {
+        estimate = std::min(estimate,
+                            m_counters[static_cast<size_t>(row) * m_width + GetColumn(row, key)]);
+    }
+    return estimate;
+}
+
+void
+CountMinSketch::UpdateHeavyHitters(uint64_t key, uint64_t estimate)
+{
+    if (m_heavyCapacity == 0)
+    {
+        return;
+    }
+    // The table is small, a linear scan beats any indexed structure here
+    auto smallest = m_heavy.end();
+    for (auto it = m_heavy.begin(); it != m_heavy.end(); ++it)
+    {
+        if (it->first == key)
+        {
+            it->second = estimate;
+            return;
+        }
+        if (smallest == m_heavy.end() || it->second < smallest->second)
+        {
+            smallest = it;
+        }
+    }
+    if (m_heavy.size() < m_heavyCapacity)
+    {
+        m_heavy.emplace_back(key, estimate);
+    }
+    else if (estimate > smallest->second)
+    {
+        *smallest = {key, estimate};
+    }
+}
+
+void
+CountMinSketch::Reset()
+{
+    std::fill(m_counters.begin(), m_counters.end(), 0);
+    m_heavy.clear();
+    m_total = 0;
+}
+
+uint64_t
+CountMinSketch::GetTotal() const
+{
+    return m_total;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>>
+CountMinSketch::GetHeavyHitters() const
+{
+    auto heavy = m_heavy;
+    std::sort(heavy.begin(), heavy.end(), [](const auto& a, const auto& b) {
+        return a.second > b.second;
+    });
+    return heavy;
+}
+
+size_t
+CountMinSketch::GetMemoryUsage() const
+{
+    return m_counters.size() * sizeof(uint64_t) +
+           m_heavyCapacity * sizeof(std::pair<uint64_t, uint64_t>);
+}
+
+} // namespace ns3
@@ -0,0 +1,110 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef COUNT_MIN_SKETCH_H
+#define COUNT_MIN_SKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Fixed-memory frequency estimator (count-min sketch) with a heavy-hitter table.
+ *
+ * Each key is hashed into one counter per row; its estimate is the smallest of those
+ * counters, which never underestimates the true count and overestimates it by at most
+ * e/width times the total count with probability 1 - exp(-depth). Updates are
+ * conservative: only the counters equal to the current estimate are raised, which
+ * tightens the estimates further without breaking the guarantee.
+ *
+ * Next to the counters, the sketch keeps the HeavyHitters keys with the largest estimates
+ * seen so far, so that the dominant keys can be listed without storing every key.
+ */
+class CountMinSketch
+{
+  public:
+    /**
+     * \param width counters per row
+     * \param depth number of rows (independent hash functions)
+     * \param heavyHitters size of the heavy-hitter table, 0 to disable it
+     * \param seed seed of the hash functions
+     */
+    CountMinSketch(uint32_t width = 1024,
+                   uint32_t depth = 4,
+                   uint32_t heavyHitters = 16,
+                   uint64_t seed = 1);
+
+    /**
+     * \param key the key
+     * \param count amount to add to the key
+     * \return the estimate of the key after the update
+     */
+    uint64_t Add(uint64_t key, uint64_t count = 1);
+
+    /**
+     * \param key the key
+     * \return the estimated count of the key
+     */
+    uint64_t Estimate(uint64_t key) const;
+
+    /// Zero every counter and empty the heavy-hitter table
+    void Reset();
+
+    /**
+     * \return the sum of every added count
+     */
+    uint64_t GetTotal() const;
+
+    /**
+     * \return the heavy hitters as (key, estimate), largest estimate first
+     */
+    std::vector<std::pair<uint64_t, uint64_t>> GetHeavyHitters() const;
+
+    /**
+     * \return the memory taken by the counters and the heavy-hitter table, in bytes
+     */
+    size_t GetMemoryUsage() const;
+
+  private:
+    /**
+     * \param row a row
+     * \param key a key
+     * \return the column of the key in the row
+     */
+    uint32_t GetColumn(uint32_t row, uint64_t key) const;
+
+    /**
+     * \brief Insert or refresh a key in the heavy-hitter table.
+     * \param key the key
+     * \param estimate its current estimate
+     */
+    void UpdateHeavyHitters(uint64_t key, uint64_t estimate);
+
+    uint32_t m_width;                                  //!< counters per row
+    uint32_t m_depth;                                  //!< rows
+    std::vector<uint64_t> m_counters;                  //!< depth x width counters
+    std::vector<std::pair<uint64_t, uint64_t>> m_hashes; //!< per-row (multiplier, offset)
+    std::vector<std::pair<uint64_t, uint64_t>> m_heavy;  //!< (key, estimate) table
+    uint32_t m_heavyCapacity;                          //!< heavy-hitter table size
+    uint64_t m_total;                                  //!< sum of the added counts
+};
+
+} // namespace ns3
+
+#endif /* COUNT_MIN_SKETCH_H */
@@ -0,0 +1,213 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "coverage-map.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CoverageMap");
+
+CoverageMap::CoverageMap()
+    : m_txPower(16.0206),
+      m_noise(-174.0 + 10.0 * std::log10(20e6) + 7.0),
+      m_minSnr(5.0),
+      m_threads(0),
+      m_resolution(1.0),
+      m_z(0.0),
+      m_columns(0),
+      m_rows(0)
+{
+}
+
+void
+CoverageMap::SetTransmitters(const std::vector<Vector>& aps)
+{
+    NS_ABORT_MSG_IF(aps.size() > UINT16_MAX, "Too many APs");
+    m_aps = aps;
+}
+
+void
+CoverageMap::SetLossModel(Ptr<PropagationLossModel> model)
+{
+    m_budget.SetLossModel(model);
+}
+
+void
+CoverageMap::SetRadio(double txPower, double bandwidth, double noiseFigure, double minSnr)
+{
+    NS_LOG_FUNCTION(this << txPower << bandwidth << noiseFigure << minSnr);
+    NS_ABORT_MSG_UNLESS(bandwidth > 0, "Bandwidth must be positive");
+    m_txPower = txPower;
+    m_noise = -174.0 + 10.0 * std::log10(bandwidth) + noiseFigure;
+    m_minSnr = minSnr;
+}
+
+void
+CoverageMap::SetThreads(uint32_t threads)
+{
+    m_threads = threads;
+}
+
+void
+CoverageMap::Compute(Vector min, Vector max, double resolution, double z)
+{
+    NS_LOG_FUNCTION(this << min << max << resolution << z);
+    NS_ABORT_MSG_IF(m_aps.empty(), "No AP");
+    NS_ABORT_MSG_UNLESS(resolution > 0, "Resolution must be positive");
+    NS_ABORT_MSG_UNLESS(max.x > min.x && max.y > min.y, "Empty area");
+    m_min = min;
+    m_resolution = resolution;
+    m_z = z;
+    m_columns = std::ceil((max.x - min.x) / resolution);
+    m_rows = std::ceil((max.y - min.y) / resolution);
+    m_rxPower.assign(std::size_t(m_columns) * m_rows, 0.0F);
+    m_outage.assign(m_rxPower.size(), 0.0F);
+    m_ap.assign(m_rxPower.size(), 0);
+
+    uint32_t threads = m_threads > 0 ? m_threads : std::thread::hardware_concurrency();
+    if (!m_budget.IsAnalytic())
+    {
+        NS_LOG_WARN("Propagation chain without closed form, evaluated on one thread");
+        threads = 1;
+    }
+    threads = std::max<uint32_t>(std::min(threads, m_rows), 1);
+    std::vector<std::thread> workers;
+    for (uint32_t t = 1; t < threads; ++t)
+    {
+        workers.emplace_back(&CoverageMap::ComputeRows, this, t, threads);
+    }
+    ComputeRows(0, threads);
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void
+CoverageMap::ComputeRows(uint32_t first, uint32_t step)
+{
+    std::vector<Vector> cells(m_columns);
+    std::vector<double> rxPower(m_columns);
+    std::vector<double> best(m_columns);
+    std::vector<uint16_t> serving(m_columns);
+    for (uint32_t row = first; row < m_rows; row += step)
+    {
+        double y = m_min.y + (row + 0.5) * m_resolution;
+        for (uint32_t c = 0; c < m_columns; ++c)
+        {
+            cells[c] = Vector(m_min.x + (c + 0.5) * m_resolution, y, m_z);
+        }
+        std::fill(best.begin(), best.end(), -std::numeric_limits<double>::infinity());
+        for (std::size_t a = 0; a < m_aps.size(); ++a)
+        {
+            m_budget.CalcRxPower(m_txPower, m_aps[a], cells.data(), m_columns, rxPower.data());
+            for (uint32_t c = 0; c < m_columns; ++c)
+            {
+                if (rxPower[c] > best[c])
+                {
+                    best[c] = rxPower[c];
+                    serving[c] = a;
+                }
+            }
+        }
+
+        std::size_t offset = std::size_t(row) * m_columns;
+        for (uint32_t c = 0; c < m_columns; ++c)
+        {
+            double m = m_budget.GetFadingShape(CalculateDistance(m_aps[serving[c]], cells[c]));
+            m_rxPower[offset + c] = best[c];
+            m_outage[offset + c] =
+                LinkBudget::GetOutageProbability(best[c] - m_noise, m_minSnr, m);
+            m_ap[offset + c] = serving[c];
+        }
+    }
+}
+
+uint32_t
+CoverageMap::GetColumns() const
+{
+    return m_columns;
+}
+
+uint32_t
+CoverageMap::GetRows() const
+{
+    return m_rows;
+}
+
+double
+CoverageMap::GetValue(Quantity quantity, uint32_t column, uint32_t row) const
+{
+    NS_ABORT_MSG_UNLESS(column < m_columns && row < m_rows, "Cell out of the grid");
+    std::size_t i = std::size_t(row) * m_columns + column;
+    switch (quantity)
+    {
+    case RX_POWER:
+        return m_rxPower[i];
+    case SNR:
+        return m_rxPower[i] - m_noise;
+    case OUTAGE:
+        return m_outage[i];
+    case SERVING_AP:
+        return m_ap[i];
+    }
+    return 0.0;
+}
+
+double
+CoverageMap::GetCoverage() const
+{
+    if (m_outage.empty())
+    {
+        return 0.0;
+    }
+    double outage = 0.0;
+    for (float o : m_outage)
+    {
+        outage += o;
+    }
+    return 1.0 - outage / m_outage.size();
+}
+
+void
+CoverageMap::WriteRaster(Quantity quantity, const std::string& fileName) const
+{
+    NS_LOG_FUNCTION(this << quantity << fileName);
+    std::ofstream out(fileName);
+    NS_ABORT_MSG_UNLESS(out.is_open(), "Could not open " << fileName);
+    out << "ncols " << m_columns << "\nnrows " << m_rows << "\nxllcorner " << m_min.x
+        << "\nyllcorner " << m_min.y << "\ncellsize " << m_resolution
+        << "\nNODATA_value -9999\n";
+    for (uint32_t row = m_rows; row-- > 0;)
+    {
+        for (uint32_t c = 0; c < m_columns; ++c)
+        {
+            out << (c > 0 ? " " : "") << GetValue(quantity, c, row);
+        }
+        out << '\n';
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,145 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef COVERAGE_MAP_H
+#define COVERAGE_MAP_H
+
+#include "link-budget.h"
+
+#include "ns3/vector.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Received power, SNR and outage of the strongest AP over a grid of cells.
+ *
+ * Each cell is evaluated at its center, at a given receiver height. The grid is split
+ * into rows handed round-robin to worker threads; a row is one LinkBudget batch per AP,
+ * so the work is a few passes over contiguous arrays. With a Nakagami stage in the chain
+ * the outage is the probability that the faded SNR from the strongest AP falls under the
+ * minimum, otherwise it is 0 or 1. A chain LinkBudget cannot evaluate in closed form is
+ * run on one thread, through the models themselves.
+ *
+ * WriteRaster writes ESRI ASCII grids, which numpy.loadtxt(skiprows=6), GDAL, QGIS and
+ * gnuplot read directly.
+ */
+class CoverageMap
+{
+  public:
+    /// Quantities of a cell
+    enum Quantity
+    {
+        RX_POWER,  //!< mean received power from the strongest AP (dBm)
+        SNR,       //!< mean SNR from the strongest AP (dB)
+        OUTAGE,    //!< probability of an SNR under the minimum
+        SERVING_AP //!< index of the strongest AP
+    };
+
+    CoverageMap();
+
+    /**
+     * \param aps AP positions
+     */
+    void SetTransmitters(const std::vector<Vector>& aps);
+
+    /**
+     * \param model propagation loss from an AP to a receiver, with its chain
+     */
+    void SetLossModel(Ptr<PropagationLossModel> model);
+
+    /**
+     * \param txPower AP transmission power (dBm)
+     * \param bandwidth channel width (Hz)
+     * \param noiseFigure receiver noise figure (dB)
+     * \param minSnr SNR below which a receiver is in outage (dB)
+     */
+    void SetRadio(double txPower, double bandwidth, double noiseFigure, double minSnr);
+
+    /**
+     * \param threads worker threads, 0 for one per hardware thread
+     */
+    void SetThreads(uint32_t threads);
+
+    /**
+     * \brief Evaluate every cell of a grid covering a rectangle.
+     * \param min lower corner
+     * \param max upper corner
+     * \param resolution cell size (m)
+     * \param z receiver height
+     */
+    void Compute(Vector min, Vector max, double resolution, double z);
+
+    /**
+     * \return cells along x
+     */
+    uint32_t GetColumns() const;
+
+    /**
+     * \return cells along y
+     */
+    uint32_t GetRows() const;
+
+    /**
+     * \param quantity the quantity
+     * \param column cell index along x
+     * \param row cell index along y, from the lower corner
+     * \return its value in the cell
+     */
+    double GetValue(Quantity quantity, uint32_t column, uint32_t row) const;
+
+    /**
+     * \return the expected fraction of the area above the minimum SNR
+     */
+    double GetCoverage() const;
+
+    /**
+     * \brief Write a quantity as an ESRI ASCII grid, northernmost row first.
+     * \param quantity the quantity
+     * \param fileName output file
+     */
+    void WriteRaster(Quantity quantity, const std::string& fileName) const;
+
+  private:
+    /**
+     * \brief Evaluate rows first, first + step, ... of the grid.
+     * \param first first row
+     * \param step row stride, the number of workers
+     */
+    void ComputeRows(uint32_t first, uint32_t step);
+
+    std::vector<Vector> m_aps;    //!< AP positions
+    LinkBudget m_budget;          //!< propagation loss chain
+    double m_txPower;             //!< AP power (dBm)
+    double m_noise;               //!< noise power (dBm)
+    double m_minSnr;              //!< outage threshold (dB)
+    uint32_t m_threads;           //!< worker threads, 0 for the hardware count
+    Vector m_min;                 //!< lower corner of the grid
+    double m_resolution;          //!< cell size
+    double m_z;                   //!< receiver height
+    uint32_t m_columns;           //!< cells along x
+    uint32_t m_rows;              //!< cells along y
+    std::vector<float> m_rxPower; //!< row-major received power (dBm)
+    std::vector<float> m_outage;  //!< row-major outage probability
+    std::vector<uint16_t> m_ap;   //!< row-major strongest AP
+};
+
+} // namespace ns3
+
+#endif /* COVERAGE_MAP_H */
@@ -0,0 +1,196 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "energy-aware-rate-controller.h"
+
+#include "ns3/double.h"
+#include "ns3/energy-source-container.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("EnergyAwareRateController");
+
+NS_OBJECT_ENSURE_REGISTERED(EnergyAwareRateController);
+
+TypeId
+EnergyAwareRateController::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::EnergyAwareRateController")
+            .SetParent<Object>()
+            .AddConstructor<EnergyAwareRateController>()
+            .AddAttribute("CheckInterval",
+                          "Interval between two state of charge checks.",
+                          TimeValue(Seconds(1.0)),
+                          MakeTimeAccessor(&EnergyAwareRateController::m_interval),
+                          MakeTimeChecker())
+            .AddAttribute("HighThreshold",
+                          "State of charge above which the nominal rate is used.",
+                          DoubleValue(0.6),
+                          MakeDoubleAccessor(&EnergyAwareRateController::m_highThreshold),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("LowThreshold",
+                          "State of charge below which the rate is MinRateFraction.",
+                          DoubleValue(0.2),
+                          MakeDoubleAccessor(&EnergyAwareRateController::m_lowThreshold),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("MinRateFraction",
+                          "Fraction of the nominal rate kept at full throttling.",
+                          DoubleValue(0.1),
+                          MakeDoubleAccessor(&EnergyAwareRateController::m_minRateFraction),
+                          MakeDoubleChecker<double>(0.001, 1.0));
+    return tid;
+}
+
+EnergyAwareRateController::EnergyAwareRateController()
+    : m_rateFractionSum(0.0),
+      m_samples(0),
+      m_minEnergyFraction(1.0),
+      m_lastEnergyFraction(1.0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+EnergyAwareRateController::~EnergyAwareRateController()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+EnergyAwareRateController::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_checkEvent.Cancel();
+    m_entries.clear();
+    Object::DoDispose();
+}
+
+void
+EnergyAwareRateController::Install(const NodeContainer& nodes)
+{
+    NS_LOG_FUNCTION(this);
+    for (auto it = nodes.Begin(); it != nodes.End(); ++it)
+    {
+        Ptr<energy::EnergySourceContainer> sources =
+            (*it)->GetObject<energy::EnergySourceContainer>();
+        if (!sources || sources->GetN() == 0)
+        {
+            NS_LOG_WARN("Node " << (*it)->GetId() << " has no energy source, not controlled");
+            continue;
+        }
+        Entry entry;
+        entry.source = sources->Get(0);
+        entry.rateFraction = 1.0;
+        for (uint32_t i = 0; i < (*it)->GetNApplications(); ++i)
+        {
+            Ptr<OnOffApplication> app = DynamicCast<OnOffApplication>((*it)->GetApplication(i));
+            if (app)
+            {
+                DataRateValue rate;
+                app->GetAttribute("DataRate", rate);
+                entry.apps.push_back(app);
+                entry.nominal.push_back(rate.Get());
+            }
+        }
+        m_entries.push_back(entry);
+    }
+}
+
+void
+EnergyAwareRateController::Start(Time start)
+{
+    NS_LOG_FUNCTION(this << start);
+    m_checkEvent.Cancel();
+    m_checkEvent = Simulator::Schedule(start, &EnergyAwareRateController::Check, this);
+}
+
+double
+EnergyAwareRateController::GetMeanRateFraction() const
+{
+    return m_samples == 0 ? 1.0 : m_rateFractionSum / m_samples;
+}
+
+double
+EnergyAwareRateController::GetMinEnergyFraction() const
+{
+    return m_minEnergyFraction;
+}
+
+double
+EnergyAwareRateController::GetLastEnergyFraction() const
+{
+    return m_lastEnergyFraction;
+}
+
+double
+EnergyAwareRateController::GetRateFraction(double energyFraction) const
+{
+    if (energyFraction >= m_highThreshold)
+    {
+        return 1.0;
+    }
+    if (energyFraction <= m_lowThreshold)
+    {
+        return m_minRateFraction;
+    }
+    double w = (energyFraction - m_lowThreshold) / (m_highThreshold - m_lowThreshold);
+    return m_minRateFraction + w * (1.0 - m_minRateFraction);
+}
+
+void
+EnergyAwareRateController::Check()
+{
+    NS_LOG_FUNCTION(this);
+    double energySum = 0.0;
+    for (auto& entry : m_entries)
+    {
+        double energyFraction = entry.source->GetEnergyFraction();
+        energySum += energyFraction;
+        m_minEnergyFraction = std::min(m_minEnergyFraction, energyFraction);
+
+        double rateFraction = GetRateFraction(energyFraction);
+        m_rateFractionSum += rateFraction;
+        ++m_samples;
+
+        // Skip negligible changes so that OnOff does not recompute its schedule every check
+        if (std::abs(rateFraction - entry.rateFraction) < 0.01)
+        {
+            continue;
+        }
+        NS_LOG_INFO("Node " << entry.source->GetNode()->GetId() << " at " << energyFraction
+                            << " state of charge, rate fraction " << rateFraction);
+        entry.rateFraction = rateFraction;
+        for (size_t i = 0; i < entry.apps.size(); ++i)
+        {
+            auto bps = static_cast<uint64_t>(entry.nominal[i].GetBitRate() * rateFraction);
+            entry.apps[i]->SetAttribute(
+                "DataRate",
+                DataRateValue(DataRate(std::max<uint64_t>(bps, 1))));
+        }
+    }
+    if (!m_entries.empty())
+    {
+        m_lastEnergyFraction = energySum / m_entries.size();
+    }
+    m_checkEvent = Simulator::Schedule(m_interval, &EnergyAwareRateController::Check, this);
+}
+
+} // namespace ns3
@@ -0,0 +1,122 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ENERGY_AWARE_RATE_CONTROLLER_H
+#define ENERGY_AWARE_RATE_CONTROLLER_H
+
+#include "ns3/data-rate.h"
+#include "ns3/energy-source.h"
+#include "ns3/event-id.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/onoff-application.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Throttles the OnOff reporting rate of nodes when their stored energy is low.
+ *
+ * Every CheckInterval the state of charge of each node's first energy source is mapped to
+ * a rate fraction: 1 above HighThreshold, MinRateFraction below LowThreshold and linear in
+ * between. The DataRate of every OnOffApplication on the node is set to that fraction of
+ * the rate it had when the controller was installed.
+ *
+ * The controller also accumulates the time-averaged rate fraction and the lowest state of
+ * charge seen, which tell whether a nominal rate is sustainable: a sustainable rate is one
+ * that never needs throttling and never drains the storage.
+ */
+class EnergyAwareRateController : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    EnergyAwareRateController();
+    ~EnergyAwareRateController() override;
+
+    /**
+     * \brief Control the OnOff applications of the given nodes.
+     *
+     * Applications must already be installed and configured.
+     *
+     * \param nodes nodes with an energy source and OnOff applications
+     */
+    void Install(const NodeContainer& nodes);
+
+    /**
+     * \brief Start periodic checks.
+     * \param start time of the first check
+     */
+    void Start(Time start);
+
+    /**
+     * \return the rate fraction averaged over nodes and checks
+     */
+    double GetMeanRateFraction() const;
+
+    /**
+     * \return the lowest state of charge of any node at any check
+     */
+    double GetMinEnergyFraction() const;
+
+    /**
+     * \return the state of charge averaged over nodes at the last check
+     */
+    double GetLastEnergyFraction() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Controlled node
+    struct Entry
+    {
+        Ptr<energy::EnergySource> source;          //!< storage of the node
+        std::vector<Ptr<OnOffApplication>> apps;   //!< reporting applications
+        std::vector<DataRate> nominal;             //!< rates at install time
+        double rateFraction;                       //!< currently applied fraction
+    };
+
+    /**
+     * \param energyFraction state of charge in [0, 1]
+     * \return the rate fraction to apply
+     */
+    double GetRateFraction(double energyFraction) const;
+
+    /// Check every node and reschedule
+    void Check();
+
+    Time m_interval;            //!< check period
+    double m_highThreshold;     //!< no throttling above this state of charge
+    double m_lowThreshold;      //!< full throttling below this state of charge
+    double m_minRateFraction;   //!< rate fraction at full throttling
+    std::vector<Entry> m_entries; //!< controlled nodes
+    EventId m_checkEvent;       //!< next check
+    double m_rateFractionSum;   //!< sum of per node rate fractions over checks
+    uint64_t m_samples;         //!< number of terms in m_rateFractionSum
+    double m_minEnergyFraction; //!< lowest state of charge seen
+    double m_lastEnergyFraction; //!< mean state of charge at the last check
+};
+
+} // namespace ns3
+
+#endif /* ENERGY_AWARE_RATE_CONTROLLER_H */
@@ -0,0 +1,136 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "flood-attack.h"
+
+#include "ns3/abort.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FloodAttack");
+
+NS_OBJECT_ENSURE_REGISTERED(FloodAttack);
+
+TypeId
+FloodAttack::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::FloodAttack")
+            .SetParent<AttackApplication>()
+            .AddConstructor<FloodAttack>()
+            .AddAttribute("Protocol",
+                          "Socket factory of the flood (ns3::TcpSocketFactory or "
+                          "ns3::UdpSocketFactory).",
+                          TypeIdValue(UdpSocketFactory::GetTypeId()),
+                          MakeTypeIdAccessor(&FloodAttack::m_tid),
+                          MakeTypeIdChecker())
+            .AddAttribute("Remote",
+                          "Address of the flooded destination.",
+                          AddressValue(),
+                          MakeAddressAccessor(&FloodAttack::m_remote),
+                          MakeAddressChecker())
+            .AddAttribute("DataRate",
+                          "Flood rate at full intensity.",
+                          DataRateValue(DataRate("5Mbps")),
+                          MakeDataRateAccessor(&FloodAttack::m_rate),
+                          MakeDataRateChecker())
+            .AddAttribute("PacketSize",
+                          "Payload of each flood packet, in bytes.",
+                          UintegerValue(512),
+                          MakeUintegerAccessor(&FloodAttack::m_packetSize),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+FloodAttack::FloodAttack()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FloodAttack::~FloodAttack()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+FloodAttack::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_sendEvent.Cancel();
+    m_socket = nullptr;
+    AttackApplication::DoDispose();
+}
+
+AttackTag::Type
+FloodAttack::GetAttackType() const
+{
+    return AttackTag::FLOOD;
+}
+
+void
+FloodAttack::StartAttack()
+{
+    NS_LOG_FUNCTION(this);
+    m_socket = Socket::CreateSocket(GetNode(), m_tid);
+    int ret = InetSocketAddress::IsMatchingType(m_remote) ? m_socket->Bind() : m_socket->Bind6();
+    NS_ABORT_MSG_IF(ret == -1, "Failed to bind the flood socket");
+    m_socket->Connect(m_remote);
+    m_socket->SetAllowBroadcast(true);
+    m_socket->ShutdownRecv();
+    SendPacket();
+}
+
+void
+FloodAttack::StopAttack()
+{
+    NS_LOG_FUNCTION(this);
+    m_sendEvent.Cancel();
+    if (m_socket)
+    {
+        m_socket->Close();
+        m_socket = nullptr;
+    }
+}
+
+void
+FloodAttack::SendPacket()
+{
+    double intensity = GetIntensity();
+    if (intensity <= 0)
+    {
+        // Nothing to send yet, look again once the ramp has progressed
+        m_sendEvent = Simulator::Schedule(MilliSeconds(10), &FloodAttack::SendPacket, this);
+        return;
+    }
+
+    // With TCP the send buffer fills up; the flood then just moves on to the next slot
+    if (m_socket->GetTxAvailable() >= m_packetSize)
+    {
+        Ptr<Packet> packet = Create<Packet>(m_packetSize);
+        Label(packet);
+        m_socket->Send(packet);
+    }
+
+    Time interval = Seconds(m_packetSize * 8.0 / (m_rate.GetBitRate() * intensity));
+    m_sendEvent = Simulator::Schedule(interval, &FloodAttack::SendPacket, this);
+}
+
+} // namespace ns3
@@ -0,0 +1,69 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOOD_ATTACK_H
+#define FLOOD_ATTACK_H
+
+#include "attack-application.h"
+
+#include "ns3/address.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/socket.h"
+
+namespace ns3
+{
+
+/**
+ * \brief TCP or UDP flood towards a single destination.
+ *
+ * One socket is opened per start and packets of PacketSize bytes are paced at
+ * DataRate scaled by the current intensity. With TCP the flood is limited by the
+ * connection itself: slots in which the send buffer is full are skipped.
+ */
+class FloodAttack : public AttackApplication
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    FloodAttack();
+    ~FloodAttack() override;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    AttackTag::Type GetAttackType() const override;
+    void StartAttack() override;
+    void StopAttack() override;
+
+    /// Send one packet and schedule the next one
+    void SendPacket();
+
+    TypeId m_tid;          //!< socket factory
+    Address m_remote;      //!< flood destination
+    DataRate m_rate;       //!< nominal rate
+    uint32_t m_packetSize; //!< payload per packet
+    Ptr<Socket> m_socket;  //!< flood socket
+    EventId m_sendEvent;   //!< next packet
+};
+
+} // namespace ns3
+
+#endif /* FLOOD_ATTACK_H */
@@ -0,0 +1,230 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "flow-delay-monitor.h"
+
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/log.h"
+#include "ns3/onoff-application.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FlowDelayMonitor");
+
+NS_OBJECT_ENSURE_REGISTERED(FlowDelayMonitor);
+
+TypeId
+FlowDelayMonitor::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::FlowDelayMonitor")
+                            .SetParent<Object>()
+                            .AddConstructor<FlowDelayMonitor>();
+    return tid;
+}
+
+FlowDelayMonitor::FlowDelayMonitor()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FlowDelayMonitor::~FlowDelayMonitor()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+FlowDelayMonitor::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_flows.clear();
+    m_senderClasses.clear();
+    Object::DoDispose();
+}
+
+uint64_t
+FlowDelayMonitor::GetKey(const Address& address)
+{
+    if (!InetSocketAddress::IsMatchingType(address))
+    {
+        return 0;
+    }
+    InetSocketAddress inet = InetSocketAddress::ConvertFrom(address);
+    return (static_cast<uint64_t>(inet.GetIpv4().Get()) << 16) | inet.GetPort();
+}
+
+void
+FlowDelayMonitor::AddTrafficClass(const std::string& name, const ApplicationContainer& senders)
+{
+    NS_LOG_FUNCTION(this << name);
+    uint32_t index = m_classes.size();
+    m_classes.push_back({name, 0, LogHistogram(), 0});
+    for (auto it = senders.Begin(); it != senders.End(); ++it)
+    {
+        Ptr<OnOffApplication> app = DynamicCast<OnOffApplication>(*it);
+        NS_ABORT_MSG_UNLESS(app, "Traffic class " << name << " must be OnOff applications");
+        app->SetAttribute("EnableSeqTsSizeHeader", BooleanValue(true));
+        app->TraceConnectWithoutContext(
+            "TxWithAddresses",
+            MakeCallback(&FlowDelayMonitor::PacketSent, this).Bind(index));
+    }
+}
+
+void
+FlowDelayMonitor::AddSink(Ptr<PacketSink> sink)
+{
+    NS_LOG_FUNCTION(this << sink);
+    sink->SetAttribute("EnableSeqTsSizeHeader", BooleanValue(true));
+    sink->TraceConnectWithoutContext("RxWithSeqTsSize",
+                                     MakeCallback(&FlowDelayMonitor::PacketReceived, this));
+}
+
+void
+FlowDelayMonitor::PacketSent(uint32_t trafficClass,
+                             Ptr<const Packet> packet,
+                             const Address& from,
+                             const Address& to)
+{
+    ++m_classes[trafficClass].txPackets;
+    m_senderClasses.emplace(GetKey(from), trafficClass);
+}
+
+void
+FlowDelayMonitor::PacketReceived(Ptr<const Packet> packet,
+                                 const Address& from,
+                                 const Address& to,
+                                 const SeqTsSizeHeader& header)
+{
+    uint64_t key = GetKey(from);
+    int64_t transitNs = (Simulator::Now() - header.GetTs()).GetNanoSeconds();
+
+    auto flow = m_flows.find(key);
+    if (flow == m_flows.end())
+    {
+        auto senderClass = m_senderClasses.find(key);
+        int32_t trafficClass = senderClass == m_senderClasses.end() ? -1 : senderClass->second;
+        flow = m_flows.emplace(key, FlowRecord{from, trafficClass, LogHistogram(), transitNs, 0.0})
+                   .first;
+    }
+    FlowRecord& record = flow->second;
+
+    // RFC 3550: J += (|D(i-1,i)| - J) / 16, D being the change in transit time
+    double d = std::abs(static_cast<double>(transitNs - record.lastTransitNs));
+    record.jitterNs += (d - record.jitterNs) / 16.0;
+    record.lastTransitNs = transitNs;
+
+    record.delays.Record(static_cast<uint64_t>(transitNs));
+    if (record.trafficClass >= 0)
+    {
+        m_classes[record.trafficClass].delays.Record(static_cast<uint64_t>(transitNs));
+        m_classes[record.trafficClass].rxBytes += header.GetSize();
+    }
+}
+
+void
+FlowDelayMonitor::WriteFlowStats(std::ostream& os) const
+{
+    std::vector<uint64_t> keys;
+    keys.reserve(m_flows.size());
+    for (const auto& [key, flow] : m_flows)
+    {
+        keys.push_back(key);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    for (uint64_t key : keys)
+    {
+        const FlowRecord& flow = m_flows.at(key);
+        InetSocketAddress source = InetSocketAddress::ConvertFrom(flow.source);
+        os << source.GetIpv4() << ":" << source.GetPort() << "\t"
+           << (flow.trafficClass >= 0 ? m_classes[flow.trafficClass].name : "-") << "\t"
+           << flow.delays.GetCount() << "\t" << flow.delays.GetMean() / 1e6 << "\t"
+           << flow.delays.GetQuantile(0.5) / 1e6 << "\t" << flow.delays.GetQuantile(0.95) / 1e6
+           << "\t" << flow.delays.GetQuantile(0.99) / 1e6 << "\t" << flow.delays.GetMax() / 1e6
+           << "\t" << flow.jitterNs / 1e6 << std::endl;
+    }
+}
+
+void
+FlowDelayMonitor::WriteClassStats(std::ostream& os, const std::string& prefix) const
+{
+    for (uint32_t i = 0; i < m_classes.size(); ++i)
+    {
+        double jitterSum = 0.0;
+        uint32_t flows = 0;
+        for (const auto& [key, flow] : m_flows)
+        {
+            if (flow.trafficClass == static_cast<int32_t>(i))
+            {
+                jitterSum += flow.jitterNs;
+                ++flows;
+            }
+        }
+        const ClassRecord& c = m_classes[i];
+        os << prefix << c.name << "\t" << c.txPackets << "\t" << c.delays.GetCount() << "\t"
+           << c.delays.GetMean() / 1e6 << "\t" << c.delays.GetQuantile(0.5) / 1e6 << "\t"
+           << c.delays.GetQuantile(0.95) / 1e6 << "\t" << c.delays.GetQuantile(0.99) / 1e6
+           << "\t" << c.delays.GetMax() / 1e6 << "\t"
+           << (flows == 0 ? 0.0 : jitterSum / flows / 1e6) << "\t" << c.rxBytes << std::endl;
+    }
+}
+
+LogHistogram
+FlowDelayMonitor::GetTotalHistogram() const
+{
+    LogHistogram total;
+    for (const auto& [key, flow] : m_flows)
+    {
+        total.Merge(flow.delays);
+    }
+    return total;
+}
+
+LogHistogram
+FlowDelayMonitor::GetClassHistogram(const std::string& name) const
+{
+    for (const auto& c : m_classes)
+    {
+        if (c.name == name)
+        {
+            return c.delays;
+        }
+    }
+    NS_ABORT_MSG("Unknown traffic class " << name);
+    return LogHistogram();
+}
+
+uint64_t
+FlowDelayMonitor::GetClassRxBytes(const std::string& name) const
+{
+    for (const auto& c : m_classes)
+    {
+        if (c.name == name)
+        {
+            return c.rxBytes;
+        }
+    }
+    NS_ABORT_MSG("Unknown traffic class " << name);
+    return 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,178 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_DELAY_MONITOR_H
+#define FLOW_DELAY_MONITOR_H
+
+#include "log-histogram.h"
+
+#include "ns3/address.h"
+#include "ns3/application-container.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/packet-sink.h"
+#include "ns3/seq-ts-size-header.h"
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Online one-way delay and jitter statistics per flow and per traffic class.
+ *
+ * Senders and sinks are switched to EnableSeqTsSizeHeader, so every application packet
+ * carries its send timestamp in-band; PacketSink reassembles it from the TCP stream and
+ * reports it through RxWithSeqTsSize, which gives the true per-packet application delay
+ * (not the flow duration). Senders therefore need a PacketSize of at least 20 bytes.
+ *
+ * A flow is a sender socket (address and port). Each flow keeps a LogHistogram of its
+ * delays and the RFC 3550 interarrival jitter estimate, so memory per flow is constant
+ * whatever the number of packets. Each traffic class aggregates the flows of its senders
+ * into one more histogram.
+ */
+class FlowDelayMonitor : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    FlowDelayMonitor();
+    ~FlowDelayMonitor() override;
+
+    /**
+     * \brief Register the OnOff applications of a traffic class.
+     *
+     * Must be called before the applications start.
+     *
+     * \param name class name used in the output
+     * \param senders the OnOff applications of the class
+     */
+    void AddTrafficClass(const std::string& name, const ApplicationContainer& senders);
+
+    /**
+     * \brief Collect delays of the packets received by a sink.
+     *
+     * Must be called before the sink starts.
+     *
+     * \param sink the sink
+     */
+    void AddSink(Ptr<PacketSink> sink);
+
+    /**
+     * \brief Write one line per flow.
+     *
+     * Columns: source, class, received packets, mean, p50, p95, p99, max delay (ms) and
+     * jitter (ms).
+     *
+     * \param os output stream
+     */
+    void WriteFlowStats(std::ostream& os) const;
+
+    /**
+     * \brief Write one line per traffic class, each prefixed by the given text.
+     *
+     * Columns after the prefix: class, sent packets, received packets, mean, p50, p95, p99,
+     * max delay (ms), mean flow jitter (ms) and received bytes.
+     *
+     * \param os output stream
+     * \param prefix text (e.g. run parameters) written at the start of each line
+     */
+    void WriteClassStats(std::ostream& os, const std::string& prefix) const;
+
+    /**
+     * \return the delay histogram, in nanoseconds, of every received packet
+     */
+    LogHistogram GetTotalHistogram() const;
+
+    /**
+     * \param name class name given to AddTrafficClass
+     * \return the delay histogram, in nanoseconds, of the packets of the class
+     */
+    LogHistogram GetClassHistogram(const std::string& name) const;
+
+    /**
+     * \param name class name given to AddTrafficClass
+     * \return the application bytes of the class received by the sinks
+     */
+    uint64_t GetClassRxBytes(const std::string& name) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Delay statistics of one sender socket
+    struct FlowRecord
+    {
+        Address source;        //!< sender socket
+        int32_t trafficClass;  //!< index in m_classes, -1 if unknown
+        LogHistogram delays;   //!< delays in ns
+        int64_t lastTransitNs; //!< transit time of the previous packet
+        double jitterNs;       //!< RFC 3550 jitter estimate
+    };
+
+    /// Aggregate of one traffic class
+    struct ClassRecord
+    {
+        std::string name;     //!< class name
+        uint64_t txPackets;   //!< packets sent by the class
+        LogHistogram delays;  //!< delays in ns
+        uint64_t rxBytes;     //!< application bytes received
+    };
+
+    /**
+     * \param address an InetSocketAddress
+     * \return a key identifying the socket
+     */
+    static uint64_t GetKey(const Address& address);
+
+    /**
+     * OnOff TxWithAddresses trace.
+     * \param trafficClass class of the sender
+     * \param packet sent packet
+     * \param from local address of the sender
+     * \param to peer address
+     */
+    void PacketSent(uint32_t trafficClass,
+                    Ptr<const Packet> packet,
+                    const Address& from,
+                    const Address& to);
+
+    /**
+     * PacketSink RxWithSeqTsSize trace.
+     * \param packet received packet
+     * \param from sender address
+     * \param to local address
+     * \param header the in-band header of the packet
+     */
+    void PacketReceived(Ptr<const Packet> packet,
+                        const Address& from,
+                        const Address& to,
+                        const SeqTsSizeHeader& header);
+
+    std::vector<ClassRecord> m_classes;                     //!< traffic classes
+    std::unordered_map<uint64_t, uint32_t> m_senderClasses; //!< sender socket to class
+    std::unordered_map<uint64_t, FlowRecord> m_flows;       //!< flows by sender socket
+};
+
+} // namespace ns3
+
+#endif /* FLOW_DELAY_MONITOR_H */
@@ -0,0 +1,146 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "flow-stats-file.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FlowStatsFile");
+
+const char FlowStatsFile::MAGIC[8] = {'N', 'S', '3', 'F', 'L', 'O', 'W', 'S'};
+const uint32_t FlowStatsFile::VERSION = 1;
+
+namespace
+{
+
+/// Write one field in host byte order
+template <typename T>
+void
+Put(std::ostream& out, T value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/// Read one field in host byte order
+template <typename T>
+void
+Get(std::istream& in, T& value)
+{
+    in.read(reinterpret_cast<char*>(&value), sizeof(value));
+}
+
+} // namespace
+
+void
+FlowStatsFile::Write(Ptr<FlowMonitor> monitor,
+                     Ptr<Ipv4FlowClassifier> classifier,
+                     const std::string& fileName)
+{
+    NS_LOG_FUNCTION(monitor << classifier << fileName);
+    std::ofstream out(fileName, std::ios::binary);
+    NS_ABORT_MSG_UNLESS(out.is_open(), "Could not open " << fileName);
+
+    const FlowMonitor::FlowStatsContainer& stats = monitor->GetFlowStats();
+    out.write(MAGIC, sizeof(MAGIC));
+    Put(out, VERSION);
+    Put(out, static_cast<uint32_t>(stats.size()));
+
+    for (const auto& [flowId, flow] : stats)
+    {
+        Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(flowId);
+        Put(out, static_cast<uint32_t>(flowId));
+        Put(out, t.sourceAddress.Get());
+        Put(out, t.destinationAddress.Get());
+        Put(out, t.sourcePort);
+        Put(out, t.destinationPort);
+        Put(out, t.protocol);
+        Put(out, flow.timeFirstTxPacket.GetNanoSeconds());
+        Put(out, flow.timeLastTxPacket.GetNanoSeconds());
+        Put(out, flow.timeFirstRxPacket.GetNanoSeconds());
+        Put(out, flow.timeLastRxPacket.GetNanoSeconds());
+        Put(out, flow.delaySum.GetNanoSeconds());
+        Put(out, flow.jitterSum.GetNanoSeconds());
+        Put(out, flow.lastDelay.GetNanoSeconds());
+        Put(out, flow.txBytes);
+        Put(out, flow.rxBytes);
+        Put(out, flow.txPackets);
+        Put(out, flow.rxPackets);
+        Put(out, flow.lostPackets);
+        Put(out, flow.timesForwarded);
+    }
+    NS_ABORT_MSG_UNLESS(out.good(), "Error while writing " << fileName);
+}
+
+bool
+FlowStatsFile::IsFlowStatsFile(std::istream& in)
+{
+    char magic[sizeof(MAGIC)];
+    std::streampos start = in.tellg();
+    in.read(magic, sizeof(magic));
+    bool match = in.gcount() == sizeof(magic) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+    in.clear();
+    in.seekg(start);
+    return match;
+}
+
+uint32_t
+FlowStatsFile::ReadHeader(std::istream& in)
+{
+    char magic[sizeof(MAGIC)];
+    in.read(magic, sizeof(magic));
+    NS_ABORT_MSG_UNLESS(in.good() && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0,
+                        "Not a binary flow statistics file");
+    uint32_t version;
+    uint32_t count;
+    Get(in, version);
+    Get(in, count);
+    NS_ABORT_MSG_UNLESS(in.good() && version == VERSION,
+                        "Unsupported flow statistics file version " << version);
+    return count;
+}
+
+bool
+FlowStatsFile::ReadRecord(std::istream& in, Record& record)
+{
+    Get(in, record.flowId);
+    Get(in, record.sourceAddress);
+    Get(in, record.destinationAddress);
+    Get(in, record.sourcePort);
+    Get(in, record.destinationPort);
+    Get(in, record.protocol);
+    Get(in, record.timeFirstTxPacket);
+    Get(in, record.timeLastTxPacket);
+    Get(in, record.timeFirstRxPacket);
+    Get(in, record.timeLastRxPacket);
+    Get(in, record.delaySum);
+    Get(in, record.jitterSum);
+    Get(in, record.lastDelay);
+    Get(in, record.txBytes);
+    Get(in, record.rxBytes);
+    Get(in, record.txPackets);
+    Get(in, record.rxPackets);
+    Get(in, record.lostPackets);
+    Get(in, record.timesForwarded);
+    return static_cast<bool>(in);
+}
+
+} // namespace ns3
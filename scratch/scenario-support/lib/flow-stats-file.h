@@ -0,0 +1,108 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_STATS_FILE_H
+#define FLOW_STATS_FILE_H
+
+#include "ns3/flow-monitor.h"
+#include "ns3/ipv4-flow-classifier.h"
+
+#include <cstdint>
+#include <istream>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \brief Compact binary dump of FlowMonitor statistics.
+ *
+ * The file is an 8-byte magic, a uint32 version and a uint32 record count, followed by
+ * one fixed-size record per flow that carries both the FlowStats counters and the
+ * IPv4 five-tuple of the flow, so a reader needs no join and no text parsing. Values are
+ * written in host byte order; times are in nanoseconds.
+ */
+class FlowStatsFile
+{
+  public:
+    /// One flow: classifier tuple and FlowStats counters
+    struct Record
+    {
+        uint32_t flowId;          //!< FlowMonitor flow identifier
+        uint32_t sourceAddress;   //!< IPv4 source address, host order
+        uint32_t destinationAddress; //!< IPv4 destination address, host order
+        uint16_t sourcePort;      //!< transport source port
+        uint16_t destinationPort; //!< transport destination port
+        uint8_t protocol;         //!< IP protocol number
+        int64_t timeFirstTxPacket; //!< ns
+        int64_t timeLastTxPacket; //!< ns
+        int64_t timeFirstRxPacket; //!< ns
+        int64_t timeLastRxPacket; //!< ns
+        int64_t delaySum;         //!< ns
+        int64_t jitterSum;        //!< ns
+        int64_t lastDelay;        //!< ns
+        uint64_t txBytes;         //!< transmitted bytes
+        uint64_t rxBytes;         //!< received bytes
+        uint32_t txPackets;       //!< transmitted packets
+        uint32_t rxPackets;       //!< received packets
+        uint32_t lostPackets;     //!< packets considered lost
+        uint32_t timesForwarded;  //!< number of forwarding events
+    };
+
+    static const char MAGIC[8];    //!< file signature
+    static const uint32_t VERSION; //!< format version
+
+    /**
+     * \brief Dump the statistics of every IPv4 flow of a monitor.
+     *
+     * Call FlowMonitor::CheckForLostPackets first, as for SerializeToXmlFile.
+     *
+     * \param monitor the flow monitor
+     * \param classifier the IPv4 classifier of the same helper
+     * \param fileName output file
+     */
+    static void Write(Ptr<FlowMonitor> monitor,
+                      Ptr<Ipv4FlowClassifier> classifier,
+                      const std::string& fileName);
+
+    /**
+     * \brief Check whether a stream starts with the binary signature.
+     *
+     * The stream position is left unchanged.
+     *
+     * \param in input stream
+     * \return true if the stream holds a binary flow statistics file
+     */
+    static bool IsFlowStatsFile(std::istream& in);
+
+    /**
+     * \brief Read the file header.
+     * \param in input stream positioned at the start of the file
+     * \return the number of records that follow
+     */
+    static uint32_t ReadHeader(std::istream& in);
+
+    /**
+     * \brief Read the next record.
+     * \param in input stream positioned after the header or a previous record
+     * \param record filled with the record
+     * \return false at end of file
+     */
+    static bool ReadRecord(std::istream& in, Record& record);
+};
+
+} // namespace ns3
+
+#endif /* FLOW_STATS_FILE_H */
@@ -0,0 +1,241 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "hop-delay-monitor.h"
+
+#include "ns3/abort.h"
+#include "ns3/ipv4.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/tag.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("HopDelayMonitor");
+
+NS_OBJECT_ENSURE_REGISTERED(HopDelayMonitor);
+
+/**
+ * \brief Time at which a packet left its sender.
+ */
+class HopSendTimeTag : public Tag
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::HopSendTimeTag")
+                                .SetParent<Tag>()
+                                .AddConstructor<HopSendTimeTag>();
+        return tid;
+    }
+
+    TypeId GetInstanceTypeId() const override
+    {
+        return GetTypeId();
+    }
+
+    uint32_t GetSerializedSize() const override
+    {
+        return 9;
+    }
+
+    void Serialize(TagBuffer i) const override
+    {
+        i.WriteU64(timestamp.GetTimeStep());
+        i.WriteU8(uplink);
+    }
+
+    void Deserialize(TagBuffer i) override
+    {
+        timestamp = TimeStep(i.ReadU64());
+        uplink = i.ReadU8();
+    }
+
+    void Print(std::ostream& os) const override
+    {
+        os << "t=" << timestamp << " uplink=" << uplink;
+    }
+
+    Time timestamp; //!< the time
+    bool uplink{false}; //!< direction, for the gateway tag
+};
+
+/**
+ * \brief Time at which the gateway forwarded a packet, and in which direction.
+ */
+class HopGatewayTimeTag : public HopSendTimeTag
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::HopGatewayTimeTag")
+                                .SetParent<Tag>()
+                                .AddConstructor<HopGatewayTimeTag>();
+        return tid;
+    }
+
+    TypeId GetInstanceTypeId() const override
+    {
+        return GetTypeId();
+    }
+};
+
+NS_OBJECT_ENSURE_REGISTERED(HopSendTimeTag);
+NS_OBJECT_ENSURE_REGISTERED(HopGatewayTimeTag);
+
+TypeId
+HopDelayMonitor::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::HopDelayMonitor")
+                            .SetParent<Object>()
+                            .AddConstructor<HopDelayMonitor>();
+    return tid;
+}
+
+HopDelayMonitor::HopDelayMonitor()
+    : m_wirelessInterface(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+HopDelayMonitor::~HopDelayMonitor()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+HopDelayMonitor::Install(Ptr<NetDevice> wirelessDevice, const NodeContainer& nodes)
+{
+    NS_LOG_FUNCTION(this << wirelessDevice << nodes.GetN());
+    Ptr<Node> gateway = wirelessDevice->GetNode();
+    Ptr<Ipv4> ipv4 = gateway->GetObject<Ipv4>();
+    NS_ABORT_MSG_UNLESS(ipv4, "The gateway has no Internet stack");
+    int32_t interface = ipv4->GetInterfaceForDevice(wirelessDevice);
+    NS_ABORT_MSG_IF(interface < 0, "The wireless device of the gateway has no IPv4 interface");
+    m_wirelessInterface = interface;
+    ipv4->TraceConnectWithoutContext("UnicastForward",
+                                     MakeCallback(&HopDelayMonitor::PacketForwarded, this));
+
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        Ptr<Ipv4> nodeIpv4 = nodes.Get(i)->GetObject<Ipv4>();
+        if (!nodeIpv4 || nodes.Get(i) == gateway)
+        {
+            continue;
+        }
+        nodeIpv4->TraceConnectWithoutContext("SendOutgoing",
+                                             MakeCallback(&HopDelayMonitor::PacketSent, this));
+        nodeIpv4->TraceConnectWithoutContext(
+            "LocalDeliver",
+            MakeCallback(&HopDelayMonitor::PacketDelivered, this));
+    }
+}
+
+std::string
+HopDelayMonitor::GetHopName(Hop hop)
+{
+    switch (hop)
+    {
+    case UPLINK_WIRELESS:
+        return "uplink-wireless";
+    case UPLINK_BACKHAUL:
+        return "uplink-backhaul";
+    case DOWNLINK_BACKHAUL:
+        return "downlink-backhaul";
+    default:
+        return "downlink-wireless";
+    }
+}
+
+const LogHistogram&
+HopDelayMonitor::GetHistogram(Hop hop) const
+{
+    NS_ABORT_MSG_UNLESS(hop < HOP_COUNT, "Unknown hop " << hop);
+    return m_delays[hop];
+}
+
+void
+HopDelayMonitor::WriteStats(std::ostream& os, const std::string& prefix) const
+{
+    for (uint32_t h = 0; h < HOP_COUNT; ++h)
+    {
+        const LogHistogram& d = m_delays[h];
+        os << prefix << GetHopName(static_cast<Hop>(h)) << "\t" << d.GetCount() << "\t"
+           << d.GetMean() / 1e6 << "\t" << d.GetQuantile(0.5) / 1e6 << "\t"
+           << d.GetQuantile(0.95) / 1e6 << "\t" << d.GetQuantile(0.99) / 1e6 << "\t"
+           << d.GetMax() / 1e6 << std::endl;
+    }
+}
+
+void
+HopDelayMonitor::PacketSent(const Ipv4Header& header,
+                            Ptr<const Packet> packet,
+                            uint32_t interface)
+{
+    HopSendTimeTag tag;
+    if (!packet->PeekPacketTag(tag))
+    {
+        tag.timestamp = Simulator::Now();
+        packet->AddPacketTag(tag);
+    }
+}
+
+void
+HopDelayMonitor::PacketForwarded(const Ipv4Header& header,
+                                 Ptr<const Packet> packet,
+                                 uint32_t interface)
+{
+    HopSendTimeTag sent;
+    HopGatewayTimeTag tag;
+    if (packet->PeekPacketTag(sent) && !packet->PeekPacketTag(tag))
+    {
+        tag.timestamp = Simulator::Now();
+        tag.uplink = interface != m_wirelessInterface;
+        packet->AddPacketTag(tag);
+    }
+}
+
+void
+HopDelayMonitor::PacketDelivered(const Ipv4Header& header,
+                                 Ptr<const Packet> packet,
+                                 uint32_t interface)
+{
+    HopSendTimeTag sent;
+    HopGatewayTimeTag gateway;
+    if (!packet->PeekPacketTag(sent) || !packet->PeekPacketTag(gateway))
+    {
+        return;
+    }
+    int64_t first = (gateway.timestamp - sent.timestamp).GetNanoSeconds();
+    int64_t second = (Simulator::Now() - gateway.timestamp).GetNanoSeconds();
+    m_delays[gateway.uplink ? UPLINK_WIRELESS : DOWNLINK_BACKHAUL].Record(
+        std::max<int64_t>(first, 0));
+    m_delays[gateway.uplink ? UPLINK_BACKHAUL : DOWNLINK_WIRELESS].Record(
+        std::max<int64_t>(second, 0));
+}
+
+} // namespace ns3
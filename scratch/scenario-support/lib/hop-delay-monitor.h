@@ -0,0 +1,130 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef HOP_DELAY_MONITOR_H
+#define HOP_DELAY_MONITOR_H
+
+#include "log-histogram.h"
+
+#include "ns3/ipv4-header.h"
+#include "ns3/net-device.h"
+#include "ns3/node-container.h"
+#include "ns3/object.h"
+#include "ns3/packet.h"
+
+#include <array>
+#include <ostream>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \brief IP latency of the wireless hop and of the backhaul hop, split at the gateway.
+ *
+ * Every IP packet sent by the monitored nodes is tagged with its send time, and the
+ * gateway tags the packets it forwards with the forwarding time and direction. When such
+ * a packet is delivered, the two segments of its path go into the histogram of their
+ * hop: uplink packets (wireless to wired, e.g. data to a server) cross the wireless hop
+ * first, downlink packets (e.g. TCP ACKs) the backhaul first. The wireless hop includes
+ * the MAC queueing, contention and retransmissions of the access network and any
+ * wireless relay; the backhaul hop the gateway queue disc and the wired links.
+ *
+ * Unlike FlowDelayMonitor, these are per-packet IP delays of every protocol, not
+ * application delays; packets not crossing the gateway are ignored.
+ */
+class HopDelayMonitor : public Object
+{
+  public:
+    /// Path segment of a packet
+    enum Hop
+    {
+        UPLINK_WIRELESS,   //!< sender to gateway, towards the backhaul
+        UPLINK_BACKHAUL,   //!< gateway to the wired receiver
+        DOWNLINK_BACKHAUL, //!< wired sender to gateway
+        DOWNLINK_WIRELESS, //!< gateway to the wireless receiver
+        HOP_COUNT          //!< number of segments
+    };
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    HopDelayMonitor();
+    ~HopDelayMonitor() override;
+
+    /**
+     * \brief Start monitoring.
+     * \param wirelessDevice the wireless device of the gateway, e.g. the AP device
+     * \param nodes nodes sending and receiving the packets, gateway included or not
+     */
+    void Install(Ptr<NetDevice> wirelessDevice, const NodeContainer& nodes);
+
+    /**
+     * \param hop a segment
+     * \return its name, e.g. "uplink-wireless"
+     */
+    static std::string GetHopName(Hop hop);
+
+    /**
+     * \param hop a segment
+     * \return the delay histogram of the segment, in nanoseconds
+     */
+    const LogHistogram& GetHistogram(Hop hop) const;
+
+    /**
+     * \brief Write one line per segment, each prefixed by the given text.
+     *
+     * Columns after the prefix: segment, packets, mean, p50, p95, p99 and max delay (ms).
+     *
+     * \param os output stream
+     * \param prefix text (e.g. run parameters) written at the start of each line
+     */
+    void WriteStats(std::ostream& os, const std::string& prefix) const;
+
+  private:
+    /**
+     * Ipv4L3Protocol SendOutgoing trace of the monitored nodes.
+     * \param header IP header
+     * \param packet IP payload
+     * \param interface output interface
+     */
+    void PacketSent(const Ipv4Header& header, Ptr<const Packet> packet, uint32_t interface);
+
+    /**
+     * Ipv4L3Protocol UnicastForward trace of the gateway.
+     * \param header IP header
+     * \param packet IP payload
+     * \param interface output interface
+     */
+    void PacketForwarded(const Ipv4Header& header, Ptr<const Packet> packet, uint32_t interface);
+
+    /**
+     * Ipv4L3Protocol LocalDeliver trace of the monitored nodes.
+     * \param header IP header
+     * \param packet IP payload
+     * \param interface input interface
+     */
+    void PacketDelivered(const Ipv4Header& header, Ptr<const Packet> packet, uint32_t interface);
+
+    uint32_t m_wirelessInterface;                  //!< gateway interface of the wireless side
+    std::array<LogHistogram, HOP_COUNT> m_delays; //!< delays in ns per segment
+};
+
+} // namespace ns3
+
+#endif /* HOP_DELAY_MONITOR_H */
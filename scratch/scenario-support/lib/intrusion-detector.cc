@@ -0,0 +1,380 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "intrusion-detector.h"
+
+#include "attack-application.h"
+#include "ipv4-input-filter.h"
+
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("IntrusionDetector");
+
+NS_OBJECT_ENSURE_REGISTERED(IntrusionDetector);
+
+TypeId
+IntrusionDetector::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::IntrusionDetector")
+            .SetParent<Application>()
+            .AddConstructor<IntrusionDetector>()
+            .AddAttribute("Window",
+                          "Counting window; the sketches are reset at the end of each.",
+                          TimeValue(Seconds(0.5)),
+                          MakeTimeAccessor(&IntrusionDetector::m_window),
+                          MakeTimeChecker(MilliSeconds(1)))
+            .AddAttribute("PacketRateThreshold",
+                          "Packet rate (pkt/s) of a source that raises an alert, 0 to disable.",
+                          DoubleValue(1000.0),
+                          MakeDoubleAccessor(&IntrusionDetector::m_packetRateThreshold),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("BitRateThreshold",
+                          "Bit rate of a source that raises an alert, 0 to disable.",
+                          DataRateValue(DataRate("1Mbps")),
+                          MakeDataRateAccessor(&IntrusionDetector::m_bitRateThreshold),
+                          MakeDataRateChecker())
+            .AddAttribute("Width",
+                          "Counters per sketch row.",
+                          UintegerValue(512),
+                          MakeUintegerAccessor(&IntrusionDetector::m_width),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Depth",
+                          "Rows (hash functions) per sketch.",
+                          UintegerValue(4),
+                          MakeUintegerAccessor(&IntrusionDetector::m_depth),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("HeavyHitters",
+                          "Sources tracked as heavy hitters, and rate-limited at most at once.",
+                          UintegerValue(16),
+                          MakeUintegerAccessor(&IntrusionDetector::m_heavyHitters),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Mitigate",
+                          "Rate-limit the alerted sources.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&IntrusionDetector::m_mitigate),
+                          MakeBooleanChecker())
+            .AddAttribute("LimitRate",
+                          "Packet rate (pkt/s) let through from a limited source, 0 to block it.",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&IntrusionDetector::m_limitRate),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("BlockTime",
+                          "Duration of the limitation after the last alert of a source.",
+                          TimeValue(Seconds(5.0)),
+                          MakeTimeAccessor(&IntrusionDetector::m_blockTime),
+                          MakeTimeChecker())
+            .AddTraceSource("Alert",
+                            "A source crossed a rate threshold.",
+                            MakeTraceSourceAccessor(&IntrusionDetector::m_alertTrace),
+                            "ns3::IntrusionDetector::AlertTracedCallback");
+    return tid;
+}
+
+IntrusionDetector::IntrusionDetector()
+    : m_filterInstalled(false),
+      m_nPackets(0),
+      m_nAlerts(0),
+      m_nTruePositives(0),
+      m_nDropped(0),
+      m_nDroppedAttack(0),
+      m_firstAttack(Seconds(-1.0)),
+      m_detection(Seconds(-1.0)),
+      m_processingNs(0.0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+IntrusionDetector::~IntrusionDetector()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+IntrusionDetector::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_windowEvent.Cancel();
+    if (m_log.is_open())
+    {
+        m_log.close();
+    }
+    m_limited.clear();
+    Application::DoDispose();
+}
+
+void
+IntrusionDetector::EnableAlertLog(const std::string& fileName)
+{
+    NS_LOG_FUNCTION(this << fileName);
+    m_log.open(fileName);
+    NS_ABORT_MSG_UNLESS(m_log.is_open(), "Could not open " << fileName);
+    m_log << "# time\tsource\tpktRate\tbitRate\tmeanSize\tattack" << std::endl;
+}
+
+void
+IntrusionDetector::StartApplication()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_packets)
+    {
+        // Attributes are only known now; the node id keeps the hashes of several
+        // detectors independent and the runs reproducible
+        uint64_t seed = GetNode()->GetId() + 1;
+        m_packets = std::make_unique<CountMinSketch>(m_width, m_depth, m_heavyHitters, seed);
+        m_bytes = std::make_unique<CountMinSketch>(m_width, m_depth, 0, seed);
+    }
+    Ptr<Ipv4L3Protocol> ipv4 = GetNode()->GetObject<Ipv4L3Protocol>();
+    NS_ABORT_MSG_UNLESS(ipv4, "IntrusionDetector needs a node with an IPv4 stack");
+    ipv4->TraceConnectWithoutContext("Rx", MakeCallback(&IntrusionDetector::Ingest, this));
+    if (m_mitigate && !m_filterInstalled)
+    {
+        Ipv4InputFilter::Install(GetNode())->AddFilter(
+            MakeCallback(&IntrusionDetector::Limit, this));
+        m_filterInstalled = true;
+    }
+    NewWindow();
+}
+
+void
+IntrusionDetector::StopApplication()
+{
+    NS_LOG_FUNCTION(this);
+    m_windowEvent.Cancel();
+    Ptr<Ipv4L3Protocol> ipv4 = GetNode()->GetObject<Ipv4L3Protocol>();
+    ipv4->TraceDisconnectWithoutContext("Rx", MakeCallback(&IntrusionDetector::Ingest, this));
+    m_limited.clear();
+}
+
+void
+IntrusionDetector::NewWindow()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_packets->GetTotal() > 0)
+    {
+        auto top = m_packets->GetHeavyHitters().front();
+        NS_LOG_DEBUG("Window of " << m_packets->GetTotal() << " packets, top source "
+                                  << Ipv4Address(static_cast<uint32_t>(top.first)) << " with "
+                                  << top.second);
+    }
+    m_packets->Reset();
+    m_bytes->Reset();
+    m_alerted.clear();
+    m_windowEvent = Simulator::Schedule(m_window, &IntrusionDetector::NewWindow, this);
+}
+
+void
+IntrusionDetector::Ingest(Ptr<const Packet> packet, Ptr<Ipv4> /* ipv4 */, uint32_t interface)
+{
+    // Interface 0 is the loopback
+    if (interface == 0)
+    {
+        return;
+    }
+    Ipv4Header header;
+    if (packet->PeekHeader(header) == 0)
+    {
+        return;
+    }
+    // The label is ground truth for scoring only, so it stays out of the measured path
+    bool attack = AttackTag::IsAttack(packet);
+    if (attack && m_firstAttack.IsNegative())
+    {
+        m_firstAttack = Simulator::Now();
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    Inspect(header.GetSource(), packet->GetSize(), attack);
+    m_processingNs += std::chrono::duration<double, std::nano>(
+                          std::chrono::steady_clock::now() - begin)
+                          .count();
+}
+
+void
+IntrusionDetector::Inspect(Ipv4Address source, uint32_t size, bool attack)
+{
+    m_nPackets++;
+    uint32_t key = source.Get();
+    uint64_t packets = m_packets->Add(key);
+    uint64_t bytes = m_bytes->Add(key, size);
+
+    double window = m_window.GetSeconds();
+    bool overPackets = m_packetRateThreshold > 0 && packets >= m_packetRateThreshold * window;
+    bool overBits = m_bitRateThreshold.GetBitRate() > 0 &&
+                    bytes * 8.0 >= m_bitRateThreshold.GetBitRate() * window;
+    if (!(overPackets || overBits) || !m_alerted.insert(key).second)
+    {
+        return;
+    }
+
+    Time now = Simulator::Now();
+    double packetRate = packets / window;
+    double bitRate = bytes * 8.0 / window;
+    m_nAlerts++;
+    if (attack)
+    {
+        m_nTruePositives++;
+        if (m_detection.IsNegative())
+        {
+            m_detection = now;
+        }
+    }
+    NS_LOG_INFO("Alert at " << now.As(Time::S) << ": " << source << " at " << packetRate
+                            << " pkt/s, " << bitRate << " bit/s");
+    if (m_log.is_open())
+    {
+        m_log << now.GetSeconds() << "\t" << source << "\t" << packetRate << "\t" << bitRate
+              << "\t" << static_cast<double>(bytes) / packets << "\t" << attack << std::endl;
+    }
+    m_alertTrace(source, packetRate, bitRate);
+
+    if (m_mitigate)
+    {
+        auto it = m_limited.find(key);
+        if (it != m_limited.end())
+        {
+            it->second.until = now + m_blockTime;
+            return;
+        }
+        if (m_limited.size() >= m_heavyHitters)
+        {
+            // Make room by releasing the source whose limitation ends first
+            m_limited.erase(std::min_element(m_limited.begin(),
+                                             m_limited.end(),
+                                             [](const auto& a, const auto& b) {
+                                                 return a.second.until < b.second.until;
+                                             }));
+        }
+        m_limited[key] = {now + m_blockTime, now, 0.0};
+    }
+}
+
+bool
+IntrusionDetector::Limit(Ptr<const Packet> packet,
+                         const Ipv4Header& header,
+                         bool /* inTransit */)
+{
+    auto it = m_limited.find(header.GetSource().Get());
+    if (it == m_limited.end())
+    {
+        return false;
+    }
+    Limiter& limiter = it->second;
+    Time now = Simulator::Now();
+    if (now >= limiter.until)
+    {
+        m_limited.erase(it);
+        return false;
+    }
+    // Bursts are capped at one window worth of the allowed rate
+    limiter.tokens = std::min(limiter.tokens + m_limitRate * (now - limiter.last).GetSeconds(),
+                              std::max(1.0, m_limitRate * m_window.GetSeconds()));
+    limiter.last = now;
+    if (limiter.tokens >= 1.0)
+    {
+        limiter.tokens -= 1.0;
+        return false;
+    }
+    m_nDropped++;
+    if (AttackTag::IsAttack(packet))
+    {
+        m_nDroppedAttack++;
+    }
+    return true;
+}
+
+uint64_t
+IntrusionDetector::GetNPackets() const
+{
+    return m_nPackets;
+}
+
+uint32_t
+IntrusionDetector::GetNAlerts() const
+{
+    return m_nAlerts;
+}
+
+uint32_t
+IntrusionDetector::GetNTruePositives() const
+{
+    return m_nTruePositives;
+}
+
+uint32_t
+IntrusionDetector::GetNFalsePositives() const
+{
+    return m_nAlerts - m_nTruePositives;
+}
+
+Time
+IntrusionDetector::GetFirstAttackTime() const
+{
+    return m_firstAttack;
+}
+
+Time
+IntrusionDetector::GetDetectionTime() const
+{
+    return m_detection;
+}
+
+Time
+IntrusionDetector::GetDetectionLatency() const
+{
+    if (m_detection.IsNegative())
+    {
+        return Seconds(-1.0);
+    }
+    return m_detection - m_firstAttack;
+}
+
+uint64_t
+IntrusionDetector::GetNDropped() const
+{
+    return m_nDropped;
+}
+
+uint64_t
+IntrusionDetector::GetNDroppedAttack() const
+{
+    return m_nDroppedAttack;
+}
+
+double
+IntrusionDetector::GetMeanProcessingTime() const
+{
+    return m_nPackets == 0 ? 0.0 : m_processingNs / m_nPackets;
+}
+
+size_t
+IntrusionDetector::GetMemoryUsage() const
+{
+    return m_packets ? m_packets->GetMemoryUsage() + m_bytes->GetMemoryUsage() : 0;
+}
+
+} // namespace ns3
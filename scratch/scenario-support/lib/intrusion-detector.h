@@ -0,0 +1,219 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef INTRUSION_DETECTOR_H
+#define INTRUSION_DETECTOR_H
+
+#include "count-min-sketch.h"
+
+#include "ns3/application.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+namespace ns3
+{
+
+/**
+ * \brief Online per-source rate detector for an access point or sink.
+ *
+ * Every IPv4 packet the node receives (Ipv4L3Protocol Rx trace) is counted per source
+ * address in two count-min sketches, one for packets and one for bytes, which are reset
+ * every Window. Memory is fixed by Width, Depth and HeavyHitters whatever the number of
+ * sources. A source whose count in the current window reaches PacketRateThreshold or
+ * BitRateThreshold (times Window) raises an alert, at most once per window, through the
+ * Alert trace and the optional alert log. Floods from spoofed, ever-changing sources
+ * (SynFloodAttack with SpoofSource) stay below per-source thresholds by design.
+ *
+ * With Mitigate, an alerted source is rate-limited to LimitRate packets/s (0 blocks it)
+ * for BlockTime after its last alert, through the node's Ipv4InputFilter. At most
+ * HeavyHitters sources are limited at once.
+ *
+ * The detector only sees addresses and sizes; the AttackTag ground truth is read on the
+ * side to score alerts as true or false positives and to time the detection. The wall
+ * clock time spent in the per-packet path is measured as well.
+ */
+class IntrusionDetector : public Application
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    IntrusionDetector();
+    ~IntrusionDetector() override;
+
+    /**
+     * \brief Write one line per alert to the given file.
+     *
+     * Columns: time, source, packet rate (pkt/s), bit rate (bit/s), mean packet size
+     * (bytes), and whether the packet that raised the alert was an attack packet.
+     *
+     * \param fileName the alert log
+     */
+    void EnableAlertLog(const std::string& fileName);
+
+    /**
+     * \return the number of packets inspected
+     */
+    uint64_t GetNPackets() const;
+
+    /**
+     * \return the number of alerts raised
+     */
+    uint32_t GetNAlerts() const;
+
+    /**
+     * \return the number of alerts raised by an attack packet
+     */
+    uint32_t GetNTruePositives() const;
+
+    /**
+     * \return the number of alerts raised by a legitimate packet
+     */
+    uint32_t GetNFalsePositives() const;
+
+    /**
+     * \return the reception time of the first attack packet, or a negative time
+     */
+    Time GetFirstAttackTime() const;
+
+    /**
+     * \return the time of the first true positive alert, or a negative time
+     */
+    Time GetDetectionTime() const;
+
+    /**
+     * \return the time from the first attack packet to its detection, or a negative time
+     */
+    Time GetDetectionLatency() const;
+
+    /**
+     * \return the number of packets dropped by the rate limiter
+     */
+    uint64_t GetNDropped() const;
+
+    /**
+     * \return the number of attack packets dropped by the rate limiter
+     */
+    uint64_t GetNDroppedAttack() const;
+
+    /**
+     * \return the mean wall clock time spent per inspected packet, in ns
+     */
+    double GetMeanProcessingTime() const;
+
+    /**
+     * \return the memory taken by the sketches, in bytes
+     */
+    size_t GetMemoryUsage() const;
+
+    /**
+     * TracedCallback signature for alerts.
+     *
+     * \param [in] source the offending source
+     * \param [in] packetRate its estimated packet rate, in pkt/s
+     * \param [in] bitRate its estimated bit rate, in bit/s
+     */
+    typedef void (*AlertTracedCallback)(Ipv4Address source, double packetRate, double bitRate);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void StartApplication() override;
+    void StopApplication() override;
+
+    /// Token bucket of a rate-limited source
+    struct Limiter
+    {
+        Time until;    //!< end of the limitation
+        Time last;     //!< last refill
+        double tokens; //!< packets that may still pass
+    };
+
+    /**
+     * Ipv4L3Protocol Rx trace sink.
+     * \param packet the received packet, IPv4 header included
+     * \param ipv4 the receiving stack
+     * \param interface the receiving interface
+     */
+    void Ingest(Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+
+    /**
+     * Count one packet and raise an alert if its source crossed a threshold.
+     * \param source the packet source
+     * \param size the packet size, in bytes
+     * \param attack whether the packet carries an AttackTag
+     */
+    void Inspect(Ipv4Address source, uint32_t size, bool attack);
+
+    /**
+     * Ipv4InputFilter callback enforcing the rate limits.
+     * \param packet the received packet
+     * \param header its IPv4 header
+     * \param inTransit whether the node is forwarding it
+     * \return true if the packet must be dropped
+     */
+    bool Limit(Ptr<const Packet> packet, const Ipv4Header& header, bool inTransit);
+
+    /// Start a new counting window
+    void NewWindow();
+
+    Time m_window;                      //!< counting window
+    double m_packetRateThreshold;       //!< alert threshold, pkt/s
+    DataRate m_bitRateThreshold;        //!< alert threshold
+    uint32_t m_width;                   //!< sketch width
+    uint32_t m_depth;                   //!< sketch depth
+    uint32_t m_heavyHitters;            //!< heavy-hitter table and limiter capacity
+    bool m_mitigate;                    //!< rate-limit alerted sources
+    double m_limitRate;                 //!< rate allowed to limited sources, pkt/s
+    Time m_blockTime;                   //!< limitation after the last alert
+
+    std::unique_ptr<CountMinSketch> m_packets; //!< packets per source in the window
+    std::unique_ptr<CountMinSketch> m_bytes;   //!< bytes per source in the window
+    std::unordered_set<uint32_t> m_alerted;    //!< sources alerted in the window
+    std::map<uint32_t, Limiter> m_limited;     //!< rate-limited sources
+    bool m_filterInstalled;                    //!< registered with Ipv4InputFilter
+    EventId m_windowEvent;                     //!< next window
+    std::ofstream m_log;                       //!< alert log
+
+    uint64_t m_nPackets;          //!< inspected packets
+    uint32_t m_nAlerts;           //!< alerts
+    uint32_t m_nTruePositives;    //!< alerts raised by attack packets
+    uint64_t m_nDropped;          //!< packets dropped by the limiter
+    uint64_t m_nDroppedAttack;    //!< attack packets dropped by the limiter
+    Time m_firstAttack;           //!< first attack packet
+    Time m_detection;             //!< first true positive
+    double m_processingNs;        //!< wall clock time spent in Inspect
+
+    TracedCallback<Ipv4Address, double, double> m_alertTrace; //!< alerts
+};
+
+} // namespace ns3
+
+#endif /* INTRUSION_DETECTOR_H */
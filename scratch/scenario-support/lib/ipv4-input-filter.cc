@@ -0,0 +1,150 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv4-input-filter.h"
+
+#include "ns3/abort.h"
+#include "ns3/ipv4.h"
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("Ipv4InputFilter");
+
+NS_OBJECT_ENSURE_REGISTERED(Ipv4InputFilter);
+
+TypeId
+Ipv4InputFilter::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::Ipv4InputFilter").SetParent<Ipv4RoutingProtocol>();
+    return tid;
+}
+
+Ptr<Ipv4InputFilter>
+Ipv4InputFilter::Install(Ptr<Node> node)
+{
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    NS_ABORT_MSG_UNLESS(ipv4 && ipv4->GetRoutingProtocol(),
+                        "Ipv4InputFilter needs a node with IPv4 routing");
+    Ptr<Ipv4InputFilter> filter = DynamicCast<Ipv4InputFilter>(ipv4->GetRoutingProtocol());
+    if (!filter)
+    {
+        filter = CreateObject<Ipv4InputFilter>(ipv4->GetRoutingProtocol(), ipv4);
+        ipv4->SetRoutingProtocol(filter);
+    }
+    return filter;
+}
+
+Ipv4InputFilter::Ipv4InputFilter(Ptr<Ipv4RoutingProtocol> inner, Ptr<Ipv4> ipv4)
+    : m_inner(inner),
+      m_ipv4(ipv4)
+{
+    NS_LOG_FUNCTION(this << inner << ipv4);
+}
+
+void
+Ipv4InputFilter::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_inner->Dispose();
+    m_inner = nullptr;
+    m_ipv4 = nullptr;
+    m_filters.clear();
+    Ipv4RoutingProtocol::DoDispose();
+}
+
+void
+Ipv4InputFilter::AddFilter(FilterCallback filter)
+{
+    m_filters.push_back(filter);
+}
+
+Ptr<Ipv4Route>
+Ipv4InputFilter::RouteOutput(Ptr<Packet> p,
+                             const Ipv4Header& header,
+                             Ptr<NetDevice> oif,
+                             Socket::SocketErrno& sockerr)
+{
+    return m_inner->RouteOutput(p, header, oif, sockerr);
+}
+
+bool
+Ipv4InputFilter::RouteInput(Ptr<const Packet> p,
+                            const Ipv4Header& header,
+                            Ptr<const NetDevice> idev,
+                            const UnicastForwardCallback& ucb,
+                            const MulticastForwardCallback& mcb,
+                            const LocalDeliverCallback& lcb,
+                            const ErrorCallback& ecb)
+{
+    // Interface 0 is the loopback
+    int32_t interface = m_ipv4->GetInterfaceForDevice(idev);
+    if (interface > 0)
+    {
+        Ipv4Address destination = header.GetDestination();
+        bool inTransit = !destination.IsBroadcast() && !destination.IsMulticast() &&
+                         !m_ipv4->IsDestinationAddress(destination, interface);
+        for (const auto& filter : m_filters)
+        {
+            if (filter(p, header, inTransit))
+            {
+                // Claiming the packet keeps anybody else from delivering or forwarding it
+                NS_LOG_LOGIC("Filtered " << header.GetSource() << " -> " << destination);
+                return true;
+            }
+        }
+    }
+    return m_inner->RouteInput(p, header, idev, ucb, mcb, lcb, ecb);
+}
+
+void
+Ipv4InputFilter::NotifyInterfaceUp(uint32_t interface)
+{
+    m_inner->NotifyInterfaceUp(interface);
+}
+
+void
+Ipv4InputFilter::NotifyInterfaceDown(uint32_t interface)
+{
+    m_inner->NotifyInterfaceDown(interface);
+}
+
+void
+Ipv4InputFilter::NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress address)
+{
+    m_inner->NotifyAddAddress(interface, address);
+}
+
+void
+Ipv4InputFilter::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress address)
+{
+    m_inner->NotifyRemoveAddress(interface, address);
+}
+
+void
+Ipv4InputFilter::SetIpv4(Ptr<Ipv4> ipv4)
+{
+    // Called by Ipv4::SetRoutingProtocol; the wrapped protocol is already bound
+    NS_ASSERT(ipv4 == m_ipv4);
+}
+
+void
+Ipv4InputFilter::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
+{
+    m_inner->PrintRoutingTable(stream, unit);
+}
+
+} // namespace ns3
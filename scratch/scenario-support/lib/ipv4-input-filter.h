@@ -0,0 +1,106 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_INPUT_FILTER_H
+#define IPV4_INPUT_FILTER_H
+
+#include "ns3/callback.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/node.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Lets applications drop received IPv4 packets before they are routed.
+ *
+ * ns-3 has no input hook in the IPv4 stack, so the filter wraps the node's routing
+ * protocol: RouteInput first asks every registered filter whether the packet must be
+ * dropped, and otherwise delegates everything to the original protocol. The original
+ * protocol keeps its binding to the IPv4 stack, since most protocols cannot be detached
+ * and re-attached, which is why the wrapper is never removed once installed.
+ *
+ * Packets looped back through the loopback interface (e.g. by AODV while it discovers a
+ * route) are never filtered.
+ */
+class Ipv4InputFilter : public Ipv4RoutingProtocol
+{
+  public:
+    /**
+     * Filter callback: returns true to drop the packet.
+     * Arguments: the packet, its IPv4 header, and whether the packet is in transit
+     * (unicast, not addressed to this node) rather than for local delivery.
+     */
+    typedef Callback<bool, Ptr<const Packet>, const Ipv4Header&, bool> FilterCallback;
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Get the filter of a node, installing it on first use.
+     * \param node a node with an IPv4 stack and a routing protocol
+     * \return the node's filter
+     */
+    static Ptr<Ipv4InputFilter> Install(Ptr<Node> node);
+
+    /**
+     * \param inner the routing protocol currently installed, already bound to ipv4
+     * \param ipv4 the node's IPv4 stack
+     */
+    Ipv4InputFilter(Ptr<Ipv4RoutingProtocol> inner, Ptr<Ipv4> ipv4);
+
+    /**
+     * \brief Register a filter. Filters are asked in registration order.
+     * \param filter the filter
+     */
+    void AddFilter(FilterCallback filter);
+
+    Ptr<Ipv4Route> RouteOutput(Ptr<Packet> p,
+                               const Ipv4Header& header,
+                               Ptr<NetDevice> oif,
+                               Socket::SocketErrno& sockerr) override;
+    bool RouteInput(Ptr<const Packet> p,
+                    const Ipv4Header& header,
+                    Ptr<const NetDevice> idev,
+                    const UnicastForwardCallback& ucb,
+                    const MulticastForwardCallback& mcb,
+                    const LocalDeliverCallback& lcb,
+                    const ErrorCallback& ecb) override;
+    void NotifyInterfaceUp(uint32_t interface) override;
+    void NotifyInterfaceDown(uint32_t interface) override;
+    void NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress address) override;
+    void NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress address) override;
+    void SetIpv4(Ptr<Ipv4> ipv4) override;
+    void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
+                           Time::Unit unit = Time::S) const override;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    Ptr<Ipv4RoutingProtocol> m_inner;     //!< wrapped protocol
+    Ptr<Ipv4> m_ipv4;                     //!< the node's IPv4 stack
+    std::vector<FilterCallback> m_filters; //!< registered filters
+};
+
+} // namespace ns3
+
+#endif /* IPV4_INPUT_FILTER_H */
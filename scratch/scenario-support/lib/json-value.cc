@@ -0,0 +1,794 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "json-value.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("JsonValue");
+
+/**
+ * \brief Recursive descent JSON parser (RFC 8259) over a null-terminated buffer.
+ */
+class JsonParser
+{
+  public:
+    /**
+     * \param text the document, must outlive the parser
+     */
+    explicit JsonParser(const std::string& text)
+        : m_begin(text.c_str()),
+          m_pos(text.c_str())
+    {
+    }
+
+    /**
+     * \param value receives the root value
+     * \param error receives the error position and message
+     * \return true if the whole text is one valid value
+     */
+    bool ParseDocument(JsonValue& value, std::string& error)
+    {
+        if (!ParseValue(value, 0))
+        {
+            error = m_error;
+            return false;
+        }
+        SkipSpace();
+        if (*m_pos != '\0')
+        {
+            Fail("trailing characters after the document");
+            error = m_error;
+            return false;
+        }
+        return true;
+    }
+
+  private:
+    /// Nesting depth beyond which the document is rejected rather than overflowing the stack
+    static constexpr uint32_t MAX_DEPTH = 256;
+
+    /**
+     * \brief Record an error at the current position.
+     * \param message what is wrong
+     * \return false
+     */
+    bool Fail(const std::string& message)
+    {
+        uint32_t line = 1;
+        uint32_t column = 1;
+        for (const char* c = m_begin; c < m_pos; ++c)
+        {
+            column = *c == '\n' ? 1 : column + 1;
+            line += *c == '\n';
+        }
+        m_error = std::to_string(line) + ":" + std::to_string(column) + ": " + message;
+        return false;
+    }
+
+    /// Skip whitespace
+    void SkipSpace()
+    {
+        while (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n' || *m_pos == '\r')
+        {
+            ++m_pos;
+        }
+    }
+
+    /**
+     * \param word literal to match at the current position
+     * \return true, past the literal, if it matches
+     */
+    bool Match(const char* word)
+    {
+        const char* p = m_pos;
+        for (; *word != '\0'; ++word, ++p)
+        {
+            if (*p != *word)
+            {
+                return false;
+            }
+        }
+        m_pos = p;
+        return true;
+    }
+
+    /**
+     * \param value receives the value
+     * \param depth current nesting depth
+     * \return false on error
+     */
+    bool ParseValue(JsonValue& value, uint32_t depth)
+    {
+        SkipSpace();
+        if (depth > MAX_DEPTH)
+        {
+            return Fail("document nested too deeply");
+        }
+        switch (*m_pos)
+        {
+        case '{':
+            return ParseObject(value, depth);
+        case '[':
+            return ParseArray(value, depth);
+        case '"':
+            value.m_type = JsonValue::STRING;
+            return ParseString(value.m_string);
+        case 't':
+        case 'f':
+            value.m_type = JsonValue::BOOLEAN;
+            value.m_bool = *m_pos == 't';
+            return Match(value.m_bool ? "true" : "false") || Fail("invalid literal");
+        case 'n':
+            value.m_type = JsonValue::NUL;
+            return Match("null") || Fail("invalid literal");
+        case '\0':
+            return Fail("unexpected end of document");
+        default:
+            return ParseNumber(value);
+        }
+    }
+
+    /**
+     * \param value receives the number
+     * \return false on error
+     */
+    bool ParseNumber(JsonValue& value)
+    {
+        // Check the JSON grammar first, strtod alone would also accept hex, inf and nan
+        const char* p = m_pos;
+        p += *p == '-';
+        if (*p == '0')
+        {
+            ++p;
+        }
+        else if (*p >= '1' && *p <= '9')
+        {
+            while (*p >= '0' && *p <= '9')
+            {
+                ++p;
+            }
+        }
+        else
+        {
+            return Fail("unexpected character");
+        }
+        if (*p == '.')
+        {
+            ++p;
+            if (*p < '0' || *p > '9')
+            {
+                m_pos = p;
+                return Fail("digit expected after the decimal point");
+            }
+            while (*p >= '0' && *p <= '9')
+            {
+                ++p;
+            }
+        }
+        if (*p == 'e' || *p == 'E')
+        {
+            ++p;
+            p += *p == '+' || *p == '-';
+            if (*p < '0' || *p > '9')
+            {
+                m_pos = p;
+                return Fail("digit expected in the exponent");
+            }
+            while (*p >= '0' && *p <= '9')
+            {
+                ++p;
+            }
+        }
+        value.m_type = JsonValue::NUMBER;
+        value.m_number = std::strtod(m_pos, nullptr);
+        if (!std::isfinite(value.m_number))
+        {
+            return Fail("number out of range");
+        }
+        m_pos = p;
+        return true;
+    }
+
+    /**
+     * \param out receives the four hexadecimal digits at the current position
+     * \return false on error
+     */
+    bool ParseHex4(uint32_t& out)
+    {
+        out = 0;
+        for (int i = 0; i < 4; ++i, ++m_pos)
+        {
+            char c = *m_pos;
+            out <<= 4;
+            if (c >= '0' && c <= '9')
+            {
+                out |= c - '0';
+            }
+            else if (c >= 'a' && c <= 'f')
+            {
+                out |= c - 'a' + 10;
+            }
+            else if (c >= 'A' && c <= 'F')
+            {
+                out |= c - 'A' + 10;
+            }
+            else
+            {
+                return Fail("invalid \\u escape");
+            }
+        }
+        return true;
+    }
+
+    /**
+     * \param out receives the string, at the opening quote
+     * \return false on error
+     */
+    bool ParseString(std::string& out)
+    {
+        ++m_pos;
+        out.clear();
+        while (true)
+        {
+            // Copy runs of plain characters at once
+            const char* run = m_pos;
+            while (*m_pos != '"' && *m_pos != '\\' && static_cast<unsigned char>(*m_pos) >= 0x20)
+            {
+                ++m_pos;
+            }
+            out.append(run, m_pos - run);
+            if (*m_pos == '"')
+            {
+                ++m_pos;
+                return true;
+            }
+            if (*m_pos != '\\')
+            {
+                return Fail(*m_pos == '\0' ? "unterminated string" : "control character in string");
+            }
+            ++m_pos;
+            char escape = *m_pos++;
+            switch (escape)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                out += escape;
+                break;
+            case 'b':
+                out += '\b';
+                break;
+            case 'f':
+                out += '\f';
+                break;
+            case 'n':
+                out += '\n';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'u': {
+                uint32_t code;
+                if (!ParseHex4(code))
+                {
+                    return false;
+                }
+                if (code >= 0xD800 && code < 0xDC00)
+                {
+                    uint32_t low;
+                    if (!Match("\\u") || !ParseHex4(low) || low < 0xDC00 || low >= 0xE000)
+                    {
+                        return Fail("unpaired surrogate in \\u escape");
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                AppendUtf8(out, code);
+                break;
+            }
+            default:
+                --m_pos;
+                return Fail("invalid escape");
+            }
+        }
+    }
+
+    /**
+     * \param out string to append to
+     * \param code Unicode code point
+     */
+    static void AppendUtf8(std::string& out, uint32_t code)
+    {
+        if (code < 0x80)
+        {
+            out += static_cast<char>(code);
+        }
+        else if (code < 0x800)
+        {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    /**
+     * \param value receives the array, at the opening bracket
+     * \param depth nesting depth of the array
+     * \return false on error
+     */
+    bool ParseArray(JsonValue& value, uint32_t depth)
+    {
+        ++m_pos;
+        value.m_type = JsonValue::ARRAY;
+        SkipSpace();
+        if (*m_pos == ']')
+        {
+            ++m_pos;
+            return true;
+        }
+        while (true)
+        {
+            value.m_array.emplace_back();
+            if (!ParseValue(value.m_array.back(), depth + 1))
+            {
+                return false;
+            }
+            SkipSpace();
+            if (*m_pos == ']')
+            {
+                ++m_pos;
+                return true;
+            }
+            if (*m_pos != ',')
+            {
+                return Fail("',' or ']' expected");
+            }
+            ++m_pos;
+        }
+    }
+
+    /**
+     * \param value receives the object, at the opening brace
+     * \param depth nesting depth of the object
+     * \return false on error
+     */
+    bool ParseObject(JsonValue& value, uint32_t depth)
+    {
+        ++m_pos;
+        value.m_type = JsonValue::OBJECT;
+        SkipSpace();
+        if (*m_pos == '}')
+        {
+            ++m_pos;
+            return true;
+        }
+        while (true)
+        {
+            SkipSpace();
+            if (*m_pos != '"')
+            {
+                return Fail("member name expected");
+            }
+            value.m_members.emplace_back();
+            if (!ParseString(value.m_members.back().first))
+            {
+                return false;
+            }
+            SkipSpace();
+            if (*m_pos != ':')
+            {
+                return Fail("':' expected");
+            }
+            ++m_pos;
+            if (!ParseValue(value.m_members.back().second, depth + 1))
+            {
+                return false;
+            }
+            SkipSpace();
+            if (*m_pos == '}')
+            {
+                ++m_pos;
+                return true;
+            }
+            if (*m_pos != ',')
+            {
+                return Fail("',' or '}' expected");
+            }
+            ++m_pos;
+        }
+    }
+
+    const char* m_begin; //!< start of the text, for error positions
+    const char* m_pos;   //!< current position
+    std::string m_error; //!< last error
+};
+
+JsonValue::JsonValue()
+    : m_type(NUL),
+      m_bool(false),
+      m_number(0.0)
+{
+}
+
+JsonValue::JsonValue(bool value)
+    : m_type(BOOLEAN),
+      m_bool(value),
+      m_number(0.0)
+{
+}
+
+JsonValue::JsonValue(double value)
+    : m_type(NUMBER),
+      m_bool(false),
+      m_number(value)
+{
+}
+
+JsonValue::JsonValue(const std::string& value)
+    : m_type(STRING),
+      m_bool(false),
+      m_number(0.0),
+      m_string(value)
+{
+}
+
+JsonValue
+JsonValue::Parse(const std::string& text)
+{
+    JsonValue value;
+    std::string error;
+    NS_ABORT_MSG_UNLESS(TryParse(text, value, error), "Invalid JSON at " << error);
+    return value;
+}
+
+bool
+JsonValue::TryParse(const std::string& text, JsonValue& value, std::string& error)
+{
+    value = JsonValue();
+    JsonParser parser(text);
+    return parser.ParseDocument(value, error);
+}
+
+JsonValue
+JsonValue::Load(const std::string& fileName)
+{
+    NS_LOG_FUNCTION(fileName);
+    std::ifstream in(fileName, std::ios::binary);
+    NS_ABORT_MSG_UNLESS(in.is_open(), "Could not open " << fileName);
+    std::ostringstream text;
+    text << in.rdbuf();
+
+    JsonValue value;
+    std::string error;
+    NS_ABORT_MSG_UNLESS(TryParse(text.str(), value, error),
+                        "Invalid JSON in " << fileName << ":" << error);
+    return value;
+}
+
+JsonValue::Type
+JsonValue::GetType() const
+{
+    return m_type;
+}
+
+bool
+JsonValue::IsNull() const
+{
+    return m_type == NUL;
+}
+
+bool
+JsonValue::IsNumber() const
+{
+    return m_type == NUMBER;
+}
+
+bool
+JsonValue::IsString() const
+{
+    return m_type == STRING;
+}
+
+bool
+JsonValue::IsArray() const
+{
+    return m_type == ARRAY;
+}
+
+bool
+JsonValue::IsObject() const
+{
+    return m_type == OBJECT;
+}
+
+bool
+JsonValue::AsBool() const
+{
+    NS_ABORT_MSG_UNLESS(m_type == BOOLEAN, "JSON boolean expected");
+    return m_bool;
+}
+
+bool
+JsonValue::AsBool(bool fallback) const
+{
+    return m_type == NUL ? fallback : AsBool();
+}
+
+double
+JsonValue::AsDouble() const
+{
+    NS_ABORT_MSG_UNLESS(m_type == NUMBER, "JSON number expected");
+    return m_number;
+}
+
+double
+JsonValue::AsDouble(double fallback) const
+{
+    return m_type == NUL ? fallback : AsDouble();
+}
+
+uint64_t
+JsonValue::AsUint() const
+{
+    double number = AsDouble();
+    NS_ABORT_MSG_UNLESS(number >= 0 && number == std::floor(number) && number < 1.8e19,
+                        "Non-negative integer expected, got " << number);
+    return static_cast<uint64_t>(number);
+}
+
+uint64_t
+JsonValue::AsUint(uint64_t fallback) const
+{
+    return m_type == NUL ? fallback : AsUint();
+}
+
+const std::string&
+JsonValue::AsString() const
+{
+    NS_ABORT_MSG_UNLESS(m_type == STRING, "JSON string expected");
+    return m_string;
+}
+
+std::string
+JsonValue::AsString(const std::string& fallback) const
+{
+    return m_type == NUL ? fallback : AsString();
+}
+
+std::string
+JsonValue::ToAttributeString() const
+{
+    switch (m_type)
+    {
+    case BOOLEAN:
+        return m_bool ? "true" : "false";
+    case STRING:
+        return m_string;
+    case NUMBER: {
+        char buffer[32];
+        // Integer attributes only parse plain digits, "1270" not "1.27e+03"
+        if (m_number == std::trunc(m_number) && std::abs(m_number) < 1e18)
+        {
+            std::snprintf(buffer, sizeof(buffer), "%.0f", m_number);
+            return buffer;
+        }
+        std::snprintf(buffer, sizeof(buffer), "%.17g", m_number);
+        // Prefer the shortest text that reads back to the same double, "0.1" not "0.1000...01"
+        for (int precision = 1; precision < 17; ++precision)
+        {
+            char shorter[32];
+            std::snprintf(shorter, sizeof(shorter), "%.*g", precision, m_number);
+            if (std::strtod(shorter, nullptr) == m_number)
+            {
+                return shorter;
+            }
+        }
+        return buffer;
+    }
+    default:
+        NS_ABORT_MSG("Scalar JSON value expected for an attribute");
+        return "";
+    }
+}
+
+uint32_t
+JsonValue::GetSize() const
+{
+    if (m_type == ARRAY)
+    {
+        return m_array.size();
+    }
+    return m_type == OBJECT ? m_members.size() : 0;
+}
+
+const JsonValue&
+JsonValue::operator[](uint32_t index) const
+{
+    NS_ABORT_MSG_UNLESS(m_type == ARRAY, "JSON array expected");
+    NS_ABORT_MSG_UNLESS(index < m_array.size(),
+                        "Index " << index << " out of range, array of " << m_array.size());
+    return m_array[index];
+}
+
+bool
+JsonValue::Has(const std::string& key) const
+{
+    for (const auto& member : m_members)
+    {
+        if (member.first == key)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+const JsonValue&
+JsonValue::operator[](const std::string& key) const
+{
+    static const JsonValue null;
+    for (const auto& member : m_members)
+    {
+        if (member.first == key)
+        {
+            return member.second;
+        }
+    }
+    return null;
+}
+
+const JsonValue::Members&
+JsonValue::GetMembers() const
+{
+    return m_members;
+}
+
+JsonValue::Assignments
+JsonValue::ParseAssignments(const std::string& text)
+{
+    Assignments assignments;
+    size_t begin = 0;
+    while (begin < text.size())
+    {
+        size_t end = text.find(';', begin);
+        if (end == std::string::npos)
+        {
+            end = text.size();
+        }
+        std::string assignment = text.substr(begin, end - begin);
+        begin = end + 1;
+        if (assignment.empty())
+        {
+            continue;
+        }
+        size_t equal = assignment.find('=');
+        NS_ABORT_MSG_IF(equal == std::string::npos, "path=value expected, got " << assignment);
+        assignments.emplace_back(assignment.substr(0, equal), assignment.substr(equal + 1));
+    }
+    return assignments;
+}
+
+void
+JsonValue::ApplyOverrides(const Assignments& assignments)
+{
+    for (const auto& [path, text] : assignments)
+    {
+        JsonValue value;
+        std::string error;
+        if (!TryParse(text, value, error))
+        {
+            value = JsonValue(text);
+        }
+        Set(path, value);
+    }
+}
+
+void
+JsonValue::Set(const std::string& path, const JsonValue& value)
+{
+    JsonValue* node = this;
+    std::istringstream components(path);
+    std::string component;
+    while (std::getline(components, component, '.'))
+    {
+        if (node->m_type == ARRAY)
+        {
+            char* end;
+            unsigned long index = std::strtoul(component.c_str(), &end, 10);
+            NS_ABORT_MSG_UNLESS(!component.empty() && *end == '\0' && index < node->m_array.size(),
+                                "No element " << component << " in " << path);
+            node = &node->m_array[index];
+            continue;
+        }
+        if (node->m_type == NUL)
+        {
+            node->m_type = OBJECT;
+        }
+        NS_ABORT_MSG_UNLESS(node->m_type == OBJECT, "Cannot set " << path << ": not an object");
+        JsonValue* child = nullptr;
+        for (auto& member : node->m_members)
+        {
+            if (member.first == component)
+            {
+                child = &member.second;
+                break;
+            }
+        }
+        if (!child)
+        {
+            node->m_members.emplace_back(component, JsonValue());
+            child = &node->m_members.back().second;
+        }
+        node = child;
+    }
+    *node = value;
+}
+
+void
+JsonValue::Append(const JsonValue& value)
+{
+    if (m_type == NUL)
+    {
+        m_type = ARRAY;
+    }
+    NS_ABORT_MSG_UNLESS(m_type == ARRAY, "JSON array expected");
+    m_array.push_back(value);
+}
+
+void
+JsonValue::SetMember(const std::string& key, const JsonValue& value)
+{
+    if (m_type == NUL)
+    {
+        m_type = OBJECT;
+    }
+    NS_ABORT_MSG_UNLESS(m_type == OBJECT, "JSON object expected");
+    for (auto& member : m_members)
+    {
+        if (member.first == key)
+        {
+            member.second = value;
+            return;
+        }
+    }
+    m_members.emplace_back(key, value);
+}
+
+} // namespace ns3
@@ -0,0 +1,258 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef JSON_VALUE_H
+#define JSON_VALUE_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief A parsed JSON document, for scenario descriptions and other run-time inputs.
+ *
+ * Only what reading configuration files needs: parsing from text or a file, typed
+ * accessors with fallbacks for optional fields, and setting a value at a dotted path
+ * ("groups.1.count") to override part of a document from the command line. Object
+ * members keep their file order and are looked up linearly, which is faster than a map
+ * for the handful of keys of a configuration object. Malformed input aborts with the
+ * line and column of the error.
+ */
+class JsonValue
+{
+  public:
+    /// Kind of a value
+    enum Type
+    {
+        NUL,     //!< null, also the result of looking up a missing member
+        BOOLEAN, //!< true or false
+        NUMBER,  //!< double
+        STRING,  //!< UTF-8 string
+        ARRAY,   //!< ordered values
+        OBJECT   //!< ordered key/value members
+    };
+
+    /// Members of an object, in document order
+    using Members = std::vector<std::pair<std::string, JsonValue>>;
+
+    /// "path=value" overrides, in order
+    using Assignments = std::vector<std::pair<std::string, std::string>>;
+
+    /// A null value
+    JsonValue();
+
+    /**
+     * \param value a boolean
+     */
+    explicit JsonValue(bool value);
+
+    /**
+     * \param value a number
+     */
+    explicit JsonValue(double value);
+
+    /**
+     * \param value a string
+     */
+    explicit JsonValue(const std::string& value);
+
+    /**
+     * \brief Parse a document, aborting on a syntax error.
+     * \param text JSON text
+     * \return the root value
+     */
+    static JsonValue Parse(const std::string& text);
+
+    /**
+     * \brief Parse a document without aborting.
+     * \param text JSON text
+     * \param value receives the root value
+     * \param error receives "line:column: message" on failure
+     * \return true on success
+     */
+    static bool TryParse(const std::string& text, JsonValue& value, std::string& error);
+
+    /**
+     * \brief Parse a file, aborting if it cannot be read or parsed.
+     * \param fileName the file
+     * \return the root value
+     */
+    static JsonValue Load(const std::string& fileName);
+
+    /**
+     * \brief Split a "path=value;path=value" list, as taken by the --set option of the
+     * scenario tools, aborting on an element without "=".
+     * \param text the list, empty elements skipped
+     * \return the assignments
+     */
+    static Assignments ParseAssignments(const std::string& text);
+
+    /**
+     * \return the kind of the value
+     */
+    Type GetType() const;
+
+    /**
+     * \return true for null, including missing members
+     */
+    bool IsNull() const;
+
+    /**
+     * \return true for a number
+     */
+    bool IsNumber() const;
+
+    /**
+     * \return true for a string
+     */
+    bool IsString() const;
+
+    /**
+     * \return true for an array
+     */
+    bool IsArray() const;
+
+    /**
+     * \return true for an object
+     */
+    bool IsObject() const;
+
+    /**
+     * \return the boolean, aborting for another type
+     */
+    bool AsBool() const;
+
+    /**
+     * \param fallback returned for null
+     * \return the boolean
+     */
+    bool AsBool(bool fallback) const;
+
+    /**
+     * \return the number, aborting for another type
+     */
+    double AsDouble() const;
+
+    /**
+     * \param fallback returned for null
+     * \return the number
+     */
+    double AsDouble(double fallback) const;
+
+    /**
+     * \return the number as a non-negative integer, aborting if it is not one
+     */
+    uint64_t AsUint() const;
+
+    /**
+     * \param fallback returned for null
+     * \return the number as a non-negative integer
+     */
+    uint64_t AsUint(uint64_t fallback) const;
+
+    /**
+     * \return the string, aborting for another type
+     */
+    const std::string& AsString() const;
+
+    /**
+     * \param fallback returned for null
+     * \return the string
+     */
+    std::string AsString(const std::string& fallback) const;
+
+    /**
+     * \brief Text of a scalar as ns-3 attribute syntax: integral numbers as plain integers,
+     * other numbers in shortest form, booleans as true/false, strings unchanged.
+     * \return the text, aborting for an array, object or null
+     */
+    std::string ToAttributeString() const;
+
+    /**
+     * \return the number of elements of an array or members of an object, 0 otherwise
+     */
+    uint32_t GetSize() const;
+
+    /**
+     * \param index element index, aborting if out of range
+     * \return the element of an array
+     */
+    const JsonValue& operator[](uint32_t index) const;
+
+    /**
+     * \param key member name
+     * \return true if the object has the member
+     */
+    bool Has(const std::string& key) const;
+
+    /**
+     * \param key member name
+     * \return the member, or a null value if absent or if this is not an object
+     */
+    const JsonValue& operator[](const std::string& key) const;
+
+    /**
+     * \return the members of an object, empty otherwise
+     */
+    const Members& GetMembers() const;
+
+    /**
+     * \brief Replace the value at a dotted path, creating missing object members.
+     *
+     * Path components are member names, or element indices for arrays.
+     *
+     * \param path e.g. "traffic.0.rate"
+     * \param value the new value
+     */
+    void Set(const std::string& path, const JsonValue& value);
+
+    /**
+     * \brief Set every assignment in order. A value that is not valid JSON is taken as a
+     * string, so "rate=2Mb/s" needs no quotes.
+     * \param assignments the overrides
+     */
+    void ApplyOverrides(const Assignments& assignments);
+
+    /**
+     * \brief Append an element, turning a null value into an array.
+     * \param value the element
+     */
+    void Append(const JsonValue& value);
+
+    /**
+     * \brief Set a member, turning a null value into an object.
+     * \param key member name
+     * \param value member value
+     */
+    void SetMember(const std::string& key, const JsonValue& value);
+
+  private:
+    friend class JsonParser;
+
+    Type m_type;                    //!< kind of the value
+    bool m_bool;                    //!< BOOLEAN value
+    double m_number;                //!< NUMBER value
+    std::string m_string;           //!< STRING value
+    std::vector<JsonValue> m_array; //!< ARRAY elements
+    Members m_members;              //!< OBJECT members
+};
+
+} // namespace ns3
+
+#endif /* JSON_VALUE_H */
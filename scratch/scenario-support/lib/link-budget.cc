@@ -0,0 +1,300 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "link-budget.h"
+
+#include "ns3/abort.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LinkBudget");
+
+/**
+ * \brief Regularized lower incomplete gamma function P(a, x).
+ *
+ * Series for x < a + 1, continued fraction of the complement beyond it.
+ *
+ * \param a shape, positive
+ * \param x upper limit
+ * \return P(a, x)
+ */
+static double
+RegularizedGammaP(double a, double x)
+{
+    if (x <= 0)
+    {
+        return 0.0;
+    }
+    // tgamma rather than lgamma, which writes the global signgam
+    double prefix = std::exp(a * std::log(x) - x - std::log(std::tgamma(a)));
+    if (x < a + 1)
+    {
+        double term = 1.0 / a;
+        double sum = term;
+        for (int n = 1; n < 500 && term > sum * 1e-12; ++n)
+        {
+            term *= x / (a + n);
+            sum += term;
+        }
+        return std::min(sum * prefix, 1.0);
+    }
+    const double tiny = 1e-300;
+    double b = x + 1 - a;
+    double c = 1.0 / tiny;
+    double d = 1.0 / b;
+    double h = d;
+    for (int i = 1; i < 500; ++i)
+    {
+        double an = -i * (i - a);
+        b += 2;
+        d = an * d + b;
+        d = std::abs(d) < tiny ? tiny : d;
+        c = b + an / c;
+        c = std::abs(c) < tiny ? tiny : c;
+        d = 1.0 / d;
+        h *= d * c;
+        if (std::abs(d * c - 1) < 1e-12)
+        {
+            break;
+        }
+    }
+    return std::max(1.0 - prefix * h, 0.0);
+}
+
+LinkBudget::LinkBudget()
+    : m_analytic(false),
+      m_fading(-1)
+{
+}
+
+bool
+LinkBudget::GetStage(Ptr<PropagationLossModel> model, Stage& stage)
+{
+    // Attribute names, in the order the stage evaluation reads them
+    std::vector<std::string> names;
+    if (DynamicCast<FriisPropagationLossModel>(model))
+    {
+        stage.type = FRIIS;
+        names = {"Frequency", "SystemLoss", "MinLoss"};
+    }
+    else if (DynamicCast<LogDistancePropagationLossModel>(model))
+    {
+        stage.type = LOG_DISTANCE;
+        names = {"Exponent", "ReferenceDistance", "ReferenceLoss"};
+    }
+    else if (DynamicCast<ThreeLogDistancePropagationLossModel>(model))
+    {
+        stage.type = THREE_LOG_DISTANCE;
+        names = {"Distance0",
+                 "Distance1",
+                 "Distance2",
+                 "Exponent0",
+                 "Exponent1",
+                 "Exponent2",
+                 "ReferenceLoss"};
+    }
+    else if (DynamicCast<RangePropagationLossModel>(model))
+    {
+        stage.type = RANGE;
+        names = {"MaxRange"};
+    }
+    else if (DynamicCast<FixedRssLossModel>(model))
+    {
+        stage.type = FIXED_RSS;
+        names = {"Rss"};
+    }
+    else if (DynamicCast<NakagamiPropagationLossModel>(model))
+    {
+        stage.type = NAKAGAMI;
+        names = {"Distance1", "Distance2", "m0", "m1", "m2"};
+    }
+    else
+    {
+        return false;
+    }
+    stage.params.clear();
+    for (const auto& name : names)
+    {
+        DoubleValue value;
+        model->GetAttribute(name, value);
+        stage.params.push_back(value.Get());
+    }
+    return true;
+}
+
+void
+LinkBudget::SetLossModel(Ptr<PropagationLossModel> model)
+{
+    NS_LOG_FUNCTION(this << model);
+    NS_ABORT_MSG_UNLESS(model, "No propagation loss model");
+    m_model = model;
+    m_stages.clear();
+    m_analytic = true;
+    m_fading = -1;
+    for (Ptr<PropagationLossModel> next = model; next; next = next->GetNext())
+    {
+        Stage stage;
+        if (!GetStage(next, stage) || (stage.type == NAKAGAMI && m_fading >= 0))
+        {
+            NS_LOG_INFO(next->GetInstanceTypeId().GetName() << " has no closed form");
+            m_stages.clear();
+            m_analytic = false;
+            m_fading = -1;
+            return;
+        }
+        if (stage.type == NAKAGAMI)
+        {
+            m_fading = m_stages.size();
+        }
+        m_stages.push_back(stage);
+    }
+}
+
+bool
+LinkBudget::IsAnalytic() const
+{
+    return m_analytic;
+}
+
+bool
+LinkBudget::HasFading() const
+{
+    return m_fading >= 0;
+}
+
+void
+LinkBudget::CalcRxPower(double txPower,
+                        const Vector& tx,
+                        const Vector* rx,
+                        std::size_t n,
+                        double* rxPower) const
+{
+    NS_ABORT_MSG_UNLESS(m_model, "No propagation loss model");
+    if (!m_analytic)
+    {
+        Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel>();
+        Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel>();
+        a->SetPosition(tx);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            b->SetPosition(rx[i]);
+            rxPower[i] = m_model->CalcRxPower(txPower, a, b);
+        }
+        return;
+    }
+
+    // Squared distances first, then one pass per stage, the way the chain applies them
+    std::vector<double> d2(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        d2[i] = CalculateDistanceSquared(tx, rx[i]);
+        rxPower[i] = txPower;
+    }
+    for (const auto& stage : m_stages)
+    {
+        const std::vector<double>& p = stage.params;
+        switch (stage.type)
+        {
+        case FRIIS: {
+            double lambda = 299792458.0 / p[0];
+            double constant = 10.0 * std::log10(16.0 * M_PI * M_PI * p[1] / (lambda * lambda));
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                double loss = d2[i] > 0 ? constant + 10.0 * std::log10(d2[i]) : p[2];
+                rxPower[i] -= std::max(loss, p[2]);
+            }
+            break;
+        }
+        case LOG_DISTANCE: {
+            double d02 = p[1] * p[1];
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                rxPower[i] -= d2[i] <= d02 ? p[2] : p[2] + 5.0 * p[0] * std::log10(d2[i] / d02);
+            }
+            break;
+        }
+        case THREE_LOG_DISTANCE: {
+            double d0 = p[0];
+            double d1 = p[1];
+            double d2Max = p[2];
+            double loss1 = p[6] + 10.0 * p[3] * std::log10(d1 / d0);
+            double loss2 = loss1 + 10.0 * p[4] * std::log10(d2Max / d1);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                double d = std::sqrt(d2[i]);
+                double loss = 0.0;
+                if (d >= d2Max)
+                {
+                    loss = loss2 + 10.0 * p[5] * std::log10(d / d2Max);
+                }
+                else if (d >= d1)
+                {
+                    loss = loss1 + 10.0 * p[4] * std::log10(d / d1);
+                }
+                else if (d >= d0)
+                {
+                    loss = p[6] + 10.0 * p[3] * std::log10(d / d0);
+                }
+                rxPower[i] -= loss;
+            }
+            break;
+        }
+        case RANGE: {
+            double range2 = p[0] * p[0];
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                rxPower[i] = d2[i] <= range2 ? rxPower[i] : -1000.0;
+            }
+            break;
+        }
+        case FIXED_RSS:
+            std::fill(rxPower, rxPower + n, p[0]);
+            break;
+        case NAKAGAMI:
+            break;
+        }
+    }
+}
+
+double
+LinkBudget::GetFadingShape(double distance) const
+{
+    if (m_fading < 0)
+    {
+        return 0.0;
+    }
+    const std::vector<double>& p = m_stages[m_fading].params;
+    return distance < p[0] ? p[2] : (distance < p[1] ? p[3] : p[4]);
+}
+
+double
+LinkBudget::GetOutageProbability(double meanSnr, double threshold, double m)
+{
+    if (m <= 0)
+    {
+        return meanSnr < threshold ? 1.0 : 0.0;
+    }
+    return RegularizedGammaP(m, m * std::pow(10.0, (threshold - meanSnr) / 10));
+}
+
+} // namespace ns3
@@ -0,0 +1,129 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LINK_BUDGET_H
+#define LINK_BUDGET_H
+
+#include "ns3/propagation-loss-model.h"
+#include "ns3/vector.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Mean received power through a propagation loss chain, in batches of receivers.
+ *
+ * SetLossModel walks the chain and keeps the parameters of every stage it knows in
+ * closed form: Friis, log-distance, three-log-distance, range and fixed RSS. A Nakagami
+ * stage does not change the mean power, so it only contributes its shape factor m, from
+ * which GetOutageProbability gives the probability of a faded SNR under a threshold.
+ * Such an analytic chain is evaluated from the squared distances of a whole batch, with
+ * no virtual call or allocation per receiver, and concurrently from several threads.
+ *
+ * Any other stage, or a second Nakagami one, makes the chain generic: CalcRxPower then
+ * goes through PropagationLossModel::CalcRxPower once per receiver, drawing the random
+ * variables of the chain, and must not be called from several threads.
+ */
+class LinkBudget
+{
+  public:
+    LinkBudget();
+
+    /**
+     * \param model the first model of the chain
+     */
+    void SetLossModel(Ptr<PropagationLossModel> model);
+
+    /**
+     * \return whether every stage of the chain has a closed form
+     */
+    bool IsAnalytic() const;
+
+    /**
+     * \return whether the analytic chain has a Nakagami fading stage
+     */
+    bool HasFading() const;
+
+    /**
+     * \brief Received power at a batch of receivers.
+     * \param txPower transmission power (dBm)
+     * \param tx transmitter position
+     * \param rx receiver positions
+     * \param n number of receivers
+     * \param rxPower mean received powers (dBm), one per receiver
+     */
+    void CalcRxPower(double txPower,
+                     const Vector& tx,
+                     const Vector* rx,
+                     std::size_t n,
+                     double* rxPower) const;
+
+    /**
+     * \param distance transmitter-receiver distance (m)
+     * \return the Nakagami shape factor at that distance, 0 without fading
+     */
+    double GetFadingShape(double distance) const;
+
+    /**
+     * \brief Probability that the SNR falls under a threshold.
+     *
+     * Under Nakagami-m fading the received power is Gamma distributed with shape m and
+     * the mean power over m as scale; without fading (m = 0) it is the mean itself.
+     *
+     * \param meanSnr mean SNR (dB)
+     * \param threshold SNR threshold (dB)
+     * \param m Nakagami shape factor, 0 without fading
+     * \return the outage probability
+     */
+    static double GetOutageProbability(double meanSnr, double threshold, double m);
+
+  private:
+    /// Closed-form stages
+    enum StageType
+    {
+        FRIIS,              //!< constant + 10 log10(d^2), at least a minimum loss
+        LOG_DISTANCE,       //!< reference loss + 5 n log10(d^2 / d0^2) beyond d0
+        THREE_LOG_DISTANCE, //!< three log-distance segments
+        RANGE,              //!< -1000 dBm beyond a range
+        FIXED_RSS,          //!< constant received power
+        NAKAGAMI            //!< fading, mean unchanged
+    };
+
+    /// One closed-form stage and its parameters
+    struct Stage
+    {
+        StageType type;              //!< stage model
+        std::vector<double> params;  //!< parameters, in the order the stage uses them
+    };
+
+    /**
+     * \param model one model of the chain
+     * \param stage its closed form
+     * \return whether the model has one
+     */
+    static bool GetStage(Ptr<PropagationLossModel> model, Stage& stage);
+
+    Ptr<PropagationLossModel> m_model; //!< first model of the chain
+    std::vector<Stage> m_stages;       //!< closed forms, empty for a generic chain
+    bool m_analytic;                   //!< whether m_stages covers the chain
+    int m_fading;                      //!< index of the Nakagami stage, -1 for none
+};
+
+} // namespace ns3
+
+#endif /* LINK_BUDGET_H */
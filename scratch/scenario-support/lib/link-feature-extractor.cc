@@ -0,0 +1,302 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "link-feature-extractor.h"
+
+#include "ns3/abort.h"
+#include "ns3/ampdu-subframe-header.h"
+#include "ns3/log.h"
+#include "ns3/qos-utils.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-mac-queue.h"
+#include "ns3/wifi-mac.h"
+#include "ns3/wifi-net-device.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LinkFeatureExtractor");
+
+NS_OBJECT_ENSURE_REGISTERED(LinkFeatureExtractor);
+
+TypeId
+LinkFeatureExtractor::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::LinkFeatureExtractor")
+            .SetParent<Object>()
+            .AddConstructor<LinkFeatureExtractor>()
+            .AddAttribute("Window",
+                          "Length of the sliding window.",
+                          TimeValue(Seconds(1.0)),
+                          MakeTimeAccessor(&LinkFeatureExtractor::m_window),
+                          MakeTimeChecker(MicroSeconds(1)))
+            .AddAttribute("Buckets",
+                          "Number of buckets the window slides by.",
+                          UintegerValue(10),
+                          MakeUintegerAccessor(&LinkFeatureExtractor::m_buckets),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+LinkFeatureExtractor::LinkState::LinkState(Time window, uint32_t buckets)
+    : received(window, buckets),
+      dropped(window, buckets),
+      snr(window, buckets)
+{
+}
+
+LinkFeatureExtractor::NodeState::NodeState(Time window, uint32_t buckets)
+    : received(window, buckets),
+      dropped(window, buckets),
+      busy(window, buckets),
+      queue(window, buckets),
+      queueLength(0)
+{
+}
+
+LinkFeatureExtractor::LinkFeatureExtractor()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+LinkFeatureExtractor::~LinkFeatureExtractor()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+LinkFeatureExtractor::Install(const NetDeviceContainer& devices)
+{
+    NS_LOG_FUNCTION(this);
+    for (uint32_t i = 0; i < devices.GetN(); ++i)
+    {
+        Ptr<WifiNetDevice> wifi = DynamicCast<WifiNetDevice>(devices.Get(i));
+        NS_ABORT_MSG_UNLESS(wifi, "LinkFeatureExtractor only follows WifiNetDevices");
+        uint32_t node = wifi->GetNode()->GetId();
+        NS_ABORT_MSG_UNLESS(node < (1 << 16), "Node ids must stay below 65536");
+        m_nodes.emplace(std::piecewise_construct,
+                        std::forward_as_tuple(node),
+                        std::forward_as_tuple(m_window, m_buckets));
+
+        Ptr<WifiPhy> phy = wifi->GetPhy();
+        phy->TraceConnectWithoutContext(
+            "MonitorSnifferRx",
+            MakeCallback(&LinkFeatureExtractor::SnifferRx, this).Bind(node));
+        phy->TraceConnectWithoutContext(
+            "PhyRxDrop",
+            MakeCallback(&LinkFeatureExtractor::RxDrop, this).Bind(node));
+        phy->GetState()->TraceConnectWithoutContext(
+            "State",
+            MakeCallback(&LinkFeatureExtractor::PhyState, this).Bind(node));
+        wifi->GetMac()->GetTxopQueue(AC_BE)->TraceConnectWithoutContext(
+            "PacketsInQueue",
+            MakeCallback(&LinkFeatureExtractor::QueueLength, this).Bind(node));
+    }
+}
+
+std::vector<std::string>
+LinkFeatureExtractor::GetFeatureNames()
+{
+    return {"link_loss_rate",
+            "link_snr_mean",
+            "link_snr_variance",
+            "node_loss_rate",
+            "busy_fraction",
+            "queue_occupancy",
+            "neighbors"};
+}
+
+uint64_t
+LinkFeatureExtractor::ToInteger(Mac48Address address)
+{
+    uint8_t bytes[6];
+    address.CopyTo(bytes);
+    uint64_t value = 0;
+    for (uint8_t byte : bytes)
+    {
+        value = (value << 8) | byte;
+    }
+    return value;
+}
+
+uint64_t
+LinkFeatureExtractor::GetLinkKey(uint32_t node, uint64_t transmitter)
+{
+    return (static_cast<uint64_t>(node) << 48) | transmitter;
+}
+
+LinkFeatureExtractor::LinkState&
+LinkFeatureExtractor::GetLink(uint32_t node, uint64_t transmitter)
+{
+    return m_links
+        .emplace(std::piecewise_construct,
+                 std::forward_as_tuple(GetLinkKey(node, transmitter)),
+                 std::forward_as_tuple(m_window, m_buckets))
+        .first->second;
+}
+
+bool
+LinkFeatureExtractor::GetTransmitter(Ptr<const Packet> packet,
+                                     MpduInfo aMpdu,
+                                     Mac48Address& transmitter)
+{
+    Ptr<Packet> copy = packet->Copy();
+    if (aMpdu.type != NORMAL_MPDU)
+    {
+        AmpduSubframeHeader subframe;
+        copy->RemoveHeader(subframe);
+    }
+    WifiMacHeader header;
+    if (copy->PeekHeader(header) == 0 || header.IsCtl())
+    {
+        return false;
+    }
+    transmitter = header.GetAddr2();
+    return true;
+}
+
+void
+LinkFeatureExtractor::ExpireNeighbors(NodeState& state, Time now)
+{
+    while (!state.heardOrder.empty() && state.heardOrder.front().first <= now - m_window)
+    {
+        auto it = state.heard.find(state.heardOrder.front().second);
+        // Only forget transmitters that were not heard again since
+        if (it != state.heard.end() && it->second == state.heardOrder.front().first)
+        {
+            state.heard.erase(it);
+        }
+        state.heardOrder.pop_front();
+    }
+}
+
+void
+LinkFeatureExtractor::SnifferRx(uint32_t node,
+                                Ptr<const Packet> packet,
+                                uint16_t /* channelFreqMhz */,
+                                WifiTxVector /* txVector */,
+                                MpduInfo aMpdu,
+                                SignalNoiseDbm signalNoise,
+                                uint16_t /* staId */)
+{
+    Time now = Simulator::Now();
+    NodeState& state = m_nodes.at(node);
+    state.received.Add(now, 1.0);
+
+    Mac48Address transmitter;
+    if (!GetTransmitter(packet, aMpdu, transmitter))
+    {
+        return;
+    }
+    uint64_t key = ToInteger(transmitter);
+    LinkState& link = GetLink(node, key);
+    link.received.Add(now, 1.0);
+    link.snr.Add(now, signalNoise.signal - signalNoise.noise);
+
+    state.heard[key] = now;
+    state.heardOrder.emplace_back(now, key);
+    ExpireNeighbors(state, now);
+}
+
+void
+LinkFeatureExtractor::RxDrop(uint32_t node,
+                             Ptr<const Packet> packet,
+                             WifiPhyRxfailureReason /* reason */)
+{
+    Time now = Simulator::Now();
+    m_nodes.at(node).dropped.Add(now, 1.0);
+
+    Mac48Address transmitter;
+    if (GetTransmitter(packet, {NORMAL_MPDU, 0}, transmitter))
+    {
+        GetLink(node, ToInteger(transmitter)).dropped.Add(now, 1.0);
+    }
+}
+
+void
+LinkFeatureExtractor::PhyState(uint32_t node, Time /* start */, Time duration, WifiPhyState state)
+{
+    if (state == WifiPhyState::RX || state == WifiPhyState::TX ||
+        state == WifiPhyState::CCA_BUSY)
+    {
+        // Spread over the buckets it spans, so a state that began before the window only
+        // counts for its part inside it
+        Time now = Simulator::Now();
+        m_nodes.at(node).busy.AddIntegral(now - duration, now, 1.0);
+    }
+}
+
+void
+LinkFeatureExtractor::QueueLength(uint32_t node, uint32_t /* oldValue */, uint32_t newValue)
+{
+    Time now = Simulator::Now();
+    NodeState& state = m_nodes.at(node);
+    // Integrate the previous length over the time it lasted, bucket by bucket, so the
+    // part of a long segment that left the window does not count
+    state.queue.AddIntegral(state.queueChange, now, state.queueLength);
+    state.queueLength = newValue;
+    state.queueChange = now;
+}
+
+void
+LinkFeatureExtractor::AppendFeatures(std::vector<double>& row,
+                                     uint32_t node,
+                                     Mac48Address transmitter)
+{
+    Time now = Simulator::Now();
+    auto lossRate = [now](const SlidingWindow& received, const SlidingWindow& dropped) {
+        double lost = dropped.GetCount(now);
+        double total = lost + received.GetCount(now);
+        return total == 0 ? 0.0 : lost / total;
+    };
+
+    auto link = m_links.find(GetLinkKey(node, ToInteger(transmitter)));
+    if (link == m_links.end())
+    {
+        row.insert(row.end(), {0.0, 0.0, 0.0});
+    }
+    else
+    {
+        row.push_back(lossRate(link->second.received, link->second.dropped));
+        row.push_back(link->second.snr.GetMean(now));
+        row.push_back(link->second.snr.GetVariance(now));
+    }
+
+    auto it = m_nodes.find(node);
+    if (it == m_nodes.end())
+    {
+        row.insert(row.end(), {0.0, 0.0, 0.0, 0.0});
+        return;
+    }
+    NodeState& state = it->second;
+    ExpireNeighbors(state, now);
+    // The open segment is clipped to the window, and the integrals divided by the time
+    // the window actually covers
+    Time start = state.queue.GetStart(now);
+    double queued = state.queue.GetSum(now) +
+                    state.queueLength * (now - std::max(state.queueChange, start)).GetSeconds();
+    double covered = (now - start).GetSeconds();
+    row.push_back(lossRate(state.received, state.dropped));
+    row.push_back(covered > 0 ? state.busy.GetSum(now) / covered : 0.0);
+    row.push_back(covered > 0 ? queued / covered : state.queueLength);
+    row.push_back(state.heard.size());
+}
+
+} // namespace ns3
@@ -0,0 +1,182 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LINK_FEATURE_EXTRACTOR_H
+#define LINK_FEATURE_EXTRACTOR_H
+
+#include "sliding-window.h"
+
+#include "ns3/mac48-address.h"
+#include "ns3/net-device-container.h"
+#include "ns3/object.h"
+#include "ns3/packet.h"
+#include "ns3/wifi-phy.h"
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Online sliding-window context of the WiFi receptions of a set of devices.
+ *
+ * The extractor follows the PHY and MAC traces of every installed device and maintains,
+ * over the last Window, with O(1) amortized updates (SlidingWindow):
+ *  - per link (receiving node, transmitter address): loss rate, SNR mean and variance;
+ *  - per node: loss rate, fraction of time the channel was busy (receiving, transmitting
+ *    or CCA busy), time-averaged occupancy of the best-effort MAC queue, and the number of
+ *    distinct transmitters heard.
+ *
+ * A loss is a PhyRxDrop of a frame whose MAC header was decoded; a success is a frame
+ * delivered to the monitor sniffer. AppendFeatures adds the current values to a dataset
+ * record, in the order of GetFeatureNames.
+ */
+class LinkFeatureExtractor : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    LinkFeatureExtractor();
+    ~LinkFeatureExtractor() override;
+
+    /**
+     * \brief Follow the traces of the given WiFi devices.
+     * \param devices WifiNetDevices
+     */
+    void Install(const NetDeviceContainer& devices);
+
+    /**
+     * \return the names of the features appended by AppendFeatures
+     */
+    static std::vector<std::string> GetFeatureNames();
+
+    /**
+     * \brief Append the current features of a node and one of its incoming links.
+     *
+     * \param row the record to extend
+     * \param node id of the receiving node
+     * \param transmitter transmitter of the link; unknown links have no history
+     */
+    void AppendFeatures(std::vector<double>& row, uint32_t node, Mac48Address transmitter);
+
+    /**
+     * \brief Transmitter of a frame seen by the monitor sniffer or a PHY trace.
+     *
+     * \param packet the frame, MAC header included
+     * \param aMpdu how the frame was aggregated, since A-MPDU subframes carry a
+     *        subframe header in front of the MAC header
+     * \param transmitter receives the transmitter address
+     * \return false for frames without a transmitter address (ACK, CTS)
+     */
+    static bool GetTransmitter(Ptr<const Packet> packet,
+                               MpduInfo aMpdu,
+                               Mac48Address& transmitter);
+
+  private:
+    /// Window aggregates of one link
+    struct LinkState
+    {
+        /**
+         * \param window window length
+         * \param buckets buckets per window
+         */
+        LinkState(Time window, uint32_t buckets);
+
+        SlidingWindow received; //!< delivered frames
+        SlidingWindow dropped;  //!< lost frames
+        SlidingWindow snr;      //!< SNR of the delivered frames, dB
+    };
+
+    /// Window aggregates of one node
+    struct NodeState
+    {
+        /**
+         * \param window window length
+         * \param buckets buckets per window
+         */
+        NodeState(Time window, uint32_t buckets);
+
+        SlidingWindow received;   //!< delivered frames
+        SlidingWindow dropped;    //!< lost frames
+        SlidingWindow busy;       //!< busy time, s
+        SlidingWindow queue;      //!< queue length times its duration, packet s
+        uint32_t queueLength;     //!< current queue length
+        Time queueChange;         //!< last queue length change
+        std::unordered_map<uint64_t, Time> heard;         //!< transmitter -> last heard
+        std::deque<std::pair<Time, uint64_t>> heardOrder; //!< hearing events, oldest first
+    };
+
+    /**
+     * Node ids must stay below 2^16 for the keys to be unique.
+     * \param node node id
+     * \param transmitter transmitter address, as an integer
+     * \return the key of the link
+     */
+    static uint64_t GetLinkKey(uint32_t node, uint64_t transmitter);
+
+    /**
+     * \param address a MAC address
+     * \return the address as an integer
+     */
+    static uint64_t ToInteger(Mac48Address address);
+
+    /**
+     * \param node node id
+     * \param transmitter transmitter address, as an integer
+     * \return the state of the link, created on first use
+     */
+    LinkState& GetLink(uint32_t node, uint64_t transmitter);
+
+    /**
+     * Forget the transmitters a node has not heard for a window.
+     * \param state the node
+     * \param now current time
+     */
+    void ExpireNeighbors(NodeState& state, Time now);
+
+    /// MonitorSnifferRx trace sink, bound to the receiving node
+    void SnifferRx(uint32_t node,
+                   Ptr<const Packet> packet,
+                   uint16_t channelFreqMhz,
+                   WifiTxVector txVector,
+                   MpduInfo aMpdu,
+                   SignalNoiseDbm signalNoise,
+                   uint16_t staId);
+
+    /// PhyRxDrop trace sink, bound to the receiving node
+    void RxDrop(uint32_t node, Ptr<const Packet> packet, WifiPhyRxfailureReason reason);
+
+    /// WifiPhyStateHelper State trace sink, bound to the node
+    void PhyState(uint32_t node, Time start, Time duration, WifiPhyState state);
+
+    /// PacketsInQueue trace sink of the best-effort queue, bound to the node
+    void QueueLength(uint32_t node, uint32_t oldValue, uint32_t newValue);
+
+    Time m_window;                                    //!< window length
+    uint32_t m_buckets;                               //!< buckets per window
+    std::unordered_map<uint32_t, NodeState> m_nodes;  //!< per node state
+    std::unordered_map<uint64_t, LinkState> m_links;  //!< per link state
+};
+
+} // namespace ns3
+
+#endif /* LINK_FEATURE_EXTRACTOR_H */
@@ -0,0 +1,216 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "link-quality-monitor.h"
+
+#include "link-feature-extractor.h"
+
+#include "ns3/log.h"
+#include "ns3/node-list.h"
+#include "ns3/simulator.h"
+#include "ns3/sta-wifi-mac.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-remote-station-manager.h"
+
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LinkQualityMonitor");
+
+NS_OBJECT_ENSURE_REGISTERED(LinkQualityMonitor);
+
+TypeId
+LinkQualityMonitor::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::LinkQualityMonitor")
+            .SetParent<Object>()
+            .AddConstructor<LinkQualityMonitor>()
+            .AddAttribute("TimeConstant",
+                          "Time constant of the RSSI and RSSI trend smoothing.",
+                          TimeValue(Seconds(1.0)),
+                          MakeTimeAccessor(&LinkQualityMonitor::m_timeConstant),
+                          MakeTimeChecker(MilliSeconds(1)))
+            .AddAttribute("RetryWindow",
+                          "Window over which the MAC retry rate is measured.",
+                          TimeValue(Seconds(1.0)),
+                          MakeTimeAccessor(&LinkQualityMonitor::m_retryWindow),
+                          MakeTimeChecker(MilliSeconds(1)));
+    return tid;
+}
+
+LinkQualityMonitor::LinkQualityMonitor()
+    : m_bssid(Mac48Address::GetBroadcast()),
+      m_associated(false),
+      m_everAssociated(false),
+      m_rssi(0.0),
+      m_trend(0.0),
+      m_hasRssi(false),
+      m_lastHandover(Seconds(-1.0))
+{
+    NS_LOG_FUNCTION(this);
+}
+
+LinkQualityMonitor::~LinkQualityMonitor()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+LinkQualityMonitor::Install(const NetDeviceContainer& devices)
+{
+    for (uint32_t i = 0; i < devices.GetN(); ++i)
+    {
+        Ptr<WifiNetDevice> wifi = DynamicCast<WifiNetDevice>(devices.Get(i));
+        Ptr<StaWifiMac> mac;
+        if (wifi)
+        {
+            mac = DynamicCast<StaWifiMac>(wifi->GetMac());
+        }
+        if (!mac)
+        {
+            continue;
+        }
+        Ptr<LinkQualityMonitor> monitor = CreateObject<LinkQualityMonitor>();
+        // Attributes are set by now, so the retry window can be sized
+        monitor->m_retries = SlidingWindow(monitor->m_retryWindow);
+        wifi->GetNode()->AggregateObject(monitor);
+
+        wifi->GetPhy()->TraceConnectWithoutContext(
+            "MonitorSnifferRx",
+            MakeCallback(&LinkQualityMonitor::SnifferRx, monitor));
+        wifi->GetRemoteStationManager()->TraceConnectWithoutContext(
+            "MacTxDataFailed",
+            MakeCallback(&LinkQualityMonitor::TxDataFailed, monitor));
+        mac->TraceConnectWithoutContext("Assoc",
+                                        MakeCallback(&LinkQualityMonitor::Associated, monitor));
+        mac->TraceConnectWithoutContext("DeAssoc",
+                                        MakeCallback(&LinkQualityMonitor::Disassociated, monitor));
+    }
+}
+
+Ptr<LinkQualityMonitor>
+LinkQualityMonitor::Get(uint32_t node)
+{
+    if (node >= NodeList::GetNNodes())
+    {
+        return nullptr;
+    }
+    return NodeList::GetNode(node)->GetObject<LinkQualityMonitor>();
+}
+
+double
+LinkQualityMonitor::GetRssi() const
+{
+    return m_rssi;
+}
+
+double
+LinkQualityMonitor::GetRssiTrend() const
+{
+    return m_trend;
+}
+
+double
+LinkQualityMonitor::GetRetryRate() const
+{
+    return m_retries.GetCount(Simulator::Now()) / m_retries.GetWindow().GetSeconds();
+}
+
+Time
+LinkQualityMonitor::GetLastHandover() const
+{
+    return m_lastHandover;
+}
+
+bool
+LinkQualityMonitor::HasRssi() const
+{
+    return m_hasRssi;
+}
+
+void
+LinkQualityMonitor::SnifferRx(Ptr<const Packet> packet,
+                              uint16_t /* channelFreqMhz */,
+                              WifiTxVector /* txVector */,
+                              MpduInfo aMpdu,
+                              SignalNoiseDbm signalNoise,
+                              uint16_t /* staId */)
+{
+    Mac48Address transmitter;
+    if (!m_associated || !LinkFeatureExtractor::GetTransmitter(packet, aMpdu, transmitter) ||
+        transmitter != m_bssid)
+    {
+        return;
+    }
+
+    Time now = Simulator::Now();
+    if (!m_hasRssi)
+    {
+        m_rssi = signalNoise.signal;
+        m_trend = 0.0;
+        m_hasRssi = true;
+        m_lastSample = now;
+        return;
+    }
+    double dt = (now - m_lastSample).GetSeconds();
+    if (dt <= 0.0)
+    {
+        return;
+    }
+    // Exponential smoothing over irregular samples: the weight of a sample grows with the
+    // time since the previous one, and the trend smooths the slope of the level
+    double weight = 1.0 - std::exp(-dt / m_timeConstant.GetSeconds());
+    double level = m_rssi + weight * (signalNoise.signal - m_rssi);
+    m_trend += weight * ((level - m_rssi) / dt - m_trend);
+    m_rssi = level;
+    m_lastSample = now;
+}
+
+void
+LinkQualityMonitor::TxDataFailed(Mac48Address /* address */)
+{
+    m_retries.Add(Simulator::Now(), 1.0);
+}
+
+void
+LinkQualityMonitor::Associated(Mac48Address bssid)
+{
+    NS_LOG_FUNCTION(this << bssid);
+    if (m_everAssociated && bssid != m_bssid)
+    {
+        m_lastHandover = Simulator::Now();
+    }
+    if (bssid != m_bssid)
+    {
+        // The RSSI history belongs to the previous AP
+        m_hasRssi = false;
+    }
+    m_bssid = bssid;
+    m_associated = true;
+    m_everAssociated = true;
+}
+
+void
+LinkQualityMonitor::Disassociated(Mac48Address bssid)
+{
+    NS_LOG_FUNCTION(this << bssid);
+    m_associated = false;
+    m_lastHandover = Simulator::Now();
+}
+
+} // namespace ns3
@@ -0,0 +1,129 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LINK_QUALITY_MONITOR_H
+#define LINK_QUALITY_MONITOR_H
+
+#include "sliding-window.h"
+
+#include "ns3/mac48-address.h"
+#include "ns3/net-device-container.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/wifi-phy.h"
+
+namespace ns3
+{
+
+/**
+ * \brief Link-layer view of a station's link to its access point.
+ *
+ * The monitor is aggregated to the node of a WiFi station and follows:
+ *  - the RSSI of the frames received from the associated AP (beacons, ACKs, data),
+ *    smoothed with time constant TimeConstant, and its trend in dB/s;
+ *  - the failed data transmission attempts (MAC retries) over the last RetryWindow;
+ *  - association changes: every association after the first and every disassociation
+ *    counts as a handover.
+ *
+ * Transport protocols of the node look the monitor up with Get(node id), e.g. with the
+ * id of the simulation context they run in, to tell losses caused by the station moving
+ * away from its AP from congestion.
+ */
+class LinkQualityMonitor : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    LinkQualityMonitor();
+    ~LinkQualityMonitor() override;
+
+    /**
+     * \brief Aggregate a monitor to the node of every station device.
+     *
+     * Devices without a StaWifiMac (APs, other technologies) are skipped.
+     *
+     * \param devices WiFi devices
+     */
+    static void Install(const NetDeviceContainer& devices);
+
+    /**
+     * \param node node id
+     * \return the monitor of the node, or null
+     */
+    static Ptr<LinkQualityMonitor> Get(uint32_t node);
+
+    /**
+     * \return the smoothed RSSI of the AP, dBm
+     */
+    double GetRssi() const;
+
+    /**
+     * \return the RSSI trend, dB/s; negative when the station moves away
+     */
+    double GetRssiTrend() const;
+
+    /**
+     * \return the failed data transmissions per second over the last RetryWindow
+     */
+    double GetRetryRate() const;
+
+    /**
+     * \return the time of the last handover, negative if none
+     */
+    Time GetLastHandover() const;
+
+    /**
+     * \return true once an RSSI sample of the AP was received
+     */
+    bool HasRssi() const;
+
+  private:
+    /// MonitorSnifferRx trace sink
+    void SnifferRx(Ptr<const Packet> packet,
+                   uint16_t channelFreqMhz,
+                   WifiTxVector txVector,
+                   MpduInfo aMpdu,
+                   SignalNoiseDbm signalNoise,
+                   uint16_t staId);
+
+    /// MacTxDataFailed trace sink
+    void TxDataFailed(Mac48Address address);
+
+    /// Assoc trace sink
+    void Associated(Mac48Address bssid);
+
+    /// DeAssoc trace sink
+    void Disassociated(Mac48Address bssid);
+
+    Time m_timeConstant;      //!< RSSI smoothing time constant
+    Time m_retryWindow;       //!< window of the retry rate
+    Mac48Address m_bssid;     //!< current AP, broadcast when not associated
+    bool m_associated;        //!< true when associated
+    bool m_everAssociated;    //!< true after the first association
+    double m_rssi;            //!< smoothed RSSI, dBm
+    double m_trend;           //!< smoothed RSSI slope, dB/s
+    Time m_lastSample;        //!< time of the last RSSI sample
+    bool m_hasRssi;           //!< an RSSI sample was received
+    SlidingWindow m_retries;  //!< failed data transmissions
+    Time m_lastHandover;      //!< last handover, negative if none
+};
+
+} // namespace ns3
+
+#endif /* LINK_QUALITY_MONITOR_H */
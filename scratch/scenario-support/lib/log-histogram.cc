@@ -0,0 +1,199 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "log-histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+LogHistogram::LogHistogram(uint32_t subBucketBits, uint32_t maxBits)
+    : m_subBucketBits(subBucketBits),
+      m_maxBits(std::max(maxBits, subBucketBits + 1)),
+      m_counts((m_maxBits - m_subBucketBits + 1) << m_subBucketBits, 0),
+      m_count(0),
+      m_min(0),
+      m_max(0),
+      m_sum(0.0)
+{
+}
+
+uint32_t
+LogHistogram::GetBucketIndex(uint64_t value) const
+{
+    uint64_t subBuckets = uint64_t{1} << m_subBucketBits;
+    if (value < subBuckets)
+    {
+        return static_cast<uint32_t>(value);
+    }
+    uint32_t msb = 63 - __builtin_clzll(value);
+    if (msb >= m_maxBits)
+    {
+        return m_counts.size() - 1;
+    }
+    uint64_t mantissa = value >> (msb - m_subBucketBits);
+    return static_cast<uint32_t>(((msb - m_subBucketBits + 1) << m_subBucketBits) +
+                                 (mantissa - subBuckets));
+}
+
+void
+LogHistogram::Record(uint64_t value)
+{
+    if (m_count == 0)
+    {
+        m_min = value;
+        m_max = value;
+    }
+    else
+    {
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+    ++m_count;
+    m_sum += static_cast<double>(value);
+    ++m_counts[GetBucketIndex(value)];
+}
+
+void
+LogHistogram::Merge(const LogHistogram& other)
+{
+    if (other.m_count == 0)
+    {
+        return;
+    }
+    if (m_count == 0)
+    {
+        m_min = other.m_min;
+        m_max = other.m_max;
+    }
+    else
+    {
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+    }
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    for (size_t i = 0; i < m_counts.size() && i < other.m_counts.size(); ++i)
+    {
+        m_counts[i] += other.m_counts[i];
+    }
+}
+
+void
+LogHistogram::Reset()
+{
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_count = 0;
+    m_min = 0;
+    m_max = 0;
+    m_sum = 0.0;
+}
+
+uint64_t
+LogHistogram::GetCount() const
+{
+    return m_count;
+}
+
+uint64_t
+LogHistogram::GetMin() const
+{
+    return m_min;
+}
+
+uint64_t
+LogHistogram::GetMax() const
+{
+    return m_max;
+}
+
+double
+LogHistogram::GetMean() const
+{
+    return m_count == 0 ? 0.0 : m_sum / m_count;
+}
+
+uint64_t
+LogHistogram::GetQuantile(double quantile) const
+{
+    if (m_count == 0)
+    {
+        return 0;
+    }
+    quantile = std::clamp(quantile, 0.0, 1.0);
+    auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * m_count)));
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < m_counts.size(); ++i)
+    {
+        seen += m_counts[i];
+        if (seen >= rank)
+        {
+            if (i == m_counts.size() - 1)
+            {
+                return m_max; // clamped bucket, no meaningful midpoint
+            }
+            uint64_t lower = GetBucketLowerBound(i);
+            uint64_t mid = lower + (GetBucketUpperBound(i) - lower) / 2;
+            return std::clamp(mid, m_min, m_max);
+        }
+    }
+    return m_max;
+}
+
+uint32_t
+LogHistogram::GetNBuckets() const
+{
+    return m_counts.size();
+}
+
+uint64_t
+LogHistogram::GetBucketCount(uint32_t index) const
+{
+    return m_counts.at(index);
+}
+
+uint64_t
+LogHistogram::GetBucketLowerBound(uint32_t index) const
+{
+    uint64_t subBuckets = uint64_t{1} << m_subBucketBits;
+    if (index < subBuckets)
+    {
+        return index;
+    }
+    uint32_t group = index >> m_subBucketBits;
+    uint64_t mantissa = subBuckets + (index & (subBuckets - 1));
+    return mantissa << (group - 1);
+}
+
+uint64_t
+LogHistogram::GetBucketUpperBound(uint32_t index) const
+{
+    uint64_t subBuckets = uint64_t{1} << m_subBucketBits;
+    if (index < subBuckets)
+    {
+        return index;
+    }
+    if (index == m_counts.size() - 1)
+    {
+        return UINT64_MAX;
+    }
+    uint32_t group = index >> m_subBucketBits;
+    uint64_t mantissa = subBuckets + (index & (subBuckets - 1));
+    return ((mantissa + 1) << (group - 1)) - 1;
+}
+
+} // namespace ns3
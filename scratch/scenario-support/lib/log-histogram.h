@@ -0,0 +1,131 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LOG_HISTOGRAM_H
+#define LOG_HISTOGRAM_H
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Fixed-memory histogram with logarithmic buckets (HDR histogram layout).
+ *
+ * Values below 2^SubBucketBits are counted exactly. Above that, every power of two is split
+ * into 2^SubBucketBits linear sub-buckets, so any recorded value is known to within a
+ * relative error of 2^-SubBucketBits (about 3% for the default of 5 bits). Values above
+ * 2^MaxBits - 1 are clamped into the last bucket, while the exact minimum, maximum and sum
+ * are kept on the side.
+ *
+ * Memory does not depend on the number of recorded values, and two histograms with the
+ * same layout can be merged.
+ */
+class LogHistogram
+{
+  public:
+    /**
+     * \param subBucketBits log2 of the number of sub-buckets per power of two
+     * \param maxBits values are tracked up to 2^maxBits - 1
+     */
+    LogHistogram(uint32_t subBucketBits = 5, uint32_t maxBits = 44);
+
+    /**
+     * \param value the value to record
+     */
+    void Record(uint64_t value);
+
+    /**
+     * \brief Add every count of another histogram with the same layout.
+     * \param other the histogram to merge
+     */
+    void Merge(const LogHistogram& other);
+
+    /// Forget every recorded value
+    void Reset();
+
+    /**
+     * \return the number of recorded values
+     */
+    uint64_t GetCount() const;
+
+    /**
+     * \return the smallest recorded value, 0 if empty
+     */
+    uint64_t GetMin() const;
+
+    /**
+     * \return the largest recorded value, 0 if empty
+     */
+    uint64_t GetMax() const;
+
+    /**
+     * \return the mean of the recorded values, 0 if empty
+     */
+    double GetMean() const;
+
+    /**
+     * \brief Value below which the given fraction of the recorded values lie.
+     *
+     * The result is the midpoint of the bucket holding that rank, clamped to [min, max].
+     *
+     * \param quantile quantile in [0, 1]
+     * \return the estimated value, 0 if empty
+     */
+    uint64_t GetQuantile(double quantile) const;
+
+    /**
+     * \return the number of buckets
+     */
+    uint32_t GetNBuckets() const;
+
+    /**
+     * \param index bucket index
+     * \return the number of values in the bucket
+     */
+    uint64_t GetBucketCount(uint32_t index) const;
+
+    /**
+     * \param index bucket index
+     * \return the smallest value that falls into the bucket
+     */
+    uint64_t GetBucketLowerBound(uint32_t index) const;
+
+    /**
+     * \param index bucket index
+     * \return the largest value that falls into the bucket
+     */
+    uint64_t GetBucketUpperBound(uint32_t index) const;
+
+  private:
+    /**
+     * \param value a value
+     * \return the bucket of the value
+     */
+    uint32_t GetBucketIndex(uint64_t value) const;
+
+    uint32_t m_subBucketBits;       //!< log2 of the sub-buckets per power of two
+    uint32_t m_maxBits;             //!< tracked range, in bits
+    std::vector<uint64_t> m_counts; //!< bucket counts
+    uint64_t m_count;               //!< number of values
+    uint64_t m_min;                 //!< smallest value
+    uint64_t m_max;                 //!< largest value
+    double m_sum;                   //!< sum of the values
+};
+
+} // namespace ns3
+
+#endif /* LOG_HISTOGRAM_H */
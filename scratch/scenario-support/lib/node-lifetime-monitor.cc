@@ -0,0 +1,292 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "node-lifetime-monitor.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/ipv4.h"
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+#include "ns3/onoff-application.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/wifi-radio-energy-model.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NodeLifetimeMonitor");
+
+NS_OBJECT_ENSURE_REGISTERED(NodeLifetimeMonitor);
+
+TypeId
+NodeLifetimeMonitor::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::NodeLifetimeMonitor")
+            .SetParent<Object>()
+            .AddConstructor<NodeLifetimeMonitor>()
+            .AddAttribute("SampleInterval",
+                          "Interval between two alive/coverage samples.",
+                          TimeValue(Seconds(1.0)),
+                          MakeTimeAccessor(&NodeLifetimeMonitor::m_interval),
+                          MakeTimeChecker())
+            .AddAttribute("SensingRange",
+                          "Radius (m) around an alive node that counts as covered.",
+                          DoubleValue(20.0),
+                          MakeDoubleAccessor(&NodeLifetimeMonitor::m_sensingRange),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("GridResolution",
+                          "Cell size (m) of the raster used to estimate area coverage.",
+                          DoubleValue(2.5),
+                          MakeDoubleAccessor(&NodeLifetimeMonitor::m_gridResolution),
+                          MakeDoubleChecker<double>(0.1))
+            .AddTraceSource("NodeDeath",
+                            "A registered node ran out of energy and left the network.",
+                            MakeTraceSourceAccessor(&NodeLifetimeMonitor::m_nodeDeathTrace),
+                            "ns3::NodeLifetimeMonitor::NodeDeathTracedCallback");
+    return tid;
+}
+
+NodeLifetimeMonitor::NodeLifetimeMonitor()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+NodeLifetimeMonitor::~NodeLifetimeMonitor()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+NodeLifetimeMonitor::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_sampleEvent.Cancel();
+    if (m_output.is_open())
+    {
+        m_output.close();
+    }
+    m_nodes.clear();
+    Object::DoDispose();
+}
+
+void
+NodeLifetimeMonitor::Install(const NetDeviceContainer& devices,
+                             const energy::DeviceEnergyModelContainer& models)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_UNLESS(devices.GetN() == models.GetN(),
+                        "Expected one radio energy model per device");
+
+    for (uint32_t i = 0; i < devices.GetN(); ++i)
+    {
+        Ptr<WifiRadioEnergyModel> model =
+            DynamicCast<WifiRadioEnergyModel>(models.Get(i));
+        if (!model)
+        {
+            NS_LOG_WARN("Device " << i << " has no WifiRadioEnergyModel, not monitored");
+            continue;
+        }
+        uint32_t index = m_nodes.size();
+        m_nodes.push_back({devices.Get(i)->GetNode(), devices.Get(i), true});
+
+        // Replace the helper's default (switch the PHY off / back on) with a permanent death
+        model->SetEnergyDepletionCallback(
+            MakeCallback(&NodeLifetimeMonitor::HandleEnergyDepletion, this).Bind(index));
+        model->SetEnergyRechargedCallback(MakeNullCallback<void>());
+    }
+}
+
+void
+NodeLifetimeMonitor::EnableTimeSeries(const std::string& fileName)
+{
+    NS_LOG_FUNCTION(this << fileName);
+    m_output.open(fileName);
+    NS_ABORT_MSG_UNLESS(m_output.is_open(), "Could not open " << fileName);
+}
+
+void
+NodeLifetimeMonitor::Start(Time start)
+{
+    NS_LOG_FUNCTION(this << start);
+    m_sampleEvent.Cancel();
+    m_sampleEvent = Simulator::Schedule(start, &NodeLifetimeMonitor::Sample, this);
+}
+
+uint32_t
+NodeLifetimeMonitor::GetNNodes() const
+{
+    return m_nodes.size();
+}
+
+uint32_t
+NodeLifetimeMonitor::GetNDead() const
+{
+    return m_deaths.size();
+}
+
+Time
+NodeLifetimeMonitor::GetDeathTime(double fraction) const
+{
+    NS_ASSERT(fraction > 0.0 && fraction <= 1.0);
+    auto needed = static_cast<size_t>(std::ceil(fraction * m_nodes.size()));
+    needed = std::max<size_t>(needed, 1);
+    if (m_deaths.size() < needed)
+    {
+        return Seconds(-1.0);
+    }
+    return m_deaths[needed - 1];
+}
+
+Time
+NodeLifetimeMonitor::GetFirstNodeDeath() const
+{
+    return m_deaths.empty() ? Seconds(-1.0) : m_deaths.front();
+}
+
+Time
+NodeLifetimeMonitor::GetHalfNetworkDeath() const
+{
+    return GetDeathTime(0.5);
+}
+
+double
+NodeLifetimeMonitor::GetCoverage() const
+{
+    if (m_nodes.empty())
+    {
+        return 0.0;
+    }
+
+    // The deployment area is the bounding box of every registered node, dead or alive
+    double minX = INFINITY;
+    double minY = INFINITY;
+    double maxX = -INFINITY;
+    double maxY = -INFINITY;
+    std::vector<Vector> alive;
+    for (const auto& state : m_nodes)
+    {
+        Vector pos = state.node->GetObject<MobilityModel>()->GetPosition();
+        minX = std::min(minX, pos.x);
+        minY = std::min(minY, pos.y);
+        maxX = std::max(maxX, pos.x);
+        maxY = std::max(maxY, pos.y);
+        if (state.alive)
+        {
+            alive.push_back(pos);
+        }
+    }
+
+    auto cols = static_cast<int64_t>(std::ceil((maxX - minX) / m_gridResolution)) + 1;
+    auto rows = static_cast<int64_t>(std::ceil((maxY - minY) / m_gridResolution)) + 1;
+    std::vector<bool> covered(cols * rows, false);
+
+    // Rasterize the disk of every alive node rather than testing every cell against every node
+    int64_t reach = static_cast<int64_t>(std::ceil(m_sensingRange / m_gridResolution));
+    double range2 = m_sensingRange * m_sensingRange;
+    for (const auto& pos : alive)
+    {
+        auto cx = static_cast<int64_t>(std::floor((pos.x - minX) / m_gridResolution));
+        auto cy = static_cast<int64_t>(std::floor((pos.y - minY) / m_gridResolution));
+        for (int64_t y = std::max<int64_t>(0, cy - reach); y <= std::min(rows - 1, cy + reach); ++y)
+        {
+            double dy = minY + (y + 0.5) * m_gridResolution - pos.y;
+            for (int64_t x = std::max<int64_t>(0, cx - reach); x <= std::min(cols - 1, cx + reach);
+                 ++x)
+            {
+                double dx = minX + (x + 0.5) * m_gridResolution - pos.x;
+                if (dx * dx + dy * dy <= range2)
+                {
+                    covered[y * cols + x] = true;
+                }
+            }
+        }
+    }
+    return static_cast<double>(std::count(covered.begin(), covered.end(), true)) /
+           covered.size();
+}
+
+void
+NodeLifetimeMonitor::HandleEnergyDepletion(uint32_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+    NodeState& state = m_nodes[index];
+    if (!state.alive)
+    {
+        return;
+    }
+    state.alive = false;
+    m_deaths.push_back(Simulator::Now());
+    NS_LOG_INFO("Node " << state.node->GetId() << " depleted at "
+                        << Simulator::Now().As(Time::S) << ", " << m_deaths.size() << "/"
+                        << m_nodes.size() << " nodes dead");
+    ShutDown(state);
+    m_nodeDeathTrace(state.node);
+}
+
+void
+NodeLifetimeMonitor::ShutDown(NodeState& state)
+{
+    Ptr<WifiNetDevice> wifi = DynamicCast<WifiNetDevice>(state.device);
+    if (wifi)
+    {
+        wifi->GetPhy()->SetOffMode();
+    }
+
+    // Taking the interface down lets AODV/global routing drop routes through this node
+    Ptr<Ipv4> ipv4 = state.node->GetObject<Ipv4>();
+    if (ipv4)
+    {
+        int32_t interface = ipv4->GetInterfaceForDevice(state.device);
+        if (interface >= 0)
+        {
+            ipv4->SetDown(interface);
+        }
+    }
+
+    // OnOffApplication has no public stop; once MaxBytes is reached it stops itself
+    // and closes its socket at the next scheduled transmission
+    for (uint32_t i = 0; i < state.node->GetNApplications(); ++i)
+    {
+        Ptr<OnOffApplication> onOff = DynamicCast<OnOffApplication>(state.node->GetApplication(i));
+        if (onOff)
+        {
+            onOff->SetAttribute("MaxBytes", UintegerValue(1));
+        }
+    }
+}
+
+void
+NodeLifetimeMonitor::Sample()
+{
+    NS_LOG_FUNCTION(this);
+    uint32_t aliveCount = m_nodes.size() - m_deaths.size();
+    if (m_output.is_open())
+    {
+        double fraction = m_nodes.empty() ? 0.0 : static_cast<double>(aliveCount) / m_nodes.size();
+        m_output << Simulator::Now().GetSeconds() << "\t" << aliveCount << "\t" << fraction
+                 << "\t" << GetCoverage() << std::endl;
+    }
+    m_sampleEvent = Simulator::Schedule(m_interval, &NodeLifetimeMonitor::Sample, this);
+}
+
+} // namespace ns3
@@ -0,0 +1,164 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NODE_LIFETIME_MONITOR_H
+#define NODE_LIFETIME_MONITOR_H
+
+#include "ns3/device-energy-model-container.h"
+#include "ns3/event-id.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/traced-callback.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Handles energy depletion of a group of nodes and derives network lifetime metrics.
+ *
+ * When the energy source behind one of the registered WiFi devices drains, the node is
+ * taken out of the network: its radio is switched off, its IPv4 interfaces are brought
+ * down so that routing stops using it, and its OnOff applications are stopped. A death is
+ * permanent, even if the source is later recharged.
+ *
+ * The monitor keeps the time of each death, from which first-node-death and
+ * half-network-death are derived, and periodically samples the fraction of nodes still
+ * alive together with the fraction of the deployment area that is still within
+ * SensingRange of an alive node.
+ */
+class NodeLifetimeMonitor : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    NodeLifetimeMonitor();
+    ~NodeLifetimeMonitor() override;
+
+    /**
+     * \brief Register nodes whose radio energy models were installed by
+     * WifiRadioEnergyModelHelper.
+     *
+     * \param devices the WiFi devices passed to the energy model helper
+     * \param models the models returned by the helper, in the same order as devices
+     */
+    void Install(const NetDeviceContainer& devices,
+                 const energy::DeviceEnergyModelContainer& models);
+
+    /**
+     * \brief Write a sample every SampleInterval to the given file.
+     *
+     * Columns: time, alive nodes, alive fraction, area coverage.
+     *
+     * \param fileName the time series output file
+     */
+    void EnableTimeSeries(const std::string& fileName);
+
+    /**
+     * \brief Start periodic sampling.
+     * \param start time of the first sample
+     */
+    void Start(Time start);
+
+    /**
+     * \return the number of registered nodes
+     */
+    uint32_t GetNNodes() const;
+
+    /**
+     * \return the number of registered nodes that have died so far
+     */
+    uint32_t GetNDead() const;
+
+    /**
+     * \brief Time at which the given fraction of the registered nodes had died.
+     *
+     * \param fraction fraction of the network, in (0, 1]
+     * \return the death time, or a negative time if it was not reached
+     */
+    Time GetDeathTime(double fraction) const;
+
+    /**
+     * \return the time of the first node death, or a negative time
+     */
+    Time GetFirstNodeDeath() const;
+
+    /**
+     * \return the time at which half of the nodes had died, or a negative time
+     */
+    Time GetHalfNetworkDeath() const;
+
+    /**
+     * \return the fraction of the deployment area currently covered by alive nodes
+     */
+    double GetCoverage() const;
+
+    /**
+     * TracedCallback signature for node deaths.
+     *
+     * \param [in] node the node whose energy source drained
+     */
+    typedef void (*NodeDeathTracedCallback)(Ptr<Node> node);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Per-node bookkeeping
+    struct NodeState
+    {
+        Ptr<Node> node;        //!< the monitored node
+        Ptr<NetDevice> device; //!< the WiFi device powered by the source
+        bool alive;            //!< false once the source drained
+    };
+
+    /**
+     * Energy depletion callback of one radio energy model.
+     * \param index index of the node in m_nodes
+     */
+    void HandleEnergyDepletion(uint32_t index);
+
+    /**
+     * Take a node out of the network.
+     * \param state the node to shut down
+     */
+    void ShutDown(NodeState& state);
+
+    /// Record one time series sample and reschedule
+    void Sample();
+
+    Time m_interval;            //!< sampling interval
+    double m_sensingRange;      //!< coverage radius of a node, in meters
+    double m_gridResolution;    //!< coverage raster cell size, in meters
+    std::vector<NodeState> m_nodes; //!< registered nodes
+    std::vector<Time> m_deaths;     //!< death times, in order
+    std::ofstream m_output;     //!< time series output
+    EventId m_sampleEvent;      //!< next sample
+
+    TracedCallback<Ptr<Node>> m_nodeDeathTrace; //!< fired when a node dies
+};
+
+} // namespace ns3
+
+#endif /* NODE_LIFETIME_MONITOR_H */
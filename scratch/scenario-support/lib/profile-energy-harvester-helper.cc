@@ -0,0 +1,64 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "profile-energy-harvester-helper.h"
+
+#include "profile-energy-harvester.h"
+
+#include "ns3/energy-source.h"
+
+namespace ns3
+{
+
+ProfileEnergyHarvesterHelper::ProfileEnergyHarvesterHelper()
+{
+    m_harvester.SetTypeId("ns3::ProfileEnergyHarvester");
+}
+
+ProfileEnergyHarvesterHelper::~ProfileEnergyHarvesterHelper()
+{
+}
+
+void
+ProfileEnergyHarvesterHelper::Set(std::string name, const AttributeValue& v)
+{
+    m_harvester.Set(name, v);
+}
+
+void
+ProfileEnergyHarvesterHelper::Start(const energy::EnergyHarvesterContainer& harvesters, Time start)
+{
+    for (auto it = harvesters.Begin(); it != harvesters.End(); ++it)
+    {
+        Ptr<ProfileEnergyHarvester> harvester = DynamicCast<ProfileEnergyHarvester>(*it);
+        if (harvester)
+        {
+            harvester->Start(start);
+        }
+    }
+}
+
+Ptr<energy::EnergyHarvester>
+ProfileEnergyHarvesterHelper::DoInstall(Ptr<energy::EnergySource> source) const
+{
+    NS_ASSERT(source);
+    Ptr<energy::EnergyHarvester> harvester = m_harvester.Create<energy::EnergyHarvester>();
+    source->ConnectEnergyHarvester(harvester);
+    harvester->SetNode(source->GetNode());
+    harvester->SetEnergySource(source);
+    return harvester;
+}
+
+} // namespace ns3
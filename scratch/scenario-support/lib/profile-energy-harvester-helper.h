@@ -0,0 +1,62 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PROFILE_ENERGY_HARVESTER_HELPER_H
+#define PROFILE_ENERGY_HARVESTER_HELPER_H
+
+#include "ns3/energy-harvester-helper.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+
+namespace ns3
+{
+
+/**
+ * \brief Installs a ProfileEnergyHarvester on each energy source.
+ *
+ * Installed harvesters produce nothing until they are started, e.g. with Start.
+ */
+class ProfileEnergyHarvesterHelper : public EnergyHarvesterHelper
+{
+  public:
+    ProfileEnergyHarvesterHelper();
+    ~ProfileEnergyHarvesterHelper() override;
+
+    /**
+     * \param name the name of the ProfileEnergyHarvester attribute to set
+     * \param v the value of the attribute
+     */
+    void Set(std::string name, const AttributeValue& v) override;
+
+    /**
+     * \brief Start every ProfileEnergyHarvester of a container.
+     * \param harvesters harvesters returned by Install
+     * \param start time of the first power evaluation
+     */
+    static void Start(const energy::EnergyHarvesterContainer& harvesters, Time start);
+
+  private:
+    /**
+     * \param source the energy source the harvester recharges
+     * \return the newly created harvester
+     */
+    Ptr<energy::EnergyHarvester> DoInstall(Ptr<energy::EnergySource> source) const override;
+
+    ObjectFactory m_harvester; //!< harvester factory
+};
+
+} // namespace ns3
+
+#endif /* PROFILE_ENERGY_HARVESTER_HELPER_H */
@@ -0,0 +1,241 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "profile-energy-harvester.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/energy-source.h"
+#include "ns3/enum.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ProfileEnergyHarvester");
+
+NS_OBJECT_ENSURE_REGISTERED(ProfileEnergyHarvester);
+
+TypeId
+ProfileEnergyHarvester::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::ProfileEnergyHarvester")
+            .SetParent<energy::EnergyHarvester>()
+            .AddConstructor<ProfileEnergyHarvester>()
+            .AddAttribute("Profile",
+                          "Shape of the harvested power over time.",
+                          EnumValue(ProfileEnergyHarvester::SOLAR),
+                          MakeEnumAccessor<Profile>(&ProfileEnergyHarvester::m_profile),
+                          MakeEnumChecker(ProfileEnergyHarvester::SOLAR,
+                                          "Solar",
+                                          ProfileEnergyHarvester::TRACE,
+                                          "Trace"))
+            .AddAttribute("PeakPower",
+                          "Solar profile: harvested power (W) at solar noon.",
+                          DoubleValue(0.05),
+                          MakeDoubleAccessor(&ProfileEnergyHarvester::m_peakPower),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("Sunrise",
+                          "Solar profile: hour of sunrise.",
+                          DoubleValue(6.0),
+                          MakeDoubleAccessor(&ProfileEnergyHarvester::m_sunrise),
+                          MakeDoubleChecker<double>(0.0, 24.0))
+            .AddAttribute("Sunset",
+                          "Solar profile: hour of sunset.",
+                          DoubleValue(18.0),
+                          MakeDoubleAccessor(&ProfileEnergyHarvester::m_sunset),
+                          MakeDoubleChecker<double>(0.0, 24.0))
+            .AddAttribute("StartHour",
+                          "Solar profile: time of day (hours) at simulation time zero.",
+                          DoubleValue(12.0),
+                          MakeDoubleAccessor(&ProfileEnergyHarvester::m_startHour),
+                          MakeDoubleChecker<double>(0.0, 24.0))
+            .AddAttribute("TraceFile",
+                          "Trace profile: file of '<time s> <power W>' lines, looped.",
+                          StringValue(""),
+                          MakeStringAccessor(&ProfileEnergyHarvester::m_traceFile),
+                          MakeStringChecker())
+            .AddAttribute("Efficiency",
+                          "Fraction of the profile power that reaches the storage.",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&ProfileEnergyHarvester::m_efficiency),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("UpdateInterval",
+                          "Period at which the harvested power is re-evaluated.",
+                          TimeValue(Seconds(1.0)),
+                          MakeTimeAccessor(&ProfileEnergyHarvester::m_updateInterval),
+                          MakeTimeChecker())
+            .AddTraceSource("HarvestedPower",
+                            "Harvested power (W).",
+                            MakeTraceSourceAccessor(&ProfileEnergyHarvester::m_harvestedPower),
+                            "ns3::TracedValueCallback::Double")
+            .AddTraceSource(
+                "TotalEnergyHarvested",
+                "Total energy (J) harvested so far.",
+                MakeTraceSourceAccessor(&ProfileEnergyHarvester::m_totalEnergyHarvestedJ),
+                "ns3::TracedValueCallback::Double");
+    return tid;
+}
+
+ProfileEnergyHarvester::ProfileEnergyHarvester()
+    : m_harvestedPower(0.0),
+      m_totalEnergyHarvestedJ(0.0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ProfileEnergyHarvester::~ProfileEnergyHarvester()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+ProfileEnergyHarvester::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_updateEvent.Cancel();
+    m_trace.clear();
+    energy::EnergyHarvester::DoDispose();
+}
+
+void
+ProfileEnergyHarvester::Start(Time start)
+{
+    NS_LOG_FUNCTION(this << start);
+    m_updateEvent.Cancel();
+    m_updateEvent =
+        Simulator::Schedule(start, &ProfileEnergyHarvester::UpdateHarvestedPower, this);
+}
+
+void
+ProfileEnergyHarvester::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    m_updateEvent.Cancel();
+    SetHarvestedPower(0.0);
+}
+
+double
+ProfileEnergyHarvester::GetProfilePower(Time t) const
+{
+    if (m_profile == SOLAR)
+    {
+        double hour = std::fmod(m_startHour + t.GetHours(), 24.0);
+        if (hour <= m_sunrise || hour >= m_sunset)
+        {
+            return 0.0;
+        }
+        return m_peakPower * std::sin(M_PI * (hour - m_sunrise) / (m_sunset - m_sunrise));
+    }
+
+    if (m_trace.empty())
+    {
+        return 0.0;
+    }
+    double period = m_trace.back().first;
+    double s = period > 0 ? std::fmod(t.GetSeconds(), period) : 0.0;
+    auto next = std::upper_bound(m_trace.begin(),
+                                 m_trace.end(),
+                                 s,
+                                 [](double v, const std::pair<double, double>& e) {
+                                     return v < e.first;
+                                 });
+    if (next == m_trace.begin())
+    {
+        return next->second;
+    }
+    if (next == m_trace.end())
+    {
+        return m_trace.back().second;
+    }
+    auto prev = next - 1;
+    double w = (s - prev->first) / (next->first - prev->first);
+    return prev->second + w * (next->second - prev->second);
+}
+
+double
+ProfileEnergyHarvester::DoGetPower() const
+{
+    return m_harvestedPower;
+}
+
+void
+ProfileEnergyHarvester::LoadTrace()
+{
+    NS_LOG_FUNCTION(this << m_traceFile);
+    std::ifstream in(m_traceFile);
+    NS_ABORT_MSG_UNLESS(in.is_open(), "Could not open harvest trace " << m_traceFile);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::istringstream fields(line);
+        double t;
+        double p;
+        if (fields >> t >> p)
+        {
+            NS_ABORT_MSG_IF(!m_trace.empty() && t <= m_trace.back().first,
+                            "Harvest trace times must be increasing: " << line);
+            m_trace.emplace_back(t, std::max(p, 0.0));
+        }
+    }
+    NS_ABORT_MSG_IF(m_trace.empty(), "Harvest trace " << m_traceFile << " has no samples");
+}
+
+void
+ProfileEnergyHarvester::UpdateHarvestedPower()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_profile == TRACE && m_trace.empty())
+    {
+        LoadTrace();
+    }
+    SetHarvestedPower(m_efficiency * GetProfilePower(Simulator::Now()));
+    m_updateEvent =
+        Simulator::Schedule(m_updateInterval, &ProfileEnergyHarvester::UpdateHarvestedPower, this);
+}
+
+void
+ProfileEnergyHarvester::SetHarvestedPower(double power)
+{
+    NS_LOG_FUNCTION(this << power);
+    Time now = Simulator::Now();
+    m_totalEnergyHarvestedJ += m_harvestedPower * (now - m_lastUpdate).GetSeconds();
+
+    // The source integrates the power returned by GetPower() since its last update, so it
+    // must be brought up to date before the power changes
+    Ptr<energy::EnergySource> source = GetEnergySource();
+    if (source)
+    {
+        source->UpdateEnergySource();
+    }
+
+    m_harvestedPower = power;
+    m_lastUpdate = now;
+    NS_LOG_DEBUG("Harvested power " << m_harvestedPower << " W at " << now.As(Time::S));
+}
+
+} // namespace ns3
@@ -0,0 +1,116 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PROFILE_ENERGY_HARVESTER_H
+#define PROFILE_ENERGY_HARVESTER_H
+
+#include "ns3/energy-harvester.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-value.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Energy harvester driven by a time-varying power profile.
+ *
+ * Two profiles are supported:
+ *  - Solar: a diurnal half-sine between Sunrise and Sunset peaking at PeakPower, zero at
+ *    night. StartHour is the time of day at simulation time zero.
+ *  - Trace: a replayed "<time s> <power W>" file (solar logger, vibration harvester, ...),
+ *    linearly interpolated and looped over its own duration.
+ *
+ * The harvested power is zero until Start, then re-evaluated every UpdateInterval and
+ * scaled by Efficiency. The energy source it is connected to plays the role of the
+ * rechargeable storage: a BasicEnergySource integrates (consumption - harvest) and
+ * saturates at its initial energy.
+ */
+class ProfileEnergyHarvester : public energy::EnergyHarvester
+{
+  public:
+    /// Shape of the harvested power over time
+    enum Profile
+    {
+        SOLAR, //!< diurnal half-sine
+        TRACE  //!< replayed trace file
+    };
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    ProfileEnergyHarvester();
+    ~ProfileEnergyHarvester() override;
+
+    /**
+     * \brief Start harvesting.
+     * \param start time of the first power evaluation
+     */
+    void Start(Time start);
+
+    /// Stop harvesting: the power drops to zero until the next Start
+    void Stop();
+
+    /**
+     * \brief Raw (before efficiency) power of the profile at a given simulation time.
+     * \param t simulation time
+     * \return the profile power in W
+     */
+    double GetProfilePower(Time t) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    double DoGetPower() const override;
+
+    /// Evaluate the profile and reschedule
+    void UpdateHarvestedPower();
+
+    /**
+     * \brief Integrate the old power into the energy source, then move to the new one.
+     * \param power new harvested power (W)
+     */
+    void SetHarvestedPower(double power);
+
+    /// Load m_traceFile into m_trace
+    void LoadTrace();
+
+    Profile m_profile;          //!< selected profile
+    double m_peakPower;         //!< solar peak power (W)
+    double m_sunrise;           //!< solar sunrise, hours
+    double m_sunset;            //!< solar sunset, hours
+    double m_startHour;         //!< time of day at simulation start, hours
+    std::string m_traceFile;    //!< trace profile input
+    double m_efficiency;        //!< conversion efficiency
+    Time m_updateInterval;      //!< power re-evaluation period
+    std::vector<std::pair<double, double>> m_trace; //!< (time s, power W) samples
+    EventId m_updateEvent;      //!< next power update
+
+    TracedValue<double> m_harvestedPower; //!< current harvested power (W)
+    TracedValue<double> m_totalEnergyHarvestedJ; //!< energy harvested so far (J)
+    Time m_lastUpdate;          //!< time of the last power update
+};
+
+} // namespace ns3
+
+#endif /* PROFILE_ENERGY_HARVESTER_H */
@@ -0,0 +1,137 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "qos-class-helper.h"
+
+#include "ns3/abort.h"
+#include "ns3/bulk-send-application.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/onoff-application.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("QosClassHelper");
+
+AcIndex
+QosClassHelper::ParseAccessCategory(const std::string& name)
+{
+    std::string category = name.rfind("AC_", 0) == 0 ? name.substr(3) : name;
+    if (category == "BK")
+    {
+        return AC_BK;
+    }
+    if (category == "BE")
+    {
+        return AC_BE;
+    }
+    if (category == "VI")
+    {
+        return AC_VI;
+    }
+    NS_ABORT_MSG_UNLESS(category == "VO", "Unknown access category " << name);
+    return AC_VO;
+}
+
+std::string
+QosClassHelper::GetName(AcIndex ac)
+{
+    switch (ac)
+    {
+    case AC_BK:
+        return "AC_BK";
+    case AC_VI:
+        return "AC_VI";
+    case AC_VO:
+        return "AC_VO";
+    default:
+        return "AC_BE";
+    }
+}
+
+uint8_t
+QosClassHelper::GetTos(AcIndex ac)
+{
+    // TOS >> 5 is the TID: 1 and 2 are AC_BK, 0 and 3 AC_BE, 4 and 5 AC_VI, 6 and 7 AC_VO
+    switch (ac)
+    {
+    case AC_BK:
+        return 0x20;
+    case AC_VI:
+        return 0xa0;
+    case AC_VO:
+        return 0xc0;
+    default:
+        return 0x00;
+    }
+}
+
+void
+QosClassHelper::Install(const ApplicationContainer& apps, AcIndex ac)
+{
+    NS_LOG_FUNCTION(apps.GetN() << GetName(ac));
+    uint8_t tos = GetTos(ac);
+    for (uint32_t i = 0; i < apps.GetN(); ++i)
+    {
+        Ptr<Application> app = apps.Get(i);
+        TimeValue start;
+        app->GetAttribute("StartTime", start);
+        // Scheduled now, this runs before the start event of the application at that instant
+        Simulator::ScheduleWithContext(app->GetNode()->GetId(),
+                                       start.Get(),
+                                       &QosClassHelper::Apply,
+                                       app,
+                                       tos);
+    }
+}
+
+void
+QosClassHelper::Apply(Ptr<Application> app, uint8_t tos)
+{
+    Simulator::ScheduleNow(&QosClassHelper::SetTos, app, tos);
+}
+
+void
+QosClassHelper::SetTos(Ptr<Application> app, uint8_t tos)
+{
+    Ptr<Socket> socket;
+    Ptr<OnOffApplication> onOff = DynamicCast<OnOffApplication>(app);
+    Ptr<BulkSendApplication> bulkSend = DynamicCast<BulkSendApplication>(app);
+    if (onOff)
+    {
+        socket = onOff->GetSocket();
+    }
+    else if (bulkSend)
+    {
+        socket = bulkSend->GetSocket();
+    }
+    else
+    {
+        NS_ABORT_MSG("QosClassHelper supports OnOff and BulkSend applications");
+    }
+    if (!socket)
+    {
+        NS_LOG_WARN("Application of node " << app->GetNode()->GetId() << " has no socket");
+        return;
+    }
+    NS_LOG_DEBUG("TOS " << +tos << " on node " << app->GetNode()->GetId());
+    socket->SetIpTos(tos);
+}
+
+} // namespace ns3
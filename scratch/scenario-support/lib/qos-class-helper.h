@@ -0,0 +1,94 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QOS_CLASS_HELPER_H
+#define QOS_CLASS_HELPER_H
+
+#include "ns3/application-container.h"
+#include "ns3/qos-utils.h"
+
+#include <string>
+
+namespace ns3
+{
+
+class Application;
+
+/**
+ * \brief 802.11e EDCA access category of a traffic class, through the TOS of its sockets.
+ *
+ * With the traffic control layer InternetStackHelper installs, a QoS Wi-Fi MAC takes the
+ * TID of a packet from the three most significant bits of its IP DS field (see
+ * SelectQueueByDSField in WifiMacHelper) and contends for the medium with the EDCA
+ * parameters of the access category of that TID. GetTos returns a TOS whose TID belongs
+ * to the requested category: CS1 for AC_BK, 0 for AC_BE, CS5 for AC_VI and CS6 for AC_VO.
+ * Note that EF (46) has precedence 5 and lands in AC_VI, not AC_VO.
+ *
+ * Install sets that TOS on the socket of every application of the class, right after the
+ * application creates it at start, so every data packet of the class carries it. Only the
+ * TCP SYN, sent while the socket is created, and the ACKs of the receiving side stay in
+ * AC_BE. The MACs must have QosSupported set, otherwise everything goes through the
+ * single DCF queue.
+ */
+class QosClassHelper
+{
+  public:
+    /**
+     * \param name "AC_BK", "AC_BE", "AC_VI" or "AC_VO", with or without the "AC_" prefix
+     * \return the access category, aborting on other names
+     */
+    static AcIndex ParseAccessCategory(const std::string& name);
+
+    /**
+     * \param ac an access category
+     * \return its name, e.g. "AC_VO"
+     */
+    static std::string GetName(AcIndex ac);
+
+    /**
+     * \param ac an access category
+     * \return a TOS byte mapped to that access category
+     */
+    static uint8_t GetTos(AcIndex ac);
+
+    /**
+     * \brief Tag the packets of the applications with the TOS of an access category.
+     *
+     * Must be called after the applications' Start and before Simulator::Run.
+     *
+     * \param apps OnOff or BulkSend applications
+     * \param ac the access category
+     */
+    static void Install(const ApplicationContainer& apps, AcIndex ac);
+
+  private:
+    /**
+     * \brief Set the TOS once the application created its socket.
+     * \param app the application, starting now
+     * \param tos the TOS
+     */
+    static void Apply(Ptr<Application> app, uint8_t tos);
+
+    /**
+     * \brief Set the TOS of the socket of an application.
+     * \param app the application
+     * \param tos the TOS
+     */
+    static void SetTos(Ptr<Application> app, uint8_t tos);
+};
+
+} // namespace ns3
+
+#endif /* QOS_CLASS_HELPER_H */
@@ -0,0 +1,288 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "queue-disc-monitor.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/mq-queue-disc.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/node.h"
+#include "ns3/string.h"
+#include "ns3/traffic-control-helper.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/type-id.h"
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("QueueDiscMonitor");
+
+NS_OBJECT_ENSURE_REGISTERED(QueueDiscMonitor);
+
+TypeId
+QueueDiscMonitor::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::QueueDiscMonitor")
+                            .SetParent<Object>()
+                            .AddConstructor<QueueDiscMonitor>();
+    return tid;
+}
+
+QueueDiscMonitor::QueueDiscMonitor()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+QueueDiscMonitor::~QueueDiscMonitor()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+QueueDiscMonitor::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_queues.clear();
+    Object::DoDispose();
+}
+
+std::string
+QueueDiscMonitor::GetTypeName(const std::string& policy)
+{
+    static const std::map<std::string, std::string> policies = {
+        {"fifo", "ns3::FifoQueueDisc"},
+        {"codel", "ns3::CoDelQueueDisc"},
+        {"fq-codel", "ns3::FqCoDelQueueDisc"},
+        {"pie", "ns3::PieQueueDisc"},
+        {"red", "ns3::RedQueueDisc"},
+        {"fq-pie", "ns3::FqPieQueueDisc"},
+    };
+    std::string name = policy;
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    auto it = policies.find(name);
+    if (it != policies.end())
+    {
+        return it->second;
+    }
+    TypeId tid;
+    NS_ABORT_MSG_UNLESS(TypeId::LookupByNameFailSafe(policy, &tid) &&
+                            tid.IsChildOf(QueueDisc::GetTypeId()),
+                        "Unknown queue disc " << policy);
+    return policy;
+}
+
+void
+QueueDiscMonitor::Install(const NetDeviceContainer& devices,
+                          const std::string& policy,
+                          const std::string& attributes)
+{
+    NS_LOG_FUNCTION(devices.GetN() << policy << attributes);
+    std::string type = GetTypeName(policy);
+
+    // The helper only takes attributes known at compile time: set them on the installed
+    // queue discs, which read them when the simulation initializes them. Config::SetDefault
+    // would also reach every later queue disc of the type.
+    TypeId tid = TypeId::LookupByName(type);
+    std::vector<std::pair<std::string, Ptr<const AttributeValue>>> values;
+    std::istringstream list(attributes);
+    std::string attribute;
+    while (std::getline(list, attribute, ','))
+    {
+        size_t eq = attribute.find('=');
+        NS_ABORT_MSG_IF(eq == std::string::npos, "Attribute must be Name=value: " << attribute);
+        std::string name = attribute.substr(0, eq);
+        TypeId::AttributeInformation info;
+        NS_ABORT_MSG_UNLESS(tid.LookupAttributeByName(name, &info),
+                            type << " has no attribute " << name);
+        Ptr<AttributeValue> value =
+            info.checker->CreateValidValue(StringValue(attribute.substr(eq + 1)));
+        NS_ABORT_MSG_UNLESS(value, "Invalid value for " << type << "::" << name);
+        values.emplace_back(name, value);
+    }
+    auto configure = [&values](Ptr<QueueDisc> queueDisc) {
+        for (const auto& [name, value] : values)
+        {
+            queueDisc->SetAttribute(name, *value);
+        }
+    };
+
+    for (uint32_t i = 0; i < devices.GetN(); ++i)
+    {
+        Ptr<NetDevice> device = devices.Get(i);
+        Ptr<TrafficControlLayer> tc = device->GetNode()->GetObject<TrafficControlLayer>();
+        NS_ABORT_MSG_UNLESS(tc, "Install the Internet stack before the queue discs");
+
+        TrafficControlHelper helper;
+        if (tc->GetRootQueueDiscOnDevice(device))
+        {
+            helper.Uninstall(device);
+        }
+        Ptr<NetDeviceQueueInterface> queues = device->GetObject<NetDeviceQueueInterface>();
+        uint16_t nQueues = queues ? queues->GetNTxQueues() : 1;
+        if (nQueues > 1)
+        {
+            uint16_t handle = helper.SetRootQueueDisc("ns3::MqQueueDisc");
+            TrafficControlHelper::ClassIdList classes =
+                helper.AddQueueDiscClasses(handle, nQueues, "ns3::QueueDiscClass");
+            helper.AddChildQueueDiscs(handle, classes, type);
+        }
+        else
+        {
+            helper.SetRootQueueDisc(type);
+        }
+        helper.Install(device);
+
+        Ptr<QueueDisc> root = tc->GetRootQueueDiscOnDevice(device);
+        if (nQueues > 1)
+        {
+            for (std::size_t c = 0; c < root->GetNQueueDiscClasses(); ++c)
+            {
+                configure(root->GetQueueDiscClass(c)->GetQueueDisc());
+            }
+        }
+        else
+        {
+            configure(root);
+        }
+    }
+}
+
+void
+QueueDiscMonitor::AddDevices(const std::string& prefix, const NetDeviceContainer& devices)
+{
+    NS_LOG_FUNCTION(this << prefix << devices.GetN());
+    for (uint32_t i = 0; i < devices.GetN(); ++i)
+    {
+        Ptr<NetDevice> device = devices.Get(i);
+        Ptr<TrafficControlLayer> tc = device->GetNode()->GetObject<TrafficControlLayer>();
+        Ptr<QueueDisc> root = tc ? tc->GetRootQueueDiscOnDevice(device) : nullptr;
+        if (!root)
+        {
+            NS_LOG_WARN("No queue disc on device " << i << " of " << prefix);
+            continue;
+        }
+        AddQueueDisc(prefix + std::to_string(i), root);
+    }
+}
+
+void
+QueueDiscMonitor::AddQueueDisc(const std::string& name, Ptr<QueueDisc> queue)
+{
+    // An mq root only dispatches to its children, which hold the packets
+    if (queue->GetInstanceTypeId() == MqQueueDisc::GetTypeId())
+    {
+        for (std::size_t c = 0; c < queue->GetNQueueDiscClasses(); ++c)
+        {
+            AddQueueDisc(name + "/" + std::to_string(c),
+                         queue->GetQueueDiscClass(c)->GetQueueDisc());
+        }
+        return;
+    }
+
+    uint32_t index = m_queues.size();
+    m_queues.push_back({name, queue, LogHistogram(), 0});
+    queue->TraceConnectWithoutContext(
+        "SojournTime",
+        MakeCallback(&QueueDiscMonitor::PacketDequeued, this).Bind(index));
+    queue->TraceConnectWithoutContext(
+        "PacketsInQueue",
+        MakeCallback(&QueueDiscMonitor::BacklogChanged, this).Bind(index));
+}
+
+void
+QueueDiscMonitor::PacketDequeued(uint32_t index, Time sojourn)
+{
+    m_queues[index].sojourn.Record(std::max<int64_t>(sojourn.GetNanoSeconds(), 0));
+}
+
+void
+QueueDiscMonitor::BacklogChanged(uint32_t index, uint32_t oldValue, uint32_t newValue)
+{
+    m_queues[index].peakPackets = std::max(m_queues[index].peakPackets, newValue);
+}
+
+void
+QueueDiscMonitor::WriteStats(std::ostream& os, const std::string& prefix) const
+{
+    for (const auto& q : m_queues)
+    {
+        const QueueDisc::Stats& stats = q.queue->GetStats();
+        os << prefix << q.name << "\t" << q.queue->GetInstanceTypeId().GetName() << "\t"
+           << stats.nTotalEnqueuedPackets << "\t" << stats.nTotalDequeuedPackets << "\t"
+           << stats.nTotalDroppedPackets << "\t" << stats.nTotalMarkedPackets << "\t"
+           << q.sojourn.GetMean() / 1e6 << "\t" << q.sojourn.GetQuantile(0.5) / 1e6 << "\t"
+           << q.sojourn.GetQuantile(0.95) / 1e6 << "\t" << q.sojourn.GetQuantile(0.99) / 1e6
+           << "\t" << q.sojourn.GetMax() / 1e6 << "\t" << q.peakPackets << std::endl;
+    }
+}
+
+void
+QueueDiscMonitor::WriteHistograms(std::ostream& os, const std::string& prefix) const
+{
+    for (const auto& q : m_queues)
+    {
+        for (uint32_t b = 0; b < q.sojourn.GetNBuckets(); ++b)
+        {
+            if (q.sojourn.GetBucketCount(b) > 0)
+            {
+                os << prefix << q.name << "\t" << q.sojourn.GetBucketLowerBound(b) / 1e6 << "\t"
+                   << q.sojourn.GetBucketUpperBound(b) / 1e6 << "\t"
+                   << q.sojourn.GetBucketCount(b) << std::endl;
+            }
+        }
+    }
+}
+
+LogHistogram
+QueueDiscMonitor::GetTotalHistogram() const
+{
+    LogHistogram total;
+    for (const auto& q : m_queues)
+    {
+        total.Merge(q.sojourn);
+    }
+    return total;
+}
+
+uint64_t
+QueueDiscMonitor::GetTotalDropped() const
+{
+    uint64_t dropped = 0;
+    for (const auto& q : m_queues)
+    {
+        dropped += q.queue->GetStats().nTotalDroppedPackets;
+    }
+    return dropped;
+}
+
+uint64_t
+QueueDiscMonitor::GetTotalMarked() const
+{
+    uint64_t marked = 0;
+    for (const auto& q : m_queues)
+    {
+        marked += q.queue->GetStats().nTotalMarkedPackets;
+    }
+    return marked;
+}
+
+} // namespace ns3
@@ -0,0 +1,169 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QUEUE_DISC_MONITOR_H
+#define QUEUE_DISC_MONITOR_H
+
+#include "log-histogram.h"
+
+#include "ns3/net-device-container.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/queue-disc.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Queue discipline of a set of devices, with sojourn time and drop statistics.
+ *
+ * Install replaces the root queue disc that Ipv4AddressHelper puts on every device
+ * (fq_codel under mq for Wi-Fi) by the requested policy: "fifo", "codel", "fq-codel",
+ * "pie", "red", "fq-pie" or any QueueDisc TypeId name. A device with several
+ * transmission queues, such as a Wi-Fi device with QosSupported, gets an mq root with
+ * one such queue disc per queue, i.e. per access category (index AC_BE, AC_BK, AC_VI,
+ * AC_VO).
+ *
+ * The Wi-Fi MAC keeps its own queue below the queue disc, which only backs up once that
+ * queue is full: shrink ns3::WifiMacQueue::MaxSize for the policy to be in control.
+ *
+ * The monitor records the sojourn time of every dequeued packet in a LogHistogram per
+ * queue disc, together with the peak backlog. Enqueue, drop and ECN mark counts come
+ * from the queue disc statistics.
+ */
+class QueueDiscMonitor : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    QueueDiscMonitor();
+    ~QueueDiscMonitor() override;
+
+    /**
+     * \param policy a policy name or a QueueDisc TypeId name
+     * \return the TypeId name, aborting on unknown policies
+     */
+    static std::string GetTypeName(const std::string& policy);
+
+    /**
+     * \brief Replace the root queue disc of the devices.
+     *
+     * Must be called after the Internet stack is installed and before Simulator::Run. The
+     * attributes apply to the queue discs installed by this call only.
+     *
+     * \param devices the devices
+     * \param policy a policy name or a QueueDisc TypeId name
+     * \param attributes "Name=value,..." attributes of the queue disc type
+     */
+    static void Install(const NetDeviceContainer& devices,
+                        const std::string& policy,
+                        const std::string& attributes = "");
+
+    /**
+     * \brief Monitor the root queue discs of devices.
+     *
+     * The queues are named after the prefix and the index of the device in the container,
+     * followed by "/<queue>" for the children of an mq root.
+     *
+     * \param prefix name prefix, e.g. "ap"
+     * \param devices devices with a root queue disc
+     */
+    void AddDevices(const std::string& prefix, const NetDeviceContainer& devices);
+
+    /**
+     * \brief Write one line per queue disc, each prefixed by the given text.
+     *
+     * Columns after the prefix: queue, type, enqueued, dequeued, dropped, marked packets,
+     * mean, p50, p95, p99, max sojourn time (ms) and peak backlog (packets).
+     *
+     * \param os output stream
+     * \param prefix text (e.g. run parameters) written at the start of each line
+     */
+    void WriteStats(std::ostream& os, const std::string& prefix) const;
+
+    /**
+     * \brief Write the non-empty sojourn time buckets of every queue disc.
+     *
+     * Columns after the prefix: queue, bucket lower and upper bound (ms), packets.
+     *
+     * \param os output stream
+     * \param prefix text (e.g. run parameters) written at the start of each line
+     */
+    void WriteHistograms(std::ostream& os, const std::string& prefix) const;
+
+    /**
+     * \return the sojourn time histogram, in nanoseconds, over every queue disc
+     */
+    LogHistogram GetTotalHistogram() const;
+
+    /**
+     * \return the packets dropped by every queue disc
+     */
+    uint64_t GetTotalDropped() const;
+
+    /**
+     * \return the packets ECN marked by every queue disc
+     */
+    uint64_t GetTotalMarked() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Statistics of one leaf queue disc
+    struct QueueRecord
+    {
+        std::string name;        //!< queue name
+        Ptr<QueueDisc> queue;    //!< the queue disc
+        LogHistogram sojourn;    //!< sojourn times in ns
+        uint32_t peakPackets;    //!< largest backlog seen
+    };
+
+    /**
+     * \brief Monitor a queue disc, or the children of a classful one.
+     * \param name queue name
+     * \param queue the queue disc
+     */
+    void AddQueueDisc(const std::string& name, Ptr<QueueDisc> queue);
+
+    /**
+     * QueueDisc SojournTime trace.
+     * \param index queue index in m_queues
+     * \param sojourn sojourn time of the dequeued packet
+     */
+    void PacketDequeued(uint32_t index, Time sojourn);
+
+    /**
+     * QueueDisc PacketsInQueue trace.
+     * \param index queue index in m_queues
+     * \param oldValue previous backlog
+     * \param newValue current backlog
+     */
+    void BacklogChanged(uint32_t index, uint32_t oldValue, uint32_t newValue);
+
+    std::vector<QueueRecord> m_queues; //!< monitored queue discs
+};
+
+} // namespace ns3
+
+#endif /* QUEUE_DISC_MONITOR_H */
@@ -0,0 +1,164 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "reactive-jammer.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/mac48-address.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-psdu.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ReactiveJammer");
+
+NS_OBJECT_ENSURE_REGISTERED(ReactiveJammer);
+
+TypeId
+ReactiveJammer::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::ReactiveJammer")
+            .SetParent<AttackApplication>()
+            .AddConstructor<ReactiveJammer>()
+            .AddAttribute("JamProbability",
+                          "Probability of jamming a detected frame at full intensity.",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&ReactiveJammer::m_jamProbability),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("ReactionTime",
+                          "Delay between the detection of a payload and the jamming frame.",
+                          TimeValue(MicroSeconds(10)),
+                          MakeTimeAccessor(&ReactiveJammer::m_reactionTime),
+                          MakeTimeChecker())
+            .AddAttribute("JamSize",
+                          "Size of a jamming frame, in bytes.",
+                          UintegerValue(100),
+                          MakeUintegerAccessor(&ReactiveJammer::m_jamSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Mode",
+                          "WifiMode of the jamming frames.",
+                          StringValue("OfdmRate6Mbps"),
+                          MakeStringAccessor(&ReactiveJammer::m_mode),
+                          MakeStringChecker());
+    return tid;
+}
+
+ReactiveJammer::ReactiveJammer()
+    : m_random(CreateObject<UniformRandomVariable>())
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ReactiveJammer::~ReactiveJammer()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+int64_t
+ReactiveJammer::AssignStreams(int64_t stream)
+{
+    m_random->SetStream(stream);
+    return 1;
+}
+
+void
+ReactiveJammer::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_phy = nullptr;
+    AttackApplication::DoDispose();
+}
+
+AttackTag::Type
+ReactiveJammer::GetAttackType() const
+{
+    return AttackTag::JAMMING;
+}
+
+void
+ReactiveJammer::StartAttack()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_phy)
+    {
+        return;
+    }
+    for (uint32_t i = 0; i < GetNode()->GetNDevices() && !m_phy; ++i)
+    {
+        Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(GetNode()->GetDevice(i));
+        if (device)
+        {
+            m_phy = device->GetPhy();
+        }
+    }
+    NS_ABORT_MSG_UNLESS(m_phy, "ReactiveJammer needs a node with a WiFi device");
+    // Stays connected for the lifetime of the application; FrameDetected checks IsRunning
+    m_phy->TraceConnectWithoutContext("PhyRxPayloadBegin",
+                                      MakeCallback(&ReactiveJammer::FrameDetected, this));
+}
+
+void
+ReactiveJammer::StopAttack()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+ReactiveJammer::FrameDetected(WifiTxVector txVector, Time duration)
+{
+    if (!IsRunning() || m_random->GetValue() >= m_jamProbability * GetIntensity())
+    {
+        return;
+    }
+    NS_LOG_LOGIC("Jamming a frame of " << duration.As(Time::US));
+    Simulator::Schedule(m_reactionTime, &ReactiveJammer::Jam, this);
+}
+
+void
+ReactiveJammer::Jam()
+{
+    if (!IsRunning() || m_phy->IsStateTx() || m_phy->IsStateSleep() || m_phy->IsStateOff())
+    {
+        return;
+    }
+
+    WifiMacHeader header(WIFI_MAC_DATA);
+    header.SetAddr1(Mac48Address::GetBroadcast());
+    header.SetAddr2(Mac48Address::ConvertFrom(m_phy->GetDevice()->GetAddress()));
+    header.SetAddr3(Mac48Address::GetBroadcast());
+    header.SetDsNotFrom();
+    header.SetDsNotTo();
+    Ptr<Packet> packet = Create<Packet>(m_jamSize);
+    Label(packet);
+
+    WifiTxVector txVector;
+    txVector.SetMode(WifiMode(m_mode));
+    txVector.SetPreambleType(WIFI_PREAMBLE_LONG);
+    txVector.SetChannelWidth(20);
+    txVector.SetNss(1);
+    txVector.SetTxPowerLevel(0);
+    // Sending while receiving aborts the reception in progress, as a jammer would
+    m_phy->Send(Create<WifiPsdu>(packet, header), txVector);
+}
+
+} // namespace ns3
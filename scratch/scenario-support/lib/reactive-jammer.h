@@ -0,0 +1,86 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef REACTIVE_JAMMER_H
+#define REACTIVE_JAMMER_H
+
+#include "attack-application.h"
+
+#include "ns3/random-variable-stream.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/wifi-tx-vector.h"
+
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \brief Reactive jammer on the node's WiFi radio.
+ *
+ * The jammer listens on the channel and, when its PHY starts receiving the payload of a
+ * frame, transmits a junk frame of JamSize bytes after ReactionTime, directly on the PHY
+ * (no carrier sense, no backoff), so that the tail of the frame collides at receivers in
+ * range of both transmitters. Each frame is jammed with probability JamProbability times
+ * the current intensity.
+ */
+class ReactiveJammer : public AttackApplication
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    ReactiveJammer();
+    ~ReactiveJammer() override;
+
+    /**
+     * \brief Assign a fixed random variable stream number.
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned
+     */
+    int64_t AssignStreams(int64_t stream) override;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    AttackTag::Type GetAttackType() const override;
+    void StartAttack() override;
+    void StopAttack() override;
+
+    /**
+     * PhyRxPayloadBegin trace sink.
+     * \param txVector TXVECTOR of the frame being received
+     * \param duration remaining duration of the frame
+     */
+    void FrameDetected(WifiTxVector txVector, Time duration);
+
+    /// Transmit one jamming frame
+    void Jam();
+
+    double m_jamProbability;  //!< probability of jamming a frame at full intensity
+    Time m_reactionTime;      //!< delay between detection and jamming
+    uint32_t m_jamSize;       //!< jamming frame size, in bytes
+    std::string m_mode;       //!< jamming frame WifiMode
+    Ptr<WifiPhy> m_phy;       //!< the jamming radio
+    Ptr<UniformRandomVariable> m_random; //!< jam decisions
+};
+
+} // namespace ns3
+
+#endif /* REACTIVE_JAMMER_H */
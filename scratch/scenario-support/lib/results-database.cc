@@ -0,0 +1,302 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "results-database.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/rng-seed-manager.h"
+
+#ifdef SCENARIO_SUPPORT_SQLITE
+#include "ns3/sqlite-output.h"
+#else
+#include "ns3/simple-ref-count.h"
+#endif
+
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ResultsDatabase");
+
+NS_OBJECT_ENSURE_REGISTERED(ResultsDatabase);
+
+#ifndef SCENARIO_SUPPORT_SQLITE
+/// Placeholder so that Ptr<SQLiteOutput> stays a complete type without SQLite
+class SQLiteOutput : public SimpleRefCount<SQLiteOutput>
+{
+};
+#endif
+
+TypeId
+ResultsDatabase::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::ResultsDatabase")
+                            .SetParent<Object>()
+                            .AddConstructor<ResultsDatabase>();
+    return tid;
+}
+
+ResultsDatabase::ResultsDatabase()
+    : m_inRun(false)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ResultsDatabase::~ResultsDatabase()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+ResultsDatabase::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_inRun)
+    {
+        NS_LOG_WARN("Run of " << m_scenario << " disposed before EndRun, results dropped");
+    }
+    m_db = nullptr;
+    Object::DoDispose();
+}
+
+bool
+ResultsDatabase::IsAvailable()
+{
+#ifdef SCENARIO_SUPPORT_SQLITE
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool
+ResultsDatabase::IsEnabled() const
+{
+    return m_db != nullptr;
+}
+
+void
+ResultsDatabase::Open(const std::string& fileName)
+{
+    NS_LOG_FUNCTION(this << fileName);
+#ifdef SCENARIO_SUPPORT_SQLITE
+    m_db = Create<SQLiteOutput>(fileName);
+    CreateSchema();
+#else
+    NS_LOG_UNCOND("ns-3 was built without SQLite, results are not stored in " << fileName);
+#endif
+}
+
+void
+ResultsDatabase::CreateSchema()
+{
+#ifdef SCENARIO_SUPPORT_SQLITE
+    // Parameter values have no declared type so that text is compared as text
+    bool ok = m_db->SpinExec("CREATE TABLE IF NOT EXISTS runs ("
+                             "run_id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                             "scenario TEXT NOT NULL, "
+                             "started TEXT NOT NULL DEFAULT (datetime('now')), "
+                             "seed INTEGER, "
+                             "run INTEGER);") &&
+              m_db->SpinExec("CREATE TABLE IF NOT EXISTS parameters ("
+                             "run_id INTEGER NOT NULL REFERENCES runs(run_id), "
+                             "name TEXT NOT NULL, "
+                             "value, "
+                             "PRIMARY KEY (run_id, name));") &&
+              m_db->SpinExec("CREATE TABLE IF NOT EXISTS metrics ("
+                             "run_id INTEGER NOT NULL REFERENCES runs(run_id), "
+                             "name TEXT NOT NULL, "
+                             "value REAL, "
+                             "PRIMARY KEY (run_id, name));") &&
+              m_db->SpinExec("CREATE TABLE IF NOT EXISTS time_series ("
+                             "run_id INTEGER NOT NULL REFERENCES runs(run_id), "
+                             "series TEXT NOT NULL, "
+                             "time REAL NOT NULL, "
+                             "value REAL);") &&
+              m_db->SpinExec("CREATE INDEX IF NOT EXISTS time_series_run "
+                             "ON time_series (run_id, series);") &&
+              m_db->SpinExec("CREATE TABLE IF NOT EXISTS flows ("
+                             "run_id INTEGER NOT NULL REFERENCES runs(run_id), "
+                             "flow_id INTEGER NOT NULL, "
+                             "source TEXT, destination TEXT, protocol INTEGER, "
+                             "source_port INTEGER, destination_port INTEGER, "
+                             "tx_packets INTEGER, rx_packets INTEGER, lost_packets INTEGER, "
+                             "tx_bytes INTEGER, rx_bytes INTEGER, times_forwarded INTEGER, "
+                             "first_tx REAL, last_tx REAL, first_rx REAL, last_rx REAL, "
+                             "delay_sum REAL, jitter_sum REAL, "
+                             "PRIMARY KEY (run_id, flow_id));");
+    NS_ABORT_MSG_UNLESS(ok, "Could not create the results database schema");
+#endif
+}
+
+void
+ResultsDatabase::BeginRun(const std::string& scenario)
+{
+    NS_LOG_FUNCTION(this << scenario);
+    m_inRun = true;
+    m_scenario = scenario;
+    m_parameters.clear();
+    m_metrics.clear();
+    m_samples.clear();
+    m_flows.clear();
+}
+
+void
+ResultsDatabase::AddParameter(const std::string& name, const std::string& value)
+{
+    if (m_db)
+    {
+        m_parameters.emplace_back(name, value);
+    }
+}
+
+void
+ResultsDatabase::AddParameter(const std::string& name, double value)
+{
+    std::ostringstream text;
+    text << value;
+    AddParameter(name, text.str());
+}
+
+void
+ResultsDatabase::AddMetric(const std::string& name, double value)
+{
+    if (m_db)
+    {
+        m_metrics.emplace_back(name, value);
+    }
+}
+
+void
+ResultsDatabase::AddSample(const std::string& series, double time, double value)
+{
+    if (m_db)
+    {
+        m_samples.push_back({series, time, value});
+    }
+}
+
+void
+ResultsDatabase::AddFlowStats(Ptr<FlowMonitor> monitor, Ptr<Ipv4FlowClassifier> classifier)
+{
+    NS_LOG_FUNCTION(this << monitor << classifier);
+    if (!m_db)
+    {
+        return;
+    }
+    for (const auto& [flowId, stats] : monitor->GetFlowStats())
+    {
+        m_flows.push_back({flowId, classifier->FindFlow(flowId), stats});
+    }
+}
+
+int64_t
+ResultsDatabase::EndRun()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_UNLESS(m_inRun, "EndRun without BeginRun");
+    m_inRun = false;
+    if (!m_db)
+    {
+        return -1;
+    }
+
+#ifdef SCENARIO_SUPPORT_SQLITE
+    bool ok = m_db->SpinExec("BEGIN IMMEDIATE TRANSACTION;");
+
+    sqlite3_stmt* stmt;
+    ok = ok && m_db->SpinPrepare(&stmt, "INSERT INTO runs (scenario, seed, run) VALUES (?, ?, ?);");
+    ok = ok && m_db->Bind(stmt, 1, m_scenario) &&
+         m_db->Bind(stmt, 2, static_cast<uint32_t>(RngSeedManager::GetSeed())) &&
+         m_db->Bind(stmt, 3, static_cast<int64_t>(RngSeedManager::GetRun())) &&
+         m_db->SpinExec(stmt);
+
+    int64_t runId = -1;
+    ok = ok && m_db->SpinPrepare(&stmt, "SELECT last_insert_rowid();");
+    if (ok && m_db->SpinStep(stmt) == SQLITE_ROW)
+    {
+        runId = m_db->RetrieveColumn<int64_t>(stmt, 0);
+    }
+    ok = ok && m_db->SpinFinalize(stmt) == SQLITE_OK && runId >= 0;
+
+    ok = ok && m_db->SpinPrepare(&stmt, "INSERT INTO parameters VALUES (?, ?, ?);");
+    for (const auto& [name, value] : m_parameters)
+    {
+        ok = ok && m_db->Bind(stmt, 1, runId) && m_db->Bind(stmt, 2, name) &&
+             m_db->Bind(stmt, 3, value) && m_db->SpinStep(stmt) == SQLITE_DONE &&
+             m_db->SpinReset(stmt) == SQLITE_OK;
+    }
+    ok = ok && m_db->SpinFinalize(stmt) == SQLITE_OK;
+
+    ok = ok && m_db->SpinPrepare(&stmt, "INSERT INTO metrics VALUES (?, ?, ?);");
+    for (const auto& [name, value] : m_metrics)
+    {
+        ok = ok && m_db->Bind(stmt, 1, runId) && m_db->Bind(stmt, 2, name) &&
+             m_db->Bind(stmt, 3, value) && m_db->SpinStep(stmt) == SQLITE_DONE &&
+             m_db->SpinReset(stmt) == SQLITE_OK;
+    }
+    ok = ok && m_db->SpinFinalize(stmt) == SQLITE_OK;
+
+    ok = ok && m_db->SpinPrepare(&stmt, "INSERT INTO time_series VALUES (?, ?, ?, ?);");
+    for (const auto& sample : m_samples)
+    {
+        ok = ok && m_db->Bind(stmt, 1, runId) && m_db->Bind(stmt, 2, sample.series) &&
+             m_db->Bind(stmt, 3, sample.time) && m_db->Bind(stmt, 4, sample.value) &&
+             m_db->SpinStep(stmt) == SQLITE_DONE && m_db->SpinReset(stmt) == SQLITE_OK;
+    }
+    ok = ok && m_db->SpinFinalize(stmt) == SQLITE_OK;
+
+    ok = ok && m_db->SpinPrepare(&stmt,
+                                 "INSERT INTO flows VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                                 "?, ?, ?, ?, ?, ?, ?, ?);");
+    for (const auto& flow : m_flows)
+    {
+        std::ostringstream source;
+        std::ostringstream destination;
+        source << flow.tuple.sourceAddress;
+        destination << flow.tuple.destinationAddress;
+        const FlowMonitor::FlowStats& s = flow.stats;
+        ok = ok && m_db->Bind(stmt, 1, runId) && m_db->Bind(stmt, 2, flow.flowId) &&
+             m_db->Bind(stmt, 3, source.str()) && m_db->Bind(stmt, 4, destination.str()) &&
+             m_db->Bind(stmt, 5, static_cast<uint32_t>(flow.tuple.protocol)) &&
+             m_db->Bind(stmt, 6, static_cast<uint32_t>(flow.tuple.sourcePort)) &&
+             m_db->Bind(stmt, 7, static_cast<uint32_t>(flow.tuple.destinationPort)) &&
+             m_db->Bind(stmt, 8, s.txPackets) && m_db->Bind(stmt, 9, s.rxPackets) &&
+             m_db->Bind(stmt, 10, s.lostPackets) &&
+             m_db->Bind(stmt, 11, static_cast<int64_t>(s.txBytes)) &&
+             m_db->Bind(stmt, 12, static_cast<int64_t>(s.rxBytes)) &&
+             m_db->Bind(stmt, 13, s.timesForwarded) &&
+             m_db->Bind(stmt, 14, s.timeFirstTxPacket.GetSeconds()) &&
+             m_db->Bind(stmt, 15, s.timeLastTxPacket.GetSeconds()) &&
+             m_db->Bind(stmt, 16, s.timeFirstRxPacket.GetSeconds()) &&
+             m_db->Bind(stmt, 17, s.timeLastRxPacket.GetSeconds()) &&
+             m_db->Bind(stmt, 18, s.delaySum.GetSeconds()) &&
+             m_db->Bind(stmt, 19, s.jitterSum.GetSeconds()) &&
+             m_db->SpinStep(stmt) == SQLITE_DONE && m_db->SpinReset(stmt) == SQLITE_OK;
+    }
+    ok = ok && m_db->SpinFinalize(stmt) == SQLITE_OK;
+
+    NS_ABORT_MSG_UNLESS(ok && m_db->SpinExec("COMMIT;"),
+                        "Could not store the results of " << m_scenario);
+    NS_LOG_INFO("Stored run " << runId << " of " << m_scenario);
+    return runId;
+#else
+    return -1;
+#endif
+}
+
+} // namespace ns3
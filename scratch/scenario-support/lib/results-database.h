@@ -0,0 +1,159 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RESULTS_DATABASE_H
+#define RESULTS_DATABASE_H
+
+#include "ns3/flow-monitor.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/object.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class SQLiteOutput;
+
+/**
+ * \brief Stores the results of a run in a shared SQLite database.
+ *
+ * Every run gets a row in `runs`; its command line parameters, scalar results, time
+ * series and FlowMonitor statistics go to the `parameters`, `metrics`, `time_series`
+ * and `flows` tables, keyed by run_id. Parameters are stored as text so that runs of
+ * different scenarios share one table; cast them to REAL to sort or compare numerically.
+ *
+ * Results are buffered in memory during the simulation and written in a single
+ * transaction by EndRun, so that concurrent runs sharing a database file only hold the
+ * write lock for a moment.
+ *
+ * When ns-3 is built without SQLite, Open warns and the database stays disabled: every
+ * other call is then a no-op, so scenarios do not need to check.
+ */
+class ResultsDatabase : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    ResultsDatabase();
+    ~ResultsDatabase() override;
+
+    /**
+     * \return true if ns-3 was built with SQLite support
+     */
+    static bool IsAvailable();
+
+    /**
+     * \brief Open (and create if needed) the database file.
+     * \param fileName database file
+     */
+    void Open(const std::string& fileName);
+
+    /**
+     * \return true if the database is open
+     */
+    bool IsEnabled() const;
+
+    /**
+     * \brief Start buffering the results of a new run.
+     * \param scenario name of the scenario program
+     */
+    void BeginRun(const std::string& scenario);
+
+    /**
+     * \brief Record an input parameter of the run.
+     * \param name parameter name
+     * \param value parameter value
+     */
+    void AddParameter(const std::string& name, const std::string& value);
+
+    /**
+     * \brief Record a numeric input parameter of the run.
+     * \param name parameter name
+     * \param value parameter value
+     */
+    void AddParameter(const std::string& name, double value);
+
+    /**
+     * \brief Record a scalar result of the run.
+     * \param name metric name
+     * \param value metric value
+     */
+    void AddMetric(const std::string& name, double value);
+
+    /**
+     * \brief Record one point of a time series.
+     * \param series series name, e.g. "throughput/total"
+     * \param time sample time, in seconds
+     * \param value sample value
+     */
+    void AddSample(const std::string& series, double time, double value);
+
+    /**
+     * \brief Record the statistics of every IPv4 flow of a monitor.
+     *
+     * Call FlowMonitor::CheckForLostPackets first.
+     *
+     * \param monitor the flow monitor
+     * \param classifier the IPv4 classifier of the same helper
+     */
+    void AddFlowStats(Ptr<FlowMonitor> monitor, Ptr<Ipv4FlowClassifier> classifier);
+
+    /**
+     * \brief Write the buffered results of the run in one transaction.
+     * \return the run_id of the run, or -1 if the database is disabled
+     */
+    int64_t EndRun();
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Create the tables if they do not exist yet
+    void CreateSchema();
+
+    /// A buffered time series point
+    struct Sample
+    {
+        std::string series; //!< series name
+        double time;        //!< s
+        double value;       //!< sample value
+    };
+
+    /// A buffered flow
+    struct FlowRow
+    {
+        uint32_t flowId;                       //!< flow identifier
+        Ipv4FlowClassifier::FiveTuple tuple;   //!< classifier tuple
+        FlowMonitor::FlowStats stats;          //!< FlowMonitor counters
+    };
+
+    Ptr<SQLiteOutput> m_db;     //!< database connection, null when disabled
+    bool m_inRun;               //!< BeginRun was called and EndRun was not
+    std::string m_scenario;     //!< scenario of the current run
+    std::vector<std::pair<std::string, std::string>> m_parameters; //!< buffered parameters
+    std::vector<std::pair<std::string, double>> m_metrics; //!< buffered metrics
+    std::vector<Sample> m_samples; //!< buffered time series points
+    std::vector<FlowRow> m_flows;  //!< buffered flows
+};
+
+} // namespace ns3
+
+#endif /* RESULTS_DATABASE_H */
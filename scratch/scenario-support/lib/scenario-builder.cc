@@ -0,0 +1,828 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "scenario-builder.h"
+
+#include "qos-class-helper.h"
+#include "queue-disc-monitor.h"
+#include "scenario-common.h"
+#include "tcp-class-helper.h"
+
+#include "ns3/abort.h"
+#include "ns3/aodv-helper.h"
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/log.h"
+#include "ns3/object-factory.h"
+#include "ns3/on-off-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/pointer.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/ssid.h"
+#include "ns3/string.h"
+#include "ns3/type-id.h"
+#include "ns3/uinteger.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/wifi-mac-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/yans-wifi-helper.h"
+
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ScenarioBuilder");
+
+namespace
+{
+
+/**
+ * \param value [x, y] or [x, y, z]
+ * \return the vector, z defaulting to 0
+ */
+Vector
+ToVector(const JsonValue& value)
+{
+    NS_ABORT_MSG_UNLESS(value.IsArray() && (value.GetSize() == 2 || value.GetSize() == 3),
+                        "[x, y] or [x, y, z] expected");
+    return Vector(value[0].AsDouble(),
+                  value[1].AsDouble(),
+                  value.GetSize() == 3 ? value[2].AsDouble() : 0.0);
+}
+
+/**
+ * \param value [min, max]
+ * \return the range
+ */
+std::pair<double, double>
+ToRange(const JsonValue& value)
+{
+    NS_ABORT_MSG_UNLESS(value.IsArray() && value.GetSize() == 2, "[min, max] expected");
+    return {value[0].AsDouble(), value[1].AsDouble()};
+}
+
+/**
+ * \brief Factory for a "{"type": ..., <attribute>: <value>, ...}" description.
+ * \param description the object description
+ * \param defaultType type if the description has none
+ * \return the factory, with every member but "type" set as an attribute
+ */
+ObjectFactory
+MakeFactory(const JsonValue& description, const std::string& defaultType)
+{
+    ObjectFactory factory(description["type"].AsString(defaultType));
+    for (const auto& [name, value] : description.GetMembers())
+    {
+        if (name != "type")
+        {
+            factory.Set(name, StringValue(value.ToAttributeString()));
+        }
+    }
+    return factory;
+}
+
+/**
+ * \param name standard name of the description, e.g. "80211n"
+ * \return the standard
+ */
+WifiStandard
+ToWifiStandard(const std::string& name)
+{
+    static const std::vector<std::pair<std::string, WifiStandard>> standards = {
+        {"80211a", WIFI_STANDARD_80211a},
+        {"80211b", WIFI_STANDARD_80211b},
+        {"80211g", WIFI_STANDARD_80211g},
+        {"80211n", WIFI_STANDARD_80211n},
+        {"80211ac", WIFI_STANDARD_80211ac},
+        {"80211ax", WIFI_STANDARD_80211ax},
+    };
+    for (const auto& [key, standard] : standards)
+    {
+        if (key == name)
+        {
+            return standard;
+        }
+    }
+    NS_ABORT_MSG("Unknown Wi-Fi standard " << name);
+    return WIFI_STANDARD_80211n;
+}
+
+/**
+ * \param protocol "tcp" or "udp"
+ * \return the socket factory type name
+ */
+std::string
+ToSocketFactory(const std::string& protocol)
+{
+    NS_ABORT_MSG_UNLESS(protocol == "tcp" || protocol == "udp", "Unknown protocol " << protocol);
+    return protocol == "tcp" ? "ns3::TcpSocketFactory" : "ns3::UdpSocketFactory";
+}
+
+/**
+ * \param value a period in seconds or a random variable string
+ * \return the attribute text of an OnOffApplication OnTime/OffTime
+ */
+std::string
+ToPeriodVariable(const JsonValue& value)
+{
+    if (value.IsNumber())
+    {
+        return "ns3::ConstantRandomVariable[Constant=" + value.ToAttributeString() + "]";
+    }
+    return value.AsString();
+}
+
+/**
+ * \brief Replace the queue disc of devices, if the description has one.
+ * \param devices the devices
+ * \param description a policy name, an object with a "type" and its attributes, or null
+ */
+void
+InstallQueueDisc(const NetDeviceContainer& devices, const JsonValue& description)
+{
+    if (description.IsNull())
+    {
+        return;
+    }
+    if (description.IsString())
+    {
+        QueueDiscMonitor::Install(devices, description.AsString());
+        return;
+    }
+    std::string attributes;
+    for (const auto& [name, value] : description.GetMembers())
+    {
+        if (name != "type")
+        {
+            attributes +=
+                (attributes.empty() ? "" : ",") + name + "=" + value.ToAttributeString();
+        }
+    }
+    QueueDiscMonitor::Install(devices, description["type"].AsString(), attributes);
+}
+
+} // namespace
+
+ScenarioBuilder::ScenarioBuilder(const JsonValue& description)
+    : m_description(description)
+{
+    NS_ABORT_MSG_UNLESS(description.IsObject(), "A scenario description is a JSON object");
+}
+
+void
+ScenarioBuilder::Build()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_UNLESS(m_groups.empty(), "Scenario already built");
+    ConfigureTcp();
+    const JsonValue& groups = m_description["groups"];
+    NS_ABORT_MSG_UNLESS(groups.IsArray() && groups.GetSize() > 0, "Scenario without groups");
+    for (uint32_t i = 0; i < groups.GetSize(); ++i)
+    {
+        CreateGroup(groups[i]);
+    }
+    InstallDevices();
+    InstallInternet();
+    InstallEnergy();
+    InstallSinks();
+    InstallTraffic();
+}
+
+void
+ScenarioBuilder::Reconfigure(const JsonValue& description)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(m_groups.empty(), "Scenario not built yet");
+    NS_ABORT_MSG_UNLESS(description.IsObject(), "A scenario description is a JSON object");
+    m_description = description;
+    ConfigureTcp();
+    const JsonValue& traffic = m_description["traffic"];
+    for (uint32_t i = 0; i < m_traffic.size(); ++i)
+    {
+        if (!traffic[i].Has("stop"))
+        {
+            m_traffic[i].second.Stop(GetDuration());
+        }
+    }
+}
+
+bool
+ScenarioBuilder::IsReconfigurable(const std::string& path)
+{
+    std::string root = path.substr(0, path.find('.'));
+    return root == "tcp" || root == "duration" || root == "outputs";
+}
+
+std::string
+ScenarioBuilder::GetName() const
+{
+    return m_description["name"].AsString("scenario");
+}
+
+Time
+ScenarioBuilder::GetDuration() const
+{
+    return Seconds(m_description["duration"].AsDouble(100.0));
+}
+
+const JsonValue&
+ScenarioBuilder::GetOutputs() const
+{
+    return m_description["outputs"];
+}
+
+const std::vector<ScenarioBuilder::Group>&
+ScenarioBuilder::GetGroups() const
+{
+    return m_groups;
+}
+
+const ScenarioBuilder::Group&
+ScenarioBuilder::GetGroup(const std::string& name) const
+{
+    return m_groups[FindGroup(name)];
+}
+
+ScenarioBuilder::Radio
+ScenarioBuilder::GetRadio(const std::string& name) const
+{
+    const Group& group = GetGroup(name);
+    NS_ABORT_MSG_IF(group.devices.GetN() == 0, "Group " << name << " has no device");
+    Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(group.devices.Get(0));
+    NS_ABORT_MSG_UNLESS(device, "Group " << name << " has no Wi-Fi device");
+    Ptr<YansWifiChannel> channel = DynamicCast<YansWifiChannel>(device->GetChannel());
+    NS_ABORT_MSG_UNLESS(channel, "Only Yans channels are supported");
+    PointerValue loss;
+    channel->GetAttribute("PropagationLossModel", loss);
+    return {device->GetPhy(), loss.Get<PropagationLossModel>()};
+}
+
+NodeContainer
+ScenarioBuilder::GetAllNodes() const
+{
+    NodeContainer nodes;
+    for (const auto& group : m_groups)
+    {
+        nodes.Add(group.nodes);
+    }
+    return nodes;
+}
+
+const std::vector<ScenarioBuilder::Sink>&
+ScenarioBuilder::GetSinks() const
+{
+    return m_sinks;
+}
+
+const BackhaulHelper::Backhaul&
+ScenarioBuilder::GetBackhaul() const
+{
+    return m_backhaul;
+}
+
+Ptr<NetDevice>
+ScenarioBuilder::GetGatewayDevice() const
+{
+    return m_gatewayDevice;
+}
+
+ApplicationContainer
+ScenarioBuilder::GetTraffic(const std::string& name) const
+{
+    for (const auto& [className, apps] : m_traffic)
+    {
+        if (className == name)
+        {
+            return apps;
+        }
+    }
+    NS_ABORT_MSG("No traffic class " << name);
+    return ApplicationContainer();
+}
+
+std::vector<std::string>
+ScenarioBuilder::GetTrafficNames() const
+{
+    std::vector<std::string> names;
+    for (const auto& traffic : m_traffic)
+    {
+        names.push_back(traffic.first);
+    }
+    return names;
+}
+
+uint32_t
+ScenarioBuilder::FindGroup(const std::string& name) const
+{
+    for (uint32_t i = 0; i < m_groups.size(); ++i)
+    {
+        if (m_groups[i].name == name)
+        {
+            return i;
+        }
+    }
+    NS_ABORT_MSG("No node group " << name);
+    return 0;
+}
+
+void
+ScenarioBuilder::ConfigureTcp()
+{
+    const JsonValue& tcp = m_description["tcp"];
+    if (tcp.Has("variant"))
+    {
+        std::string variant = tcp["variant"].AsString();
+        if (variant.rfind("ns3::", 0) != 0)
+        {
+            variant = "ns3::" + variant;
+        }
+        TypeId tid;
+        NS_ABORT_MSG_UNLESS(TypeId::LookupByNameFailSafe(variant, &tid),
+                            "TypeId " << variant << " not found");
+        Config::SetDefault("ns3::TcpL4Protocol::SocketType", TypeIdValue(tid));
+        // Stacks installed before, by a Build this scenario is reconfigured from
+        Config::SetFailSafe("/NodeList/*/$ns3::TcpL4Protocol/SocketType", TypeIdValue(tid));
+    }
+    for (const auto& [name, value] : tcp["socket"].GetMembers())
+    {
+        Config::SetDefault("ns3::TcpSocket::" + name, StringValue(value.ToAttributeString()));
+    }
+}
+
+TopologyGenerator::Layout
+ScenarioBuilder::GetLayout(const JsonValue& description, uint32_t count) const
+{
+    std::string layout =
+        description["layout"].AsString(description.Has("positions") ? "list" : "origin");
+    double z = description["z"].AsDouble(0.0);
+    auto corner = [&description, z](bool upper) {
+        auto [minX, maxX] = ToRange(description["x"]);
+        auto [minY, maxY] = ToRange(description["y"]);
+        return upper ? Vector(maxX, maxY, z) : Vector(minX, minY, z);
+    };
+
+    if (layout == "list")
+    {
+        const JsonValue& list = description["positions"];
+        NS_ABORT_MSG_UNLESS(list.GetSize() == count,
+                            list.GetSize() << " positions for " << count << " nodes");
+        TopologyGenerator::Layout positions;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            positions.positions.push_back(ToVector(list[i]));
+        }
+        return positions;
+    }
+    if (layout == "grid")
+    {
+        Vector min = description.Has("min") ? ToVector(description["min"]) : Vector(0, 0, z);
+        Vector delta = description.Has("delta") ? ToVector(description["delta"]) : Vector(1, 1, 0);
+        min.z = z;
+        auto width = static_cast<uint32_t>(
+            description["width"].AsUint(std::ceil(std::sqrt(static_cast<double>(count)))));
+        return TopologyGenerator::Grid(count,
+                                       min,
+                                       delta,
+                                       width,
+                                       description["order"].AsString("row") == "row");
+    }
+    if (layout == "circle" || layout == "ellipse")
+    {
+        double radius = description["radius"].AsDouble(0.0);
+        return TopologyGenerator::Ellipse(count,
+                                          ToVector(description["center"]),
+                                          description["radiusX"].AsDouble(radius),
+                                          description["radiusY"].AsDouble(radius));
+    }
+    if (layout == "line")
+    {
+        return TopologyGenerator::Line(count,
+                                       ToVector(description["from"]),
+                                       ToVector(description["to"]));
+    }
+    if (layout == "uniform")
+    {
+        return m_topology.Box(count, corner(false), corner(true));
+    }
+    if (layout == "disk")
+    {
+        return m_topology.Disk(count,
+                               ToVector(description["center"]),
+                               description["radius"].AsDouble());
+    }
+    if (layout == "poisson-disk")
+    {
+        return m_topology.PoissonDisk(count,
+                                      corner(false),
+                                      corner(true),
+                                      description["minDistance"].AsDouble());
+    }
+    if (layout == "clusters")
+    {
+        return m_topology.Clusters(count,
+                                   description["clusters"].AsUint(),
+                                   corner(false),
+                                   corner(true),
+                                   description["sigma"].AsDouble());
+    }
+    if (layout == "manhattan")
+    {
+        const JsonValue& streets = description["streets"];
+        NS_ABORT_MSG_UNLESS(streets.GetSize() == 2, "[streets along x, along y] expected");
+        Vector min = description.Has("min") ? ToVector(description["min"]) : Vector(0, 0, z);
+        return m_topology.Manhattan(count,
+                                    min,
+                                    description["block"].AsDouble(),
+                                    streets[0].AsUint(),
+                                    streets[1].AsUint(),
+                                    description["speed"].AsDouble(0.0));
+    }
+    if (layout == "file")
+    {
+        TopologyGenerator::Layout positions =
+            TopologyGenerator::Load(description["file"].AsString());
+        NS_ABORT_MSG_UNLESS(positions.positions.size() == count,
+                            positions.positions.size() << " positions for " << count
+                                                       << " nodes");
+        return positions;
+    }
+    NS_ABORT_MSG_UNLESS(layout == "origin", "Unknown mobility layout " << layout);
+    TopologyGenerator::Layout positions;
+    positions.positions.assign(count, Vector(0, 0, z));
+    return positions;
+}
+
+void
+ScenarioBuilder::CreateGroup(const JsonValue& description)
+{
+    Group group;
+    group.name = description["name"].AsString();
+    for (const auto& other : m_groups)
+    {
+        NS_ABORT_MSG_IF(other.name == group.name, "Duplicate node group " << group.name);
+    }
+    auto count = static_cast<uint32_t>(description["count"].AsUint(1));
+    NS_LOG_FUNCTION(this << group.name << count);
+    group.nodes.Create(count);
+
+    const JsonValue& mobility = description["mobility"];
+    TopologyGenerator::Layout layout = GetLayout(mobility, count);
+    if (mobility.Has("velocity"))
+    {
+        Vector speed = ToVector(mobility["velocity"]);
+        if (mobility["mirror"].AsBool(false))
+        {
+            TopologyGenerator::SetVelocities(layout,
+                                             {speed, Vector(-speed.x, speed.y, speed.z)});
+        }
+        else
+        {
+            TopologyGenerator::SetVelocities(layout, {speed});
+        }
+    }
+    else if (mobility.Has("velocities"))
+    {
+        const JsonValue& velocities = mobility["velocities"];
+        std::vector<Vector> pattern;
+        for (uint32_t i = 0; i < velocities.GetSize(); ++i)
+        {
+            pattern.push_back(ToVector(velocities[i]));
+        }
+        TopologyGenerator::SetVelocities(layout, pattern);
+    }
+
+    ObjectFactory factory(mobility["model"].AsString(layout.velocities.empty()
+                                                         ? "ns3::ConstantPositionMobilityModel"
+                                                         : "ns3::ConstantVelocityMobilityModel"));
+    for (const auto& [name, value] : mobility["attributes"].GetMembers())
+    {
+        factory.Set(name, StringValue(value.ToAttributeString()));
+    }
+    TopologyGenerator::Install(group.nodes, layout, factory);
+    m_groups.push_back(group);
+}
+
+void
+ScenarioBuilder::InstallDevices()
+{
+    NS_LOG_FUNCTION(this);
+    const JsonValue& wifi = m_description["wifi"];
+
+    WifiHelper wifiHelper;
+    wifiHelper.SetStandard(ToWifiStandard(wifi["standard"].AsString("80211n")));
+    if (wifi.Has("stationManager"))
+    {
+        // The helper only takes a fixed number of attributes, set them as defaults instead
+        const JsonValue& manager = wifi["stationManager"];
+        std::string type = manager["type"].AsString("ns3::ConstantRateWifiManager");
+        for (const auto& [name, value] : manager.GetMembers())
+        {
+            if (name != "type")
+            {
+                Config::SetDefault(type + "::" + name, StringValue(value.ToAttributeString()));
+            }
+        }
+        wifiHelper.SetRemoteStationManager(type);
+    }
+    else
+    {
+        wifiHelper.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                           "DataMode",
+                                           StringValue("HtMcs7"),
+                                           "ControlMode",
+                                           StringValue("HtMcs0"));
+    }
+
+    Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel>();
+    channel->SetPropagationDelayModel(
+        MakeFactory(wifi["propagationDelay"], "ns3::ConstantSpeedPropagationDelayModel")
+            .Create<PropagationDelayModel>());
+    const JsonValue& losses = wifi["propagationLoss"];
+    Ptr<PropagationLossModel> first;
+    Ptr<PropagationLossModel> last;
+    for (uint32_t i = 0; i < losses.GetSize(); ++i)
+    {
+        Ptr<PropagationLossModel> loss = MakeFactory(losses[i], "").Create<PropagationLossModel>();
+        if (last)
+        {
+            last->SetNext(loss);
+        }
+        else
+        {
+            first = loss;
+        }
+        last = loss;
+    }
+    if (!first)
+    {
+        first = CreateObject<LogDistancePropagationLossModel>();
+    }
+    channel->SetPropagationLossModel(first);
+
+    YansWifiPhyHelper phy;
+    phy.SetChannel(channel);
+    phy.SetErrorRateModel(wifi["errorRateModel"].AsString("ns3::YansErrorRateModel"));
+    for (const auto& [name, value] : wifi["phy"].GetMembers())
+    {
+        phy.Set(name, StringValue(value.ToAttributeString()));
+    }
+
+    if (wifi.Has("macQueue"))
+    {
+        Config::SetDefault("ns3::WifiMacQueue::MaxSize",
+                           StringValue(wifi["macQueue"].ToAttributeString()));
+    }
+    if (wifi["qos"].AsBool(false))
+    {
+        Config::SetDefault("ns3::WifiMac::QosSupported", BooleanValue(true));
+    }
+
+    const JsonValue& groups = m_description["groups"];
+    WifiMacHelper mac;
+    for (uint32_t i = 0; i < m_groups.size(); ++i)
+    {
+        std::string device = groups[i]["device"].AsString("sta");
+        Ssid ssid(groups[i]["ssid"].AsString(wifi["ssid"].AsString("network")));
+        if (device == "ap")
+        {
+            mac.SetType("ns3::ApWifiMac", "Ssid", SsidValue(ssid));
+        }
+        else if (device == "sta")
+        {
+            mac.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid));
+        }
+        else if (device == "adhoc")
+        {
+            mac.SetType("ns3::AdhocWifiMac");
+        }
+        else
+        {
+            NS_ABORT_MSG_UNLESS(device == "none", "Unknown device " << device);
+            continue;
+        }
+        m_groups[i].devices = wifiHelper.Install(phy, mac, m_groups[i].nodes);
+    }
+}
+
+void
+ScenarioBuilder::InstallInternet()
+{
+    NS_LOG_FUNCTION(this);
+    const JsonValue& internet = m_description["internet"];
+    std::string routing = internet["routing"].AsString("none");
+    NS_ABORT_MSG_UNLESS(routing == "none" || routing == "aodv" || routing == "global",
+                        "Unknown routing " << routing);
+
+    InternetStackHelper stack;
+    AodvHelper aodv;
+    if (routing == "aodv")
+    {
+        stack.SetRoutingHelper(aodv);
+    }
+    Ipv4AddressHelper address;
+    address.SetBase(internet["network"].AsString("192.168.0.0").c_str(),
+                    internet["mask"].AsString("255.255.0.0").c_str());
+    for (auto& group : m_groups)
+    {
+        if (group.devices.GetN() > 0)
+        {
+            stack.Install(group.nodes);
+            group.interfaces = address.Assign(group.devices);
+        }
+    }
+    InstallBackhaul();
+
+    const JsonValue& groups = m_description["groups"];
+    for (uint32_t i = 0; i < m_groups.size(); ++i)
+    {
+        if (m_groups[i].devices.GetN() > 0)
+        {
+            InstallQueueDisc(m_groups[i].devices, groups[i]["queueDisc"]);
+        }
+    }
+
+    // Global routing runs a shortest path computation per node, only worth it when
+    // packets cross several hops
+    if (routing == "global" || (routing == "none" && m_gatewayDevice))
+    {
+        Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    }
+}
+
+void
+ScenarioBuilder::InstallBackhaul()
+{
+    NS_LOG_FUNCTION(this);
+    const JsonValue& description = m_description["backhaul"];
+    if (description.IsNull())
+    {
+        return;
+    }
+    const Group& gateway = m_groups[FindGroup(description["gateway"].AsString())];
+    uint32_t gatewayIndex = description["gatewayIndex"].AsUint(0);
+    NS_ABORT_MSG_UNLESS(gatewayIndex < gateway.devices.GetN(),
+                        "No device " << gatewayIndex << " in gateway group " << gateway.name);
+    Group& servers = m_groups[FindGroup(description["servers"].AsString())];
+    NS_ABORT_MSG_UNLESS(servers.devices.GetN() == 0,
+                        "Server group " << servers.name << " must have device \"none\"");
+
+    BackhaulHelper helper;
+    helper.SetType(description["type"].AsString("p2p"));
+    if (description.Has("rate"))
+    {
+        helper.SetDataRate(description["rate"].ToAttributeString());
+    }
+    if (description.Has("delay"))
+    {
+        helper.SetDelay(Time(description["delay"].ToAttributeString()));
+    }
+    helper.SetLoss(description["loss"].AsDouble(0.0));
+    helper.SetNetwork(description["network"].AsString("10.1.0.0"),
+                      description["mask"].AsString("255.255.255.0"));
+
+    InternetStackHelper stack;
+    AodvHelper aodv;
+    if (m_description["internet"]["routing"].AsString("none") == "aodv")
+    {
+        stack.SetRoutingHelper(aodv);
+    }
+    stack.Install(servers.nodes);
+    m_gatewayDevice = gateway.devices.Get(gatewayIndex);
+    m_backhaul = helper.Install(gateway.nodes.Get(gatewayIndex), servers.nodes);
+    servers.devices = m_backhaul.serverDevices;
+    servers.interfaces = m_backhaul.serverInterfaces;
+
+    InstallQueueDisc(m_backhaul.gatewayDevices, description["queueDisc"]);
+}
+
+void
+ScenarioBuilder::InstallEnergy()
+{
+    NS_LOG_FUNCTION(this);
+    const JsonValue& groups = m_description["groups"];
+    for (uint32_t i = 0; i < m_groups.size(); ++i)
+    {
+        const JsonValue& energy = groups[i]["energy"];
+        if (energy.IsNull())
+        {
+            continue;
+        }
+        NS_ABORT_MSG_UNLESS(m_groups[i].devices.GetN() == m_groups[i].nodes.GetN(),
+                            "Energy model without devices in group " << m_groups[i].name);
+        ScenarioCommon::RadioEnergyParameters parameters;
+        parameters.initialEnergy = energy["initial"].AsDouble(parameters.initialEnergy);
+        parameters.supplyVoltage = energy["voltage"].AsDouble(parameters.supplyVoltage);
+        parameters.txCurrent = energy["txCurrent"].AsDouble(parameters.txCurrent);
+        parameters.rxCurrent = energy["rxCurrent"].AsDouble(parameters.rxCurrent);
+        parameters.idleCurrent = energy["idleCurrent"].AsDouble(parameters.idleCurrent);
+        parameters.sleepCurrent = energy["sleepCurrent"].AsDouble(parameters.sleepCurrent);
+        m_groups[i].sources =
+            ScenarioCommon::InstallRadioEnergy(m_groups[i].nodes, m_groups[i].devices, parameters)
+                .sources;
+    }
+}
+
+void
+ScenarioBuilder::InstallSinks()
+{
+    NS_LOG_FUNCTION(this);
+    const JsonValue& sinks = m_description["sinks"];
+    for (uint32_t i = 0; i < sinks.GetSize(); ++i)
+    {
+        const JsonValue& description = sinks[i];
+        const Group& group = m_groups[FindGroup(description["group"].AsString())];
+        NS_ABORT_MSG_UNLESS(group.interfaces.GetN() == group.nodes.GetN(),
+                            "Sink group " << group.name << " has no addresses");
+        auto port = static_cast<uint16_t>(description["port"].AsUint(9));
+        PacketSinkHelper helper(ToSocketFactory(description["protocol"].AsString("tcp")),
+                                InetSocketAddress(Ipv4Address::GetAny(), port));
+
+        // One sink on the given node, or on every node of the group
+        uint32_t begin = description["index"].AsUint(0);
+        uint32_t end = description.Has("index") ? begin + 1 : group.nodes.GetN();
+        NS_ABORT_MSG_UNLESS(end <= group.nodes.GetN(), "No node " << begin << " in " << group.name);
+        for (uint32_t n = begin; n < end; ++n)
+        {
+            ApplicationContainer app = helper.Install(group.nodes.Get(n));
+            app.Start(Seconds(0.0));
+            m_sinks.push_back({group.name + std::to_string(n) + ":" + std::to_string(port),
+                               StaticCast<PacketSink>(app.Get(0)),
+                               group.interfaces.GetAddress(n)});
+        }
+    }
+}
+
+void
+ScenarioBuilder::InstallTraffic()
+{
+    NS_LOG_FUNCTION(this);
+    const JsonValue& traffic = m_description["traffic"];
+    for (uint32_t i = 0; i < traffic.GetSize(); ++i)
+    {
+        const JsonValue& description = traffic[i];
+        std::string name = description["name"].AsString("class" + std::to_string(i));
+        const Group& from = m_groups[FindGroup(description["from"].AsString())];
+        const Group& to = m_groups[FindGroup(description["to"].AsString())];
+        uint32_t toIndex = description["toIndex"].AsUint(0);
+        NS_ABORT_MSG_UNLESS(toIndex < to.interfaces.GetN(),
+                            "No address " << toIndex << " in group " << to.name);
+
+        OnOffHelper onOff(ToSocketFactory(description["protocol"].AsString("tcp")),
+                          InetSocketAddress(to.interfaces.GetAddress(toIndex),
+                                            description["port"].AsUint(9)));
+        onOff.SetAttribute("PacketSize", UintegerValue(description["packetSize"].AsUint(512)));
+        onOff.SetAttribute("DataRate",
+                           StringValue(description.Has("rate")
+                                           ? description["rate"].ToAttributeString()
+                                           : "500Kb/s"));
+        onOff.SetAttribute("OnTime",
+                           StringValue(ToPeriodVariable(description.Has("on") ? description["on"]
+                                                                              : JsonValue(1.0))));
+        onOff.SetAttribute("OffTime",
+                           StringValue(ToPeriodVariable(
+                               description.Has("off") ? description["off"] : JsonValue(0.0))));
+        onOff.SetAttribute("MaxBytes", UintegerValue(description["maxBytes"].AsUint(0)));
+        ApplicationContainer apps = onOff.Install(from.nodes);
+        apps.Start(Seconds(description["start"].AsDouble(1.0)));
+        apps.Stop(Seconds(description["stop"].AsDouble(GetDuration().GetSeconds())));
+
+        if (description.Has("congestionControl") || description.Has("socket"))
+        {
+            TcpClassHelper tcp;
+            tcp.SetCongestionControl(description["congestionControl"].AsString(""));
+            for (const auto& [attribute, value] : description["socket"].GetMembers())
+            {
+                tcp.SetSocketAttribute(attribute, StringValue(value.ToAttributeString()));
+            }
+            tcp.Install(apps);
+        }
+        if (description.Has("accessCategory"))
+        {
+            QosClassHelper::Install(
+                apps,
+                QosClassHelper::ParseAccessCategory(description["accessCategory"].AsString()));
+        }
+        m_traffic.emplace_back(name, apps);
+    }
+}
+
+} // namespace ns3
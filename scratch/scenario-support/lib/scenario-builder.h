@@ -0,0 +1,300 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SCENARIO_BUILDER_H
+#define SCENARIO_BUILDER_H
+
+#include "backhaul-helper.h"
+#include "json-value.h"
+#include "topology-generator.h"
+
+#include "ns3/application-container.h"
+#include "ns3/energy-source-container.h"
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/packet-sink.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/wifi-phy.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Builds a Wi-Fi scenario from a JSON description instead of code in main().
+ *
+ * The description lists node groups with their device, mobility and energy model, the
+ * traffic classes between groups, the sinks and the outputs of the run. Every group
+ * shares one Yans channel; all devices get addresses of one subnet, so a single BSS
+ * needs no routing protocol at all.
+ *
+ * \verbatim
+   {
+     "name": "vehicles",                         scenario name in the results database
+     "duration": 100,                            simulated seconds
+     "tcp": {"variant": "TcpWestwoodPlus",       default congestion control
+             "socket": {"SegmentSize": 1448}},   ns3::TcpSocket attribute defaults
+     "wifi": {"standard": "80211n",              80211a/b/g/n/ac/ax
+              "ssid": "network", "qos": false,     802.11e EDCA queues
+              "stationManager": {"type": "ns3::ConstantRateWifiManager",
+                                 "DataMode": "HtMcs7", "ControlMode": "HtMcs0"},
+              "phy": {"TxPowerStart": 16},       YansWifiPhy attributes
+              "propagationDelay": {"type": "ns3::ConstantSpeedPropagationDelayModel"},
+              "propagationLoss": [{"type": "ns3::NakagamiPropagationLossModel", "m0": 1.5}]},
+     "internet": {"routing": "none",             none, aodv or global
+                  "network": "192.168.0.0", "mask": "255.255.0.0"},
+     "groups": [
+       {"name": "ap", "count": 1, "device": "ap",  ap, sta, adhoc or none
+        "mobility": {"layout": "list", "positions": [[0, 10, 0]]},
+        "queueDisc": {"type": "codel", "Target": "5ms"}},
+       {"name": "vehicles", "count": 75, "device": "sta",
+        "mobility": {"layout": "grid", "min": [0, 0], "delta": [10, 20], "width": 16,
+                     "velocity": [1, 0, 0], "mirror": true},
+        "energy": {"initial": 1000, "voltage": 12, "txCurrent": 0.017,
+                   "rxCurrent": 0.0197, "idleCurrent": 0.273, "sleepCurrent": 0.033}}
+     ],
+     "backhaul": {"type": "p2p", "gateway": "ap", "gatewayIndex": 0,  p2p or csma
+                  "servers": "servers", "rate": "1Gbps", "delay": "10ms", "loss": 0.001,
+                  "network": "10.1.0.0", "mask": "255.255.255.0", "queueDisc": "codel"},
+     "sinks": [{"group": "ap", "index": 0, "protocol": "tcp", "port": 9}],
+     "traffic": [
+       {"name": "small", "from": "vehicles", "to": "ap", "toIndex": 0, "protocol": "tcp",
+        "port": 9, "packetSize": 100, "rate": "100Kb/s", "on": 1, "off": 1, "start": 1.1,
+        "congestionControl": "TcpLedbat", "socket": {"TcpNoDelay": true},
+        "accessCategory": "AC_VO"}
+     ],
+     "outputs": {"db": "results.db", "throughput": "throughput/vehicles.txt",
+                 "throughputWindow": 5, "throughputStart": 1.1,
+                 "flowStats": "flowstats/vehicles.bin", "classDelay": "flowstats/delay.txt",
+                 "queueStats": "flowstats/queues.txt", "queueSojourn": "flowstats/sojourn.txt",
+                 "hopDelay": "flowstats/hops.txt",
+                 "connectivity": "flowstats/graph.txt", "connectivityRange": 100,
+                 "parameters": {"vehicles": 75}}
+   }
+   \endverbatim
+ *
+ * Mobility layouts, generated by TopologyGenerator, are "list" (positions), "grid" (min,
+ * delta, width, order "row" or "column"), "circle" or "ellipse" (center, radius or
+ * radiusX and radiusY, evenly spaced), "line" (from, to, evenly spaced), "uniform" (x and
+ * y ranges [min, max]), "disk" (center, radius), "poisson-disk" (x, y, minDistance),
+ * "clusters" (x, y, clusters, sigma), "manhattan" (min, block, streets [along x, along
+ * y], speed) and "file" (file written by TopologyGenerator::Write or the
+ * topology-generator tool); "z" sets the height. "velocity" gives every node a
+ * ConstantVelocityMobilityModel, "mirror" reverses the x speed of the second half of the
+ * group, and "velocities" gives consecutive equal parts of the group a velocity each;
+ * "model" with "attributes" selects any other mobility model. A traffic "on"/"off"
+ * number is a constant period in seconds, a string is a random variable.
+ * Omitted energy currents default to those of ScenarioCommon::InstallRadioEnergy, so
+ * "energy": {} installs the default model. A group "ssid" overrides the Wi-Fi one, and
+ * "wifi" also takes an "errorRateModel" type (YansErrorRateModel by default). With
+ * "qos", a traffic "accessCategory" puts the class in an EDCA queue (QosClassHelper).
+ * A group "queueDisc", a policy name or an object with a "type" and its attributes,
+ * replaces the default queue disc of its devices (QueueDiscMonitor::Install); "wifi"
+ * "macQueue" sets the size of the MAC queue below it, e.g. "50p".
+ *
+ * A "backhaul" links a group of servers (device "none") to a gateway node, usually the
+ * AP, through wired links (BackhaulHelper); the servers can then hold sinks and be
+ * traffic destinations. Its "queueDisc" applies to the gateway side of the links. With
+ * routing "none", a backhaul makes the builder populate global routing tables, since
+ * packets then cross the gateway.
+ *
+ * Positions are generated directly rather than through position allocators and
+ * MobilityHelper, and devices, stacks and addresses are installed once per group, so
+ * building is linear in the number of nodes.
+ */
+class ScenarioBuilder
+{
+  public:
+    /// A node group and what was installed on it
+    struct Group
+    {
+        std::string name;                      //!< group name
+        NodeContainer nodes;                   //!< the nodes
+        NetDeviceContainer devices;            //!< Wi-Fi devices, or backhaul ones of servers
+        Ipv4InterfaceContainer interfaces;     //!< IPv4 interfaces of the devices
+        energy::EnergySourceContainer sources; //!< energy sources, if the group has a model
+    };
+
+    /// Radio of a group, for link budget tools
+    struct Radio
+    {
+        Ptr<WifiPhy> phy;               //!< PHY of the first device of the group
+        Ptr<PropagationLossModel> loss; //!< loss chain of the shared channel
+    };
+
+    /// A packet sink
+    struct Sink
+    {
+        std::string name;     //!< "<group><index>:<port>"
+        Ptr<PacketSink> sink; //!< the application
+        Ipv4Address address;  //!< address of the sink node
+    };
+
+    /**
+     * \param description the parsed scenario
+     */
+    explicit ScenarioBuilder(const JsonValue& description);
+
+    /**
+     * \brief Create the nodes, devices, stacks and applications of the scenario.
+     *
+     * Sets the TCP defaults with Config::SetDefault, so call it before any other TCP
+     * socket is created.
+     */
+    void Build();
+
+    /**
+     * \brief Switch a built scenario to a description differing only in "tcp",
+     * "duration" or "outputs".
+     *
+     * Lets a fork-server child reuse the topology built by its parent. The TCP variant
+     * is changed on the existing TcpL4Protocol instances, and the traffic classes without
+     * an explicit "stop" are stopped at the new duration. Must be called before
+     * Simulator::Run.
+     *
+     * \param description the new description
+     */
+    void Reconfigure(const JsonValue& description);
+
+    /**
+     * \param path a dotted description path, as taken by JsonValue::Set
+     * \return whether changing it is supported by Reconfigure
+     */
+    static bool IsReconfigurable(const std::string& path);
+
+    /**
+     * \return the scenario name
+     */
+    std::string GetName() const;
+
+    /**
+     * \return the simulated duration
+     */
+    Time GetDuration() const;
+
+    /**
+     * \return the "outputs" object of the description
+     */
+    const JsonValue& GetOutputs() const;
+
+    /**
+     * \return the groups, in description order
+     */
+    const std::vector<Group>& GetGroups() const;
+
+    /**
+     * \param name group name, aborting if there is no such group
+     * \return the group
+     */
+    const Group& GetGroup(const std::string& name) const;
+
+    /**
+     * \param name group name, aborting unless its devices are Wi-Fi on a Yans channel
+     * \return the PHY of its first device and the propagation loss of the channel
+     */
+    Radio GetRadio(const std::string& name) const;
+
+    /**
+     * \return every node of every group
+     */
+    NodeContainer GetAllNodes() const;
+
+    /**
+     * \return the packet sinks, in description order
+     */
+    const std::vector<Sink>& GetSinks() const;
+
+    /**
+     * \param name traffic class name, aborting if there is no such class
+     * \return the sender applications of the class
+     */
+    ApplicationContainer GetTraffic(const std::string& name) const;
+
+    /**
+     * \return the traffic class names, in description order
+     */
+    std::vector<std::string> GetTrafficNames() const;
+
+    /**
+     * \return the backhaul, without servers if the scenario has none
+     */
+    const BackhaulHelper::Backhaul& GetBackhaul() const;
+
+    /**
+     * \return the wireless device of the backhaul gateway, null without backhaul
+     */
+    Ptr<NetDevice> GetGatewayDevice() const;
+
+  private:
+    /// Set the TCP defaults, and the variant of the already installed stacks
+    void ConfigureTcp();
+
+    /**
+     * \brief Create a group and install its mobility.
+     * \param description the group description
+     */
+    void CreateGroup(const JsonValue& description);
+
+    /**
+     * \brief Install the Wi-Fi devices of every group on one channel.
+     */
+    void InstallDevices();
+
+    /// Install the Internet stacks and assign the addresses
+    void InstallInternet();
+
+    /// Connect the server group to the gateway and assign the server addresses
+    void InstallBackhaul();
+
+    /// Install the energy sources and radio energy models
+    void InstallEnergy();
+
+    /// Install the packet sinks
+    void InstallSinks();
+
+    /// Install the traffic classes
+    void InstallTraffic();
+
+    /**
+     * \param description the group mobility description
+     * \param count number of nodes
+     * \return the initial position, and velocity for the layouts that have one, of every
+     *         node
+     */
+    TopologyGenerator::Layout GetLayout(const JsonValue& description, uint32_t count) const;
+
+    /**
+     * \param name group name
+     * \return the index of the group in m_groups, aborting if absent
+     */
+    uint32_t FindGroup(const std::string& name) const;
+
+    JsonValue m_description;                              //!< the scenario
+    TopologyGenerator m_topology;                         //!< random layouts
+    std::vector<Group> m_groups;                          //!< groups in description order
+    std::vector<Sink> m_sinks;                            //!< packet sinks
+    std::vector<std::pair<std::string, ApplicationContainer>> m_traffic; //!< traffic classes
+    BackhaulHelper::Backhaul m_backhaul;                  //!< wired segment to the servers
+    Ptr<NetDevice> m_gatewayDevice;                       //!< wireless device of the gateway
+};
+
+} // namespace ns3
+
+#endif /* SCENARIO_BUILDER_H */
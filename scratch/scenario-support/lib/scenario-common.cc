@@ -0,0 +1,139 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "scenario-common.h"
+
+#include "topology-generator.h"
+
+#include "ns3/abort.h"
+#include "ns3/basic-energy-source-helper.h"
+#include "ns3/basic-energy-source.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/wifi-radio-energy-model-helper.h"
+
+#include <fstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ScenarioCommon");
+
+void
+ScenarioCommon::InstallVehicleMobility(const NodeContainer& vehicles,
+                                       double minX,
+                                       double minY,
+                                       double speedX,
+                                       double speedY)
+{
+    NS_LOG_FUNCTION(vehicles.GetN() << minX << minY << speedX << speedY);
+    TopologyGenerator::Layout layout = TopologyGenerator::Grid(vehicles.GetN(),
+                                                               Vector(minX, minY, 0.0),
+                                                               Vector(10.0, 20.0, 0.0),
+                                                               16,
+                                                               true);
+    TopologyGenerator::SetVelocities(layout,
+                                     {Vector(speedX, speedY, 0.0), Vector(-speedX, speedY, 0.0)});
+    TopologyGenerator::Install(vehicles, layout);
+}
+
+ScenarioCommon::EnergyInstallation
+ScenarioCommon::InstallRadioEnergy(const NodeContainer& nodes,
+                                   const NetDeviceContainer& devices,
+                                   double initialEnergy)
+{
+    RadioEnergyParameters parameters;
+    parameters.initialEnergy = initialEnergy;
+    return InstallRadioEnergy(nodes, devices, parameters);
+}
+
+ScenarioCommon::EnergyInstallation
+ScenarioCommon::InstallRadioEnergy(const NodeContainer& nodes,
+                                   const NetDeviceContainer& devices,
+                                   const RadioEnergyParameters& parameters)
+{
+    NS_LOG_FUNCTION(nodes.GetN() << devices.GetN() << parameters.initialEnergy);
+    NS_ABORT_MSG_UNLESS(nodes.GetN() == devices.GetN(), "Expected one device per node");
+
+    BasicEnergySourceHelper sourceHelper;
+    sourceHelper.Set("BasicEnergySourceInitialEnergyJ", DoubleValue(parameters.initialEnergy));
+    sourceHelper.Set("BasicEnergySupplyVoltageV", DoubleValue(parameters.supplyVoltage));
+
+    WifiRadioEnergyModelHelper radioHelper;
+    radioHelper.Set("TxCurrentA", DoubleValue(parameters.txCurrent));
+    radioHelper.Set("RxCurrentA", DoubleValue(parameters.rxCurrent));
+    radioHelper.Set("IdleCurrentA", DoubleValue(parameters.idleCurrent));
+    radioHelper.Set("SleepCurrentA", DoubleValue(parameters.sleepCurrent));
+
+    EnergyInstallation installation;
+    installation.sources = sourceHelper.Install(nodes);
+    installation.models = radioHelper.Install(devices, installation.sources);
+    return installation;
+}
+
+std::vector<double>
+ScenarioCommon::GetEnergyConsumed(const NodeContainer& nodes)
+{
+    std::vector<double> consumed(nodes.GetN(), 0.0);
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        Ptr<energy::EnergySourceContainer> sources =
+            nodes.Get(i)->GetObject<energy::EnergySourceContainer>();
+        Ptr<energy::BasicEnergySource> source;
+        if (sources && sources->GetN() > 0)
+        {
+            source = DynamicCast<energy::BasicEnergySource>(sources->Get(0));
+        }
+        if (!source)
+        {
+            NS_LOG_WARN("Energy source not found for node " << nodes.Get(i)->GetId());
+            continue;
+        }
+        consumed[i] = source->GetInitialEnergy() - source->GetRemainingEnergy();
+    }
+    return consumed;
+}
+
+ScenarioCommon::FlowTotals
+ScenarioCommon::WriteFlowStats(Ptr<FlowMonitor> monitor,
+                               Ptr<Ipv4FlowClassifier> classifier,
+                               Ipv4Address destination,
+                               const std::string& fileName)
+{
+    NS_LOG_FUNCTION(monitor << classifier << destination << fileName);
+    std::ofstream out(fileName);
+    NS_ABORT_MSG_UNLESS(out.is_open(), "Could not open " << fileName);
+
+    FlowTotals totals;
+    for (const auto& [flowId, flow] : monitor->GetFlowStats())
+    {
+        Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(flowId);
+        if (t.destinationAddress != destination)
+        {
+            continue;
+        }
+        totals.txPackets += flow.txPackets;
+        totals.rxPackets += flow.rxPackets;
+        totals.delaySum += flow.delaySum.GetSeconds();
+        double duration = (flow.timeLastRxPacket - flow.timeFirstTxPacket).GetSeconds();
+        out << flowId << "\t" << t.sourceAddress << "\t" << t.destinationAddress << "\t"
+            << flow.txBytes << "\t" << flow.rxBytes << "\t" << flow.txPackets << "\t"
+            << flow.rxPackets << "\t" << flow.lostPackets << "\t"
+            << flow.rxBytes * 8.0 / duration / 1024 / 1024 << std::endl;
+    }
+    return totals;
+}
+
+} // namespace ns3
@@ -0,0 +1,141 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SCENARIO_COMMON_H
+#define SCENARIO_COMMON_H
+
+#include "ns3/device-energy-model-container.h"
+#include "ns3/energy-source-container.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node-container.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Building blocks shared by the vehicle and sensor scenarios of scratch/.
+ *
+ * These used to be copied into every scenario as CalculateEnergyConsumption,
+ * setVehicleMobility, the energy helper setup and the flow statistics loop. Periodic
+ * throughput sampling is done by ThroughputMonitor.
+ */
+class ScenarioCommon
+{
+  public:
+    /// Energy source and radio energy model of every node of an energy installation
+    struct EnergyInstallation
+    {
+        energy::EnergySourceContainer sources;    //!< one BasicEnergySource per node
+        energy::DeviceEnergyModelContainer models; //!< one WifiRadioEnergyModel per device
+    };
+
+    /// Battery and Wi-Fi radio currents of InstallRadioEnergy
+    struct RadioEnergyParameters
+    {
+        double initialEnergy{1000.0}; //!< initial energy of every source (J)
+        double supplyVoltage{12.0};   //!< supply voltage (V)
+        double txCurrent{0.017};      //!< TX current (A)
+        double rxCurrent{0.0197};     //!< RX current (A)
+        double idleCurrent{0.273};    //!< idle current (A)
+        double sleepCurrent{0.033};   //!< sleep current (A)
+    };
+
+    /// Totals over the flows that end at a given address
+    struct FlowTotals
+    {
+        uint64_t txPackets{0}; //!< packets sent by the flows
+        uint64_t rxPackets{0}; //!< packets received by the destination
+        double delaySum{0.0};  //!< sum of the one-way delays of the received packets (s)
+    };
+
+    /**
+     * \brief Place vehicles on a 16-wide grid, the first half driving in +x, the rest in -x.
+     *
+     * Grid cells are 10 m wide and 20 m high, starting at (minX, minY).
+     *
+     * \param vehicles the vehicle nodes
+     * \param minX x of the first grid cell
+     * \param minY y of the first grid cell
+     * \param speedX speed along x of the first half, the second half drives at -speedX
+     * \param speedY speed along y of every vehicle
+     */
+    static void InstallVehicleMobility(const NodeContainer& vehicles,
+                                       double minX,
+                                       double minY,
+                                       double speedX,
+                                       double speedY);
+
+    /**
+     * \brief Give every node a 12 V BasicEnergySource and its Wi-Fi device a radio model.
+     *
+     * The radio currents are those of the scenarios: 17 mA TX, 19.7 mA RX, 273 mA idle
+     * and 33 mA sleep.
+     *
+     * \param nodes the nodes, one device each
+     * \param devices the Wi-Fi devices of the nodes
+     * \param initialEnergy initial energy of every source (J)
+     * \return the installed sources and device models
+     */
+    static EnergyInstallation InstallRadioEnergy(const NodeContainer& nodes,
+                                                 const NetDeviceContainer& devices,
+                                                 double initialEnergy = 1000.0);
+
+    /**
+     * \brief Give every node a BasicEnergySource and its Wi-Fi device a radio model.
+     * \param nodes the nodes, one device each
+     * \param devices the Wi-Fi devices of the nodes
+     * \param parameters battery and radio currents
+     * \return the installed sources and device models
+     */
+    static EnergyInstallation InstallRadioEnergy(const NodeContainer& nodes,
+                                                 const NetDeviceContainer& devices,
+                                                 const RadioEnergyParameters& parameters);
+
+    /**
+     * \brief Energy drawn so far from the first BasicEnergySource of each node.
+     * \param nodes the nodes
+     * \return the consumed energy (J) per node, 0 for a node without such a source
+     */
+    static std::vector<double> GetEnergyConsumed(const NodeContainer& nodes);
+
+    /**
+     * \brief Write the per-flow table of the flows that end at an address.
+     *
+     * One tab-separated line per flow: id, source, destination, TX bytes, RX bytes,
+     * TX packets, RX packets, lost packets and goodput (Mib/s). Call
+     * FlowMonitor::CheckForLostPackets first.
+     *
+     * \param monitor the flow monitor
+     * \param classifier the IPv4 classifier of the same helper
+     * \param destination only flows to this address are written and counted
+     * \param fileName output file
+     * \return the totals of the written flows
+     */
+    static FlowTotals WriteFlowStats(Ptr<FlowMonitor> monitor,
+                                     Ptr<Ipv4FlowClassifier> classifier,
+                                     Ipv4Address destination,
+                                     const std::string& fileName);
+};
+
+} // namespace ns3
+
+#endif /* SCENARIO_COMMON_H */
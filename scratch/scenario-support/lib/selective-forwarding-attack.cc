@@ -0,0 +1,132 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "selective-forwarding-attack.h"
+
+#include "ipv4-input-filter.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SelectiveForwardingAttack");
+
+NS_OBJECT_ENSURE_REGISTERED(SelectiveForwardingAttack);
+
+TypeId
+SelectiveForwardingAttack::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SelectiveForwardingAttack")
+            .SetParent<AttackApplication>()
+            .AddConstructor<SelectiveForwardingAttack>()
+            .AddAttribute("DropProbability",
+                          "Probability of dropping a packet in transit at full intensity "
+                          "(1 for a blackhole).",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&SelectiveForwardingAttack::m_dropProbability),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("Protocol",
+                          "Only drop packets of this IP protocol (6 TCP, 17 UDP), 0 for all.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&SelectiveForwardingAttack::m_protocol),
+                          MakeUintegerChecker<uint8_t>())
+            .AddTraceSource("Drop",
+                            "A packet in transit was dropped by the attack.",
+                            MakeTraceSourceAccessor(&SelectiveForwardingAttack::m_dropTrace),
+                            "ns3::SelectiveForwardingAttack::DropTracedCallback");
+    return tid;
+}
+
+SelectiveForwardingAttack::SelectiveForwardingAttack()
+    : m_random(CreateObject<UniformRandomVariable>()),
+      m_filterInstalled(false),
+      m_dropped(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SelectiveForwardingAttack::~SelectiveForwardingAttack()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+int64_t
+SelectiveForwardingAttack::AssignStreams(int64_t stream)
+{
+    m_random->SetStream(stream);
+    return 1;
+}
+
+void
+SelectiveForwardingAttack::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    AttackApplication::DoDispose();
+}
+
+uint64_t
+SelectiveForwardingAttack::GetDroppedPackets() const
+{
+    return m_dropped;
+}
+
+AttackTag::Type
+SelectiveForwardingAttack::GetAttackType() const
+{
+    return AttackTag::SELECTIVE_FORWARDING;
+}
+
+void
+SelectiveForwardingAttack::StartAttack()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_filterInstalled)
+    {
+        Ipv4InputFilter::Install(GetNode())->AddFilter(
+            MakeCallback(&SelectiveForwardingAttack::ShouldDrop, this));
+        m_filterInstalled = true;
+    }
+}
+
+void
+SelectiveForwardingAttack::StopAttack()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+bool
+SelectiveForwardingAttack::ShouldDrop(Ptr<const Packet> packet,
+                                      const Ipv4Header& header,
+                                      bool inTransit)
+{
+    if (!inTransit || !IsRunning() || (m_protocol != 0 && header.GetProtocol() != m_protocol))
+    {
+        return false;
+    }
+    if (m_random->GetValue() >= m_dropProbability * GetIntensity())
+    {
+        return false;
+    }
+    NS_LOG_LOGIC("Dropping " << header.GetSource() << " -> " << header.GetDestination());
+    m_dropped++;
+    m_dropTrace(packet, header);
+    return true;
+}
+
+} // namespace ns3
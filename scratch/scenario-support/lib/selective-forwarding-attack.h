@@ -0,0 +1,100 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SELECTIVE_FORWARDING_ATTACK_H
+#define SELECTIVE_FORWARDING_ATTACK_H
+
+#include "attack-application.h"
+
+#include "ns3/ipv4-header.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3
+{
+
+/**
+ * \brief Selective forwarding / blackhole on a compromised router.
+ *
+ * While running, the node silently drops the unicast packets it should forward, each
+ * with probability DropProbability times the current intensity (1 makes it a
+ * blackhole), optionally only for one IP protocol. Packets addressed to the node itself,
+ * broadcasts and the routing protocol's own control traffic are untouched, so the node
+ * keeps advertising routes and stays on the forwarding paths.
+ *
+ * On first start the attack registers with the node's Ipv4InputFilter, which asks it
+ * about every received packet; it stays registered, and lets everything through, once
+ * the attack stops.
+ */
+class SelectiveForwardingAttack : public AttackApplication
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    SelectiveForwardingAttack();
+    ~SelectiveForwardingAttack() override;
+
+    /**
+     * \brief Assign a fixed random variable stream number.
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned
+     */
+    int64_t AssignStreams(int64_t stream) override;
+
+    /**
+     * \return the number of packets dropped so far
+     */
+    uint64_t GetDroppedPackets() const;
+
+    /**
+     * TracedCallback signature for dropped packets.
+     *
+     * \param [in] packet the dropped packet
+     * \param [in] header its IPv4 header
+     */
+    typedef void (*DropTracedCallback)(Ptr<const Packet> packet, const Ipv4Header& header);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    AttackTag::Type GetAttackType() const override;
+    void StartAttack() override;
+    void StopAttack() override;
+
+    /**
+     * Ipv4InputFilter callback.
+     * \param packet the received packet
+     * \param header its IPv4 header
+     * \param inTransit whether the node was about to forward it
+     * \return true if the packet must be dropped
+     */
+    bool ShouldDrop(Ptr<const Packet> packet, const Ipv4Header& header, bool inTransit);
+
+    double m_dropProbability;         //!< drop probability at full intensity
+    uint8_t m_protocol;               //!< only drop this IP protocol, 0 for all
+    Ptr<UniformRandomVariable> m_random; //!< drop decisions
+    bool m_filterInstalled;           //!< registered with the node's Ipv4InputFilter
+    uint64_t m_dropped;               //!< dropped packets
+
+    TracedCallback<Ptr<const Packet>, const Ipv4Header&> m_dropTrace; //!< dropped packets
+};
+
+} // namespace ns3
+
+#endif /* SELECTIVE_FORWARDING_ATTACK_H */
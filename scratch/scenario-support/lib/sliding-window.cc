@@ -0,0 +1,138 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "sliding-window.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+SlidingWindow::SlidingWindow(Time window, uint32_t buckets)
+    : m_bucketWidth(std::max<int64_t>(window.GetTimeStep() / std::max<uint32_t>(buckets, 1), 1)),
+      m_buckets(std::max<uint32_t>(buckets, 1)),
+      m_serial(0)
+{
+}
+
+void
+SlidingWindow::Advance(Time now) const
+{
+    int64_t serial = now.GetTimeStep() / m_bucketWidth;
+    if (serial <= m_serial)
+    {
+        return;
+    }
+    auto n = static_cast<int64_t>(m_buckets.size());
+    for (int64_t s = m_serial + 1; s <= std::min(serial, m_serial + n); ++s)
+    {
+        Bucket& bucket = m_buckets[s % n];
+        m_total.count -= bucket.count;
+        m_total.sum -= bucket.sum;
+        m_total.sumSquares -= bucket.sumSquares;
+        bucket = Bucket();
+    }
+    m_serial = serial;
+    if (m_total.count == 0)
+    {
+        // Reset the float totals whenever possible, so rounding errors cannot accumulate
+        m_total = Bucket();
+    }
+}
+
+void
+SlidingWindow::Add(Time now, double value)
+{
+    Advance(now);
+    Bucket& bucket = m_buckets[m_serial % m_buckets.size()];
+    bucket.count++;
+    bucket.sum += value;
+    bucket.sumSquares += value * value;
+    m_total.count++;
+    m_total.sum += value;
+    m_total.sumSquares += value * value;
+}
+
+void
+SlidingWindow::AddIntegral(Time start, Time now, double rate)
+{
+    Advance(now);
+    auto n = static_cast<int64_t>(m_buckets.size());
+    int64_t end = now.GetTimeStep();
+    int64_t from = std::max(start.GetTimeStep(), GetStart(now).GetTimeStep());
+    while (from < end)
+    {
+        int64_t serial = from / m_bucketWidth;
+        int64_t to = std::min((serial + 1) * m_bucketWidth, end);
+        double value = rate * TimeStep(to - from).GetSeconds();
+        Bucket& bucket = m_buckets[serial % n];
+        bucket.count++;
+        bucket.sum += value;
+        bucket.sumSquares += value * value;
+        m_total.count++;
+        m_total.sum += value;
+        m_total.sumSquares += value * value;
+        from = to;
+    }
+}
+
+uint64_t
+SlidingWindow::GetCount(Time now) const
+{
+    Advance(now);
+    return m_total.count;
+}
+
+double
+SlidingWindow::GetSum(Time now) const
+{
+    Advance(now);
+    return m_total.sum;
+}
+
+double
+SlidingWindow::GetMean(Time now) const
+{
+    Advance(now);
+    return m_total.count == 0 ? 0.0 : m_total.sum / m_total.count;
+}
+
+double
+SlidingWindow::GetVariance(Time now) const
+{
+    Advance(now);
+    if (m_total.count == 0)
+    {
+        return 0.0;
+    }
+    double mean = m_total.sum / m_total.count;
+    return std::max(m_total.sumSquares / m_total.count - mean * mean, 0.0);
+}
+
+Time
+SlidingWindow::GetWindow() const
+{
+    return TimeStep(m_bucketWidth * m_buckets.size());
+}
+
+Time
+SlidingWindow::GetStart(Time now) const
+{
+    int64_t serial = now.GetTimeStep() / m_bucketWidth;
+    auto n = static_cast<int64_t>(m_buckets.size());
+    return TimeStep(std::max<int64_t>(serial - n + 1, 0) * m_bucketWidth);
+}
+
+} // namespace ns3
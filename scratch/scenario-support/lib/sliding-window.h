@@ -0,0 +1,122 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SLIDING_WINDOW_H
+#define SLIDING_WINDOW_H
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Count, sum, mean and variance of the values added over the last Window.
+ *
+ * The window is split into a ring of equal buckets, each holding the count, sum and sum
+ * of squares of its values, next to running totals over the whole ring. Adding a value
+ * or querying first expires the buckets that left the window, subtracting them from the
+ * totals, so both are O(1) amortized and memory is fixed by the number of buckets. The
+ * window therefore slides by one bucket at a time: it covers between Window - Window /
+ * buckets and Window of history.
+ */
+class SlidingWindow
+{
+  public:
+    /**
+     * \param window length of the window
+     * \param buckets number of buckets the window is split into
+     */
+    SlidingWindow(Time window = Seconds(1.0), uint32_t buckets = 10);
+
+    /**
+     * \param now current time, not earlier than at the previous call
+     * \param value the value to add
+     */
+    void Add(Time now, double value);
+
+    /**
+     * \brief Add the integral of a constant rate over an interval ending now.
+     *
+     * Each bucket the interval spans gets the share of the integral that falls in it, as
+     * one value; the share before the window is dropped.
+     *
+     * \param start interval start
+     * \param now interval end, the current time, not earlier than at the previous call
+     * \param rate value per second over the interval
+     */
+    void AddIntegral(Time start, Time now, double rate);
+
+    /**
+     * \param now current time
+     * \return the number of values in the window
+     */
+    uint64_t GetCount(Time now) const;
+
+    /**
+     * \param now current time
+     * \return the sum of the values in the window
+     */
+    double GetSum(Time now) const;
+
+    /**
+     * \param now current time
+     * \return the mean of the values in the window, 0 if empty
+     */
+    double GetMean(Time now) const;
+
+    /**
+     * \param now current time
+     * \return the population variance of the values in the window, 0 if empty
+     */
+    double GetVariance(Time now) const;
+
+    /**
+     * \return the window length
+     */
+    Time GetWindow() const;
+
+    /**
+     * \param now current time
+     * \return the start of the oldest bucket in the window, not before time zero
+     */
+    Time GetStart(Time now) const;
+
+  private:
+    /// Aggregates of one bucket
+    struct Bucket
+    {
+        uint64_t count = 0;    //!< values
+        double sum = 0;        //!< sum of the values
+        double sumSquares = 0; //!< sum of the squared values
+    };
+
+    /**
+     * Expire the buckets that are older than the window at the given time.
+     * \param now current time
+     */
+    void Advance(Time now) const;
+
+    int64_t m_bucketWidth;                 //!< bucket length, in time steps
+    mutable std::vector<Bucket> m_buckets; //!< ring of buckets
+    mutable Bucket m_total;                //!< totals over the ring
+    mutable int64_t m_serial;              //!< index since time zero of the current bucket
+};
+
+} // namespace ns3
+
+#endif /* SLIDING_WINDOW_H */
@@ -0,0 +1,99 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "stratified-reservoir.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+StratifiedReservoir::StratifiedReservoir(uint32_t quota, const std::vector<std::string>& labels)
+    : m_quota(quota),
+      m_random(CreateObject<UniformRandomVariable>())
+{
+    for (const auto& label : labels)
+    {
+        m_strata[label].rows.reserve(quota);
+    }
+}
+
+int64_t
+StratifiedReservoir::AssignStreams(int64_t stream)
+{
+    m_random->SetStream(stream);
+    return 1;
+}
+
+bool
+StratifiedReservoir::Offer(const std::string& label, const std::string& row)
+{
+    auto it = m_strata.find(label);
+    if (it == m_strata.end())
+    {
+        return false;
+    }
+    Stratum& stratum = it->second;
+    stratum.offered++;
+    if (stratum.rows.size() < m_quota)
+    {
+        stratum.rows.push_back(row);
+        return true;
+    }
+    // Keep the new row with probability quota / offered, in place of a random kept one
+    auto slot = static_cast<uint64_t>(m_random->GetValue(0.0, stratum.offered));
+    if (slot >= m_quota)
+    {
+        return false;
+    }
+    stratum.rows[slot] = row;
+    return true;
+}
+
+bool
+StratifiedReservoir::IsComplete() const
+{
+    return std::all_of(m_strata.begin(), m_strata.end(), [this](const auto& stratum) {
+        return stratum.second.offered >= m_quota;
+    });
+}
+
+uint64_t
+StratifiedReservoir::GetOffered(const std::string& label) const
+{
+    auto it = m_strata.find(label);
+    return it == m_strata.end() ? 0 : it->second.offered;
+}
+
+uint32_t
+StratifiedReservoir::GetKept(const std::string& label) const
+{
+    auto it = m_strata.find(label);
+    return it == m_strata.end() ? 0 : it->second.rows.size();
+}
+
+void
+StratifiedReservoir::Write(std::ostream& os) const
+{
+    for (const auto& stratum : m_strata)
+    {
+        for (const auto& row : stratum.second.rows)
+        {
+            os << row << "\n";
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,101 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef STRATIFIED_RESERVOIR_H
+#define STRATIFIED_RESERVOIR_H
+
+#include "ns3/random-variable-stream.h"
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Class-balanced sample of a stream of labeled rows.
+ *
+ * Every label has its own reservoir of Quota rows, filled by reservoir sampling
+ * (Algorithm R): once a label has been offered more than Quota rows, each new row
+ * replaces a random kept one with probability Quota / offered. Each reservoir therefore
+ * holds a uniform sample of its label over the whole stream, rather than the first rows
+ * of an abundant label. The sample is complete, and generation can stop, as soon as
+ * every expected label has been offered Quota rows.
+ */
+class StratifiedReservoir
+{
+  public:
+    /**
+     * \param quota rows kept per label
+     * \param labels labels that must reach the quota for the sample to be complete;
+     *        rows with other labels are ignored
+     */
+    StratifiedReservoir(uint32_t quota, const std::vector<std::string>& labels);
+
+    /**
+     * \brief Assign a fixed random variable stream number.
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned
+     */
+    int64_t AssignStreams(int64_t stream);
+
+    /**
+     * \param label the class of the row
+     * \param row the row
+     * \return true if the row was kept
+     */
+    bool Offer(const std::string& label, const std::string& row);
+
+    /**
+     * \return true once every expected label has been offered the quota
+     */
+    bool IsComplete() const;
+
+    /**
+     * \param label a label
+     * \return the number of rows offered with that label
+     */
+    uint64_t GetOffered(const std::string& label) const;
+
+    /**
+     * \param label a label
+     * \return the number of rows kept with that label
+     */
+    uint32_t GetKept(const std::string& label) const;
+
+    /**
+     * \brief Write the kept rows, one per line, grouped by label.
+     * \param os output stream
+     */
+    void Write(std::ostream& os) const;
+
+  private:
+    /// Reservoir of one label
+    struct Stratum
+    {
+        uint64_t offered = 0;          //!< rows offered so far
+        std::vector<std::string> rows; //!< kept rows
+    };
+
+    uint32_t m_quota;                       //!< rows kept per label
+    std::map<std::string, Stratum> m_strata; //!< reservoirs, by label
+    Ptr<UniformRandomVariable> m_random;    //!< replacement decisions
+};
+
+} // namespace ns3
+
+#endif /* STRATIFIED_RESERVOIR_H */
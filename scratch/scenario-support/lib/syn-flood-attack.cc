@@ -0,0 +1,168 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "syn-flood-attack.h"
+
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-raw-socket-factory.h"
+#include "ns3/ipv4.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-header.h"
+#include "ns3/uinteger.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SynFloodAttack");
+
+NS_OBJECT_ENSURE_REGISTERED(SynFloodAttack);
+
+TypeId
+SynFloodAttack::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SynFloodAttack")
+            .SetParent<AttackApplication>()
+            .AddConstructor<SynFloodAttack>()
+            .AddAttribute("Remote",
+                          "InetSocketAddress of the attacked listener.",
+                          AddressValue(),
+                          MakeAddressAccessor(&SynFloodAttack::m_remote),
+                          MakeAddressChecker())
+            .AddAttribute("Rate",
+                          "SYN segments per second at full intensity.",
+                          DoubleValue(1000.0),
+                          MakeDoubleAccessor(&SynFloodAttack::m_rate),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("SpoofSource",
+                          "Use random source addresses from the attacker's subnet.",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&SynFloodAttack::m_spoof),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+SynFloodAttack::SynFloodAttack()
+    : m_random(CreateObject<UniformRandomVariable>())
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SynFloodAttack::~SynFloodAttack()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+int64_t
+SynFloodAttack::AssignStreams(int64_t stream)
+{
+    m_random->SetStream(stream);
+    return 1;
+}
+
+void
+SynFloodAttack::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_sendEvent.Cancel();
+    m_socket = nullptr;
+    AttackApplication::DoDispose();
+}
+
+AttackTag::Type
+SynFloodAttack::GetAttackType() const
+{
+    return AttackTag::SYN_FLOOD;
+}
+
+void
+SynFloodAttack::StartAttack()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_UNLESS(InetSocketAddress::IsMatchingType(m_remote),
+                        "SynFloodAttack needs an IPv4 InetSocketAddress");
+
+    Ptr<Ipv4> ipv4 = GetNode()->GetObject<Ipv4>();
+    NS_ABORT_MSG_UNLESS(ipv4 && ipv4->GetNInterfaces() > 1, "SynFloodAttack needs IPv4");
+    m_local = ipv4->GetAddress(1, 0).GetLocal();
+    m_mask = ipv4->GetAddress(1, 0).GetMask();
+
+    m_socket = Socket::CreateSocket(GetNode(), Ipv4RawSocketFactory::GetTypeId());
+    m_socket->SetAttribute("Protocol", UintegerValue(6));
+    m_socket->SetAttribute("IpHeaderInclude", BooleanValue(m_spoof));
+    m_socket->Bind();
+    m_socket->ShutdownRecv();
+    SendSyn();
+}
+
+void
+SynFloodAttack::StopAttack()
+{
+    NS_LOG_FUNCTION(this);
+    m_sendEvent.Cancel();
+    if (m_socket)
+    {
+        m_socket->Close();
+        m_socket = nullptr;
+    }
+}
+
+void
+SynFloodAttack::SendSyn()
+{
+    double rate = m_rate * GetIntensity();
+    if (rate <= 0)
+    {
+        m_sendEvent = Simulator::Schedule(MilliSeconds(10), &SynFloodAttack::SendSyn, this);
+        return;
+    }
+
+    InetSocketAddress remote = InetSocketAddress::ConvertFrom(m_remote);
+    TcpHeader tcp;
+    tcp.SetSourcePort(m_random->GetInteger(1024, 65535));
+    tcp.SetDestinationPort(remote.GetPort());
+    tcp.SetSequenceNumber(SequenceNumber32(m_random->GetInteger(0, UINT32_MAX)));
+    tcp.SetFlags(TcpHeader::SYN);
+    tcp.SetWindowSize(65535);
+
+    Ptr<Packet> packet = Create<Packet>();
+    packet->AddHeader(tcp);
+    if (m_spoof)
+    {
+        // Keep the network part of the attacker's address, randomize the host part
+        uint32_t hosts = ~m_mask.Get();
+        Ipv4Address source = hosts > 1 ? Ipv4Address(m_local.CombineMask(m_mask).Get() |
+                                                     m_random->GetInteger(1, hosts - 1))
+                                       : m_local;
+        Ipv4Header ip;
+        ip.SetSource(source);
+        ip.SetDestination(remote.GetIpv4());
+        ip.SetProtocol(6);
+        ip.SetPayloadSize(packet->GetSize());
+        ip.SetTtl(64);
+        packet->AddHeader(ip);
+    }
+    Label(packet);
+    m_socket->SendTo(packet, 0, InetSocketAddress(remote.GetIpv4(), 0));
+
+    m_sendEvent = Simulator::Schedule(Seconds(1.0 / rate), &SynFloodAttack::SendSyn, this);
+}
+
+} // namespace ns3
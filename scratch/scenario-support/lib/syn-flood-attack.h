@@ -0,0 +1,81 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SYN_FLOOD_ATTACK_H
+#define SYN_FLOOD_ATTACK_H
+
+#include "attack-application.h"
+
+#include "ns3/address.h"
+#include "ns3/event-id.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/socket.h"
+
+namespace ns3
+{
+
+/**
+ * \brief TCP SYN flood towards a listening port.
+ *
+ * Bare SYN segments are written to a single raw IPv4 socket, each with a random source
+ * port and initial sequence number, so every one of them makes the listener open a
+ * half-open connection. With SpoofSource the IPv4 header is built by the attack and the
+ * source address is drawn at random from the attacker's own subnet, so the SYN-ACKs go
+ * nowhere.
+ */
+class SynFloodAttack : public AttackApplication
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    SynFloodAttack();
+    ~SynFloodAttack() override;
+
+    /**
+     * \brief Assign a fixed random variable stream number.
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned
+     */
+    int64_t AssignStreams(int64_t stream) override;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    AttackTag::Type GetAttackType() const override;
+    void StartAttack() override;
+    void StopAttack() override;
+
+    /// Send one SYN and schedule the next one
+    void SendSyn();
+
+    Address m_remote;          //!< listener address and port
+    double m_rate;             //!< SYN per second at full intensity
+    bool m_spoof;              //!< randomize the source address
+    Ptr<Socket> m_socket;      //!< raw socket
+    Ipv4Address m_local;       //!< attacker address
+    Ipv4Mask m_mask;           //!< attacker subnet mask
+    Ptr<UniformRandomVariable> m_random; //!< ports, sequence numbers and addresses
+    EventId m_sendEvent;       //!< next SYN
+};
+
+} // namespace ns3
+
+#endif /* SYN_FLOOD_ATTACK_H */
@@ -0,0 +1,171 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-class-helper.h"
+
+#include "ns3/abort.h"
+#include "ns3/application.h"
+#include "ns3/config.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-socket.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TcpClassHelper");
+
+uint32_t TcpClassHelper::s_pendingDefaults = 0;
+TcpClassHelper::Attributes TcpClassHelper::s_savedDefaults;
+std::map<uint32_t, std::pair<uint32_t, TypeId>> TcpClassHelper::s_savedSocketTypes;
+
+TcpClassHelper::TcpClassHelper()
+{
+}
+
+void
+TcpClassHelper::SetCongestionControl(const std::string& variant)
+{
+    NS_LOG_FUNCTION(this << variant);
+    if (variant.empty())
+    {
+        m_congestion = TypeId();
+        return;
+    }
+    std::string name = variant.rfind("ns3::", 0) == 0 ? variant : "ns3::" + variant;
+    NS_ABORT_MSG_UNLESS(TypeId::LookupByNameFailSafe(name, &m_congestion),
+                        "TypeId " << name << " not found");
+    NS_ABORT_MSG_UNLESS(m_congestion.IsChildOf(TcpCongestionOps::GetTypeId()),
+                        name << " is not a TCP congestion control");
+}
+
+void
+TcpClassHelper::SetSocketAttribute(const std::string& name, const AttributeValue& value)
+{
+    NS_LOG_FUNCTION(this << name);
+    TypeId::AttributeInformation info;
+    NS_ABORT_MSG_UNLESS(TcpSocket::GetTypeId().LookupAttributeByName(name, &info),
+                        "ns3::TcpSocket has no attribute " << name);
+    Ptr<AttributeValue> valid = info.checker->CreateValidValue(value);
+    NS_ABORT_MSG_UNLESS(valid, "Invalid value for ns3::TcpSocket::" << name);
+    m_attributes.emplace_back(name, valid);
+}
+
+void
+TcpClassHelper::SetSocketAttributes(const std::string& attributes)
+{
+    std::istringstream list(attributes);
+    std::string attribute;
+    while (std::getline(list, attribute, ','))
+    {
+        size_t eq = attribute.find('=');
+        NS_ABORT_MSG_IF(eq == std::string::npos, "Attribute must be Name=value: " << attribute);
+        SetSocketAttribute(attribute.substr(0, eq), StringValue(attribute.substr(eq + 1)));
+    }
+}
+
+void
+TcpClassHelper::Install(const ApplicationContainer& apps) const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(Simulator::GetEventCount() > 0,
+                    "TcpClassHelper::Install must be called before Simulator::Run");
+    for (uint32_t i = 0; i < apps.GetN(); ++i)
+    {
+        Ptr<Application> app = apps.Get(i);
+        TimeValue start;
+        app->GetAttribute("StartTime", start);
+        // Scheduled now, the switch runs before the start event the application schedules
+        // for the same instant when the simulation initializes it
+        Simulator::ScheduleWithContext(app->GetNode()->GetId(),
+                                       start.Get(),
+                                       &TcpClassHelper::Apply,
+                                       app->GetNode(),
+                                       m_congestion,
+                                       m_attributes);
+    }
+}
+
+void
+TcpClassHelper::Apply(Ptr<Node> node, TypeId congestion, Attributes attributes)
+{
+    NS_LOG_FUNCTION(node->GetId() << congestion);
+    Ptr<TcpL4Protocol> tcp = node->GetObject<TcpL4Protocol>();
+    NS_ABORT_MSG_UNLESS(tcp, "Node " << node->GetId() << " has no TCP");
+
+    // Applications of a class may start together on many nodes: only the first switch
+    // saves the configuration, and only the last restore brings it back
+    auto& savedType = s_savedSocketTypes[node->GetId()];
+    if (savedType.first++ == 0)
+    {
+        TypeIdValue previous;
+        tcp->GetAttribute("SocketType", previous);
+        savedType.second = previous.Get();
+    }
+    if (congestion != TypeId())
+    {
+        tcp->SetAttribute("SocketType", TypeIdValue(congestion));
+    }
+
+    ++s_pendingDefaults;
+    TypeId socketType = TcpSocket::GetTypeId();
+    for (const auto& [name, value] : attributes)
+    {
+        auto saved = std::find_if(s_savedDefaults.begin(),
+                                  s_savedDefaults.end(),
+                                  [&name](const auto& a) { return a.first == name; });
+        if (saved == s_savedDefaults.end())
+        {
+            TypeId::AttributeInformation info;
+            socketType.LookupAttributeByName(name, &info);
+            s_savedDefaults.emplace_back(name, info.initialValue);
+        }
+        Config::SetDefault("ns3::TcpSocket::" + name, *value);
+    }
+
+    // After the start events already queued for this instant, i.e. once the socket exists
+    Simulator::ScheduleNow(&TcpClassHelper::Restore, node);
+}
+
+void
+TcpClassHelper::Restore(Ptr<Node> node)
+{
+    NS_LOG_FUNCTION(node->GetId());
+    auto savedType = s_savedSocketTypes.find(node->GetId());
+    if (--savedType->second.first == 0)
+    {
+        node->GetObject<TcpL4Protocol>()->SetAttribute("SocketType",
+                                                       TypeIdValue(savedType->second.second));
+        s_savedSocketTypes.erase(savedType);
+    }
+    if (--s_pendingDefaults == 0)
+    {
+        for (const auto& [name, value] : s_savedDefaults)
+        {
+            Config::SetDefault("ns3::TcpSocket::" + name, *value);
+        }
+        s_savedDefaults.clear();
+    }
+}
+
+} // namespace ns3
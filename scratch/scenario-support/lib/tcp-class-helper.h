@@ -0,0 +1,113 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_CLASS_HELPER_H
+#define TCP_CLASS_HELPER_H
+
+#include "ns3/application-container.h"
+#include "ns3/attribute.h"
+#include "ns3/type-id.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+class Node;
+
+/**
+ * \brief TCP configuration of one traffic class: congestion control and socket attributes.
+ *
+ * Sockets take their congestion control from the SocketType of their node's
+ * TcpL4Protocol and their other settings from the ns3::TcpSocket attribute defaults, both
+ * read when the application creates its socket at start. Install schedules, at the start
+ * time of every application of the class and just before it, the switch of both to the
+ * class configuration, and restores them right after, so the applications of different
+ * classes on the same node get different TCP stacks.
+ *
+ * The switch relies on being scheduled before the start events of the applications at
+ * the same instant. The applications schedule those when the simulation initializes their
+ * node, so Install must be called after the applications' Start and before
+ * Simulator::Run, and aborts otherwise. Two classes must not start applications on the
+ * same instant.
+ *
+ * Sockets accepted by a sink are forks of its listening socket, so receiver-side settings
+ * (DelAckCount, DelAckTimeout, ...) of a class take effect by installing the class on a
+ * sink of its own as well.
+ */
+class TcpClassHelper
+{
+  public:
+    TcpClassHelper();
+
+    /**
+     * \brief Select the congestion control of the class.
+     * \param variant TcpCongestionOps name, with or without "ns3::"; empty keeps the default
+     */
+    void SetCongestionControl(const std::string& variant);
+
+    /**
+     * \brief Set an ns3::TcpSocket attribute (SegmentSize, TcpNoDelay, DelAckCount, ...).
+     * \param name attribute name
+     * \param value attribute value; a StringValue is converted
+     */
+    void SetSocketAttribute(const std::string& name, const AttributeValue& value);
+
+    /**
+     * \brief Set attributes from a "Name=value,Name=value" list.
+     * \param attributes the list, empty for none
+     */
+    void SetSocketAttributes(const std::string& attributes);
+
+    /**
+     * \brief Apply the class configuration to the sockets of the given applications.
+     * \param apps applications creating TCP sockets at start (OnOff, BulkSend, PacketSink,
+     * ...)
+     */
+    void Install(const ApplicationContainer& apps) const;
+
+  private:
+    /// Attribute name and validated value
+    typedef std::vector<std::pair<std::string, Ptr<const AttributeValue>>> Attributes;
+
+    /**
+     * \brief Switch a node and the socket defaults to a configuration.
+     * \param node node of the application about to start
+     * \param congestion congestion control, or the default TypeId to keep the node's
+     * \param attributes socket attribute defaults
+     */
+    static void Apply(Ptr<Node> node, TypeId congestion, Attributes attributes);
+
+    /**
+     * \brief Undo an Apply; the last pending one restores what the first one saved.
+     * \param node the node
+     */
+    static void Restore(Ptr<Node> node);
+
+    TypeId m_congestion;      //!< congestion control, default TypeId to keep the node's
+    Attributes m_attributes;  //!< socket attributes
+
+    static uint32_t s_pendingDefaults; //!< Apply calls not restored yet
+    static Attributes s_savedDefaults; //!< socket defaults before the first pending Apply
+    /// Per node: pending Apply calls and SocketType before the first of them
+    static std::map<uint32_t, std::pair<uint32_t, TypeId>> s_savedSocketTypes;
+};
+
+} // namespace ns3
+
+#endif /* TCP_CLASS_HELPER_H */
@@ -0,0 +1,157 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-mobility-aware.h"
+
+#include "link-quality-monitor.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-socket-state.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TcpMobilityAware");
+
+NS_OBJECT_ENSURE_REGISTERED(TcpMobilityAware);
+
+uint64_t TcpMobilityAware::s_mobilityLosses = 0;
+uint64_t TcpMobilityAware::s_congestionLosses = 0;
+
+TypeId
+TcpMobilityAware::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TcpMobilityAware")
+            .SetParent<TcpNewReno>()
+            .SetGroupName("Internet")
+            .AddConstructor<TcpMobilityAware>()
+            .AddAttribute("MobilityBeta",
+                          "Multiplicative decrease of ssthresh for losses caused by mobility.",
+                          DoubleValue(0.85),
+                          MakeDoubleAccessor(&TcpMobilityAware::m_mobilityBeta),
+                          MakeDoubleChecker<double>(0.5, 1.0))
+            .AddAttribute("TrendThreshold",
+                          "RSSI trend (dB/s) below which the station moves away from its AP.",
+                          DoubleValue(-0.5),
+                          MakeDoubleAccessor(&TcpMobilityAware::m_trendThreshold),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("WeakRssi",
+                          "AP RSSI (dBm) below which losses are blamed on range.",
+                          DoubleValue(-85.0),
+                          MakeDoubleAccessor(&TcpMobilityAware::m_weakRssi),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("MinRetryRate",
+                          "MAC retries per second that confirm a falling RSSI.",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&TcpMobilityAware::m_minRetryRate),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("HandoverGuard",
+                          "Time after a handover during which losses are blamed on it.",
+                          TimeValue(Seconds(2.0)),
+                          MakeTimeAccessor(&TcpMobilityAware::m_handoverGuard),
+                          MakeTimeChecker());
+    return tid;
+}
+
+TcpMobilityAware::TcpMobilityAware()
+    : TcpNewReno()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpMobilityAware::TcpMobilityAware(const TcpMobilityAware& sock)
+    : TcpNewReno(sock),
+      m_mobilityBeta(sock.m_mobilityBeta),
+      m_trendThreshold(sock.m_trendThreshold),
+      m_weakRssi(sock.m_weakRssi),
+      m_minRetryRate(sock.m_minRetryRate),
+      m_handoverGuard(sock.m_handoverGuard)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpMobilityAware::~TcpMobilityAware()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+std::string
+TcpMobilityAware::GetName() const
+{
+    return "TcpMobilityAware";
+}
+
+Ptr<TcpCongestionOps>
+TcpMobilityAware::Fork()
+{
+    return CopyObject<TcpMobilityAware>(this);
+}
+
+uint64_t
+TcpMobilityAware::GetMobilityLosses()
+{
+    return s_mobilityLosses;
+}
+
+uint64_t
+TcpMobilityAware::GetCongestionLosses()
+{
+    return s_congestionLosses;
+}
+
+bool
+TcpMobilityAware::IsMobilityLoss() const
+{
+    // Congestion control runs in the context of the node that owns the socket
+    Ptr<LinkQualityMonitor> monitor = LinkQualityMonitor::Get(Simulator::GetContext());
+    if (!monitor)
+    {
+        return false;
+    }
+    Time handover = monitor->GetLastHandover();
+    if (!handover.IsNegative() && Simulator::Now() - handover <= m_handoverGuard)
+    {
+        return true;
+    }
+    if (!monitor->HasRssi())
+    {
+        return false;
+    }
+    return monitor->GetRssi() < m_weakRssi ||
+           (monitor->GetRssiTrend() < m_trendThreshold &&
+            monitor->GetRetryRate() >= m_minRetryRate);
+}
+
+uint32_t
+TcpMobilityAware::GetSsThresh(Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight)
+{
+    NS_LOG_FUNCTION(this << tcb << bytesInFlight);
+    if (!IsMobilityLoss())
+    {
+        ++s_congestionLosses;
+        return TcpNewReno::GetSsThresh(tcb, bytesInFlight);
+    }
+    ++s_mobilityLosses;
+    NS_LOG_INFO("Loss at " << Simulator::Now().As(Time::S) << " blamed on mobility");
+    return std::max(2 * tcb->m_segmentSize,
+                    static_cast<uint32_t>(bytesInFlight * m_mobilityBeta));
+}
+
+} // namespace ns3
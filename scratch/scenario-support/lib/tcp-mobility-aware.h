@@ -0,0 +1,94 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_MOBILITY_AWARE_H
+#define TCP_MOBILITY_AWARE_H
+
+#include "ns3/nstime.h"
+#include "ns3/tcp-congestion-ops.h"
+
+namespace ns3
+{
+
+/**
+ * \brief NewReno that does not halve its window for losses caused by mobility.
+ *
+ * On a loss, the congestion control asks the LinkQualityMonitor of its node (the node of
+ * the simulation context, see LinkQualityMonitor::Get) whether the link explains it:
+ *  - a handover in the last HandoverGuard;
+ *  - an AP RSSI below WeakRssi; or
+ *  - an AP RSSI falling faster than TrendThreshold (dB/s) while the MAC retries at least
+ *    MinRetryRate data frames per second.
+ *
+ * Such a loss sets ssthresh to MobilityBeta times the bytes in flight instead of half of
+ * them, so that after recovery, or after the slow start that follows a timeout, the
+ * window comes back to where the link still supports it. Without a monitor on the node,
+ * or when none of the conditions holds, it behaves as TcpNewReno.
+ *
+ * Select it with --tcpVariant=TcpMobilityAware; the station nodes need
+ * LinkQualityMonitor::Install.
+ */
+class TcpMobilityAware : public TcpNewReno
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    TcpMobilityAware();
+
+    /**
+     * \brief Copy constructor.
+     * \param sock the object to copy
+     */
+    TcpMobilityAware(const TcpMobilityAware& sock);
+
+    ~TcpMobilityAware() override;
+
+    std::string GetName() const override;
+    uint32_t GetSsThresh(Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight) override;
+    Ptr<TcpCongestionOps> Fork() override;
+
+    /**
+     * \return the losses classified as caused by mobility, over every instance
+     */
+    static uint64_t GetMobilityLosses();
+
+    /**
+     * \return the losses classified as congestion, over every instance
+     */
+    static uint64_t GetCongestionLosses();
+
+  private:
+    /**
+     * \return true if the link layer of the current node explains a loss now
+     */
+    bool IsMobilityLoss() const;
+
+    double m_mobilityBeta;   //!< multiplicative decrease for mobility losses
+    double m_trendThreshold; //!< RSSI trend below which the station is leaving, dB/s
+    double m_weakRssi;       //!< RSSI below which losses are blamed on range, dBm
+    double m_minRetryRate;   //!< MAC retries per second that confirm a falling RSSI
+    Time m_handoverGuard;    //!< time after a handover during which losses are forgiven
+
+    static uint64_t s_mobilityLosses;   //!< mobility losses of every instance
+    static uint64_t s_congestionLosses; //!< congestion losses of every instance
+};
+
+} // namespace ns3
+
+#endif /* TCP_MOBILITY_AWARE_H */
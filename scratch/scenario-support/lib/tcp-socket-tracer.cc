@@ -0,0 +1,288 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-socket-tracer.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/node-list.h"
+#include "ns3/object-vector.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/uinteger.h"
+
+#include <cstring>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TcpSocketTracer");
+
+NS_OBJECT_ENSURE_REGISTERED(TcpSocketTracer);
+
+const char TcpSocketTracer::MAGIC[8] = {'N', 'S', '3', 'T', 'C', 'P', 'T', 'R'};
+const uint32_t TcpSocketTracer::VERSION = 1;
+
+static_assert(sizeof(TcpSocketTracer::Record) == 24, "TCP trace records must stay packed");
+
+/// Number of value types subject to decimation, CWND to RTO
+static const uint32_t DECIMATED_TYPES = TcpSocketTracer::RTO - TcpSocketTracer::CWND + 1;
+
+TypeId
+TcpSocketTracer::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TcpSocketTracer")
+            .SetParent<Object>()
+            .AddConstructor<TcpSocketTracer>()
+            .AddAttribute("ScanInterval",
+                          "Period at which new sockets are looked for.",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&TcpSocketTracer::m_scanInterval),
+                          MakeTimeChecker(MicroSeconds(1)))
+            .AddAttribute("Decimation",
+                          "Keep one of every N cwnd, ssthresh, RTT and RTO changes of a socket.",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&TcpSocketTracer::m_decimation),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("BufferSize",
+                          "Number of records buffered before they are written out.",
+                          UintegerValue(8192),
+                          MakeUintegerAccessor(&TcpSocketTracer::m_bufferSize),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+TcpSocketTracer::TcpSocketTracer()
+    : m_records(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpSocketTracer::~TcpSocketTracer()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+TcpSocketTracer::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Stop();
+    if (m_output.is_open())
+    {
+        m_output.close();
+    }
+    m_sockets.clear();
+    m_seen.clear();
+    Object::DoDispose();
+}
+
+void
+TcpSocketTracer::Open(const std::string& fileName)
+{
+    NS_LOG_FUNCTION(this << fileName);
+    m_output.open(fileName, std::ios::binary);
+    NS_ABORT_MSG_UNLESS(m_output.is_open(), "Could not open " << fileName);
+    m_output.write(MAGIC, sizeof(MAGIC));
+    m_output.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+    m_buffer.reserve(m_bufferSize);
+}
+
+void
+TcpSocketTracer::Start(Time start)
+{
+    NS_LOG_FUNCTION(this << start);
+    m_scanEvent.Cancel();
+    m_scanEvent = Simulator::Schedule(start, &TcpSocketTracer::Scan, this);
+}
+
+void
+TcpSocketTracer::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    m_scanEvent.Cancel();
+    Flush();
+}
+
+uint32_t
+TcpSocketTracer::GetNSockets() const
+{
+    return m_sockets.size();
+}
+
+uint64_t
+TcpSocketTracer::GetNRecords() const
+{
+    return m_records;
+}
+
+void
+TcpSocketTracer::Scan()
+{
+    NS_LOG_FUNCTION(this);
+    for (uint32_t i = 0; i < NodeList::GetNNodes(); ++i)
+    {
+        Ptr<Node> node = NodeList::GetNode(i);
+        Ptr<TcpL4Protocol> tcp = node->GetObject<TcpL4Protocol>();
+        if (!tcp)
+        {
+            continue;
+        }
+        ObjectVectorValue sockets;
+        tcp->GetAttribute("SocketList", sockets);
+        for (auto it = sockets.Begin(); it != sockets.End(); ++it)
+        {
+            Ptr<TcpSocketBase> socket = DynamicCast<TcpSocketBase>(it->second);
+            if (socket && m_seen.insert(PeekPointer(socket)).second)
+            {
+                Attach(socket, node->GetId());
+            }
+        }
+    }
+    m_scanEvent = Simulator::Schedule(m_scanInterval, &TcpSocketTracer::Scan, this);
+}
+
+void
+TcpSocketTracer::Attach(Ptr<TcpSocketBase> socket, uint32_t node)
+{
+    uint32_t id = m_sockets.size();
+    NS_LOG_FUNCTION(this << socket << node << id);
+    // Keeping the socket alive also keeps its address from being reused by a later one
+    m_sockets.push_back(socket);
+    m_changes.resize(m_changes.size() + DECIMATED_TYPES, 0);
+    Add(id, SOCKET, node);
+
+    socket->TraceConnectWithoutContext(
+        "CongestionWindow",
+        MakeCallback(&TcpSocketTracer::CwndChange, this).Bind(id));
+    socket->TraceConnectWithoutContext(
+        "SlowStartThreshold",
+        MakeCallback(&TcpSocketTracer::SsthreshChange, this).Bind(id));
+    socket->TraceConnectWithoutContext("RTT",
+                                       MakeCallback(&TcpSocketTracer::RttChange, this).Bind(id));
+    socket->TraceConnectWithoutContext("RTO",
+                                       MakeCallback(&TcpSocketTracer::RtoChange, this).Bind(id));
+    socket->TraceConnectWithoutContext(
+        "CongState",
+        MakeCallback(&TcpSocketTracer::CongStateChange, this).Bind(id));
+    socket->TraceConnectWithoutContext(
+        "Retransmission",
+        MakeCallback(&TcpSocketTracer::Retransmission, this).Bind(id));
+}
+
+void
+TcpSocketTracer::Add(uint32_t socket, RecordType type, double value)
+{
+    if (!m_output.is_open())
+    {
+        return;
+    }
+    m_buffer.push_back({Simulator::Now().GetNanoSeconds(), value, socket, type});
+    ++m_records;
+    if (m_buffer.size() >= m_bufferSize)
+    {
+        Flush();
+    }
+}
+
+void
+TcpSocketTracer::AddDecimated(uint32_t socket, RecordType type, double value)
+{
+    uint32_t& changes = m_changes[socket * DECIMATED_TYPES + (type - CWND)];
+    if (changes++ % m_decimation == 0)
+    {
+        Add(socket, type, value);
+    }
+}
+
+void
+TcpSocketTracer::Flush()
+{
+    if (m_buffer.empty() || !m_output.is_open())
+    {
+        return;
+    }
+    m_output.write(reinterpret_cast<const char*>(m_buffer.data()),
+                   m_buffer.size() * sizeof(Record));
+    NS_ABORT_MSG_UNLESS(m_output.good(), "Error while writing the TCP trace");
+    m_buffer.clear();
+}
+
+void
+TcpSocketTracer::CwndChange(uint32_t socket, uint32_t /* oldValue */, uint32_t newValue)
+{
+    AddDecimated(socket, CWND, newValue);
+}
+
+void
+TcpSocketTracer::SsthreshChange(uint32_t socket, uint32_t /* oldValue */, uint32_t newValue)
+{
+    AddDecimated(socket, SSTHRESH, newValue);
+}
+
+void
+TcpSocketTracer::RttChange(uint32_t socket, Time /* oldValue */, Time newValue)
+{
+    AddDecimated(socket, RTT, newValue.GetSeconds());
+}
+
+void
+TcpSocketTracer::RtoChange(uint32_t socket, Time /* oldValue */, Time newValue)
+{
+    AddDecimated(socket, RTO, newValue.GetSeconds());
+}
+
+void
+TcpSocketTracer::CongStateChange(uint32_t socket,
+                                 TcpSocketState::TcpCongState_t /* oldValue */,
+                                 TcpSocketState::TcpCongState_t newValue)
+{
+    Add(socket, CONG_STATE, newValue);
+}
+
+void
+TcpSocketTracer::Retransmission(uint32_t socket,
+                                Ptr<const Packet> /* packet */,
+                                const TcpHeader& header,
+                                const Address& /* localAddress */,
+                                const Address& /* peerAddress */,
+                                Ptr<const TcpSocketBase> /* tcp */)
+{
+    Add(socket, RETRANSMISSION, header.GetSequenceNumber().GetValue());
+}
+
+void
+TcpSocketTracer::ReadHeader(std::istream& in)
+{
+    char magic[sizeof(MAGIC)];
+    uint32_t version;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    NS_ABORT_MSG_UNLESS(in.good() && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0,
+                        "Not a TCP socket trace");
+    NS_ABORT_MSG_UNLESS(version == VERSION, "Unsupported TCP socket trace version " << version);
+}
+
+bool
+TcpSocketTracer::ReadRecord(std::istream& in, Record& record)
+{
+    in.read(reinterpret_cast<char*>(&record), sizeof(record));
+    return static_cast<bool>(in);
+}
+
+} // namespace ns3
@@ -0,0 +1,202 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_SOCKET_TRACER_H
+#define TCP_SOCKET_TRACER_H
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/sequence-number.h"
+#include "ns3/tcp-socket-state.h"
+
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace ns3
+{
+
+class Address;
+class Packet;
+class TcpHeader;
+class TcpSocketBase;
+
+/**
+ * \brief Binary congestion-control traces of every TCP socket of the simulation.
+ *
+ * Every ScanInterval the tracer walks the SocketList of the TcpL4Protocol of each node
+ * and connects to the sockets it has not seen yet, so the sockets the OnOff applications
+ * open and those a PacketSink accepts are all followed without any per-application
+ * wiring. From each socket it records the congestion window, slow start threshold, RTT,
+ * RTO, congestion state changes and retransmissions. Changes that happen before the scan
+ * that discovers a socket, at most one ScanInterval after its creation, are not seen.
+ *
+ * Records have a fixed size and are written through a buffer of BufferSize records. With
+ * Decimation = N, only one of every N cwnd, ssthresh, RTT and RTO changes of a socket is
+ * kept; state changes and retransmissions are always kept.
+ *
+ * The file is an 8-byte magic and a uint32 version, followed by Record structures up to
+ * the end of the file, in host byte order. The first record of every socket is of type
+ * SOCKET, with the id of its node as value.
+ */
+class TcpSocketTracer : public Object
+{
+  public:
+    /// What a record holds
+    enum RecordType : uint32_t
+    {
+        SOCKET,         //!< socket attached, value: node id
+        CWND,           //!< congestion window, bytes
+        SSTHRESH,       //!< slow start threshold, bytes
+        RTT,            //!< RTT estimate, s
+        RTO,            //!< retransmission timeout, s
+        CONG_STATE,     //!< new TcpSocketState::TcpCongState_t
+        RETRANSMISSION, //!< retransmitted segment, value: sequence number
+    };
+
+    /// One trace record
+    struct Record
+    {
+        int64_t time;    //!< ns
+        double value;    //!< depends on the type
+        uint32_t socket; //!< socket id, in order of discovery
+        uint32_t type;   //!< RecordType
+    };
+
+    static const char MAGIC[8];    //!< file signature
+    static const uint32_t VERSION; //!< format version
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    TcpSocketTracer();
+    ~TcpSocketTracer() override;
+
+    /**
+     * \brief Open the trace file and write its header.
+     * \param fileName output file
+     */
+    void Open(const std::string& fileName);
+
+    /**
+     * \brief Start scanning for sockets.
+     * \param start delay before the first scan
+     */
+    void Start(Time start);
+
+    /**
+     * \brief Stop scanning and write the buffered records.
+     */
+    void Stop();
+
+    /**
+     * \return the number of sockets followed so far
+     */
+    uint32_t GetNSockets() const;
+
+    /**
+     * \return the number of records written or buffered so far
+     */
+    uint64_t GetNRecords() const;
+
+    /**
+     * \brief Read the file header.
+     * \param in input stream positioned at the start of the file
+     */
+    static void ReadHeader(std::istream& in);
+
+    /**
+     * \brief Read the next record.
+     * \param in input stream positioned after the header or a previous record
+     * \param record filled with the record
+     * \return false at end of file
+     */
+    static bool ReadRecord(std::istream& in, Record& record);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Attach to the sockets created since the last scan
+    void Scan();
+
+    /**
+     * \brief Connect the trace sources of a socket.
+     * \param socket the socket
+     * \param node id of its node
+     */
+    void Attach(Ptr<TcpSocketBase> socket, uint32_t node);
+
+    /**
+     * \brief Buffer a record, writing the buffer out when it is full.
+     * \param socket socket id
+     * \param type record type
+     * \param value record value
+     */
+    void Add(uint32_t socket, RecordType type, double value);
+
+    /**
+     * \brief Buffer a record subject to decimation.
+     * \param socket socket id
+     * \param type record type
+     * \param value record value
+     */
+    void AddDecimated(uint32_t socket, RecordType type, double value);
+
+    /// Write the buffered records to the file
+    void Flush();
+
+    /// CongestionWindow trace sink, bound to the socket id
+    void CwndChange(uint32_t socket, uint32_t oldValue, uint32_t newValue);
+    /// SlowStartThreshold trace sink, bound to the socket id
+    void SsthreshChange(uint32_t socket, uint32_t oldValue, uint32_t newValue);
+    /// RTT trace sink, bound to the socket id
+    void RttChange(uint32_t socket, Time oldValue, Time newValue);
+    /// RTO trace sink, bound to the socket id
+    void RtoChange(uint32_t socket, Time oldValue, Time newValue);
+    /// CongState trace sink, bound to the socket id
+    void CongStateChange(uint32_t socket,
+                         TcpSocketState::TcpCongState_t oldValue,
+                         TcpSocketState::TcpCongState_t newValue);
+    /// Retransmission trace sink, bound to the socket id
+    void Retransmission(uint32_t socket,
+                        Ptr<const Packet> packet,
+                        const TcpHeader& header,
+                        const Address& localAddress,
+                        const Address& peerAddress,
+                        Ptr<const TcpSocketBase> tcp);
+
+    Time m_scanInterval;      //!< period of the socket scans
+    uint32_t m_decimation;    //!< keep one of every m_decimation value changes
+    uint32_t m_bufferSize;    //!< records buffered before a write
+    std::ofstream m_output;   //!< trace file
+    std::vector<Record> m_buffer; //!< records not written yet
+    uint64_t m_records;       //!< records so far
+    std::vector<Ptr<TcpSocketBase>> m_sockets; //!< followed sockets, index is the id
+    std::unordered_set<const TcpSocketBase*> m_seen; //!< followed sockets, for the scans
+    std::vector<uint32_t> m_changes; //!< value changes per socket and decimated type
+    EventId m_scanEvent;      //!< next scan
+};
+
+} // namespace ns3
+
+#endif /* TCP_SOCKET_TRACER_H */
@@ -0,0 +1,250 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "throughput-monitor.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ThroughputMonitor");
+
+NS_OBJECT_ENSURE_REGISTERED(ThroughputMonitor);
+
+TypeId
+ThroughputMonitor::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::ThroughputMonitor")
+            .SetParent<Object>()
+            .AddConstructor<ThroughputMonitor>()
+            .AddAttribute("Window",
+                          "Sampling window.",
+                          TimeValue(Seconds(1.0)),
+                          MakeTimeAccessor(&ThroughputMonitor::m_window),
+                          MakeTimeChecker(TimeStep(1)))
+            .AddAttribute("BufferSize",
+                          "Number of samples kept in memory before they are written out.",
+                          UintegerValue(64),
+                          MakeUintegerAccessor(&ThroughputMonitor::m_bufferSize),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+ThroughputMonitor::ThroughputMonitor()
+    : m_rows(0),
+      m_headerWritten(false)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ThroughputMonitor::~ThroughputMonitor()
+{
+    NS_LOG_FUNCTION(this);
+    Flush();
+}
+
+void
+ThroughputMonitor::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Stop();
+    m_sinks.clear();
+    m_db = nullptr;
+    Object::DoDispose();
+}
+
+void
+ThroughputMonitor::AddSink(Ptr<PacketSink> sink, const std::string& name)
+{
+    NS_LOG_FUNCTION(this << sink << name);
+    NS_ABORT_MSG_IF(m_sampleEvent.IsPending(), "Sinks must be added before Start");
+    m_names.push_back(name.empty() ? "sink" + std::to_string(m_sinks.size()) : name);
+    m_sinks.push_back(sink);
+}
+
+void
+ThroughputMonitor::EnableOutput(const std::string& fileName)
+{
+    NS_LOG_FUNCTION(this << fileName);
+    m_output.open(fileName);
+    NS_ABORT_MSG_UNLESS(m_output.is_open(), "Could not open " << fileName);
+}
+
+void
+ThroughputMonitor::EnableDatabase(Ptr<ResultsDatabase> db, const std::string& prefix)
+{
+    NS_LOG_FUNCTION(this << db << prefix);
+    m_db = db;
+    m_seriesPrefix = prefix;
+}
+
+void
+ThroughputMonitor::Start(Time start)
+{
+    NS_LOG_FUNCTION(this << start);
+    m_startEvent.Cancel();
+    m_sampleEvent.Cancel();
+    m_startRx.assign(m_sinks.size(), 0);
+    m_lastRx.assign(m_sinks.size(), 0);
+    m_buffer.assign(static_cast<size_t>(m_bufferSize) * (m_sinks.size() + 2), 0.0);
+    m_rows = 0;
+    m_startTime = Simulator::Now() + start;
+    m_lastTime = m_startTime;
+
+    // The first window begins at Start, not at time zero
+    m_startEvent = Simulator::Schedule(start, [this]() {
+        for (size_t i = 0; i < m_sinks.size(); ++i)
+        {
+            m_startRx[i] = m_sinks[i]->GetTotalRx();
+            m_lastRx[i] = m_startRx[i];
+        }
+    });
+    m_sampleEvent = Simulator::Schedule(start + m_window, &ThroughputMonitor::Sample, this);
+}
+
+void
+ThroughputMonitor::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    m_startEvent.Cancel();
+    m_sampleEvent.Cancel();
+    Flush();
+    if (m_output.is_open())
+    {
+        m_output.flush();
+    }
+}
+
+uint32_t
+ThroughputMonitor::GetNSinks() const
+{
+    return m_sinks.size();
+}
+
+double
+ThroughputMonitor::GetLastThroughput(uint32_t index) const
+{
+    NS_ASSERT(index < m_sinks.size());
+    return m_lastRow.empty() ? 0.0 : m_lastRow[1 + index];
+}
+
+double
+ThroughputMonitor::GetLastTotalThroughput() const
+{
+    return m_lastRow.empty() ? 0.0 : m_lastRow.back();
+}
+
+double
+ThroughputMonitor::GetMeanThroughput(uint32_t index) const
+{
+    NS_ASSERT(index < m_sinks.size());
+    double elapsed = (Simulator::Now() - m_startTime).GetSeconds();
+    if (elapsed <= 0 || m_startRx.empty())
+    {
+        return 0.0;
+    }
+    return (m_sinks[index]->GetTotalRx() - m_startRx[index]) * 8.0 / elapsed / 1e6;
+}
+
+double
+ThroughputMonitor::GetMeanTotalThroughput() const
+{
+    double total = 0.0;
+    for (uint32_t i = 0; i < m_sinks.size(); ++i)
+    {
+        total += GetMeanThroughput(i);
+    }
+    return total;
+}
+
+void
+ThroughputMonitor::Sample()
+{
+    NS_LOG_FUNCTION(this);
+    Time now = Simulator::Now();
+    double elapsed = (now - m_lastTime).GetSeconds();
+    size_t columns = m_sinks.size() + 2;
+
+    if (m_rows == m_bufferSize)
+    {
+        Flush();
+    }
+    double* values = &m_buffer[m_rows * columns];
+    values[0] = now.GetSeconds();
+    double total = 0.0;
+    for (size_t i = 0; i < m_sinks.size(); ++i)
+    {
+        uint64_t rx = m_sinks[i]->GetTotalRx();
+        values[1 + i] = (rx - m_lastRx[i]) * 8.0 / elapsed / 1e6;
+        total += values[1 + i];
+        m_lastRx[i] = rx;
+    }
+    values[columns - 1] = total;
+    m_lastRow.assign(values, values + columns);
+    ++m_rows;
+    m_lastTime = now;
+
+    m_sampleEvent = Simulator::Schedule(m_window, &ThroughputMonitor::Sample, this);
+}
+
+void
+ThroughputMonitor::Flush()
+{
+    size_t columns = m_sinks.size() + 2;
+    if (m_db)
+    {
+        for (uint32_t r = 0; r < m_rows; ++r)
+        {
+            const double* values = &m_buffer[r * columns];
+            for (size_t c = 1; c < columns; ++c)
+            {
+                std::string name = c < columns - 1 ? m_names[c - 1] : "total";
+                m_db->AddSample(m_seriesPrefix + name, values[0], values[c]);
+            }
+        }
+    }
+    if (m_output.is_open())
+    {
+        if (!m_headerWritten)
+        {
+            m_output << "# time";
+            for (const auto& name : m_names)
+            {
+                m_output << "\t" << name;
+            }
+            m_output << "\ttotal\n";
+            m_headerWritten = true;
+        }
+        for (uint32_t r = 0; r < m_rows; ++r)
+        {
+            const double* values = &m_buffer[r * columns];
+            m_output << values[0];
+            for (size_t c = 1; c < columns; ++c)
+            {
+                m_output << "\t" << values[c];
+            }
+            m_output << "\n";
+        }
+    }
+    // Without any output the rows are only dropped
+    m_rows = 0;
+}
+
+} // namespace ns3
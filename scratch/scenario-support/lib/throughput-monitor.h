@@ -0,0 +1,145 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef THROUGHPUT_MONITOR_H
+#define THROUGHPUT_MONITOR_H
+
+#include "results-database.h"
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/packet-sink.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Samples the received bytes of any number of PacketSinks on a fixed window.
+ *
+ * Every Window the monitor reads GetTotalRx() of each registered sink and converts the
+ * difference to Mb/s using the time actually elapsed since the previous sample, so the
+ * normalization always matches the window. Samples are buffered, up to BufferSize rows,
+ * and written out as a single multi-column time series (time, one column per sink,
+ * total) whenever the buffer is full and when the monitor is stopped or destroyed, to a
+ * file and/or a ResultsDatabase.
+ */
+class ThroughputMonitor : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    ThroughputMonitor();
+    ~ThroughputMonitor() override;
+
+    /**
+     * \brief Register a sink. Sinks must be added before Start.
+     * \param sink the sink to sample
+     * \param name column name, "sink<index>" if empty
+     */
+    void AddSink(Ptr<PacketSink> sink, const std::string& name = "");
+
+    /**
+     * \brief Write the time series to the given file.
+     * \param fileName output file
+     */
+    void EnableOutput(const std::string& fileName);
+
+    /**
+     * \brief Also store the time series in a results database.
+     *
+     * Each column becomes the series "<prefix><sink name>", plus "<prefix>total".
+     *
+     * \param db the results database of the run
+     * \param prefix series name prefix
+     */
+    void EnableDatabase(Ptr<ResultsDatabase> db, const std::string& prefix = "throughput/");
+
+    /**
+     * \brief Start sampling.
+     * \param start time at which the first window begins
+     */
+    void Start(Time start);
+
+    /// Stop sampling and flush the buffered samples
+    void Stop();
+
+    /**
+     * \return the number of registered sinks
+     */
+    uint32_t GetNSinks() const;
+
+    /**
+     * \param index sink index
+     * \return the throughput (Mb/s) of the sink over the last complete window
+     */
+    double GetLastThroughput(uint32_t index) const;
+
+    /**
+     * \return the throughput (Mb/s) of all sinks together over the last complete window
+     */
+    double GetLastTotalThroughput() const;
+
+    /**
+     * \param index sink index
+     * \return the throughput (Mb/s) of the sink since Start
+     */
+    double GetMeanThroughput(uint32_t index) const;
+
+    /**
+     * \return the throughput (Mb/s) of all sinks together since Start
+     */
+    double GetMeanTotalThroughput() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Take one sample and reschedule
+    void Sample();
+
+    /// Write the buffered rows to the outputs and empty the buffer
+    void Flush();
+
+    Time m_window;                      //!< sampling window
+    uint32_t m_bufferSize;              //!< flush buffer capacity, in rows
+    std::vector<Ptr<PacketSink>> m_sinks; //!< sampled sinks
+    std::vector<std::string> m_names;   //!< column names
+    std::vector<uint64_t> m_startRx;    //!< total received bytes at Start
+    std::vector<uint64_t> m_lastRx;     //!< total received bytes at the last sample
+    Time m_startTime;                   //!< time of Start
+    Time m_lastTime;                    //!< time of the last sample
+    std::vector<double> m_buffer;       //!< rows of (time, sink..., total) not written yet
+    std::vector<double> m_lastRow;      //!< most recent row, kept across flushes
+    uint32_t m_rows;                    //!< number of rows in the buffer
+    std::ofstream m_output;             //!< time series output
+    Ptr<ResultsDatabase> m_db;          //!< time series database, if any
+    std::string m_seriesPrefix;         //!< database series name prefix
+    bool m_headerWritten;               //!< whether the column names were written
+    EventId m_startEvent;               //!< reading of the byte counts at Start
+    EventId m_sampleEvent;              //!< next sample
+};
+
+} // namespace ns3
+
+#endif /* THROUGHPUT_MONITOR_H */
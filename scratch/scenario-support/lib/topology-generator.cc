@@ -0,0 +1,425 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "topology-generator.h"
+
+#include "ns3/abort.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TopologyGenerator");
+
+void
+TopologyGenerator::Layout::Append(const Layout& other)
+{
+    NS_ABORT_MSG_UNLESS(positions.empty() || velocities.empty() == other.velocities.empty(),
+                        "Cannot append moving and static layouts");
+    positions.insert(positions.end(), other.positions.begin(), other.positions.end());
+    velocities.insert(velocities.end(), other.velocities.begin(), other.velocities.end());
+}
+
+TopologyGenerator::TopologyGenerator()
+    : m_uniform(CreateObject<UniformRandomVariable>()),
+      m_normal(CreateObject<NormalRandomVariable>())
+{
+}
+
+int64_t
+TopologyGenerator::AssignStreams(int64_t stream)
+{
+    m_uniform->SetStream(stream);
+    m_normal->SetStream(stream + 1);
+    return 2;
+}
+
+TopologyGenerator::Layout
+TopologyGenerator::Grid(uint32_t count, Vector min, Vector delta, uint32_t width, bool rowFirst)
+{
+    NS_ABORT_MSG_UNLESS(width > 0, "Grid width must be positive");
+    Layout layout;
+    layout.positions.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t along = i % width;
+        uint32_t across = i / width;
+        layout.positions.emplace_back(min.x + delta.x * (rowFirst ? along : across),
+                                      min.y + delta.y * (rowFirst ? across : along),
+                                      min.z);
+    }
+    return layout;
+}
+
+TopologyGenerator::Layout
+TopologyGenerator::Ellipse(uint32_t count, Vector center, double radiusX, double radiusY)
+{
+    Layout layout;
+    layout.positions.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        double angle = 2 * M_PI * i / count;
+        layout.positions.emplace_back(center.x + radiusX * std::cos(angle),
+                                      center.y + radiusY * std::sin(angle),
+                                      center.z);
+    }
+    return layout;
+}
+
+TopologyGenerator::Layout
+TopologyGenerator::Line(uint32_t count, Vector from, Vector to)
+{
+    Layout layout;
+    layout.positions.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        double w = count > 1 ? static_cast<double>(i) / (count - 1) : 0.0;
+        layout.positions.emplace_back(from.x + w * (to.x - from.x),
+                                      from.y + w * (to.y - from.y),
+                                      from.z + w * (to.z - from.z));
+    }
+    return layout;
+}
+
+TopologyGenerator::Layout
+TopologyGenerator::Box(uint32_t count, Vector min, Vector max) const
+{
+    Layout layout;
+    layout.positions.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        double x = m_uniform->GetValue(min.x, max.x);
+        double y = m_uniform->GetValue(min.y, max.y);
+        double z = min.z == max.z ? min.z : m_uniform->GetValue(min.z, max.z);
+        layout.positions.emplace_back(x, y, z);
+    }
+    return layout;
+}
+
+TopologyGenerator::Layout
+TopologyGenerator::Disk(uint32_t count, Vector center, double radius) const
+{
+    Layout layout;
+    layout.positions.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        // sqrt makes the density uniform over the area rather than over the radius
+        double r = radius * std::sqrt(m_uniform->GetValue());
+        double angle = m_uniform->GetValue(0, 2 * M_PI);
+        layout.positions.emplace_back(center.x + r * std::cos(angle),
+                                      center.y + r * std::sin(angle),
+                                      center.z);
+    }
+    return layout;
+}
+
+TopologyGenerator::Layout
+TopologyGenerator::PoissonDisk(uint32_t count, Vector min, Vector max, double minDistance) const
+{
+    NS_LOG_FUNCTION(this << count << min << max << minDistance);
+    NS_ABORT_MSG_UNLESS(minDistance > 0, "Poisson-disk minimum distance must be positive");
+    NS_ABORT_MSG_UNLESS(max.x > min.x && max.y > min.y, "Empty Poisson-disk rectangle");
+
+    // Cells of minDistance: a conflicting node can only be in the 3x3 neighboring cells.
+    // Hashed, so memory follows the node count rather than the area.
+    const uint32_t attempts = 30;
+    Layout layout;
+    std::vector<Vector>& positions = layout.positions;
+    positions.reserve(count);
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells;
+    cells.reserve(count);
+    auto cellKey = [](int64_t cx, int64_t cy) {
+        return (static_cast<uint64_t>(cx) << 32) ^ static_cast<uint32_t>(cy);
+    };
+    auto cellOf = [&](double v, double origin) {
+        return static_cast<int64_t>(std::floor((v - origin) / minDistance));
+    };
+    auto isFree = [&](double x, double y) {
+        int64_t cx = cellOf(x, min.x);
+        int64_t cy = cellOf(y, min.y);
+        for (int64_t dx = -1; dx <= 1; ++dx)
+        {
+            for (int64_t dy = -1; dy <= 1; ++dy)
+            {
+                auto it = cells.find(cellKey(cx + dx, cy + dy));
+                if (it == cells.end())
+                {
+                    continue;
+                }
+                for (uint32_t j : it->second)
+                {
+                    double ex = positions[j].x - x;
+                    double ey = positions[j].y - y;
+                    if (ex * ex + ey * ey < minDistance * minDistance)
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    };
+    auto add = [&](double x, double y) {
+        cells[cellKey(cellOf(x, min.x), cellOf(y, min.y))].push_back(positions.size());
+        positions.emplace_back(x, y, min.z);
+    };
+
+    // Dart throwing spreads the nodes over the whole rectangle
+    for (uint64_t dart = 0; dart < static_cast<uint64_t>(attempts) * count; ++dart)
+    {
+        if (positions.size() == count)
+        {
+            return layout;
+        }
+        double x = m_uniform->GetValue(min.x, max.x);
+        double y = m_uniform->GetValue(min.y, max.y);
+        if (isFree(x, y))
+        {
+            add(x, y);
+        }
+    }
+
+    // Close to saturation: Bridson's algorithm, candidates in the [r, 2r] annulus of an
+    // active node, which retires after as many failed candidates
+    std::vector<uint32_t> active(positions.size());
+    for (uint32_t i = 0; i < active.size(); ++i)
+    {
+        active[i] = i;
+    }
+    while (positions.size() < count && !active.empty())
+    {
+        uint32_t a = m_uniform->GetInteger(0, active.size() - 1);
+        Vector center = positions[active[a]];
+        bool placed = false;
+        for (uint32_t k = 0; k < attempts && !placed; ++k)
+        {
+            double angle = m_uniform->GetValue(0, 2 * M_PI);
+            double distance = m_uniform->GetValue(minDistance, 2 * minDistance);
+            double x = center.x + distance * std::cos(angle);
+            double y = center.y + distance * std::sin(angle);
+            if (x >= min.x && x <= max.x && y >= min.y && y <= max.y && isFree(x, y))
+            {
+                active.push_back(positions.size());
+                add(x, y);
+                placed = true;
+            }
+        }
+        if (!placed)
+        {
+            active[a] = active.back();
+            active.pop_back();
+        }
+    }
+    NS_ABORT_MSG_IF(positions.size() < count,
+                    "Only " << positions.size() << " nodes fit " << minDistance
+                            << " m apart in the rectangle, " << count << " requested");
+    return layout;
+}
+
+TopologyGenerator::Layout
+TopologyGenerator::Clusters(uint32_t count,
+                            uint32_t clusters,
+                            Vector min,
+                            Vector max,
+                            double sigma) const
+{
+    NS_ABORT_MSG_UNLESS(clusters > 0, "At least one cluster expected");
+    std::vector<Vector> centers;
+    centers.reserve(clusters);
+    for (uint32_t c = 0; c < clusters; ++c)
+    {
+        double x = m_uniform->GetValue(min.x, max.x);
+        double y = m_uniform->GetValue(min.y, max.y);
+        centers.emplace_back(x, y, min.z);
+    }
+
+    Layout layout;
+    layout.positions.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const Vector& center = centers[i % clusters];
+        double x = center.x + m_normal->GetValue(0, sigma * sigma);
+        double y = center.y + m_normal->GetValue(0, sigma * sigma);
+        layout.positions.emplace_back(std::clamp(x, min.x, max.x),
+                                      std::clamp(y, min.y, max.y),
+                                      min.z);
+    }
+    return layout;
+}
+
+TopologyGenerator::Layout
+TopologyGenerator::Manhattan(uint32_t count,
+                             Vector min,
+                             double blockSize,
+                             uint32_t streetsX,
+                             uint32_t streetsY,
+                             double speed) const
+{
+    NS_ABORT_MSG_UNLESS(streetsX >= 2 && streetsY >= 2, "At least 2 streets per direction");
+    NS_ABORT_MSG_UNLESS(blockSize > 0, "Block size must be positive");
+    double lengthX = (streetsY - 1) * blockSize; // streets along x span the streets along y
+    double lengthY = (streetsX - 1) * blockSize;
+    double totalX = streetsX * lengthX;
+
+    Layout layout;
+    layout.positions.reserve(count);
+    if (speed != 0)
+    {
+        layout.velocities.reserve(count);
+    }
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        double u = m_uniform->GetValue(0, totalX + streetsY * lengthY);
+        double direction = m_uniform->GetValue() < 0.5 ? speed : -speed;
+        if (u < totalX)
+        {
+            auto street = std::min(static_cast<uint32_t>(u / lengthX), streetsX - 1);
+            layout.positions.emplace_back(min.x + u - street * lengthX,
+                                          min.y + street * blockSize,
+                                          min.z);
+            if (speed != 0)
+            {
+                layout.velocities.emplace_back(direction, 0, 0);
+            }
+        }
+        else
+        {
+            u -= totalX;
+            auto street = std::min(static_cast<uint32_t>(u / lengthY), streetsY - 1);
+            layout.positions.emplace_back(min.x + street * blockSize,
+                                          min.y + u - street * lengthY,
+                                          min.z);
+            if (speed != 0)
+            {
+                layout.velocities.emplace_back(0, direction, 0);
+            }
+        }
+    }
+    return layout;
+}
+
+void
+TopologyGenerator::SetVelocities(Layout& layout, const std::vector<Vector>& pattern)
+{
+    NS_ABORT_MSG_IF(pattern.empty(), "Empty velocity pattern");
+    uint32_t count = layout.positions.size();
+    uint32_t parts = pattern.size();
+    layout.velocities.resize(count);
+    // Part k starts at node k * count / parts, as the scenarios split their vehicles
+    uint32_t part = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        while (part + 1 < parts && i >= static_cast<uint64_t>(part + 1) * count / parts)
+        {
+            ++part;
+        }
+        layout.velocities[i] = pattern[part];
+    }
+}
+
+void
+TopologyGenerator::Install(const NodeContainer& nodes, const Layout& layout, ObjectFactory factory)
+{
+    NS_LOG_FUNCTION(nodes.GetN() << layout.positions.size());
+    NS_ABORT_MSG_UNLESS(nodes.GetN() == layout.positions.size(),
+                        layout.positions.size() << " positions for " << nodes.GetN()
+                                                << " nodes");
+    bool moving = !layout.velocities.empty();
+    NS_ABORT_MSG_IF(moving && layout.velocities.size() != layout.positions.size(),
+                    "Velocities expected for every node");
+
+    // What MobilityHelper::Install does, without a position allocator in between
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        Ptr<MobilityModel> model = factory.Create<MobilityModel>();
+        nodes.Get(i)->AggregateObject(model);
+        model->SetPosition(layout.positions[i]);
+        if (moving)
+        {
+            Ptr<ConstantVelocityMobilityModel> constantVelocity =
+                DynamicCast<ConstantVelocityMobilityModel>(model);
+            NS_ABORT_MSG_UNLESS(constantVelocity,
+                                "Velocities need a ConstantVelocityMobilityModel");
+            constantVelocity->SetVelocity(layout.velocities[i]);
+        }
+    }
+}
+
+void
+TopologyGenerator::Install(const NodeContainer& nodes, const Layout& layout)
+{
+    Install(nodes,
+            layout,
+            ObjectFactory(layout.velocities.empty() ? "ns3::ConstantPositionMobilityModel"
+                                                    : "ns3::ConstantVelocityMobilityModel"));
+}
+
+void
+TopologyGenerator::Write(const Layout& layout, const std::string& fileName)
+{
+    std::ofstream out(fileName);
+    NS_ABORT_MSG_UNLESS(out.is_open(), "Could not open " << fileName);
+    out.precision(10);
+    for (uint32_t i = 0; i < layout.positions.size(); ++i)
+    {
+        const Vector& p = layout.positions[i];
+        out << p.x << " " << p.y << " " << p.z;
+        if (!layout.velocities.empty())
+        {
+            const Vector& v = layout.velocities[i];
+            out << " " << v.x << " " << v.y << " " << v.z;
+        }
+        out << "\n";
+    }
+}
+
+TopologyGenerator::Layout
+TopologyGenerator::Load(const std::string& fileName)
+{
+    std::ifstream in(fileName);
+    NS_ABORT_MSG_UNLESS(in.is_open(), "Could not open " << fileName);
+    Layout layout;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::istringstream fields(line);
+        Vector p;
+        NS_ABORT_MSG_UNLESS(fields >> p.x >> p.y >> p.z, "x y z expected: " << line);
+        Vector v;
+        bool moving = static_cast<bool>(fields >> v.x >> v.y >> v.z);
+        NS_ABORT_MSG_IF(!layout.positions.empty() && moving == layout.velocities.empty(),
+                        "Every line or none must have a velocity: " << line);
+        layout.positions.push_back(p);
+        if (moving)
+        {
+            layout.velocities.push_back(v);
+        }
+    }
+    return layout;
+}
+
+} // namespace ns3
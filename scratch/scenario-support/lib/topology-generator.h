@@ -0,0 +1,220 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TOPOLOGY_GENERATOR_H
+#define TOPOLOGY_GENERATOR_H
+
+#include "ns3/node-container.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/vector.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Node placements for the scenarios: grid, ellipse, line, box, disk,
+ * Poisson-disk, Gaussian clusters and Manhattan road lattice.
+ *
+ * Replaces the position allocator branches and hand-written position loops of the
+ * scenarios (proj's Grid/Circle/Ellipse topologies, the sensor network lines, circles
+ * and box, the vanet RowFirst/ColumnFirst halves and velocity quadrants). Every layout
+ * is generated in O(n) expected time and memory, Poisson-disk included, and Install
+ * aggregates the mobility models without going through a position allocator, so tens of
+ * thousands of nodes are placed in milliseconds.
+ *
+ * The random layouts draw from two random variable streams: the same RngSeed, RngRun
+ * and creation order (or AssignStreams) give the same placement.
+ */
+class TopologyGenerator
+{
+  public:
+    /// Initial position, and velocity for moving nodes, of every node
+    struct Layout
+    {
+        std::vector<Vector> positions;  //!< one per node
+        std::vector<Vector> velocities; //!< one per node, or empty for static nodes
+
+        /**
+         * \brief Append the nodes of another layout.
+         * \param other the layout, with velocities if and only if this one has some
+         */
+        void Append(const Layout& other);
+    };
+
+    TopologyGenerator();
+
+    /**
+     * \brief Assign fixed random variable stream numbers.
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned
+     */
+    int64_t AssignStreams(int64_t stream);
+
+    /**
+     * \brief Same placement as GridPositionAllocator.
+     * \param count number of nodes
+     * \param min position of the first node
+     * \param delta spacing along x and y
+     * \param width nodes per row (per column with rowFirst false)
+     * \param rowFirst fill rows first, as the RowFirst LayoutType
+     * \return the layout
+     */
+    static Layout Grid(uint32_t count, Vector min, Vector delta, uint32_t width, bool rowFirst);
+
+    /**
+     * \brief Nodes evenly spaced on an ellipse, the first one at angle 0.
+     * \param count number of nodes
+     * \param center center of the ellipse
+     * \param radiusX semi-axis along x
+     * \param radiusY semi-axis along y, radiusX for a circle
+     * \return the layout
+     */
+    static Layout Ellipse(uint32_t count, Vector center, double radiusX, double radiusY);
+
+    /**
+     * \brief Nodes evenly spaced from one point to another, both included.
+     * \param count number of nodes
+     * \param from first node
+     * \param to last node
+     * \return the layout
+     */
+    static Layout Line(uint32_t count, Vector from, Vector to);
+
+    /**
+     * \brief Nodes uniformly distributed in a box.
+     * \param count number of nodes
+     * \param min lower corner
+     * \param max upper corner, equal z for a flat box
+     * \return the layout
+     */
+    Layout Box(uint32_t count, Vector min, Vector max) const;
+
+    /**
+     * \brief Nodes uniformly distributed in a disk.
+     * \param count number of nodes
+     * \param center center of the disk
+     * \param radius radius of the disk
+     * \return the layout
+     */
+    Layout Disk(uint32_t count, Vector center, double radius) const;
+
+    /**
+     * \brief Nodes at least minDistance apart, uniformly spread over a rectangle.
+     *
+     * Darts are thrown at the rectangle and kept when no kept node is closer than
+     * minDistance, looked up in a hash grid of minDistance cells. If the darts do not
+     * place every node (the rectangle is close to saturation), Bridson's algorithm fills
+     * the gaps around the kept nodes. Aborts if the rectangle cannot hold count nodes.
+     *
+     * \param count number of nodes
+     * \param min lower corner
+     * \param max upper corner, z ignored
+     * \param minDistance minimum distance between two nodes
+     * \return the layout
+     */
+    Layout PoissonDisk(uint32_t count, Vector min, Vector max, double minDistance) const;
+
+    /**
+     * \brief Gaussian clusters around uniformly placed centers.
+     *
+     * Node i belongs to cluster i % clusters. Positions are clamped to the rectangle.
+     *
+     * \param count number of nodes
+     * \param clusters number of clusters
+     * \param min lower corner of the rectangle of the centers
+     * \param max upper corner, z ignored
+     * \param sigma standard deviation of the distance to the center along x and y
+     * \return the layout
+     */
+    Layout Clusters(uint32_t count, uint32_t clusters, Vector min, Vector max, double sigma)
+        const;
+
+    /**
+     * \brief Vehicles on a Manhattan lattice of streets.
+     *
+     * streetsX streets run along x and streetsY along y, blockSize apart, the first ones
+     * through min. Vehicles are uniformly spread over the total street length and drive
+     * at speed along their street, in either direction. They do not turn at
+     * intersections; use a dedicated mobility model for that.
+     *
+     * \param count number of vehicles
+     * \param min first intersection
+     * \param blockSize distance between parallel streets
+     * \param streetsX number of streets along x
+     * \param streetsY number of streets along y
+     * \param speed speed of every vehicle, 0 for parked vehicles without velocities
+     * \return the layout
+     */
+    Layout Manhattan(uint32_t count,
+                     Vector min,
+                     double blockSize,
+                     uint32_t streetsX,
+                     uint32_t streetsY,
+                     double speed) const;
+
+    /**
+     * \brief Give consecutive equal parts of the nodes a velocity each.
+     *
+     * {(v, 0, 0), (-v, 0, 0)} is the two-way road of the vehicle scenarios, four
+     * velocities the vanet quadrants.
+     *
+     * \param layout the layout
+     * \param pattern velocity of every part
+     */
+    static void SetVelocities(Layout& layout, const std::vector<Vector>& pattern);
+
+    /**
+     * \brief Aggregate a mobility model to every node and set its position and velocity.
+     * \param nodes the nodes, as many as the layout
+     * \param layout the layout
+     * \param factory mobility model factory; with velocities, the model must be a
+     *        ConstantVelocityMobilityModel
+     */
+    static void Install(const NodeContainer& nodes, const Layout& layout, ObjectFactory factory);
+
+    /**
+     * \brief Install ConstantVelocityMobilityModel with velocities,
+     * ConstantPositionMobilityModel without.
+     * \param nodes the nodes, as many as the layout
+     * \param layout the layout
+     */
+    static void Install(const NodeContainer& nodes, const Layout& layout);
+
+    /**
+     * \brief Write one "x y z" or "x y z vx vy vz" line per node.
+     * \param layout the layout
+     * \param fileName output file
+     */
+    static void Write(const Layout& layout, const std::string& fileName);
+
+    /**
+     * \brief Read a layout written by Write.
+     * \param fileName input file, "#" lines ignored
+     * \return the layout
+     */
+    static Layout Load(const std::string& fileName);
+
+  private:
+    Ptr<UniformRandomVariable> m_uniform; //!< positions, angles and directions
+    Ptr<NormalRandomVariable> m_normal;   //!< cluster offsets
+};
+
+} // namespace ns3
+
+#endif /* TOPOLOGY_GENERATOR_H */
@@ -0,0 +1,232 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tree-ensemble.h"
+
+#include "ns3/abort.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace ns3
+{
+
+TreeEnsemble::TreeEnsemble()
+{
+}
+
+void
+TreeEnsemble::Load(const std::string& fileName)
+{
+    std::ifstream in(fileName);
+    NS_ABORT_MSG_UNLESS(in.is_open(), "Could not open " << fileName);
+    std::string line;
+    std::getline(in, line);
+    NS_ABORT_MSG_UNLESS(line == "tree-ensemble 1", fileName << " is not a tree-ensemble model");
+
+    m_classes.clear();
+    m_features.clear();
+    m_roots.clear();
+    m_nodes.clear();
+    m_leaves.clear();
+    while (std::getline(in, line))
+    {
+        std::istringstream fields(line);
+        std::string key;
+        fields >> key;
+        if (key == "class" || key == "feature")
+        {
+            std::string name;
+            std::getline(fields >> std::ws, name);
+            (key == "class" ? m_classes : m_features).push_back(name);
+        }
+        else if (key == "root")
+        {
+            int32_t root;
+            fields >> root;
+            m_roots.push_back(root);
+        }
+        else if (key == "node")
+        {
+            Node node;
+            fields >> node.feature >> node.threshold >> node.child;
+            m_nodes.push_back(node);
+        }
+        else if (key == "leaf")
+        {
+            for (size_t c = 0; c < m_classes.size(); ++c)
+            {
+                double p;
+                fields >> p;
+                m_leaves.push_back(p);
+            }
+        }
+        else
+        {
+            NS_ABORT_MSG_UNLESS(key.empty() || key[0] == '#', "Unexpected model line: " << line);
+        }
+        NS_ABORT_MSG_IF(fields.fail(), "Malformed model line: " << line);
+    }
+    Check();
+}
+
+void
+TreeEnsemble::SetModel(const std::vector<std::string>& classes,
+                       const std::vector<std::string>& features,
+                       const std::vector<int32_t>& roots,
+                       const std::vector<int32_t>& feature,
+                       const std::vector<double>& threshold,
+                       const std::vector<int32_t>& child,
+                       const std::vector<double>& leaves)
+{
+    NS_ABORT_MSG_UNLESS(feature.size() == threshold.size() && feature.size() == child.size(),
+                        "Node arrays differ in size");
+    m_classes = classes;
+    m_features = features;
+    m_roots = roots;
+    m_nodes.clear();
+    for (size_t i = 0; i < feature.size(); ++i)
+    {
+        m_nodes.push_back({threshold[i], feature[i], child[i]});
+    }
+    m_leaves = leaves;
+    Check();
+}
+
+void
+TreeEnsemble::Check() const
+{
+    NS_ABORT_MSG_IF(m_classes.empty() || m_roots.empty(), "Model without classes or trees");
+    NS_ABORT_MSG_IF(m_features.empty(), "Model without features");
+    NS_ABORT_MSG_UNLESS(m_leaves.size() % m_classes.size() == 0, "Truncated leaf table");
+    auto nNodes = static_cast<int32_t>(m_nodes.size());
+    auto nLeaves = static_cast<int32_t>(m_leaves.size() / m_classes.size());
+    for (int32_t root : m_roots)
+    {
+        NS_ABORT_MSG_UNLESS(root >= 0 && root < nNodes, "Root " << root << " out of range");
+    }
+    for (const auto& node : m_nodes)
+    {
+        if (node.feature < 0)
+        {
+            NS_ABORT_MSG_UNLESS(node.child >= 0 && node.child < nLeaves,
+                                "Leaf " << node.child << " out of range");
+        }
+        else
+        {
+            NS_ABORT_MSG_UNLESS(node.feature < static_cast<int32_t>(m_features.size()),
+                                "Feature " << node.feature << " out of range");
+            NS_ABORT_MSG_UNLESS(node.child >= 0 && node.child + 1 < nNodes,
+                                "Child " << node.child << " out of range");
+        }
+    }
+}
+
+int32_t
+TreeEnsemble::FindLeaf(int32_t root, const float* x) const
+{
+    const Node* node = &m_nodes[root];
+    while (node->feature >= 0)
+    {
+        node = &m_nodes[node->child + (static_cast<double>(x[node->feature]) > node->threshold)];
+    }
+    return node->child;
+}
+
+void
+TreeEnsemble::PredictProba(const float* x, double* proba) const
+{
+    size_t nClasses = m_classes.size();
+    std::fill(proba, proba + nClasses, 0.0);
+    for (int32_t root : m_roots)
+    {
+        const double* leaf = &m_leaves[FindLeaf(root, x) * nClasses];
+        for (size_t c = 0; c < nClasses; ++c)
+        {
+            proba[c] += leaf[c];
+        }
+    }
+    for (size_t c = 0; c < nClasses; ++c)
+    {
+        proba[c] /= m_roots.size();
+    }
+}
+
+uint32_t
+TreeEnsemble::Predict(const float* x) const
+{
+    if (m_roots.size() == 1)
+    {
+        const double* leaf = &m_leaves[FindLeaf(m_roots[0], x) * m_classes.size()];
+        return std::max_element(leaf, leaf + m_classes.size()) - leaf;
+    }
+    // Keep the per-packet path free of allocations for the usual handful of classes
+    double small[16];
+    std::vector<double> large;
+    double* proba = small;
+    if (m_classes.size() > 16)
+    {
+        large.resize(m_classes.size());
+        proba = large.data();
+    }
+    PredictProba(x, proba);
+    return std::max_element(proba, proba + m_classes.size()) - proba;
+}
+
+uint32_t
+TreeEnsemble::GetNClasses() const
+{
+    return m_classes.size();
+}
+
+uint32_t
+TreeEnsemble::GetNFeatures() const
+{
+    return m_features.size();
+}
+
+uint32_t
+TreeEnsemble::GetNTrees() const
+{
+    return m_roots.size();
+}
+
+uint32_t
+TreeEnsemble::GetNNodes() const
+{
+    return m_nodes.size();
+}
+
+const std::string&
+TreeEnsemble::GetClassName(uint32_t index) const
+{
+    return m_classes.at(index);
+}
+
+int32_t
+TreeEnsemble::GetClassIndex(const std::string& name) const
+{
+    auto it = std::find(m_classes.begin(), m_classes.end(), name);
+    return it == m_classes.end() ? -1 : it - m_classes.begin();
+}
+
+const std::string&
+TreeEnsemble::GetFeatureName(uint32_t index) const
+{
+    return m_features.at(index);
+}
+
+} // namespace ns3
@@ -0,0 +1,160 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TREE_ENSEMBLE_H
+#define TREE_ENSEMBLE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Inference for decision trees and random forests trained offline.
+ *
+ * Every tree of the ensemble lives in one flat node array. An internal node tests
+ * "feature > threshold" and its two children are stored next to each other, so a step
+ * down the tree is a single index computation, child + (x > threshold), without a
+ * data-dependent branch; a leaf has feature -1 and points into the table of leaf class
+ * probabilities. Predict averages the leaf probabilities of every tree and returns the
+ * most probable class, as scikit-learn does for DecisionTreeClassifier and
+ * RandomForestClassifier.
+ *
+ * Features are compared in single precision against double thresholds, like scikit-learn,
+ * so an exported model takes the same decisions as the trained one.
+ *
+ * Models are written by export_drop_model.py, either as a text file for Load or as a C++
+ * header of arrays for SetModel:
+ *
+ * \verbatim
+   tree-ensemble 1
+   class <name>                     one line per class
+   feature <name>                   one line per feature
+   root <node index>                one line per tree
+   node <feature> <threshold> <child>   internal node, or -1 0 <leaf index> for a leaf
+   leaf <p0> <p1> ...               class probabilities of a leaf
+   \endverbatim
+ */
+class TreeEnsemble
+{
+  public:
+    TreeEnsemble();
+
+    /**
+     * \brief Load a model file, aborting if it is malformed.
+     * \param fileName the model file
+     */
+    void Load(const std::string& fileName);
+
+    /**
+     * \brief Set the model from flat arrays, in the layout of the model file.
+     *
+     * \param classes class names
+     * \param features feature names
+     * \param roots root node of every tree
+     * \param feature per node, the tested feature or -1 for a leaf
+     * \param threshold per node, the split threshold
+     * \param child per node, the left child (the right one follows it) or the leaf index
+     * \param leaves leaf class probabilities, one row of classes.size() per leaf
+     */
+    void SetModel(const std::vector<std::string>& classes,
+                  const std::vector<std::string>& features,
+                  const std::vector<int32_t>& roots,
+                  const std::vector<int32_t>& feature,
+                  const std::vector<double>& threshold,
+                  const std::vector<int32_t>& child,
+                  const std::vector<double>& leaves);
+
+    /**
+     * \param x feature vector, GetNFeatures() values in the order of the model
+     * \return the index of the predicted class
+     */
+    uint32_t Predict(const float* x) const;
+
+    /**
+     * \param x feature vector
+     * \param proba receives GetNClasses() averaged class probabilities
+     */
+    void PredictProba(const float* x, double* proba) const;
+
+    /**
+     * \return the number of classes
+     */
+    uint32_t GetNClasses() const;
+
+    /**
+     * \return the number of features
+     */
+    uint32_t GetNFeatures() const;
+
+    /**
+     * \return the number of trees
+     */
+    uint32_t GetNTrees() const;
+
+    /**
+     * \return the number of nodes of every tree together
+     */
+    uint32_t GetNNodes() const;
+
+    /**
+     * \param index class index
+     * \return the class name
+     */
+    const std::string& GetClassName(uint32_t index) const;
+
+    /**
+     * \param name a class name
+     * \return its index, or -1 if the model has no such class
+     */
+    int32_t GetClassIndex(const std::string& name) const;
+
+    /**
+     * \param index feature index
+     * \return the feature name
+     */
+    const std::string& GetFeatureName(uint32_t index) const;
+
+  private:
+    /// A tree node, 16 bytes
+    struct Node
+    {
+        double threshold; //!< split threshold
+        int32_t feature;  //!< tested feature, -1 for a leaf
+        int32_t child;    //!< left child, or leaf index
+    };
+
+    /**
+     * \param root root node of a tree
+     * \param x feature vector
+     * \return the leaf index reached by x
+     */
+    int32_t FindLeaf(int32_t root, const float* x) const;
+
+    /// Abort unless the node and leaf references are consistent
+    void Check() const;
+
+    std::vector<std::string> m_classes;  //!< class names
+    std::vector<std::string> m_features; //!< feature names
+    std::vector<int32_t> m_roots;        //!< root node of every tree
+    std::vector<Node> m_nodes;           //!< nodes of every tree
+    std::vector<double> m_leaves;        //!< leaf probabilities, classes per row
+};
+
+} // namespace ns3
+
+#endif /* TREE_ENSEMBLE_H */
@@ -0,0 +1,232 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Queries the results database written by the scenarios through ResultsDatabase.
+//
+//  --list                       runs with their scenario, time and parameters
+//  --names                      metric, parameter and series names in the database
+//  --metric=M --x=P             mean/stddev/min/max of metric M for each value of
+//                               parameter P, e.g. throughput vs node count
+//    [--groupBy=G]              ... with one line per value of parameter G as well
+//    [--filter=a=v,b=w]         ... only over runs whose parameters match
+//    [--scenario=S]             ... only over runs of scenario S
+//  --series=S --run=N           dump one time series of a run
+//  --sql="SELECT ..."           run an arbitrary query
+//
+// ./ns3 run "results-query --db=results.db --metric=averageThroughput --x=vehicles
+//            --filter=tcp=TcpHybla"
+
+#include "ns3/core-module.h"
+#include "ns3/sqlite-output.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("ResultsQuery");
+
+namespace
+{
+
+/**
+ * Run a query with text parameters and print every row, tab separated, after a
+ * "# column..." header.
+ */
+void
+PrintQuery(Ptr<SQLiteOutput> db, const std::string& sql, const std::vector<std::string>& binds)
+{
+    sqlite3_stmt* stmt;
+    NS_ABORT_MSG_UNLESS(db->SpinPrepare(&stmt, sql), "Invalid query: " << sql);
+    for (size_t i = 0; i < binds.size(); ++i)
+    {
+        db->Bind(stmt, static_cast<int>(i + 1), binds[i]);
+    }
+
+    int columns = sqlite3_column_count(stmt);
+    std::cout << "#";
+    for (int c = 0; c < columns; ++c)
+    {
+        std::cout << (c > 0 ? "\t" : " ") << sqlite3_column_name(stmt, c);
+    }
+    std::cout << "\n";
+    while (db->SpinStep(stmt) == SQLITE_ROW)
+    {
+        for (int c = 0; c < columns; ++c)
+        {
+            const unsigned char* text = sqlite3_column_text(stmt, c);
+            std::cout << (c > 0 ? "\t" : "") << (text ? reinterpret_cast<const char*>(text) : "");
+        }
+        std::cout << "\n";
+    }
+    db->SpinFinalize(stmt);
+}
+
+/// Aggregate a metric over runs, per value of one or two parameters
+void
+PrintAggregate(Ptr<SQLiteOutput> db,
+               const std::string& metric,
+               const std::string& x,
+               const std::string& groupBy,
+               const std::string& filter,
+               const std::string& scenario)
+{
+    std::vector<std::string> binds;
+    std::string sql = "SELECT px.value";
+    sql += groupBy.empty() ? "" : ", pg.value";
+    sql += ", COUNT(*), AVG(m.value), MIN(m.value), MAX(m.value), AVG(m.value * m.value) "
+           "FROM metrics m JOIN runs r ON r.run_id = m.run_id "
+           "JOIN parameters px ON px.run_id = m.run_id AND px.name = ? ";
+    binds.push_back(x);
+    if (!groupBy.empty())
+    {
+        sql += "JOIN parameters pg ON pg.run_id = m.run_id AND pg.name = ? ";
+        binds.push_back(groupBy);
+    }
+
+    std::istringstream conditions(filter);
+    std::string condition;
+    for (int i = 0; std::getline(conditions, condition, ','); ++i)
+    {
+        size_t eq = condition.find('=');
+        NS_ABORT_MSG_IF(eq == std::string::npos, "Filter must be name=value: " << condition);
+        std::string alias = "f" + std::to_string(i);
+        sql += "JOIN parameters " + alias + " ON " + alias + ".run_id = m.run_id AND " + alias +
+               ".name = ? AND " + alias + ".value = ? ";
+        binds.push_back(condition.substr(0, eq));
+        binds.push_back(condition.substr(eq + 1));
+    }
+
+    sql += "WHERE m.name = ? ";
+    binds.push_back(metric);
+    if (!scenario.empty())
+    {
+        sql += "AND r.scenario = ? ";
+        binds.push_back(scenario);
+    }
+    sql += groupBy.empty() ? "GROUP BY px.value ORDER BY "
+                           : "GROUP BY px.value, pg.value ORDER BY pg.value, ";
+    sql += "CAST(px.value AS REAL), px.value;";
+
+    sqlite3_stmt* stmt;
+    NS_ABORT_MSG_UNLESS(db->SpinPrepare(&stmt, sql), "Invalid query: " << sql);
+    for (size_t i = 0; i < binds.size(); ++i)
+    {
+        db->Bind(stmt, static_cast<int>(i + 1), binds[i]);
+    }
+
+    std::cout << "# " << x << (groupBy.empty() ? "" : "\t" + groupBy)
+              << "\truns\tmean\tstddev\tmin\tmax\n";
+    int first = groupBy.empty() ? 1 : 2;
+    while (db->SpinStep(stmt) == SQLITE_ROW)
+    {
+        std::cout << sqlite3_column_text(stmt, 0);
+        if (!groupBy.empty())
+        {
+            std::cout << "\t" << sqlite3_column_text(stmt, 1);
+        }
+        auto runs = sqlite3_column_int64(stmt, first);
+        double mean = sqlite3_column_double(stmt, first + 1);
+        double meanSquare = sqlite3_column_double(stmt, first + 4);
+        // Sample standard deviation from the first two moments
+        double stddev =
+            runs > 1 ? std::sqrt(std::max(0.0, meanSquare - mean * mean) * runs / (runs - 1))
+                     : 0.0;
+        std::cout << "\t" << runs << "\t" << mean << "\t" << stddev << "\t"
+                  << sqlite3_column_double(stmt, first + 2) << "\t"
+                  << sqlite3_column_double(stmt, first + 3) << "\n";
+    }
+    db->SpinFinalize(stmt);
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::string dbFile = "results.db";
+    bool list = false;
+    bool names = false;
+    std::string metric;
+    std::string x;
+    std::string groupBy;
+    std::string filter;
+    std::string scenario;
+    std::string series;
+    int64_t run = -1;
+    std::string sql;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("db", "Results database", dbFile);
+    cmd.AddValue("list", "List the runs", list);
+    cmd.AddValue("names", "List metric, parameter and series names", names);
+    cmd.AddValue("metric", "Metric to aggregate", metric);
+    cmd.AddValue("x", "Parameter on the x axis of the aggregate", x);
+    cmd.AddValue("groupBy", "Second parameter of the aggregate", groupBy);
+    cmd.AddValue("filter", "Comma-separated name=value parameter constraints", filter);
+    cmd.AddValue("scenario", "Only runs of this scenario", scenario);
+    cmd.AddValue("series", "Time series to dump", series);
+    cmd.AddValue("run", "Run of the time series", run);
+    cmd.AddValue("sql", "Arbitrary SQL query", sql);
+    cmd.Parse(argc, argv);
+
+    auto db = Create<SQLiteOutput>(dbFile);
+
+    if (list)
+    {
+        PrintQuery(db,
+                   "SELECT r.run_id, r.scenario, r.started, r.seed, r.run, "
+                   "group_concat(p.name || '=' || p.value, ' ') AS parameters "
+                   "FROM runs r LEFT JOIN parameters p ON p.run_id = r.run_id "
+                   "GROUP BY r.run_id ORDER BY r.run_id;",
+                   {});
+    }
+    else if (names)
+    {
+        PrintQuery(db,
+                   "SELECT 'metric' AS kind, name, COUNT(*) AS runs FROM metrics GROUP BY name "
+                   "UNION ALL SELECT 'parameter', name, COUNT(*) FROM parameters GROUP BY name "
+                   "UNION ALL SELECT 'series', series, COUNT(DISTINCT run_id) FROM time_series "
+                   "GROUP BY series ORDER BY 1, 2;",
+                   {});
+    }
+    else if (!metric.empty())
+    {
+        NS_ABORT_MSG_IF(x.empty(), "--metric needs --x");
+        PrintAggregate(db, metric, x, groupBy, filter, scenario);
+    }
+    else if (!series.empty())
+    {
+        NS_ABORT_MSG_IF(run < 0, "--series needs --run");
+        PrintQuery(db,
+                   "SELECT time, value FROM time_series WHERE run_id = ? AND series = ? "
+                   "ORDER BY time;",
+                   {std::to_string(run), series});
+    }
+    else if (!sql.empty())
+    {
+        PrintQuery(db, sql, {});
+    }
+    else
+    {
+        cmd.PrintHelp(std::cout);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,480 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Summarizes every run of the results database for plotting, in one pass per table.
+//
+// Runs are grouped by the values of their --keys parameters (TCP variant, node count and
+// sink count by default); runs missing one of them are left out. For every group it
+// computes the mean, 95% confidence interval (Student t), min and max of throughput,
+// packet delivery ratio (rxPackets / txPackets), mean delay and energy, and the mean of a
+// time series over the runs of the group, averaged down to at most --points points.
+//
+// Output, for --output=<prefix>:
+//  - <prefix>_summary.csv   one row per group: keys, runs, then mean/ci/min/max per metric
+//  - <prefix>_<metric>.dat  "x mean ci" rows vs the --x key, one gnuplot index per line
+//                           (the values of the other keys)
+//  - <prefix>_series.dat    "time mean" rows, one gnuplot index per group
+//  - <prefix>.plt           gnuplot script drawing all of them to <prefix>.png and
+//                           <prefix>_series.png
+//
+// Nothing is listed by hand: every variant, node count or sink count present in the
+// database shows up, so the plots follow whatever the sweep produced.
+//
+// ./ns3 run "results-summary --db=results.db --scenario=seventyfivenodes --output=summary"
+
+#include "ns3/core-module.h"
+#include "ns3/sqlite-output.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("ResultsSummary");
+
+namespace
+{
+
+/// Running mean, variance and range of a metric (Welford)
+struct Statistics
+{
+    uint64_t n = 0;                                     //!< number of values
+    double mean = 0.0;                                  //!< running mean
+    double m2 = 0.0;                                    //!< sum of squared deviations
+    double min = std::numeric_limits<double>::max();    //!< smallest value
+    double max = std::numeric_limits<double>::lowest(); //!< largest value
+
+    /// Add a value
+    void Add(double value)
+    {
+        ++n;
+        double delta = value - mean;
+        mean += delta / n;
+        m2 += delta * (value - mean);
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    /// Half width of the 95% confidence interval of the mean, 0 below two values
+    double GetConfidence() const
+    {
+        if (n < 2)
+        {
+            return 0.0;
+        }
+        // Two-sided 97.5% quantiles of Student's t up to 30 degrees of freedom, then its
+        // first-order expansion around the normal quantile
+        static const double t[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+                                   2.262,  2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+                                   2.110,  2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064,
+                                   2.060,  2.056, 2.052, 2.048, 2.045, 2.042};
+        uint64_t df = n - 1;
+        double quantile = df <= 30 ? t[df - 1] : 1.960 + 2.37 / df;
+        return quantile * std::sqrt(m2 / df / n);
+    }
+};
+
+/// A summarized metric, computed per run from the raw metrics of the database
+struct Metric
+{
+    std::string name;  //!< output name
+    std::string label; //!< axis label
+    std::vector<std::string> inputs; //!< database metrics it needs
+    double (*compute)(const double* inputs); //!< value of a run from its inputs
+};
+
+const std::vector<Metric> g_metrics = {
+    {"throughput",
+     "Average throughput (Mbit/s)",
+     {"averageThroughput"},
+     [](const double* v) { return v[0]; }},
+    {"pdr",
+     "Packet delivery ratio",
+     {"rxPackets", "txPackets"},
+     [](const double* v) { return v[1] > 0 ? v[0] / v[1] : 0.0; }},
+    {"delay", "Mean delay (s)", {"meanDelay"}, [](const double* v) { return v[0]; }},
+    {"energy",
+     "Average energy consumption (J)",
+     {"averageEnergyConsumption"},
+     [](const double* v) { return v[0]; }},
+};
+
+/// Runs sharing the same key values
+struct Group
+{
+    std::vector<std::string> key;         //!< values of the key parameters
+    std::vector<Statistics> metrics;      //!< one per g_metrics entry
+    std::map<double, Statistics> series;  //!< time series value per sample time
+};
+
+/// Parse a parameter as a number, for numeric ordering
+bool
+ToNumber(const std::string& text, double& value)
+{
+    char* end;
+    value = std::strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0';
+}
+
+/// Numeric when both values are numbers, lexicographic otherwise
+bool
+ValueLess(const std::string& a, const std::string& b)
+{
+    double x;
+    double y;
+    if (ToNumber(a, x) && ToNumber(b, y))
+    {
+        return x < y;
+    }
+    return a < b;
+}
+
+/// Prepare a statement and bind text parameters to it
+sqlite3_stmt*
+Prepare(Ptr<SQLiteOutput> db, const std::string& sql, const std::vector<std::string>& binds)
+{
+    sqlite3_stmt* stmt;
+    NS_ABORT_MSG_UNLESS(db->SpinPrepare(&stmt, sql), "Invalid query: " << sql);
+    for (size_t i = 0; i < binds.size(); ++i)
+    {
+        db->Bind(stmt, static_cast<int>(i + 1), binds[i]);
+    }
+    return stmt;
+}
+
+/// Text of a column, empty for NULL
+std::string
+ColumnText(sqlite3_stmt* stmt, int column)
+{
+    const unsigned char* text = sqlite3_column_text(stmt, column);
+    return text ? reinterpret_cast<const char*>(text) : "";
+}
+
+/// Average consecutive samples so that at most maxPoints (time, value) points remain
+std::vector<std::pair<double, double>>
+Downsample(const std::map<double, Statistics>& series, size_t maxPoints)
+{
+    size_t step = std::max<size_t>(1, (series.size() + maxPoints - 1) / maxPoints);
+    std::vector<std::pair<double, double>> points;
+    double time = 0.0;
+    double value = 0.0;
+    size_t count = 0;
+    for (const auto& sample : series)
+    {
+        time += sample.first;
+        value += sample.second.mean;
+        if (++count == step)
+        {
+            points.emplace_back(time / count, value / count);
+            time = value = 0.0;
+            count = 0;
+        }
+    }
+    if (count > 0)
+    {
+        points.emplace_back(time / count, value / count);
+    }
+    return points;
+}
+
+/// "name=value ..." of the given key positions
+std::string
+Describe(const std::vector<std::string>& names,
+         const std::vector<std::string>& values,
+         size_t skip = std::string::npos)
+{
+    std::string text;
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        if (i != skip)
+        {
+            text += (text.empty() ? "" : " ") + names[i] + "=" + values[i];
+        }
+    }
+    return text;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::string dbFile = "results.db";
+    std::string scenario;
+    std::string keys = "tcp,vehicles,sinks";
+    std::string x = "vehicles";
+    std::string seriesName = "throughput/total";
+    uint32_t maxPoints = 200;
+    std::string output = "summary";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("db", "Results database", dbFile);
+    cmd.AddValue("scenario", "Only runs of this scenario, empty for all", scenario);
+    cmd.AddValue("keys", "Comma-separated parameters that define a group", keys);
+    cmd.AddValue("x", "Key on the x axis of the metric plots (numeric)", x);
+    cmd.AddValue("series", "Time series averaged per group, empty to skip", seriesName);
+    cmd.AddValue("points", "Maximum number of points per time series", maxPoints);
+    cmd.AddValue("output", "Prefix of the output files", output);
+    cmd.Parse(argc, argv);
+
+    std::vector<std::string> keyNames;
+    std::istringstream keyList(keys);
+    for (std::string key; std::getline(keyList, key, ',');)
+    {
+        keyNames.push_back(key);
+    }
+    auto xIt = std::find(keyNames.begin(), keyNames.end(), x);
+    NS_ABORT_MSG_IF(xIt == keyNames.end(), "--x must be one of --keys");
+    size_t xIndex = xIt - keyNames.begin();
+    NS_ABORT_MSG_IF(maxPoints == 0, "--points must be positive");
+
+    auto db = Create<SQLiteOutput>(dbFile);
+
+    // Key of every run of the scenario
+    std::unordered_map<int64_t, std::vector<std::string>> runKeys;
+    std::unordered_map<int64_t, size_t> runKeyCount;
+    sqlite3_stmt* stmt = Prepare(db,
+                                 "SELECT p.run_id, p.name, p.value FROM parameters p "
+                                 "JOIN runs r ON r.run_id = p.run_id WHERE ? = '' OR "
+                                 "r.scenario = ?;",
+                                 {scenario, scenario});
+    while (db->SpinStep(stmt) == SQLITE_ROW)
+    {
+        auto key = std::find(keyNames.begin(), keyNames.end(), ColumnText(stmt, 1));
+        if (key == keyNames.end())
+        {
+            continue;
+        }
+        int64_t run = sqlite3_column_int64(stmt, 0);
+        auto& values = runKeys[run];
+        values.resize(keyNames.size());
+        values[key - keyNames.begin()] = ColumnText(stmt, 2);
+        runKeyCount[run]++;
+    }
+    db->SpinFinalize(stmt);
+
+    std::map<std::vector<std::string>, Group> groups;
+    std::unordered_map<int64_t, Group*> runGroup;
+    for (const auto& run : runKeys)
+    {
+        if (runKeyCount[run.first] < keyNames.size())
+        {
+            continue;
+        }
+        Group& group = groups[run.second];
+        group.key = run.second;
+        runGroup[run.first] = &group;
+    }
+    NS_ABORT_MSG_IF(groups.empty(), "No run has all of the parameters " << keys);
+
+    // Raw metrics of every run, then one value per summarized metric
+    std::vector<std::string> inputs;
+    for (const auto& metric : g_metrics)
+    {
+        inputs.insert(inputs.end(), metric.inputs.begin(), metric.inputs.end());
+    }
+    const double missing = std::numeric_limits<double>::quiet_NaN();
+    std::unordered_map<int64_t, std::vector<double>> runInputs;
+    stmt = Prepare(db, "SELECT run_id, name, value FROM metrics;", {});
+    while (db->SpinStep(stmt) == SQLITE_ROW)
+    {
+        int64_t run = sqlite3_column_int64(stmt, 0);
+        auto input = std::find(inputs.begin(), inputs.end(), ColumnText(stmt, 1));
+        if (input == inputs.end() || runGroup.find(run) == runGroup.end())
+        {
+            continue;
+        }
+        auto& values = runInputs[run];
+        values.resize(inputs.size(), missing);
+        values[input - inputs.begin()] = sqlite3_column_double(stmt, 2);
+    }
+    db->SpinFinalize(stmt);
+
+    for (auto& group : groups)
+    {
+        group.second.metrics.resize(g_metrics.size());
+    }
+    for (const auto& run : runInputs)
+    {
+        Group* group = runGroup[run.first];
+        const double* values = run.second.data();
+        for (size_t m = 0; m < g_metrics.size(); ++m)
+        {
+            size_t n = g_metrics[m].inputs.size();
+            // A run only counts for the metrics it recorded every input of
+            if (std::none_of(values, values + n, [](double v) { return std::isnan(v); }))
+            {
+                group->metrics[m].Add(g_metrics[m].compute(values));
+            }
+            values += n;
+        }
+    }
+
+    if (!seriesName.empty())
+    {
+        stmt = Prepare(db,
+                       "SELECT run_id, time, value FROM time_series WHERE series = ?;",
+                       {seriesName});
+        while (db->SpinStep(stmt) == SQLITE_ROW)
+        {
+            auto group = runGroup.find(sqlite3_column_int64(stmt, 0));
+            if (group != runGroup.end())
+            {
+                group->second->series[sqlite3_column_double(stmt, 1)].Add(
+                    sqlite3_column_double(stmt, 2));
+            }
+        }
+        db->SpinFinalize(stmt);
+    }
+
+    // Order the groups by their lines (every key but x), then numerically along x
+    std::vector<const Group*> ordered;
+    for (const auto& group : groups)
+    {
+        ordered.push_back(&group.second);
+    }
+    std::sort(ordered.begin(), ordered.end(), [xIndex](const Group* a, const Group* b) {
+        for (size_t k = 0; k < a->key.size(); ++k)
+        {
+            if (k != xIndex && a->key[k] != b->key[k])
+            {
+                return ValueLess(a->key[k], b->key[k]);
+            }
+        }
+        return ValueLess(a->key[xIndex], b->key[xIndex]);
+    });
+
+    std::ofstream csv(output + "_summary.csv");
+    NS_ABORT_MSG_UNLESS(csv.is_open(), "Could not open " << output << "_summary.csv");
+    for (const auto& key : keyNames)
+    {
+        csv << key << ",";
+    }
+    csv << "runs";
+    for (const auto& metric : g_metrics)
+    {
+        csv << "," << metric.name << "_mean," << metric.name << "_ci," << metric.name
+            << "_min," << metric.name << "_max";
+    }
+    csv << "\n";
+    for (const Group* group : ordered)
+    {
+        uint64_t runs = 0;
+        for (const auto& stats : group->metrics)
+        {
+            runs = std::max(runs, stats.n);
+        }
+        for (const auto& value : group->key)
+        {
+            csv << value << ",";
+        }
+        csv << runs;
+        for (const auto& stats : group->metrics)
+        {
+            if (stats.n == 0)
+            {
+                csv << ",,,,";
+                continue;
+            }
+            csv << "," << stats.mean << "," << stats.GetConfidence() << "," << stats.min << ","
+                << stats.max;
+        }
+        csv << "\n";
+    }
+
+    // One gnuplot index per line, i.e. per value of the keys other than x
+    std::vector<std::string> lines;
+    for (size_t m = 0; m < g_metrics.size(); ++m)
+    {
+        std::string fileName = output + "_" + g_metrics[m].name + ".dat";
+        std::ofstream dat(fileName);
+        NS_ABORT_MSG_UNLESS(dat.is_open(), "Could not open " << fileName);
+        std::string current;
+        for (const Group* group : ordered)
+        {
+            std::string line = Describe(keyNames, group->key, xIndex);
+            if (line != current || dat.tellp() == 0)
+            {
+                dat << (dat.tellp() == 0 ? "" : "\n\n") << "# " << line << "\n";
+                current = line;
+                if (m == 0)
+                {
+                    lines.push_back(line);
+                }
+            }
+            const Statistics& stats = group->metrics[m];
+            if (stats.n > 0)
+            {
+                dat << group->key[xIndex] << "\t" << stats.mean << "\t" << stats.GetConfidence()
+                    << "\n";
+            }
+        }
+    }
+
+    std::ofstream series(output + "_series.dat");
+    NS_ABORT_MSG_UNLESS(series.is_open(), "Could not open " << output << "_series.dat");
+    for (size_t i = 0; i < ordered.size(); ++i)
+    {
+        series << (i > 0 ? "\n\n" : "") << "# " << Describe(keyNames, ordered[i]->key) << "\n";
+        for (const auto& point : Downsample(ordered[i]->series, maxPoints))
+        {
+            series << point.first << "\t" << point.second << "\n";
+        }
+    }
+
+    std::ofstream plot(output + ".plt");
+    NS_ABORT_MSG_UNLESS(plot.is_open(), "Could not open " << output << ".plt");
+    plot << "set terminal pngcairo size 1920,1080 enhanced font 'Arial,14'\n"
+         << "set output \"" << output << ".png\"\n"
+         << "set multiplot layout 2,2\n"
+         << "set key outside right\n"
+         << "set xlabel '" << x << "'\n";
+    for (const auto& metric : g_metrics)
+    {
+        plot << "set ylabel '" << metric.label << "'\n"
+             << "plot";
+        for (size_t i = 0; i < lines.size(); ++i)
+        {
+            plot << (i > 0 ? ", \\\n    " : " ") << "'" << output << "_" << metric.name
+                 << ".dat' index " << i << " using 1:2:3 with yerrorlines title \"" << lines[i]
+                 << "\"";
+        }
+        plot << "\n";
+    }
+    plot << "unset multiplot\n"
+         << "set output \"" << output << "_series.png\"\n"
+         << "set xlabel 'Time (s)'\n"
+         << "set ylabel '" << seriesName << "'\n"
+         << "plot";
+    for (size_t i = 0; i < ordered.size(); ++i)
+    {
+        plot << (i > 0 ? ", \\\n    " : " ") << "'" << output << "_series.dat' index " << i
+             << " using 1:2 with lines title \"" << Describe(keyNames, ordered[i]->key) << "\"";
+    }
+    plot << "\n";
+
+    std::cout << groups.size() << " groups, " << runGroup.size() << " runs summarized to "
+              << output << "_*\n";
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Maps the coverage of the APs of a JSON scenario (CoverageMap) before any traffic runs:
+// received power, SNR, outage probability and strongest AP over a grid of cells, each
+// written as an ESRI ASCII grid <output>-rx.asc, -snr.asc, -outage.asc and -ap.asc.
+//
+// ./ns3 run "rf-heatmap --scenario=scratch/scenario-support/scenarios/sensor-network.json
+//            --resolution=0.25 --margin=20 --output=heatmap/sensor"
+//
+// The scenario is built once for the AP positions, the propagation loss chain of its
+// channel and the transmission power and channel width of the AP group. The area is the
+// bounding box of every node plus --margin, or --min and --max given as "x,y". A chain
+// of Nakagami fading alone, as in vehicles.json, has no mean path loss: only the outage
+// then varies over the area, with the shape factor of each distance range.
+//
+// import numpy; snr = numpy.loadtxt("heatmap/sensor-snr.asc", skiprows=6)
+
+#include "coverage-map.h"
+#include "json-value.h"
+#include "scenario-builder.h"
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-model.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("RfHeatmapTool");
+
+/**
+ * \param text "x,y" or "x,y,z"
+ * \return the vector
+ */
+static Vector
+ParseVector(const std::string& text)
+{
+    std::istringstream in(text);
+    Vector v;
+    char comma = 0;
+    NS_ABORT_MSG_UNLESS(in >> v.x >> comma >> v.y && comma == ',', "x,y expected: " << text);
+    if (in >> comma)
+    {
+        NS_ABORT_MSG_UNLESS(comma == ',' && in >> v.z, "x,y,z expected: " << text);
+    }
+    return v;
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string scenarioFile;
+    std::string overrides;
+    std::string apGroup = "ap";
+    double resolution = 1;
+    double margin = 10;
+    std::string min;
+    std::string max;
+    double height = 0;
+    uint32_t threads = 0;
+    double noiseFigure = 7;
+    double minSnr = 5;
+    std::string output = "heatmap";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("scenario", "JSON scenario description", scenarioFile);
+    cmd.AddValue("set", "path=value;... overrides of the description", overrides);
+    cmd.AddValue("apGroup", "Group of the transmitting APs", apGroup);
+    cmd.AddValue("resolution", "Cell size (m)", resolution);
+    cmd.AddValue("margin", "Area beyond the bounding box of the nodes", margin);
+    cmd.AddValue("min", "Lower corner of the area, instead of the bounding box", min);
+    cmd.AddValue("max", "Upper corner of the area, instead of the bounding box", max);
+    cmd.AddValue("height", "Receiver height", height);
+    cmd.AddValue("threads", "Worker threads, 0 for one per hardware thread", threads);
+    cmd.AddValue("noiseFigure", "Receiver noise figure (dB)", noiseFigure);
+    cmd.AddValue("minSnr", "SNR below which a receiver is in outage (dB)", minSnr);
+    cmd.AddValue("output", "Prefix of the raster files", output);
+    cmd.Parse(argc, argv);
+    NS_ABORT_MSG_IF(scenarioFile.empty(), "--scenario is required");
+
+    JsonValue description = JsonValue::Load(scenarioFile);
+    description.ApplyOverrides(JsonValue::ParseAssignments(overrides));
+    ScenarioBuilder scenario(description);
+    scenario.Build();
+
+    const ScenarioBuilder::Group& aps = scenario.GetGroup(apGroup);
+    ScenarioBuilder::Radio radio = scenario.GetRadio(apGroup);
+
+    std::vector<Vector> transmitters;
+    for (uint32_t i = 0; i < aps.nodes.GetN(); ++i)
+    {
+        transmitters.push_back(aps.nodes.Get(i)->GetObject<MobilityModel>()->GetPosition());
+    }
+
+    Vector lower = transmitters.front();
+    Vector upper = transmitters.front();
+    NodeContainer all = scenario.GetAllNodes();
+    for (uint32_t i = 0; i < all.GetN(); ++i)
+    {
+        Ptr<MobilityModel> mobility = all.Get(i)->GetObject<MobilityModel>();
+        if (mobility)
+        {
+            Vector p = mobility->GetPosition();
+            lower = Vector(std::min(lower.x, p.x), std::min(lower.y, p.y), 0);
+            upper = Vector(std::max(upper.x, p.x), std::max(upper.y, p.y), 0);
+        }
+    }
+    lower = min.empty() ? Vector(lower.x - margin, lower.y - margin, 0) : ParseVector(min);
+    upper = max.empty() ? Vector(upper.x + margin, upper.y + margin, 0) : ParseVector(max);
+
+    CoverageMap map;
+    map.SetTransmitters(transmitters);
+    map.SetLossModel(radio.loss);
+    map.SetRadio(radio.phy->GetTxPowerStart(),
+                 radio.phy->GetChannelWidth() * 1e6,
+                 noiseFigure,
+                 minSnr);
+    map.SetThreads(threads);
+
+    auto start = std::chrono::steady_clock::now();
+    map.Compute(lower, upper, resolution, height);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << transmitters.size() << " APs, " << map.GetColumns() << "x" << map.GetRows()
+              << " cells in " << elapsed.count() << " s, " << map.GetCoverage() * 100
+              << "% of the area above " << minSnr << " dB" << std::endl;
+
+    map.WriteRaster(CoverageMap::RX_POWER, output + "-rx.asc");
+    map.WriteRaster(CoverageMap::SNR, output + "-snr.asc");
+    map.WriteRaster(CoverageMap::OUTAGE, output + "-outage.asc");
+    map.WriteRaster(CoverageMap::SERVING_AP, output + "-ap.asc");
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,705 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Runs a scenario described in a JSON file (see ScenarioBuilder for the schema).
+//
+// --set overrides members of the description without editing it, so a parameter sweep
+// is a loop over one file:
+//
+// ./ns3 run "scenario-runner --scenario=scratch/scenario-support/scenarios/vehicles.json
+//            --set=groups.1.count=150;tcp.variant=TcpCubic;outputs.parameters.vehicles=150"
+//
+// A value that parses as JSON (number, true, [1, 2], {"a": 1}) is set as such, anything
+// else as a string. Array elements are addressed by their index. --dryRun only builds the
+// scenario and prints its size and build time.
+//
+// --jobs runs a whole sweep as a fork server: one job per line of the file, in the --set
+// syntax plus "run=<RngRun>", e.g.
+//
+//   run=1;tcp.variant=TcpCubic;duration=50
+//   run=2;tcp.variant=TcpCubic;groups.2.count=150
+//
+// The module libraries are loaded and the TypeIds registered once. Jobs with the same run
+// and the same overrides outside "tcp", "duration" and "outputs" share a topology: it is
+// built once in a forked process, and every job of it is a fork of that process, whose
+// pages are copied only when the simulation writes to them. --parallel builds and jobs
+// run at a time over all topologies, which share the slots through a token pipe as make
+// does. The startup and build time saved over one process per job is reported.
+
+#include "connectivity-monitor.h"
+#include "flow-delay-monitor.h"
+#include "flow-stats-file.h"
+#include "hop-delay-monitor.h"
+#include "json-value.h"
+#include "queue-disc-monitor.h"
+#include "results-database.h"
+#include "scenario-builder.h"
+#include "scenario-common.h"
+#include "throughput-monitor.h"
+
+#include "ns3/core-module.h"
+#include "ns3/flow-monitor-helper.h"
+#include "ns3/ipv4-flow-classifier.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <poll.h>
+#include <set>
+#include <sstream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("ScenarioRunner");
+
+/// One line of a --jobs file
+struct Job
+{
+    std::string line;                   //!< the job as written
+    uint32_t run;                       //!< RngRun
+    JsonValue::Assignments topology;    //!< overrides that need their own build
+    JsonValue::Assignments reconfigure; //!< overrides applied with ScenarioBuilder::Reconfigure
+};
+
+/**
+ * \param fileName the --jobs file
+ * \return the jobs, "#" lines and empty lines skipped
+ */
+static std::vector<Job>
+LoadJobs(const std::string& fileName)
+{
+    std::ifstream in(fileName);
+    NS_ABORT_MSG_UNLESS(in.is_open(), "Could not open " << fileName);
+    std::vector<Job> jobs;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        Job job{line, static_cast<uint32_t>(RngSeedManager::GetRun()), {}, {}};
+        for (const auto& assignment : JsonValue::ParseAssignments(line))
+        {
+            if (assignment.first == "run")
+            {
+                job.run = std::stoul(assignment.second);
+            }
+            else if (ScenarioBuilder::IsReconfigurable(assignment.first))
+            {
+                job.reconfigure.push_back(assignment);
+            }
+            else
+            {
+                job.topology.push_back(assignment);
+            }
+        }
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+/**
+ * \return seconds since the process started, dynamic loading and static initialization
+ *         included, or 0 where /proc is not available
+ */
+static double
+GetProcessAge()
+{
+    std::ifstream stat("/proc/self/stat");
+    std::ifstream uptime("/proc/uptime");
+    std::string text;
+    double now = 0;
+    if (!std::getline(stat, text) || !(uptime >> now))
+    {
+        return 0.0;
+    }
+    // starttime is field 22, the 20th after the parenthesized command name
+    std::istringstream fields(text.substr(text.rfind(')') + 1));
+    std::string field;
+    for (int i = 0; i < 20; ++i)
+    {
+        fields >> field;
+    }
+    return now - std::stod(field) / sysconf(_SC_CLK_TCK);
+}
+
+/**
+ * \brief Run a built scenario and record its metrics.
+ * \param scenario the scenario
+ * \param description its description, overrides applied
+ * \param scenarioFile the description file
+ * \param overrides the overrides, recorded as a parameter
+ */
+static void
+RunScenario(ScenarioBuilder& scenario,
+            const JsonValue& description,
+            const std::string& scenarioFile,
+            const std::string& overrides)
+{
+    const JsonValue& outputs = scenario.GetOutputs();
+    Time duration = scenario.GetDuration();
+
+    Ptr<ResultsDatabase> resultsDb = CreateObject<ResultsDatabase>();
+    if (outputs.Has("db"))
+    {
+        resultsDb->Open(outputs["db"].AsString());
+    }
+    resultsDb->BeginRun(scenario.GetName());
+    resultsDb->AddParameter("scenario", scenarioFile);
+    resultsDb->AddParameter("overrides", overrides);
+    resultsDb->AddParameter("tcp", description["tcp"]["variant"].AsString("TcpNewReno"));
+    resultsDb->AddParameter("simulationTime", duration.GetSeconds());
+    for (const auto& [name, value] : outputs["parameters"].GetMembers())
+    {
+        if (value.IsNumber())
+        {
+            resultsDb->AddParameter(name, value.AsDouble());
+        }
+        else
+        {
+            resultsDb->AddParameter(name, value.ToAttributeString());
+        }
+    }
+
+    FlowMonitorHelper flowmon;
+    Ptr<FlowMonitor> monitor = flowmon.InstallAll();
+
+    Ptr<ThroughputMonitor> throughputMonitor = CreateObject<ThroughputMonitor>();
+    throughputMonitor->SetAttribute("Window",
+                                    TimeValue(Seconds(outputs["throughputWindow"].AsDouble(5.0))));
+    for (const auto& sink : scenario.GetSinks())
+    {
+        throughputMonitor->AddSink(sink.sink, sink.name);
+    }
+    if (outputs.Has("throughput"))
+    {
+        throughputMonitor->EnableOutput(outputs["throughput"].AsString());
+    }
+    throughputMonitor->EnableDatabase(resultsDb);
+    throughputMonitor->Start(Seconds(outputs["throughputStart"].AsDouble(1.0)));
+
+    // Per-class delay and throughput, for senders with a PacketSize of at least 20 bytes
+    Ptr<FlowDelayMonitor> delayMonitor;
+    if (outputs.Has("classDelay"))
+    {
+        delayMonitor = CreateObject<FlowDelayMonitor>();
+        for (const auto& name : scenario.GetTrafficNames())
+        {
+            delayMonitor->AddTrafficClass(name, scenario.GetTraffic(name));
+        }
+        for (const auto& sink : scenario.GetSinks())
+        {
+            delayMonitor->AddSink(sink.sink);
+        }
+    }
+
+    // Sojourn times and drops of the groups given a queue disc
+    Ptr<QueueDiscMonitor> queueMonitor = CreateObject<QueueDiscMonitor>();
+    const std::vector<ScenarioBuilder::Group>& groups = scenario.GetGroups();
+    for (uint32_t i = 0; i < groups.size(); ++i)
+    {
+        if (description["groups"][i].Has("queueDisc"))
+        {
+            queueMonitor->AddDevices(groups[i].name, groups[i].devices);
+        }
+    }
+    if (description["backhaul"].Has("queueDisc"))
+    {
+        queueMonitor->AddDevices("backhaul", scenario.GetBackhaul().gatewayDevices);
+    }
+
+    // Latency of the wireless and of the backhaul hop, split at the gateway
+    Ptr<HopDelayMonitor> hopMonitor;
+    if (scenario.GetGatewayDevice())
+    {
+        hopMonitor = CreateObject<HopDelayMonitor>();
+        hopMonitor->Install(scenario.GetGatewayDevice(), scenario.GetAllNodes());
+    }
+
+    // Neighbor graph of the wireless nodes, rooted at the first AP
+    Ptr<ConnectivityMonitor> connectivityMonitor;
+    if (outputs.Has("connectivity"))
+    {
+        connectivityMonitor = CreateObject<ConnectivityMonitor>();
+        connectivityMonitor->SetAttribute(
+            "Range",
+            DoubleValue(outputs["connectivityRange"].AsDouble(100.0)));
+        Ptr<Node> connectivityRoot;
+        for (uint32_t i = 0; i < groups.size(); ++i)
+        {
+            if (groups[i].devices.GetN() == 0)
+            {
+                continue;
+            }
+            connectivityMonitor->AddNodes(groups[i].nodes);
+            if (description["groups"][i]["device"].AsString("sta") == "ap" &&
+                !connectivityRoot)
+            {
+                connectivityRoot = groups[i].nodes.Get(0);
+            }
+        }
+        if (connectivityRoot)
+        {
+            connectivityMonitor->SetRoot(connectivityRoot);
+        }
+        connectivityMonitor->EnableOutput(outputs["connectivity"].AsString());
+        connectivityMonitor->EnableDatabase(resultsDb);
+        connectivityMonitor->Start(Seconds(0));
+    }
+
+    // Consumption is read just before the end, as the hand-written scenarios do
+    NodeContainer energyNodes;
+    for (const auto& group : scenario.GetGroups())
+    {
+        if (group.sources.GetN() > 0)
+        {
+            energyNodes.Add(group.nodes);
+        }
+    }
+    std::vector<double> energyConsumed;
+    Simulator::Schedule(duration - Seconds(1.0), [energyNodes, &energyConsumed]() {
+        energyConsumed = ScenarioCommon::GetEnergyConsumed(energyNodes);
+    });
+
+    Simulator::Stop(duration);
+    Simulator::Run();
+    throughputMonitor->Stop();
+
+    uint64_t totalRx = 0;
+    for (const auto& sink : scenario.GetSinks())
+    {
+        totalRx += sink.sink->GetTotalRx();
+    }
+    double averageThroughput = static_cast<double>(totalRx * 8) / duration.GetMicroSeconds();
+    std::cout << "Average throughput: " << averageThroughput << " Mbit/s" << std::endl;
+    resultsDb->AddMetric("averageThroughput", averageThroughput);
+
+    if (energyNodes.GetN() > 0)
+    {
+        double averageEnergyConsumption =
+            std::accumulate(energyConsumed.begin(), energyConsumed.end(), 0.0) /
+            energyNodes.GetN();
+        std::cout << "Average energy consumption: " << averageEnergyConsumption << " J"
+                  << std::endl;
+        resultsDb->AddMetric("averageEnergyConsumption", averageEnergyConsumption);
+    }
+
+    monitor->CheckForLostPackets();
+    Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmon.GetClassifier());
+    resultsDb->AddFlowStats(monitor, classifier);
+    if (outputs.Has("flowStats"))
+    {
+        FlowStatsFile::Write(monitor, classifier, outputs["flowStats"].AsString());
+    }
+
+    // Totals over the flows terminating at a sink
+    std::set<Ipv4Address> sinkAddresses;
+    for (const auto& sink : scenario.GetSinks())
+    {
+        sinkAddresses.insert(sink.address);
+    }
+    uint64_t txPackets = 0;
+    uint64_t rxPackets = 0;
+    double delaySum = 0.0;
+    for (const auto& [flowId, flow] : monitor->GetFlowStats())
+    {
+        if (sinkAddresses.count(classifier->FindFlow(flowId).destinationAddress) > 0)
+        {
+            txPackets += flow.txPackets;
+            rxPackets += flow.rxPackets;
+            delaySum += flow.delaySum.GetSeconds();
+        }
+    }
+    double meanDelay = rxPackets > 0 ? delaySum / rxPackets : 0.0;
+    std::cout << "Packets: " << rxPackets << "/" << txPackets << " received, mean delay "
+              << meanDelay << " s" << std::endl;
+    resultsDb->AddMetric("txPackets", txPackets);
+    resultsDb->AddMetric("rxPackets", rxPackets);
+    resultsDb->AddMetric("meanDelay", meanDelay);
+
+    if (outputs.Has("queueStats"))
+    {
+        std::ofstream queueStatsFile(outputs["queueStats"].AsString(), std::ios::app);
+        NS_ABORT_MSG_UNLESS(queueStatsFile.is_open(),
+                            "Could not open " << outputs["queueStats"].AsString());
+        queueMonitor->WriteStats(queueStatsFile, scenario.GetName() + "\t");
+    }
+    if (outputs.Has("queueSojourn"))
+    {
+        std::ofstream queueSojournFile(outputs["queueSojourn"].AsString(), std::ios::app);
+        NS_ABORT_MSG_UNLESS(queueSojournFile.is_open(),
+                            "Could not open " << outputs["queueSojourn"].AsString());
+        queueMonitor->WriteHistograms(queueSojournFile, scenario.GetName() + "\t");
+    }
+    LogHistogram sojourn = queueMonitor->GetTotalHistogram();
+    if (sojourn.GetCount() > 0)
+    {
+        resultsDb->AddMetric("queue_sojourn_mean", sojourn.GetMean() / 1e9);
+        resultsDb->AddMetric("queue_sojourn_p95", sojourn.GetQuantile(0.95) / 1e9);
+        resultsDb->AddMetric("queue_sojourn_p99", sojourn.GetQuantile(0.99) / 1e9);
+        resultsDb->AddMetric("queue_dropped", queueMonitor->GetTotalDropped());
+        resultsDb->AddMetric("queue_marked", queueMonitor->GetTotalMarked());
+    }
+
+    if (hopMonitor)
+    {
+        if (outputs.Has("hopDelay"))
+        {
+            std::ofstream hopDelayFile(outputs["hopDelay"].AsString(), std::ios::app);
+            NS_ABORT_MSG_UNLESS(hopDelayFile.is_open(),
+                                "Could not open " << outputs["hopDelay"].AsString());
+            hopMonitor->WriteStats(hopDelayFile, scenario.GetName() + "\t");
+        }
+        for (uint32_t h = 0; h < HopDelayMonitor::HOP_COUNT; ++h)
+        {
+            auto hop = static_cast<HopDelayMonitor::Hop>(h);
+            const LogHistogram& delays = hopMonitor->GetHistogram(hop);
+            std::string name = HopDelayMonitor::GetHopName(hop);
+            std::replace(name.begin(), name.end(), '-', '_');
+            resultsDb->AddMetric("hop_" + name + "_mean", delays.GetMean() / 1e9);
+            resultsDb->AddMetric("hop_" + name + "_p95", delays.GetQuantile(0.95) / 1e9);
+        }
+    }
+
+    if (connectivityMonitor)
+    {
+        double partition = connectivityMonitor->GetFirstPartitionTime().GetSeconds();
+        std::cout << "First partition from the AP: "
+                  << (partition >= 0 ? std::to_string(partition) + " s" : "none") << std::endl;
+        resultsDb->AddMetric("first_partition", partition);
+    }
+
+    if (delayMonitor)
+    {
+        std::ofstream classDelayFile(outputs["classDelay"].AsString(), std::ios::app);
+        NS_ABORT_MSG_UNLESS(classDelayFile.is_open(),
+                            "Could not open " << outputs["classDelay"].AsString());
+        delayMonitor->WriteClassStats(classDelayFile, scenario.GetName() + "\t");
+        for (const auto& name : scenario.GetTrafficNames())
+        {
+            LogHistogram classDelays = delayMonitor->GetClassHistogram(name);
+            resultsDb->AddMetric("delay_" + name + "_mean", classDelays.GetMean() / 1e9);
+            resultsDb->AddMetric("delay_" + name + "_p95", classDelays.GetQuantile(0.95) / 1e9);
+            resultsDb->AddMetric("delay_" + name + "_p99", classDelays.GetQuantile(0.99) / 1e9);
+            resultsDb->AddMetric("throughput_" + name,
+                                 delayMonitor->GetClassRxBytes(name) * 8.0 /
+                                     duration.GetMicroSeconds());
+        }
+    }
+    resultsDb->EndRun();
+}
+
+/**
+ * \param status status of a child process
+ * \return 0 if it exited successfully, 1 otherwise
+ */
+static int
+ExitFailed(int status)
+{
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Give a slot back to the token pipe.
+ * \param slots write end of the token pipe
+ */
+static void
+ReleaseSlot(int slots)
+{
+    char token = '+';
+    NS_ABORT_MSG_IF(write(slots, &token, 1) != 1, "Could not release a job slot");
+}
+
+/**
+ * \brief Take a slot from the token pipe, reaping finished jobs while waiting.
+ *
+ * A job gives its slot back itself when it succeeds; the slot of a job that failed or
+ * crashed is given back here when it is reaped, so no slot is lost.
+ *
+ * \param slots token pipe, read end non-blocking
+ * \param running jobs of this process still running, decreased as they are reaped
+ * \param failed failed jobs, increased as they are reaped
+ */
+static void
+AcquireSlot(const int slots[2], uint32_t& running, int& failed)
+{
+    while (true)
+    {
+        char token;
+        if (read(slots[0], &token, 1) == 1)
+        {
+            return;
+        }
+        int status = 0;
+        pid_t pid;
+        while (running > 0 && (pid = waitpid(-1, &status, WNOHANG)) > 0)
+        {
+            --running;
+            if (ExitFailed(status))
+            {
+                ++failed;
+                ReleaseSlot(slots[1]);
+            }
+        }
+        // Another process may take the token first, hence the non-blocking read above
+        pollfd readable{slots[0], POLLIN, 0};
+        poll(&readable, 1, 100);
+    }
+}
+
+/**
+ * \brief Build one topology and run its jobs, each in a fork. Runs in a forked process.
+ *
+ * The build holds one slot, which then goes to the first job.
+ *
+ * \param description the scenario, without overrides
+ * \param scenarioFile the description file
+ * \param jobs the jobs of the topology, all with the same run and topology overrides
+ * \param slots token pipe shared by every topology, one token per free slot
+ * \param report pipe the build time is written to, once built
+ * \return the number of failed jobs
+ */
+static int
+ServeTopology(const JsonValue& description,
+              const std::string& scenarioFile,
+              const std::vector<const Job*>& jobs,
+              const int slots[2],
+              int report)
+{
+    int failed = 0;
+    uint32_t running = 0;
+    AcquireSlot(slots, running, failed);
+
+    RngSeedManager::SetRun(jobs.front()->run);
+    JsonValue base = description;
+    base.ApplyOverrides(jobs.front()->topology);
+
+    auto buildStart = std::chrono::steady_clock::now();
+    ScenarioBuilder scenario(base);
+    scenario.Build();
+    std::chrono::duration<double> buildTime = std::chrono::steady_clock::now() - buildStart;
+    double seconds = buildTime.count();
+    NS_ABORT_MSG_IF(write(report, &seconds, sizeof(seconds)) != sizeof(seconds),
+                    "Could not report the build time");
+
+    for (std::size_t j = 0; j < jobs.size(); ++j)
+    {
+        if (j > 0)
+        {
+            AcquireSlot(slots, running, failed);
+        }
+        const Job* job = jobs[j];
+        std::cout.flush();
+        pid_t pid = fork();
+        NS_ABORT_MSG_IF(pid < 0, "fork failed");
+        if (pid == 0)
+        {
+            std::cout << "Job " << job->line << std::endl;
+            JsonValue jobDescription = base;
+            jobDescription.ApplyOverrides(job->reconfigure);
+            scenario.Reconfigure(jobDescription);
+            RunScenario(scenario, jobDescription, scenarioFile, job->line);
+            std::cout.flush();
+            ReleaseSlot(slots[1]);
+            _exit(0);
+        }
+        ++running;
+    }
+    while (running > 0)
+    {
+        int status = 0;
+        NS_ABORT_MSG_IF(wait(&status) < 0, "wait failed");
+        --running;
+        if (ExitFailed(status))
+        {
+            ++failed;
+            ReleaseSlot(slots[1]);
+        }
+    }
+    return failed;
+}
+
+/**
+ * \brief Run every job of a --jobs file, one fork per topology and per job.
+ * \param description the scenario, without overrides
+ * \param scenarioFile the description file
+ * \param jobs the jobs
+ * \param parallel number of builds and jobs running at a time, over all topologies
+ * \param startup seconds the process took to get ready, paid once instead of per job
+ * \return the number of failed jobs
+ */
+static int
+ServeJobs(const JsonValue& description,
+          const std::string& scenarioFile,
+          const std::vector<Job>& jobs,
+          uint32_t parallel,
+          double startup)
+{
+    // Jobs differing only in what Reconfigure supports share a topology
+    std::vector<std::vector<const Job*>> topologies;
+    std::map<std::string, size_t> index;
+    for (const Job& job : jobs)
+    {
+        std::string key = std::to_string(job.run);
+        for (const auto& [path, value] : job.topology)
+        {
+            key += ";" + path + "=" + value;
+        }
+        auto [it, inserted] = index.emplace(key, topologies.size());
+        if (inserted)
+        {
+            topologies.emplace_back();
+        }
+        topologies[it->second].push_back(&job);
+    }
+
+    int slots[2];
+    NS_ABORT_MSG_IF(pipe(slots) != 0, "pipe failed");
+    NS_ABORT_MSG_IF(fcntl(slots[0], F_SETFL, O_NONBLOCK) != 0, "fcntl failed");
+    for (uint32_t i = 0; i < parallel; ++i)
+    {
+        ReleaseSlot(slots[1]);
+    }
+
+    int failed = 0;
+    double saved = startup * (jobs.size() - 1);
+    // Report pipe and topology of every topology process still running
+    std::map<pid_t, std::pair<int, size_t>> servers;
+    auto reap = [&]() {
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        NS_ABORT_MSG_IF(pid < 0, "waitpid failed");
+        auto it = servers.find(pid);
+        NS_ABORT_MSG_IF(it == servers.end(), "Unknown child " << pid);
+        auto [report, t] = it->second;
+        servers.erase(it);
+        double buildTime = 0;
+        int topologyFailed = 0;
+        bool built = read(report, &buildTime, sizeof(buildTime)) == sizeof(buildTime);
+        bool done = read(report, &topologyFailed, sizeof(topologyFailed)) ==
+                    sizeof(topologyFailed);
+        close(report);
+        if (!built)
+        {
+            // The build slot died with the process
+            ReleaseSlot(slots[1]);
+        }
+        if (!built || !done || ExitFailed(status))
+        {
+            std::cerr << "Topology of job " << topologies[t].front()->line
+                      << (built ? " crashed" : " failed to build") << std::endl;
+            failed += topologies[t].size();
+            return;
+        }
+        failed += topologyFailed;
+        std::cout << "Topology built in " << buildTime << " s, shared by "
+                  << topologies[t].size() << " jobs" << std::endl;
+        saved += buildTime * (topologies[t].size() - 1);
+    };
+
+    // A topology process holds its built scenario until its last job is done, so at most
+    // --parallel of them are alive; their jobs compete for the shared slots
+    for (size_t t = 0; t < topologies.size(); ++t)
+    {
+        if (servers.size() == parallel)
+        {
+            reap();
+        }
+        int report[2];
+        NS_ABORT_MSG_IF(pipe(report) != 0, "pipe failed");
+        std::cout.flush();
+        pid_t pid = fork();
+        NS_ABORT_MSG_IF(pid < 0, "fork failed");
+        if (pid == 0)
+        {
+            close(report[0]);
+            int topologyFailed =
+                ServeTopology(description, scenarioFile, topologies[t], slots, report[1]);
+            std::cout.flush();
+            bool reported = write(report[1], &topologyFailed, sizeof(topologyFailed)) ==
+                            sizeof(topologyFailed);
+            _exit(reported ? 0 : 1);
+        }
+        close(report[1]);
+        servers[pid] = {report[0], t};
+    }
+    while (!servers.empty())
+    {
+        reap();
+    }
+    close(slots[0]);
+    close(slots[1]);
+
+    std::cout << jobs.size() << " jobs on " << topologies.size() << " topologies, "
+              << failed << " failed. Startup of " << startup << " s paid once, "
+              << saved << " s of startup and build saved over one process per job"
+              << std::endl;
+    return failed;
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string scenarioFile;
+    std::string overrides;
+    std::string jobsFile;
+    uint32_t parallel = 1;
+    bool dryRun = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("scenario", "JSON scenario description", scenarioFile);
+    cmd.AddValue("set", "path=value;... overrides of the description", overrides);
+    cmd.AddValue("jobs", "Fork-server mode: file of one path=value;... job per line", jobsFile);
+    cmd.AddValue("parallel", "Builds and jobs running at a time with --jobs", parallel);
+    cmd.AddValue("dryRun", "Build the scenario without running it", dryRun);
+    cmd.Parse(argc, argv);
+    NS_ABORT_MSG_IF(scenarioFile.empty(), "--scenario is required");
+    NS_ABORT_MSG_IF(parallel == 0, "--parallel must be positive");
+
+    JsonValue description = JsonValue::Load(scenarioFile);
+    description.ApplyOverrides(JsonValue::ParseAssignments(overrides));
+
+    if (!jobsFile.empty())
+    {
+        std::vector<Job> jobs = LoadJobs(jobsFile);
+        NS_ABORT_MSG_IF(jobs.empty(), "No job in " << jobsFile);
+        return ServeJobs(description, scenarioFile, jobs, parallel, GetProcessAge()) > 0 ? 1 : 0;
+    }
+
+    auto buildStart = std::chrono::steady_clock::now();
+    ScenarioBuilder scenario(description);
+    scenario.Build();
+    std::chrono::duration<double> buildTime = std::chrono::steady_clock::now() - buildStart;
+    std::cout << "Scenario " << scenario.GetName() << ": " << scenario.GetAllNodes().GetN()
+              << " nodes, " << scenario.GetSinks().size() << " sinks, "
+              << scenario.GetTrafficNames().size() << " traffic classes, built in "
+              << buildTime.count() << " s" << std::endl;
+    if (!dryRun)
+    {
+        RunScenario(scenario, description, scenarioFile, overrides);
+    }
+    Simulator::Destroy();
+    return 0;
+}
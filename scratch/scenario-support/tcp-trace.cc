@@ -0,0 +1,96 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Converts a TcpSocketTracer binary trace to text, one column set per record type.
+//
+// Every record becomes a "time socket node value" line in <prefix>_<type>.txt, with
+// type among cwnd, ssthresh, rtt, rto, state and retx. --socket keeps a single socket,
+// --node the sockets of one node.
+//
+// ./ns3 run "tcp-trace --input=flowstats/tcptrace_TcpHybla_75_1.bin --output=hybla"
+
+#include "tcp-socket-tracer.h"
+
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpTrace");
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output = "tcptrace";
+    int64_t socketFilter = -1;
+    int64_t nodeFilter = -1;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "Trace written by TcpSocketTracer", input);
+    cmd.AddValue("output", "Prefix of the text files", output);
+    cmd.AddValue("socket", "Only this socket, -1 for all", socketFilter);
+    cmd.AddValue("node", "Only the sockets of this node, -1 for all", nodeFilter);
+    cmd.Parse(argc, argv);
+    NS_ABORT_MSG_IF(input.empty(), "--input is required");
+
+    std::ifstream in(input, std::ios::binary);
+    NS_ABORT_MSG_UNLESS(in.is_open(), "Could not open " << input);
+    TcpSocketTracer::ReadHeader(in);
+
+    const char* names[] = {"cwnd", "ssthresh", "rtt", "rto", "state", "retx"};
+    std::vector<std::ofstream> files;
+    for (const char* name : names)
+    {
+        std::string fileName = output + "_" + name + ".txt";
+        files.emplace_back(fileName);
+        NS_ABORT_MSG_UNLESS(files.back().is_open(), "Could not open " << fileName);
+        files.back() << "# time\tsocket\tnode\tvalue\n";
+    }
+
+    std::vector<int64_t> socketNode; // node of every socket, from its SOCKET record
+    uint64_t records = 0;
+    TcpSocketTracer::Record record;
+    while (TcpSocketTracer::ReadRecord(in, record))
+    {
+        ++records;
+        if (record.type == TcpSocketTracer::SOCKET)
+        {
+            socketNode.resize(std::max<size_t>(socketNode.size(), record.socket + 1), -1);
+            socketNode[record.socket] = static_cast<int64_t>(record.value);
+            continue;
+        }
+        NS_ABORT_MSG_IF(record.type > TcpSocketTracer::RETRANSMISSION,
+                        "Unknown record type " << record.type);
+        int64_t node = record.socket < socketNode.size() ? socketNode[record.socket] : -1;
+        if ((socketFilter >= 0 && record.socket != socketFilter) ||
+            (nodeFilter >= 0 && node != nodeFilter))
+        {
+            continue;
+        }
+        files[record.type - TcpSocketTracer::CWND]
+            << record.time * 1e-9 << "\t" << record.socket << "\t" << node << "\t"
+            << record.value << "\n";
+    }
+
+    std::cout << records << " records of " << socketNode.size() << " sockets written to "
+              << output << "_*.txt\n";
+    return 0;
+}
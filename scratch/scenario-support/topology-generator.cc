@@ -0,0 +1,171 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Generates a node layout with TopologyGenerator and writes it as one "x y z [vx vy vz]"
+// line per node, for the "file" mobility layout of scenario-runner or any scenario
+// calling TopologyGenerator::Load. The same --RngRun gives the same layout.
+//
+// ./ns3 run "topology-generator --layout=poisson-disk --count=20000 --max=2000,2000
+//            --minDistance=10 --output=poisson.txt --RngRun=3"
+//
+// Layouts: grid, ellipse, line, box, disk, poisson-disk, clusters, manhattan. Vectors
+// are given as "x,y" or "x,y,z".
+
+#include "topology-generator.h"
+
+#include "ns3/core-module.h"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TopologyGeneratorTool");
+
+/**
+ * \param text "x,y" or "x,y,z"
+ * \return the vector
+ */
+static Vector
+ParseVector(const std::string& text)
+{
+    std::istringstream in(text);
+    Vector v;
+    char comma = 0;
+    NS_ABORT_MSG_UNLESS(in >> v.x >> comma >> v.y && comma == ',', "x,y expected: " << text);
+    if (in >> comma)
+    {
+        NS_ABORT_MSG_UNLESS(comma == ',' && in >> v.z, "x,y,z expected: " << text);
+    }
+    return v;
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string layoutName = "grid";
+    uint32_t count = 100;
+    std::string min = "0,0";
+    std::string max = "100,100";
+    std::string delta = "10,10";
+    uint32_t width = 10;
+    bool columnFirst = false;
+    double radius = 50;
+    double radiusY = 0;
+    double minDistance = 5;
+    uint32_t clusters = 4;
+    double sigma = 10;
+    double block = 100;
+    uint32_t streetsX = 5;
+    uint32_t streetsY = 5;
+    double speed = 0;
+    std::string velocities;
+    std::string output = "layout.txt";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("layout",
+                 "grid, ellipse, line, box, disk, poisson-disk, clusters or manhattan",
+                 layoutName);
+    cmd.AddValue("count", "Number of nodes", count);
+    cmd.AddValue("min",
+                 "Lower corner, first grid node, ellipse or disk center, line start",
+                 min);
+    cmd.AddValue("max", "Upper corner, line end", max);
+    cmd.AddValue("delta", "Grid spacing", delta);
+    cmd.AddValue("width", "Grid nodes per row (per column with --columnFirst)", width);
+    cmd.AddValue("columnFirst", "Fill grid columns first", columnFirst);
+    cmd.AddValue("radius", "Disk radius, ellipse semi-axis along x", radius);
+    cmd.AddValue("radiusY", "Ellipse semi-axis along y, 0 for a circle", radiusY);
+    cmd.AddValue("minDistance", "Poisson-disk minimum distance between nodes", minDistance);
+    cmd.AddValue("clusters", "Number of Gaussian clusters", clusters);
+    cmd.AddValue("sigma", "Standard deviation of the cluster spread", sigma);
+    cmd.AddValue("block", "Manhattan block size", block);
+    cmd.AddValue("streetsX", "Manhattan streets along x", streetsX);
+    cmd.AddValue("streetsY", "Manhattan streets along y", streetsY);
+    cmd.AddValue("speed", "Manhattan vehicle speed, 0 for static nodes", speed);
+    cmd.AddValue("velocities",
+                 "x,y,z;x,y,z;... velocities of consecutive equal parts of the nodes",
+                 velocities);
+    cmd.AddValue("output", "Layout file", output);
+    cmd.Parse(argc, argv);
+
+    TopologyGenerator generator;
+    TopologyGenerator::Layout layout;
+    auto start = std::chrono::steady_clock::now();
+    if (layoutName == "grid")
+    {
+        layout = TopologyGenerator::Grid(count,
+                                         ParseVector(min),
+                                         ParseVector(delta),
+                                         width,
+                                         !columnFirst);
+    }
+    else if (layoutName == "ellipse")
+    {
+        layout = TopologyGenerator::Ellipse(count,
+                                            ParseVector(min),
+                                            radius,
+                                            radiusY > 0 ? radiusY : radius);
+    }
+    else if (layoutName == "line")
+    {
+        layout = TopologyGenerator::Line(count, ParseVector(min), ParseVector(max));
+    }
+    else if (layoutName == "box")
+    {
+        layout = generator.Box(count, ParseVector(min), ParseVector(max));
+    }
+    else if (layoutName == "disk")
+    {
+        layout = generator.Disk(count, ParseVector(min), radius);
+    }
+    else if (layoutName == "poisson-disk")
+    {
+        layout = generator.PoissonDisk(count, ParseVector(min), ParseVector(max), minDistance);
+    }
+    else if (layoutName == "clusters")
+    {
+        layout = generator.Clusters(count, clusters, ParseVector(min), ParseVector(max), sigma);
+    }
+    else if (layoutName == "manhattan")
+    {
+        layout =
+            generator.Manhattan(count, ParseVector(min), block, streetsX, streetsY, speed);
+    }
+    else
+    {
+        NS_ABORT_MSG("Unknown layout " << layoutName);
+    }
+
+    if (!velocities.empty())
+    {
+        std::vector<Vector> pattern;
+        std::istringstream parts(velocities);
+        std::string part;
+        while (std::getline(parts, part, ';'))
+        {
+            pattern.push_back(ParseVector(part));
+        }
+        TopologyGenerator::SetVelocities(layout, pattern);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    TopologyGenerator::Write(layout, output);
+    std::cout << layoutName << ": " << layout.positions.size() << " nodes in "
+              << elapsed.count() << " s, written to " << output << std::endl;
+    return 0;
+}
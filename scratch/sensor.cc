@@ -26,6 +26,10 @@
 
 
 
+#include "attack-helper.h"
+#include "scenario-common.h"
+#include "throughput-monitor.h"
+
 #include <fstream>
 
 NS_LOG_COMPONENT_DEFINE("proj");
@@ -36,11 +40,6 @@ Ptr<PacketSink> sink;
 Ptr<PacketSink> sink2;
 Ptr<PacketSink> sink3;
 Ptr<PacketSink> sink4;
-uint64_t lastTotalRx = 0;
-uint64_t lastTotalRx2 = 0;
-uint64_t lastTotalRx3 = 0;
-uint64_t lastTotalRx4 = 0;
-std::ofstream throughputFile;
 double totalEnergyConsumed = 0.0;
 std::vector<double> nodeEnergyConsumed;
 ApplicationContainer soundPktServerApp; 
@@ -53,18 +52,6 @@ double prevEnergyConsumed[4] = {0.0,0.0,0.0,0.0};
  
 
 
-void
-CalculateThroughput()
-{
-    Time now = Simulator::Now(); /* Return the simulator's virtual time. */
-    //double cur = (sink->GetTotalRx() - lastTotalRx) * 8.0 /1e6; /* Convert Application RX Packets to MBits. */
-    double cur = ((sink->GetTotalRx() - lastTotalRx)+ (sink2->GetTotalRx() - lastTotalRx2) + (sink3->GetTotalRx() - lastTotalRx3) + (sink4->GetTotalRx() - lastTotalRx4)) * 8.0 /1e6;
-    throughputFile << now.GetSeconds() << "\t" << cur << std::endl;
-    
-
-    lastTotalRx = sink->GetTotalRx();
-    Simulator::Schedule(MilliSeconds(1000), &CalculateThroughput);
-}
 void CalculateEnergyConsumption(NodeContainer temperatureSensorNodes, NodeContainer humiditySensorNodes,NodeContainer pressureSensorNodes,NodeContainer soundSensorNodes,NodeContainer apWifiNode) {
     totalEnergyConsumed = 0.0;
     for (size_t i = 0; i < nodeEnergyConsumed.size(); ++i) {
@@ -151,23 +138,15 @@ void CalculateEnergyConsumption(NodeContainer temperatureSensorNodes, NodeContai
   }
 }
 
-void dos_fn(NodeContainer attackerNode,Ipv4InterfaceContainer apInterface){
-	OnOffHelper tcpDOS("ns3::TcpSocketFactory",(InetSocketAddress(apInterface.GetAddress(0),9)));
-    tcpDOS.SetAttribute("PacketSize",UintegerValue(43)); /*Replace ENTER_PAYLOAD_SIZE_IN_BYTES_HERE with the avg payload size for DOS attacks*/
-    tcpDOS.SetAttribute("OnTime",StringValue("ns3::ConstantRandomVariable[Constant=1]"));
-    tcpDOS.SetAttribute("OffTime",StringValue("ns3::ConstantRandomVariable[Constant=0]"));
-    tcpDOS.SetAttribute("DataRate",DataRateValue(DataRate("5Mbps")));
-    ApplicationContainer tcpDOSApp = tcpDOS.Install(attackerNode);
-    tcpDOSApp.Start(Seconds(0.0));
-    tcpDOSApp.Stop(Seconds(100.0));
-    Simulator :: Schedule(Seconds(0.1),&(dos_fn),attackerNode,apInterface);
-}
 
 int
 main(int argc, char *argv[]){
     std::string tcpVariant{"TcpCubic"}; /* TCP variant type. */
     std::string phyRate{"HtMcs7"};        /* Physical layer bitrate. */
     Time simulationTime{"10s"};           /* Simulation time. */
+    std::string attack{"tcp-flood"};      /* Attack run by the attacker node, or none. */
+    Time attackStart{"1s"};               /* Start of the attack. */
+    Time attackRamp{"0s"};                /* Time for the attack to reach full intensity. */
 
     /* Command line argument parser setup. */
     CommandLine cmd(__FILE__);
@@ -178,6 +157,9 @@ main(int argc, char *argv[]){
                  tcpVariant);
     cmd.AddValue("phyRate", "Physical layer bitrate", phyRate);
     cmd.AddValue("simulationTime", "Simulation time in seconds", simulationTime);
+    cmd.AddValue("attack", "Attack of the attacker node: none, tcp-flood, udp-flood, syn-flood, jammer", attack);
+    cmd.AddValue("attackStart", "Start of the attack", attackStart);
+    cmd.AddValue("attackRamp", "Time for the attack to reach full intensity", attackRamp);
     cmd.Parse(argc, argv);
     std::string tcpName = tcpVariant;
 
@@ -411,9 +393,20 @@ main(int argc, char *argv[]){
     soundPktServer.SetAttribute("DataRate", DataRateValue(DataRate("20Kb/s")));
     soundPktServerApp = soundPktServer.Install(soundSensorNodes);
     	
-	//dos_fn(attackerNode,apInterface); TCP flood 
-    
-    Simulator :: Schedule(Seconds(1.0),&(dos_fn),attackerNode,apInterface); //TCP Syn
+    // One long-lived attack application, labeled at the source with AttackTag
+    if (attack != "none")
+    {
+        AttackHelper attackHelper(attack, InetSocketAddress(apInterface.GetAddress(0), 9));
+        if (attack == "tcp-flood")
+        {
+            attackHelper.SetAttribute("PacketSize", UintegerValue(43));
+        }
+        attackHelper.SetAttribute("InitialIntensity", DoubleValue(attackRamp.IsStrictlyPositive() ? 0.0 : 1.0));
+        attackHelper.SetAttribute("RampTime", TimeValue(attackRamp));
+        ApplicationContainer attackApp = attackHelper.Install(attackerNode);
+        attackApp.Start(attackStart);
+        attackApp.Stop(simulationTime);
+    }
     
 
     FlowMonitorHelper flowmon;
@@ -425,7 +418,12 @@ main(int argc, char *argv[]){
     std::string throughputFileName = "throughput.txt";
 
     
-    throughputFile.open(throughputFileName);
+    Ptr<ThroughputMonitor> throughputMonitor = CreateObject<ThroughputMonitor>();
+    throughputMonitor->AddSink(sink, "ap0");
+    throughputMonitor->AddSink(sink2, "ap1");
+    throughputMonitor->AddSink(sink3, "ap2");
+    throughputMonitor->AddSink(sink4, "ap3");
+    throughputMonitor->EnableOutput(throughputFileName);
     AnimationInterface anim("visual.xml");
    
     for(int i = 0; i < number_of_ap; i++){
@@ -453,32 +451,11 @@ main(int argc, char *argv[]){
     soundPktServerApp.Start(Seconds(1.3));
     pressurePktServerApp.Start(Seconds(1.4));
     
-    BasicEnergySourceHelper basicSourceHelper;
-    basicSourceHelper.Set("BasicEnergySourceInitialEnergyJ", DoubleValue(1000.0));
-    basicSourceHelper.Set("BasicEnergySupplyVoltageV", DoubleValue(12.0));
-    
-    WifiRadioEnergyModelHelper radioEnergyHelper;
-    
-    radioEnergyHelper.Set("TxCurrentA",DoubleValue(0.017));
-    radioEnergyHelper.Set("RxCurrentA",DoubleValue(0.0197));
-    radioEnergyHelper.Set("IdleCurrentA",DoubleValue(0.273));
-    radioEnergyHelper.Set("SleepCurrentA",DoubleValue(0.033));
-    
-    ns3::energy::EnergySourceContainer sources = basicSourceHelper.Install(temperatureSensorNodes);
-    ns3::energy::DeviceEnergyModelContainer deviceModels = radioEnergyHelper.Install(temperatureSensorDevices, sources);
-    
-    ns3::energy::EnergySourceContainer srcs_h = basicSourceHelper.Install(humiditySensorNodes);
-    ns3::energy::DeviceEnergyModelContainer devModels_h = radioEnergyHelper.Install(humiditySensorDevices,srcs_h);
-    
-    ns3::energy::EnergySourceContainer srcs_s = basicSourceHelper.Install(soundSensorNodes);
-    ns3::energy::DeviceEnergyModelContainer devModels_s = radioEnergyHelper.Install(soundSensorDevices,srcs_s);
-    
-    ns3::energy::EnergySourceContainer srcs_p = basicSourceHelper.Install(pressureSensorNodes);
-    ns3::energy::DeviceEnergyModelContainer devModels_p = radioEnergyHelper.Install(pressureSensorDevices,srcs_p);
-    
-    
-    ns3::energy::EnergySourceContainer srcs_sink = basicSourceHelper.Install(apWifiNode);
-    ns3::energy::DeviceEnergyModelContainer devModel_sink_temp = radioEnergyHelper.Install(apDevice,srcs_sink);
+    ScenarioCommon::InstallRadioEnergy(temperatureSensorNodes, temperatureSensorDevices);
+    ScenarioCommon::InstallRadioEnergy(humiditySensorNodes, humiditySensorDevices);
+    ScenarioCommon::InstallRadioEnergy(soundSensorNodes, soundSensorDevices);
+    ScenarioCommon::InstallRadioEnergy(pressureSensorNodes, pressureSensorDevices);
+    ScenarioCommon::InstallRadioEnergy(apWifiNode, apDevice);
 
     nodeEnergyConsumed.resize(temperatureSensorNodes.GetN(), 0.0);
     //nodeEnergyConsumed2.resize(apWifiNode.GetN(), 0.0);
@@ -486,7 +463,7 @@ main(int argc, char *argv[]){
     Simulator::Schedule(Seconds(1.0), &CalculateEnergyConsumption,temperatureSensorNodes,humiditySensorNodes,pressureSensorNodes,soundSensorNodes,apWifiNode);
    
     
-    Simulator::Schedule(Seconds(1.1), &CalculateThroughput);
+    throughputMonitor->Start(Seconds(1.1));
     
     
     
@@ -522,10 +499,11 @@ main(int argc, char *argv[]){
 	double averageEnergyConsumption = totalEnergyConsumed / temperatureSensorNodes.GetN();
     std::cout << "Average energy consumption: " << averageEnergyConsumption << " J" << std::endl;
     
-    throughputFile.close();
+    throughputMonitor->Stop();
     
+    // sensors report to several APs, so the network throughput is the sum over their sinks
     auto averageThroughput =
-        (static_cast<double>(sink->GetTotalRx() * 8  ) / simulationTime.GetMicroSeconds());
+        (static_cast<double>((sink->GetTotalRx() + sink2->GetTotalRx() + sink3->GetTotalRx() + sink4->GetTotalRx()) * 8) / simulationTime.GetMicroSeconds());
     
     std::cout << "\nAverage throughput: " << averageThroughput << " Mbit/s" << std::endl;
     
@@ -1,3 +1,5 @@
+#include "ns3/application-helper.h"
+#include "ns3/boolean.h"
 #include "ns3/command-line.h"
 #include "ns3/config.h"
 #include "ns3/internet-stack-helper.h"
@@ -22,9 +24,18 @@
 #include "ns3/constant-velocity-mobility-model.h"
 #include "ns3/energy-module.h"
 #include "ns3/wifi-radio-energy-model-helper.h"
+#include "energy-aware-rate-controller.h"
+#include "node-lifetime-monitor.h"
+#include "profile-energy-harvester.h"
+#include "profile-energy-harvester-helper.h"
+#include "attack-helper.h"
+#include "intrusion-detector.h"
+#include "results-database.h"
+#include "throughput-monitor.h"
 
 
 
+#include <cmath>
 #include <fstream>
 
 NS_LOG_COMPONENT_DEFINE("proj");
@@ -33,24 +44,11 @@ using namespace ns3;
 
 Ptr<PacketSink> sink;
 Ptr<PacketSink> sink2;
-uint64_t lastTotalRx = 0;
-std::ofstream throughputFile;
+Ptr<PacketSink> sink3;
 double totalEnergyConsumed = 0.0;
 std::vector<double> nodeEnergyConsumed;
 
 
-void
-CalculateThroughput()
-{
-    Time now = Simulator::Now(); /* Return the simulator's virtual time. */
-    double cur = (sink->GetTotalRx() - lastTotalRx) * 8.0 /1e6; /* Convert Application RX Packets to MBits. */
-                
-    throughputFile << now.GetSeconds() << "\t" << cur << std::endl;
-    
-
-    lastTotalRx = sink->GetTotalRx();
-    Simulator::Schedule(MilliSeconds(1000), &CalculateThroughput);
-}
 void CalculateEnergyConsumption(NodeContainer temperatureSensorNodes, NodeContainer humiditySensorNodes,NodeContainer pressureSensorNodes,NodeContainer soundSensorNodes) {
     totalEnergyConsumed = 0.0;
 
@@ -106,6 +104,19 @@ main(int argc, char *argv[]){
     std::string tcpVariant{"TcpCubic"}; /* TCP variant type. */
     std::string phyRate{"HtMcs7"};        /* Physical layer bitrate. */
     Time simulationTime{"10s"};           /* Simulation time. */
+    double initialEnergy{1000.0};         /* Initial energy of every sensor in J. */
+    double trafficScale{1.0};             /* Multiplier on the data rate of every sensor class. */
+    std::string harvest{"none"};          /* Energy harvesting profile: none, solar or trace. */
+    std::string harvestTrace{""};         /* "<time s> <power W>" file for the trace profile. */
+    double solarPeakPower{0.05};          /* Harvested power at solar noon in W. */
+    double startHour{12.0};               /* Time of day at the start of the simulation. */
+    std::string dbFile{"results.db"};     /* SQLite results database, empty to disable. */
+    std::string attack{"none"};           /* Attack run by the attacker node. */
+    Time attackStart{"1s"};               /* Start of the attack. */
+    Time attackRamp{"0s"};                /* Time for the attack to reach full intensity. */
+    bool detect{false};                   /* Run an intrusion detector on every AP. */
+    bool mitigate{false};                 /* Let the detectors block the alerted sources. */
+    int number_of_sensors{21};            /* Number of temperature sensors. */
 
     /* Command line argument parser setup. */
     CommandLine cmd(__FILE__);
@@ -116,9 +127,40 @@ main(int argc, char *argv[]){
                  tcpVariant);
     cmd.AddValue("phyRate", "Physical layer bitrate", phyRate);
     cmd.AddValue("simulationTime", "Simulation time in seconds", simulationTime);
+    cmd.AddValue("initialEnergy", "Initial energy of every sensor in J", initialEnergy);
+    cmd.AddValue("trafficScale", "Multiplier on the data rate of every sensor class", trafficScale);
+    cmd.AddValue("harvest", "Energy harvesting profile: none, solar, trace", harvest);
+    cmd.AddValue("harvestTrace", "Harvested power trace file for --harvest=trace", harvestTrace);
+    cmd.AddValue("solarPeakPower", "Harvested power at solar noon in W", solarPeakPower);
+    cmd.AddValue("startHour", "Time of day at the start of the simulation", startHour);
+    cmd.AddValue("db", "SQLite results database, empty to disable", dbFile);
+    cmd.AddValue("attack", "Attack of the attacker node: none, tcp-flood, udp-flood, syn-flood, jammer", attack);
+    cmd.AddValue("attackStart", "Start of the attack", attackStart);
+    cmd.AddValue("attackRamp", "Time for the attack to reach full intensity", attackRamp);
+    cmd.AddValue("detect", "Run an intrusion detector on every AP", detect);
+    cmd.AddValue("mitigate", "Let the detectors block the alerted sources", mitigate);
+    cmd.AddValue("temperatureSensors", "Number of temperature sensors", number_of_sensors);
     cmd.Parse(argc, argv);
     std::string tcpName = tcpVariant;
 
+    Ptr<ResultsDatabase> resultsDb = CreateObject<ResultsDatabase>();
+    if (!dbFile.empty())
+    {
+        resultsDb->Open(dbFile);
+    }
+    resultsDb->BeginRun("sensor_network");
+    resultsDb->AddParameter("tcp", tcpName);
+    resultsDb->AddParameter("phyRate", phyRate);
+    resultsDb->AddParameter("simulationTime", simulationTime.GetSeconds());
+    resultsDb->AddParameter("initialEnergy", initialEnergy);
+    resultsDb->AddParameter("trafficScale", trafficScale);
+    resultsDb->AddParameter("harvest", harvest);
+    resultsDb->AddParameter("startHour", startHour);
+    resultsDb->AddParameter("attack", attack);
+    resultsDb->AddParameter("detect", detect ? "on" : "off");
+    resultsDb->AddParameter("mitigate", mitigate ? "on" : "off");
+    resultsDb->AddParameter("temperatureSensors", number_of_sensors);
+
     tcpVariant = std::string("ns3::") + tcpVariant;
     // Select TCP variant
     TypeId tcpTid;
@@ -154,7 +196,6 @@ main(int argc, char *argv[]){
     NodeContainer apWifiNode;
     int number_of_ap = 4;
     apWifiNode.Create(number_of_ap);
-    int number_of_sensors = 21;
     
     NodeContainer temperatureSensorNodes;
     temperatureSensorNodes.Create(number_of_sensors);
@@ -249,8 +290,11 @@ main(int argc, char *argv[]){
     soundMobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
 	soundMobility.Install(soundSensorNodes);    
     
+    // Larger deployments are packed into the same 100 m wide grid (5 x 20 m by default)
+    int gridWidth = std::max(5, static_cast<int>(std::ceil(std::sqrt(number_of_sensors))));
+    double gridDelta = 100.0 / gridWidth;
     MobilityHelper sensorMobility;
-    sensorMobility.SetPositionAllocator("ns3::GridPositionAllocator","MinX", DoubleValue(0.0),"MinY",DoubleValue(0.0),"DeltaX",DoubleValue(20),"DeltaY",DoubleValue(20),"LayoutType",StringValue("RowFirst"),"GridWidth",UintegerValue(5));
+    sensorMobility.SetPositionAllocator("ns3::GridPositionAllocator","MinX", DoubleValue(0.0),"MinY",DoubleValue(0.0),"DeltaX",DoubleValue(gridDelta),"DeltaY",DoubleValue(gridDelta),"LayoutType",StringValue("RowFirst"),"GridWidth",UintegerValue(gridWidth));
    
    
    MobilityHelper humidityMobility; 
@@ -314,7 +358,10 @@ main(int argc, char *argv[]){
     PacketSinkHelper sinkHelper("ns3::TcpSocketFactory",InetSocketAddress(InetSocketAddress(Ipv4Address::GetAny(), 9)));
     ApplicationContainer sinkApp = sinkHelper.Install(apWifiNode.Get(0));
     ApplicationContainer secondSinkApp = sinkHelper.Install(apWifiNode.Get(1));
+    // pressure and sound sensors report to the third AP
+    ApplicationContainer thirdSinkApp = sinkHelper.Install(apWifiNode.Get(2));
     
+    sink3 = StaticCast<PacketSink>(thirdSinkApp.Get(0));
     sink2 = StaticCast<PacketSink>(secondSinkApp.Get(0));
     sink = StaticCast<PacketSink>(sinkApp.Get(0));
     
@@ -323,36 +370,61 @@ main(int argc, char *argv[]){
     temperaturePktServer.SetAttribute("PacketSize", UintegerValue(3));
     temperaturePktServer.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
     temperaturePktServer.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
-    temperaturePktServer.SetAttribute("DataRate", DataRateValue(DataRate("10Kb/s")));
+    temperaturePktServer.SetAttribute("DataRate", DataRateValue(DataRate(static_cast<uint64_t>(10e3 * trafficScale))));
     ApplicationContainer temperaturePktServerApp = temperaturePktServer.Install(temperatureSensorNodes);
     
     OnOffHelper humidityPktServer("ns3::TcpSocketFactory", (InetSocketAddress(apInterface.GetAddress(1), 9)));
     humidityPktServer.SetAttribute("PacketSize", UintegerValue(2));
     humidityPktServer.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
     humidityPktServer.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
-    humidityPktServer.SetAttribute("DataRate", DataRateValue(DataRate("10Kb/s")));
+    humidityPktServer.SetAttribute("DataRate", DataRateValue(DataRate(static_cast<uint64_t>(10e3 * trafficScale))));
     ApplicationContainer humidityPktServerApp = humidityPktServer.Install(humiditySensorNodes);
     
     OnOffHelper pressurePktServer("ns3::TcpSocketFactory", (InetSocketAddress(apInterface.GetAddress(2), 9)));
     pressurePktServer.SetAttribute("PacketSize", UintegerValue(5));
     pressurePktServer.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
     pressurePktServer.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=2]"));
-    pressurePktServer.SetAttribute("DataRate", DataRateValue(DataRate("20Kb/s")));
+    pressurePktServer.SetAttribute("DataRate", DataRateValue(DataRate(static_cast<uint64_t>(20e3 * trafficScale))));
     ApplicationContainer pressurePktServerApp = pressurePktServer.Install(pressureSensorNodes);
     
     OnOffHelper soundPktServer("ns3::TcpSocketFactory", (InetSocketAddress(apInterface.GetAddress(2), 9)));
     soundPktServer.SetAttribute("PacketSize", UintegerValue(5));
     soundPktServer.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
     soundPktServer.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=2]"));
-    soundPktServer.SetAttribute("DataRate", DataRateValue(DataRate("20Kb/s")));
+    soundPktServer.SetAttribute("DataRate", DataRateValue(DataRate(static_cast<uint64_t>(20e3 * trafficScale))));
     ApplicationContainer soundPktServerApp = soundPktServer.Install(soundSensorNodes);
     
-    OnOffHelper tcpDOS("ns3::TcpSocketFactory",(InetSocketAddress(apInterface.GetAddress(0),9)));
-    tcpDOS.SetAttribute("PacketSize",UintegerValue(43)); /*Replace ENTER_PAYLOAD_SIZE_IN_BYTES_HERE with the avg payload size for DOS attacks*/
-    tcpDOS.SetAttribute("OnTime",StringValue("ns3::ConstantRandomVariable[Constant=100]"));
-    tcpDOS.SetAttribute("OffTime",StringValue("ns3::ConstantRandomVariable[Constant=0]"));
-    tcpDOS.SetAttribute("DataRate",DataRateValue(DataRate("5Mbps")));
-    ApplicationContainer tcpDOSApp = tcpDOS.Install(attackerNode);
+    // One long-lived attack application, labeled at the source with AttackTag
+    if (attack != "none")
+    {
+        AttackHelper attackHelper(attack, InetSocketAddress(apInterface.GetAddress(0), 9));
+        if (attack == "tcp-flood")
+        {
+            attackHelper.SetAttribute("PacketSize", UintegerValue(43));
+        }
+        attackHelper.SetAttribute("InitialIntensity", DoubleValue(attackRamp.IsStrictlyPositive() ? 0.0 : 1.0));
+        attackHelper.SetAttribute("RampTime", TimeValue(attackRamp));
+        ApplicationContainer attackApp = attackHelper.Install(attackerNode);
+        attackApp.Start(attackStart);
+        attackApp.Stop(simulationTime);
+    }
+
+    // Per-source rate detectors on the APs, scored against the AttackTag ground truth
+    std::vector<Ptr<IntrusionDetector>> detectors;
+    if (detect)
+    {
+        ApplicationHelper detectorHelper(IntrusionDetector::GetTypeId());
+        detectorHelper.SetAttribute("Mitigate", BooleanValue(mitigate));
+        ApplicationContainer detectorApps = detectorHelper.Install(apWifiNode);
+        detectorApps.Start(Seconds(0.0));
+        detectorApps.Stop(simulationTime);
+        for (uint32_t i = 0; i < detectorApps.GetN(); ++i)
+        {
+            Ptr<IntrusionDetector> detector = StaticCast<IntrusionDetector>(detectorApps.Get(i));
+            detector->EnableAlertLog("alerts_ap" + std::to_string(i) + ".txt");
+            detectors.push_back(detector);
+        }
+    }
     
     
     
@@ -366,7 +438,12 @@ main(int argc, char *argv[]){
     std::string throughputFileName = "throughput.txt";
 
     
-    throughputFile.open(throughputFileName);
+    Ptr<ThroughputMonitor> throughputMonitor = CreateObject<ThroughputMonitor>();
+    throughputMonitor->AddSink(sink, "ap0");
+    throughputMonitor->AddSink(sink2, "ap1");
+    throughputMonitor->AddSink(sink3, "ap2");
+    throughputMonitor->EnableOutput(throughputFileName);
+    throughputMonitor->EnableDatabase(resultsDb);
     AnimationInterface anim("visual.xml");
    
     for(int i = 0; i < number_of_ap; i++){
@@ -393,10 +470,9 @@ main(int argc, char *argv[]){
     humidityPktServerApp.Start(Seconds(1.2));
     soundPktServerApp.Start(Seconds(1.3));
     pressurePktServerApp.Start(Seconds(1.4));
-   // tcpDOSApp.Start(Seconds(1.0));
     
     BasicEnergySourceHelper basicSourceHelper;
-    basicSourceHelper.Set("BasicEnergySourceInitialEnergyJ", DoubleValue(1000.0));
+    basicSourceHelper.Set("BasicEnergySourceInitialEnergyJ", DoubleValue(initialEnergy));
     basicSourceHelper.Set("BasicEnergySupplyVoltageV", DoubleValue(12.0));
     
     WifiRadioEnergyModelHelper radioEnergyHelper;
@@ -418,12 +494,55 @@ main(int argc, char *argv[]){
     ns3::energy::EnergySourceContainer srcs_p = basicSourceHelper.Install(pressureSensorNodes);
     ns3::energy::DeviceEnergyModelContainer devModels_p = radioEnergyHelper.Install(pressureSensorDevices,srcs_p);
 
+    // Sensors whose battery drains leave the network; track when and how coverage degrades
+    Ptr<NodeLifetimeMonitor> lifetimeMonitor = CreateObject<NodeLifetimeMonitor>();
+    lifetimeMonitor->Install(temperatureSensorDevices, deviceModels);
+    lifetimeMonitor->Install(humiditySensorDevices, devModels_h);
+    lifetimeMonitor->Install(soundSensorDevices, devModels_s);
+    lifetimeMonitor->Install(pressureSensorDevices, devModels_p);
+    lifetimeMonitor->EnableTimeSeries("energystats/alive_" + tcpName + ".txt");
+    lifetimeMonitor->Start(Seconds(1.0));
+
+    // With harvesting the battery acts as rechargeable storage (capped at initialEnergy) and
+    // each sensor class throttles its reporting rate when its storage runs low
+    std::vector<NodeContainer> sensorClasses = {temperatureSensorNodes, humiditySensorNodes, soundSensorNodes, pressureSensorNodes};
+    std::vector<std::string> sensorClassNames = {"temperature", "humidity", "sound", "pressure"};
+    std::vector<Ptr<EnergyAwareRateController>> rateControllers;
+    if (harvest != "none")
+    {
+        ProfileEnergyHarvesterHelper harvesterHelper;
+        if (harvest == "trace")
+        {
+            harvesterHelper.Set("Profile", EnumValue(ProfileEnergyHarvester::TRACE));
+            harvesterHelper.Set("TraceFile", StringValue(harvestTrace));
+        }
+        else
+        {
+            NS_ABORT_MSG_UNLESS(harvest == "solar", "Unknown harvest profile " << harvest);
+            harvesterHelper.Set("Profile", EnumValue(ProfileEnergyHarvester::SOLAR));
+            harvesterHelper.Set("PeakPower", DoubleValue(solarPeakPower));
+            harvesterHelper.Set("StartHour", DoubleValue(startHour));
+        }
+        for (const auto& classSources : {sources, srcs_h, srcs_s, srcs_p})
+        {
+            ProfileEnergyHarvesterHelper::Start(harvesterHelper.Install(classSources), Seconds(0.0));
+        }
+
+        for (auto& sensorClass : sensorClasses)
+        {
+            Ptr<EnergyAwareRateController> controller = CreateObject<EnergyAwareRateController>();
+            controller->Install(sensorClass);
+            controller->Start(Seconds(1.0));
+            rateControllers.push_back(controller);
+        }
+    }
+
     nodeEnergyConsumed.resize(temperatureSensorNodes.GetN(), 0.0);
 
     Simulator::Schedule(Seconds(1.0), &CalculateEnergyConsumption,temperatureSensorNodes,humiditySensorNodes,pressureSensorNodes,soundSensorNodes);
    
     
-    Simulator::Schedule(Seconds(1.1), &CalculateThroughput);
+    throughputMonitor->Start(Seconds(1.1));
     
     
     
@@ -459,17 +578,93 @@ main(int argc, char *argv[]){
 	double averageEnergyConsumption = totalEnergyConsumed / temperatureSensorNodes.GetN();
     std::cout << "Average energy consumption: " << averageEnergyConsumption << " J" << std::endl;
     
-    throughputFile.close();
+    throughputMonitor->Stop();
     
+    // sensors report to several APs, so the network throughput is the sum over their sinks
     auto averageThroughput =
-        (static_cast<double>(sink->GetTotalRx() * 8  ) / simulationTime.GetMicroSeconds());
+        (static_cast<double>((sink->GetTotalRx() + sink2->GetTotalRx() + sink3->GetTotalRx()) * 8) / simulationTime.GetMicroSeconds());
     
     std::cout << "\nAverage throughput: " << averageThroughput << " Mbit/s" << std::endl;
+    resultsDb->AddMetric("averageThroughput", averageThroughput);
+    resultsDb->AddMetric("averageEnergyConsumption", averageEnergyConsumption);
+    resultsDb->AddMetric("deadNodes", lifetimeMonitor->GetNDead());
+    resultsDb->AddMetric("firstNodeDeath", lifetimeMonitor->GetFirstNodeDeath().GetSeconds());
+    resultsDb->AddMetric("halfNetworkDeath", lifetimeMonitor->GetHalfNetworkDeath().GetSeconds());
+    resultsDb->AddMetric("coverage", lifetimeMonitor->GetCoverage());
+
+    std::cout << "Dead sensors: " << lifetimeMonitor->GetNDead() << "/" << lifetimeMonitor->GetNNodes()
+              << ", first node death: " << lifetimeMonitor->GetFirstNodeDeath().GetSeconds()
+              << " s, half network death: " << lifetimeMonitor->GetHalfNetworkDeath().GetSeconds() << " s" << std::endl;
+
+    std::ofstream lifetimeFile;
+    lifetimeFile.open("energystats/lifetime_sensors.txt", std::ios::app);
+    lifetimeFile << tcpName << "\t" << initialEnergy << "\t" << trafficScale << "\t" << averageThroughput << "\t"
+                 << lifetimeMonitor->GetFirstNodeDeath().GetSeconds() << "\t"
+                 << lifetimeMonitor->GetHalfNetworkDeath().GetSeconds() << "\t"
+                 << lifetimeMonitor->GetCoverage() << std::endl;
+    lifetimeFile.close();
+
+    if (!detectors.empty())
+    {
+        uint64_t inspected = 0;
+        uint32_t alerts = 0;
+        uint32_t falsePositives = 0;
+        uint64_t dropped = 0;
+        double processingNs = 0.0;
+        Time detection = Seconds(-1.0);
+        for (const auto& detector : detectors)
+        {
+            inspected += detector->GetNPackets();
+            alerts += detector->GetNAlerts();
+            falsePositives += detector->GetNFalsePositives();
+            dropped += detector->GetNDropped();
+            processingNs += detector->GetMeanProcessingTime() * detector->GetNPackets();
+            Time t = detector->GetDetectionTime();
+            if (!t.IsNegative() && (detection.IsNegative() || t < detection))
+            {
+                detection = t;
+            }
+        }
+        // Latency is counted from the start of the attack, whichever AP detects it first
+        double detectionLatency = detection.IsNegative() ? -1.0 : (detection - attackStart).GetSeconds();
+        double costPerPacket = inspected == 0 ? 0.0 : processingNs / inspected;
+        std::cout << "Alerts: " << alerts << " (" << falsePositives << " false positives), detection latency: "
+                  << detectionLatency << " s, detector cost: " << costPerPacket << " ns/packet, "
+                  << detectors[0]->GetMemoryUsage() << " bytes per AP" << std::endl;
+        resultsDb->AddMetric("alerts", alerts);
+        resultsDb->AddMetric("falsePositives", falsePositives);
+        resultsDb->AddMetric("detectionLatency", detectionLatency);
+        resultsDb->AddMetric("detectorNsPerPacket", costPerPacket);
+        resultsDb->AddMetric("detectorDrops", dropped);
+
+        std::ofstream detectorFile;
+        detectorFile.open("flowstats/detector_sensors.txt", std::ios::app);
+        detectorFile << tcpName << "\t" << attack << "\t" << number_of_sensors << "\t" << mitigate << "\t"
+                     << alerts << "\t" << falsePositives << "\t" << detectionLatency << "\t"
+                     << costPerPacket << "\t" << dropped << std::endl;
+        detectorFile.close();
+    }
+
+    // A class rate is sustainable when it was never throttled and its storage never ran low
+    if (!rateControllers.empty())
+    {
+        std::ofstream harvestFile;
+        harvestFile.open("energystats/harvest_sensors.txt", std::ios::app);
+        for (size_t i = 0; i < rateControllers.size(); ++i)
+        {
+            harvestFile << tcpName << "\t" << harvest << "\t" << trafficScale << "\t" << sensorClassNames[i] << "\t"
+                        << rateControllers[i]->GetMeanRateFraction() << "\t"
+                        << rateControllers[i]->GetMinEnergyFraction() << "\t"
+                        << rateControllers[i]->GetLastEnergyFraction() << std::endl;
+        }
+        harvestFile.close();
+    }
     
     //Flow monitor code
     monitor->CheckForLostPackets();
     Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier> (flowmon.GetClassifier());
     std::map<FlowId, FlowMonitor::FlowStats> stats = monitor->GetFlowStats();
+    resultsDb->AddFlowStats(monitor, classifier);
 
     std::ofstream flowStatsFile;
     
@@ -511,6 +706,8 @@ main(int argc, char *argv[]){
     pktStatsFile << tcpName << "\t" << total_tx << "\t" << total_rx << std::endl;
     
     pktStatsFile.close();
+    resultsDb->AddMetric("txPackets", total_tx);
+    resultsDb->AddMetric("rxPackets", total_rx);
    
     Simulator :: Destroy();
     
@@ -524,6 +721,7 @@ main(int argc, char *argv[]){
         energyFile << "Node " << i << ": " << power_consumed << " W" << std::endl;
     }
     energyFile.close();
+    resultsDb->EndRun();
 
   
     
@@ -23,19 +23,36 @@
 #include "ns3/energy-module.h"
 #include "ns3/wifi-radio-energy-model-helper.h"
 #include "ns3/aodv-module.h"
+#include "ns3/constant-position-mobility-model.h"
 #include "ns3/three-gpp-propagation-loss-model.h"
-
-
+#include "backhaul-helper.h"
+#include "energy-aware-rate-controller.h"
+#include "flow-delay-monitor.h"
+#include "flow-stats-file.h"
+#include "hop-delay-monitor.h"
+#include "link-quality-monitor.h"
+#include "node-lifetime-monitor.h"
+#include "profile-energy-harvester.h"
+#include "profile-energy-harvester-helper.h"
+#include "qos-class-helper.h"
+#include "queue-disc-monitor.h"
+#include "results-database.h"
+#include "scenario-common.h"
+#include "tcp-class-helper.h"
+#include "tcp-mobility-aware.h"
+#include "tcp-socket-tracer.h"
+#include "throughput-monitor.h"
+
+
+#include <algorithm>
 #include <fstream>
+#include <numeric>
 
 NS_LOG_COMPONENT_DEFINE("proj");
 
 using namespace ns3;
 
-Ptr<PacketSink> sink;
-uint64_t lastTotalRx = 0;
-std::ofstream throughputFile;
-double totalEnergyConsumed = 0.0;
+Ptr<PacketSink> sinks[3];
 std::vector<double> nodeEnergyConsumed;
 int number_of_vehicles = 75;
 int sink_count= 1;
@@ -43,80 +60,100 @@ int sink_count= 1;
 std::string fileName = "_75_1.txt";
 
 
-void
-CalculateThroughput()
-{
-    Time now = Simulator::Now(); /* Return the simulator's virtual time. */
-    double cur = (sink->GetTotalRx() - lastTotalRx) * 8.0 /(5*1e6); /* Convert Application RX Packets to MBits. */
-                
-    throughputFile << now.GetSeconds() << "\t" << cur << std::endl;
-    
-
-    lastTotalRx = sink->GetTotalRx();
-    std::cout << now.GetSeconds();
-    Simulator::Schedule(MilliSeconds(5000), &CalculateThroughput);
-}
-void CalculateEnergyConsumption(NodeContainer smartVehicleNodes) {
-    totalEnergyConsumed = 0.0;
-    for (size_t i = 0; i < nodeEnergyConsumed.size(); ++i) {
-        Ptr<ns3::energy::BasicEnergySource> energySource = DynamicCast<ns3::energy::BasicEnergySource>(smartVehicleNodes.Get(i)->GetObject<ns3::energy::EnergySourceContainer>()->Get(0));
-        if (energySource) {
-            nodeEnergyConsumed[i] = energySource->GetInitialEnergy() - energySource->GetRemainingEnergy();
-            totalEnergyConsumed += nodeEnergyConsumed[i];
-        } else {
-            NS_LOG_WARN("Energy source not found for node " << i);
-        }
-    }
-}
-
-void setVehicleMobility(NodeContainer smartVehicleNodes, double minx, double miny,double speedx,double speedy, double delx, double dely){
- 
-MobilityHelper smartVehicleMobility;
-// First half with RowFirst layout
-smartVehicleMobility.SetMobilityModel("ns3::ConstantVelocityMobilityModel");
-smartVehicleMobility.SetPositionAllocator("ns3::GridPositionAllocator",
-                                           "MinX", DoubleValue(minx),
-                                           "MinY", DoubleValue(miny),
-                                           "DeltaX", DoubleValue(10.0),
-                                           "DeltaY", DoubleValue(20.0),
-                                           "GridWidth", UintegerValue(16),
-                                           "LayoutType", StringValue("RowFirst"));
-// Install the mobility models
-smartVehicleMobility.Install(smartVehicleNodes);
-
-
-// Assign velocities
-for (int i = 0; i < number_of_vehicles / 2; i++) {
-    Ptr<Node> node = smartVehicleNodes.Get(i);
-    Ptr<ConstantVelocityMobilityModel> mob = node->GetObject<ConstantVelocityMobilityModel>();
-    mob->SetVelocity(Vector(speedx, speedy, 0.0));
-}
-
-for (int i = number_of_vehicles / 2; i < number_of_vehicles; i++) {
-    Ptr<Node> node = smartVehicleNodes.Get(i);
-    Ptr<ConstantVelocityMobilityModel> mob = node->GetObject<ConstantVelocityMobilityModel>();
-    mob->SetVelocity(Vector(-speedx, speedy, 0.0));
-}
-}
-
-
 int
 main(int argc, char *argv[]){
     std::string tcpVariant{"TcpWestwoodPlus"}; /* TCP variant type. */
     std::string phyRate{"HtMcs7"};        /* Physical layer bitrate. */
     Time simulationTime{"100s"};           /* Simulation time. */
+    double initialEnergy{1000.0};         /* Initial energy of every vehicle in J. */
+    std::string harvest{"none"};          /* Energy harvesting profile: none, solar or trace. */
+    std::string harvestTrace{""};         /* "<time s> <power W>" file for the trace profile. */
+    double solarPeakPower{0.05};          /* Harvested power at solar noon in W. */
+    std::string dbFile{"results.db"};     /* SQLite results database, empty to disable. */
+    bool tcpTrace{false};                 /* Binary cwnd/RTT/RTO trace of every TCP socket. */
+    uint32_t tcpTraceDecimation{1};       /* Keep one of every N value changes per socket. */
+    double speed{1.0};                    /* Vehicle speed in m/s. */
+    std::string classTcp[3];              /* Congestion control of the small, mid and large classes. */
+    std::string classSocket[3];           /* ns3::TcpSocket attributes of the small, mid and large classes. */
+    bool qos{false};                      /* Tag every class for an EDCA access category. */
+    std::string classAc[3] = {"AC_VO", "AC_VI", "AC_BK"}; /* Access categories of the classes. */
+    std::string queueDisc{""};            /* Queue disc of the AP and sinks, empty for the ns-3 default. */
+    std::string queueDiscAttributes{""};  /* Name=value,... attributes of that queue disc. */
+    std::string macQueueSize{""};         /* Wi-Fi MAC queue size below the queue disc, e.g. 50p. */
+    std::string backhaul{""};             /* Wired backhaul from the AP to a server: p2p or csma, empty for none. */
+    std::string backhaulRate{"1Gbps"};    /* Backhaul link rate. */
+    Time backhaulDelay{"10ms"};           /* Backhaul one-way delay. */
+    double backhaulLoss{0.0};             /* Backhaul packet loss probability. */
+    const std::string classNames[3] = {"small", "mid", "large"};
 
     /* Command line argument parser setup. */
     CommandLine cmd(__FILE__);
     cmd.AddValue("tcpVariant",
                  "Transport protocol to use: TcpNewReno, "
                  "TcpHybla, TcpHighSpeed, TcpHtcp, TcpVegas, TcpScalable, TcpVeno, "
-                 "TcpBic, TcpYeah, TcpIllinois, TcpWestwood, TcpWestwoodPlus, TcpLedbat ",
+                 "TcpBic, TcpYeah, TcpIllinois, TcpWestwood, TcpWestwoodPlus, TcpLedbat, "
+                 "TcpMobilityAware ",
                  tcpVariant);
     cmd.AddValue("phyRate", "Physical layer bitrate", phyRate);
     cmd.AddValue("simulationTime", "Simulation time in seconds", simulationTime);
+    cmd.AddValue("vehicles", "Number of vehicles", number_of_vehicles);
+    cmd.AddValue("speed", "Vehicle speed in m/s", speed);
+    cmd.AddValue("qos", "Map every packet class to an EDCA access category with its TOS/DSCP tag "
+                 "(802.11n already runs EDCA, this only controls the tagging)", qos);
+    for (int c = 0; c < 3; c++) {
+        cmd.AddValue(classNames[c] + "Tcp", "Congestion control of the " + classNames[c] + " packet class, empty for --tcpVariant", classTcp[c]);
+        cmd.AddValue(classNames[c] + "Socket", "Name=value,... ns3::TcpSocket attributes of the " + classNames[c] + " packet class "
+                     "(SegmentSize, TcpNoDelay, DelAckCount, ...)", classSocket[c]);
+        cmd.AddValue(classNames[c] + "Ac", "EDCA access category of the " + classNames[c] + " packet class with --qos "
+                     "(AC_BK, AC_BE, AC_VI, AC_VO)", classAc[c]);
+    }
+    cmd.AddValue("initialEnergy", "Initial energy of every vehicle in J", initialEnergy);
+    cmd.AddValue("harvest", "Energy harvesting profile: none, solar, trace", harvest);
+    cmd.AddValue("harvestTrace", "Harvested power trace file (e.g. vibration) for --harvest=trace", harvestTrace);
+    cmd.AddValue("solarPeakPower", "Harvested power at solar noon in W", solarPeakPower);
+    cmd.AddValue("db", "SQLite results database, empty to disable", dbFile);
+    cmd.AddValue("tcpTrace", "Write the cwnd/ssthresh/RTT/RTO/retransmission trace of every TCP socket", tcpTrace);
+    cmd.AddValue("tcpTraceDecimation", "Keep one of every N cwnd/ssthresh/RTT/RTO changes per socket", tcpTraceDecimation);
+    cmd.AddValue("queueDisc", "Queue disc of the AP and sink devices: fifo, codel, fq-codel, pie, red, fq-pie "
+                 "or a TypeId, empty for the ns-3 default", queueDisc);
+    cmd.AddValue("queueDiscAttributes", "Name=value,... attributes of the queue disc", queueDiscAttributes);
+    cmd.AddValue("macQueueSize", "Wi-Fi MAC queue size (e.g. 50p), empty for the ns-3 default", macQueueSize);
+    cmd.AddValue("backhaul", "Put the sink on a server behind a wired AP backhaul: p2p or csma, empty for the "
+                 "Wi-Fi sink node", backhaul);
+    cmd.AddValue("backhaulRate", "Backhaul link rate", backhaulRate);
+    cmd.AddValue("backhaulDelay", "Backhaul one-way delay", backhaulDelay);
+    cmd.AddValue("backhaulLoss", "Backhaul packet loss probability", backhaulLoss);
     cmd.Parse(argc, argv);
     std::string tcpName = tcpVariant;
+    fileName = "_" + std::to_string(number_of_vehicles) + "_" + std::to_string(sink_count) + ".txt";
+
+    Ptr<ResultsDatabase> resultsDb = CreateObject<ResultsDatabase>();
+    if (!dbFile.empty())
+    {
+        resultsDb->Open(dbFile);
+    }
+    resultsDb->BeginRun("seventyfivenodes");
+    resultsDb->AddParameter("tcp", tcpName);
+    resultsDb->AddParameter("phyRate", phyRate);
+    resultsDb->AddParameter("simulationTime", simulationTime.GetSeconds());
+    resultsDb->AddParameter("vehicles", number_of_vehicles);
+    resultsDb->AddParameter("sinks", sink_count);
+    resultsDb->AddParameter("speed", speed);
+    resultsDb->AddParameter("qos", qos);
+    for (int c = 0; c < 3; c++) {
+        resultsDb->AddParameter(classNames[c] + "Tcp", classTcp[c].empty() ? tcpName : classTcp[c]);
+        resultsDb->AddParameter(classNames[c] + "Socket", classSocket[c]);
+        resultsDb->AddParameter(classNames[c] + "Ac", qos ? classAc[c] : "");
+    }
+    resultsDb->AddParameter("initialEnergy", initialEnergy);
+    resultsDb->AddParameter("harvest", harvest);
+    resultsDb->AddParameter("queueDisc", queueDisc);
+    resultsDb->AddParameter("queueDiscAttributes", queueDiscAttributes);
+    resultsDb->AddParameter("macQueueSize", macQueueSize);
+    resultsDb->AddParameter("backhaul", backhaul);
+    resultsDb->AddParameter("backhaulRate", backhaul.empty() ? "" : backhaulRate);
+    resultsDb->AddParameter("backhaulDelay", backhaul.empty() ? 0.0 : backhaulDelay.GetSeconds());
+    resultsDb->AddParameter("backhaulLoss", backhaul.empty() ? 0.0 : backhaulLoss);
 
     tcpVariant = std::string("ns3::") + tcpVariant;
     // Select TCP variant
@@ -172,6 +209,10 @@ main(int argc, char *argv[]){
     Ssid ssid = Ssid("network");
 
 
+    if (!macQueueSize.empty()) {
+        // The queue disc only backs up once the MAC queue below it is full
+        Config::SetDefault("ns3::WifiMacQueue::MaxSize", StringValue(macQueueSize));
+    }
     wifiMac.SetType("ns3::ApWifiMac", "Ssid", SsidValue(ssid));
     NetDeviceContainer apDevice;
     apDevice = wifiHelper.Install(wifiPhy, wifiMac, apWifiNode);
@@ -180,6 +221,8 @@ main(int argc, char *argv[]){
     
     NetDeviceContainer smartVehicleDevices;
     smartVehicleDevices = wifiHelper.Install(wifiPhy,wifiMac,smartVehicleNodes);
+    // RSSI trend, MAC retries and handovers of every vehicle, for TcpMobilityAware
+    LinkQualityMonitor::Install(smartVehicleDevices);
     
     NetDeviceContainer sinkDevices;
     sinkDevices = wifiHelper.Install(wifiPhy,wifiMac,sinkNodes);
@@ -198,7 +241,7 @@ main(int argc, char *argv[]){
     sinkMobility.SetPositionAllocator(sinkPositionAlloc);
     sinkMobility.Install(sinkNodes);
     
-    setVehicleMobility(smartVehicleNodes,0.0,0.0,1.0,0.0, 20.0, 10.0);
+    ScenarioCommon::InstallVehicleMobility(smartVehicleNodes,0.0,0.0,speed,0.0);
      
     AodvHelper aodv;
     InternetStackHelper stack;
@@ -215,20 +258,63 @@ main(int argc, char *argv[]){
     sinkInterface = address.Assign(sinkDevices);
     Ipv4InterfaceContainer smartVehicleInterface;
     smartVehicleInterface = address.Assign(smartVehicleDevices); 
+
+    // With a backhaul the sink moves to a server behind the AP; the Wi-Fi sink node stays idle
+    Ptr<Node> sinkNode = sinkNodes.Get(0);
+    Ipv4Address sinkAddress = sinkInterface.GetAddress(0);
+    BackhaulHelper::Backhaul serverTier;
+    if (!backhaul.empty()) {
+        NodeContainer serverNodes;
+        serverNodes.Create(1);
+        serverNodes.Get(0)->AggregateObject(CreateObject<ConstantPositionMobilityModel>());
+        serverNodes.Get(0)->GetObject<MobilityModel>()->SetPosition(Vector(0.0, -50.0, 0.0));
+        stack.Install(serverNodes);
+        BackhaulHelper backhaulHelper;
+        backhaulHelper.SetType(backhaul);
+        backhaulHelper.SetDataRate(backhaulRate);
+        backhaulHelper.SetDelay(backhaulDelay);
+        backhaulHelper.SetLoss(backhaulLoss);
+        serverTier = backhaulHelper.Install(apWifiNode.Get(0), serverNodes);
+        sinkNode = serverNodes.Get(0);
+        sinkAddress = serverTier.serverInterfaces.GetAddress(0);
+    }
+
+    // Every uplink packet crosses the AP queue towards the sink; watch its sojourn times
+    if (!queueDisc.empty()) {
+        QueueDiscMonitor::Install(apDevice, queueDisc, queueDiscAttributes);
+        QueueDiscMonitor::Install(sinkDevices, queueDisc, queueDiscAttributes);
+        QueueDiscMonitor::Install(serverTier.gatewayDevices, queueDisc, queueDiscAttributes);
+    }
+    Ptr<QueueDiscMonitor> queueMonitor = CreateObject<QueueDiscMonitor>();
+    queueMonitor->AddDevices("ap", apDevice);
+    queueMonitor->AddDevices("sink", sinkDevices);
+    queueMonitor->AddDevices("backhaul", serverTier.gatewayDevices);
+
+    // Wireless hop and backhaul hop latency, split at the AP
+    Ptr<HopDelayMonitor> hopMonitor;
+    if (!backhaul.empty()) {
+        hopMonitor = CreateObject<HopDelayMonitor>();
+        hopMonitor->Install(apDevice.Get(0), NodeContainer::GetGlobal());
+    }
     
 
     Ipv4GlobalRoutingHelper::PopulateRoutingTables();
     
-    PacketSinkHelper sinkHelper("ns3::TcpSocketFactory",InetSocketAddress(InetSocketAddress(Ipv4Address::GetAny(), 9)));
-    ApplicationContainer sinkApp = sinkHelper.Install(sinkNodes.Get(0));
-    sink = StaticCast<PacketSink>(sinkApp.Get(0));
+    // One sink per packet class on ports 9, 10 and 11, so that the receiver-side TCP settings
+    // of a class (DelAckCount, ...) reach the sockets its sink accepts
+    ApplicationContainer sinkApps[3];
+    for (int c = 0; c < 3; c++) {
+        PacketSinkHelper sinkHelper("ns3::TcpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), 9 + c));
+        sinkApps[c] = sinkHelper.Install(sinkNode);
+        sinks[c] = StaticCast<PacketSink>(sinkApps[c].Get(0));
+    }
     /*ApplicationContainer sinkApp2 = sinkHelper.Install(apWifiNode.Get(1));
     sink2 = StaticCast<PacketSink>(sinkApp2.Get(0));
     ApplicationContainer sinkApp3 = sinkHelper.Install(apWifiNode.Get(2));
     sink3 = StaticCast<PacketSink>(sinkApp3.Get(0));
 */
     //cluster1 
-    OnOffHelper smallPktServer("ns3::TcpSocketFactory", (InetSocketAddress(sinkInterface.GetAddress(0), 9)));
+    OnOffHelper smallPktServer("ns3::TcpSocketFactory", (InetSocketAddress(sinkAddress, 9)));
     smallPktServer.SetAttribute("PacketSize", UintegerValue(100));
     smallPktServer.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
     smallPktServer.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
@@ -236,7 +322,7 @@ main(int argc, char *argv[]){
     ApplicationContainer smallPktServerApp = smallPktServer.Install(smartVehicleNodes);
 
     
-    OnOffHelper midPktServer("ns3::TcpSocketFactory", (InetSocketAddress(sinkInterface.GetAddress(0), 9)));
+    OnOffHelper midPktServer("ns3::TcpSocketFactory", (InetSocketAddress(sinkAddress, 10)));
     midPktServer.SetAttribute("PacketSize", UintegerValue(200));
     midPktServer.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
     midPktServer.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=10]"));
@@ -244,19 +330,34 @@ main(int argc, char *argv[]){
     ApplicationContainer midPktServerApp = midPktServer.Install(smartVehicleNodes);
 
     
-    OnOffHelper largePktServer("ns3::TcpSocketFactory", (InetSocketAddress(sinkInterface.GetAddress(0), 9)));
+    OnOffHelper largePktServer("ns3::TcpSocketFactory", (InetSocketAddress(sinkAddress, 11)));
     largePktServer.SetAttribute("PacketSize", UintegerValue(1500));
     largePktServer.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
     largePktServer.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=25]"));
     largePktServer.SetAttribute("DataRate", DataRateValue(DataRate("20Mb/s")));
     ApplicationContainer largePktServerApp = largePktServer.Install(smartVehicleNodes);
     
+    // Per-packet application delay, carried in-band from each OnOff sender to the sink
+    Ptr<FlowDelayMonitor> delayMonitor = CreateObject<FlowDelayMonitor>();
+    delayMonitor->AddTrafficClass("small", smallPktServerApp);
+    delayMonitor->AddTrafficClass("mid", midPktServerApp);
+    delayMonitor->AddTrafficClass("large", largePktServerApp);
+    for (const auto& sink : sinks) {
+        delayMonitor->AddSink(sink);
+    }
+
     FlowMonitorHelper flowmon;
     Ptr<FlowMonitor> monitor = flowmon.InstallAll();
     
     std :: string throughputFileName = "throughput/throughput_" + tcpName + fileName;
     
-    throughputFile.open(throughputFileName);
+    Ptr<ThroughputMonitor> throughputMonitor = CreateObject<ThroughputMonitor>();
+    throughputMonitor->SetAttribute("Window", TimeValue(Seconds(5)));
+    for (int c = 0; c < 3; c++) {
+        throughputMonitor->AddSink(sinks[c], classNames[c]);
+    }
+    throughputMonitor->EnableOutput(throughputFileName);
+    throughputMonitor->EnableDatabase(resultsDb);
     AnimationInterface anim("75_proj_netanim.xml");
     anim.SetMaxPktsPerTraceFile(3145728);
    
@@ -276,33 +377,76 @@ main(int argc, char *argv[]){
     anim.UpdateNodeColor(sinkNodes.Get(0),100,100,100);
     
     
-    sinkApp.Start(Seconds(0.0));
+    // TcpClassHelper cannot tell apart two classes starting on the same instant
+    for (int c = 0; c < 3; c++) {
+        sinkApps[c].Start(Seconds(0.1 * c));
+    }
 
 
     smallPktServerApp.Start(Seconds(1.1));
     midPktServerApp.Start(Seconds(1.2));
     largePktServerApp.Start(Seconds(1.3));
+
+    // Per-class TCP stacks, switched in when each class creates its sockets
+    ApplicationContainer classApps[3] = {smallPktServerApp, midPktServerApp, largePktServerApp};
+    for (int c = 0; c < 3; c++) {
+        TcpClassHelper classHelper;
+        classHelper.SetCongestionControl(classTcp[c]);
+        classHelper.SetSocketAttributes(classSocket[c]);
+        classHelper.Install(classApps[c]);
+        classHelper.Install(sinkApps[c]);
+        if (qos) {
+            QosClassHelper::Install(classApps[c], QosClassHelper::ParseAccessCategory(classAc[c]));
+        }
+    }
     
-    BasicEnergySourceHelper basicSourceHelper;
-    basicSourceHelper.Set("BasicEnergySourceInitialEnergyJ", DoubleValue(1000.0));
-    basicSourceHelper.Set("BasicEnergySupplyVoltageV", DoubleValue(12.0));
-    
-    WifiRadioEnergyModelHelper radioEnergyHelper;
-    
-    radioEnergyHelper.Set("TxCurrentA",DoubleValue(0.017));
-    radioEnergyHelper.Set("RxCurrentA",DoubleValue(0.0197));
-    radioEnergyHelper.Set("IdleCurrentA",DoubleValue(0.273));
-    radioEnergyHelper.Set("SleepCurrentA",DoubleValue(0.033));
-    
-    ns3::energy::EnergySourceContainer sources = basicSourceHelper.Install(smartVehicleNodes);
-    ns3::energy::DeviceEnergyModelContainer deviceModels = radioEnergyHelper.Install(smartVehicleDevices, sources);
+    ScenarioCommon::EnergyInstallation vehicleEnergy = ScenarioCommon::InstallRadioEnergy(smartVehicleNodes, smartVehicleDevices, initialEnergy);
+    ns3::energy::EnergySourceContainer sources = vehicleEnergy.sources;
+    ns3::energy::DeviceEnergyModelContainer deviceModels = vehicleEnergy.models;
+
+    // Vehicles whose battery drains leave the network; track when and how coverage degrades
+    Ptr<NodeLifetimeMonitor> lifetimeMonitor = CreateObject<NodeLifetimeMonitor>();
+    lifetimeMonitor->Install(smartVehicleDevices, deviceModels);
+    lifetimeMonitor->EnableTimeSeries("energystats/alive_" + tcpName + fileName);
+    lifetimeMonitor->Start(Seconds(1.0));
+
+    Ptr<EnergyAwareRateController> rateController;
+    if (harvest != "none")
+    {
+        ProfileEnergyHarvesterHelper harvesterHelper;
+        if (harvest == "trace")
+        {
+            harvesterHelper.Set("Profile", EnumValue(ProfileEnergyHarvester::TRACE));
+            harvesterHelper.Set("TraceFile", StringValue(harvestTrace));
+        }
+        else
+        {
+            NS_ABORT_MSG_UNLESS(harvest == "solar", "Unknown harvest profile " << harvest);
+            harvesterHelper.Set("Profile", EnumValue(ProfileEnergyHarvester::SOLAR));
+            harvesterHelper.Set("PeakPower", DoubleValue(solarPeakPower));
+        }
+        ProfileEnergyHarvesterHelper::Start(harvesterHelper.Install(sources), Seconds(0.0));
 
-    nodeEnergyConsumed.resize(smartVehicleNodes.GetN(), 0.0);
+        rateController = CreateObject<EnergyAwareRateController>();
+        rateController->Install(smartVehicleNodes);
+        rateController->Start(Seconds(1.0));
+    }
 
-    Simulator::Schedule(Seconds(99.0), &CalculateEnergyConsumption, smartVehicleNodes);
+    Simulator::Schedule(Seconds(99.0), [smartVehicleNodes]() {
+        nodeEnergyConsumed = ScenarioCommon::GetEnergyConsumed(smartVehicleNodes);
+    });
    
     
-    Simulator::Schedule(Seconds(1.1), &CalculateThroughput);
+    throughputMonitor->Start(Seconds(1.1));
+
+    // Sockets appear when the applications start and when the sinks accept them
+    Ptr<TcpSocketTracer> tcpTracer = CreateObject<TcpSocketTracer>();
+    if (tcpTrace)
+    {
+        tcpTracer->SetAttribute("Decimation", UintegerValue(tcpTraceDecimation));
+        tcpTracer->Open("flowstats/tcptrace_" + tcpName + fileName.substr(0, fileName.rfind('.')) + ".bin");
+        tcpTracer->Start(Seconds(1.0));
+    }
     
     
     
@@ -318,66 +462,137 @@ main(int argc, char *argv[]){
     Simulator::Stop(simulationTime);
     Simulator :: Run();
     
-	double averageEnergyConsumption = totalEnergyConsumed / smartVehicleNodes.GetN();
+	double averageEnergyConsumption = std::accumulate(nodeEnergyConsumed.begin(), nodeEnergyConsumed.end(), 0.0) / smartVehicleNodes.GetN();
     std::cout << "Average energy consumption: " << averageEnergyConsumption << " J" << std::endl;
     
-    throughputFile.close();
+    throughputMonitor->Stop();
+    tcpTracer->Stop();
+    if (tcpTrace)
+    {
+        std::cout << "TCP trace: " << tcpTracer->GetNRecords() << " records of " << tcpTracer->GetNSockets() << " sockets" << std::endl;
+    }
     
+    uint64_t totalRx = 0;
+    for (const auto& sink : sinks) {
+        totalRx += sink->GetTotalRx();
+    }
     auto averageThroughput =
-        (static_cast<double>(sink->GetTotalRx() * 8  ) / simulationTime.GetMicroSeconds());
+        (static_cast<double>(totalRx * 8  ) / simulationTime.GetMicroSeconds());
     
     std::cout << "\nAverage throughput: " << averageThroughput << " Mbit/s" << std::endl;
+    resultsDb->AddMetric("averageThroughput", averageThroughput);
+    resultsDb->AddMetric("averageEnergyConsumption", averageEnergyConsumption);
+    resultsDb->AddMetric("deadNodes", lifetimeMonitor->GetNDead());
+    resultsDb->AddMetric("firstNodeDeath", lifetimeMonitor->GetFirstNodeDeath().GetSeconds());
+    resultsDb->AddMetric("halfNetworkDeath", lifetimeMonitor->GetHalfNetworkDeath().GetSeconds());
+    resultsDb->AddMetric("coverage", lifetimeMonitor->GetCoverage());
+    if (tcpName == "TcpMobilityAware")
+    {
+        resultsDb->AddMetric("mobilityLosses", TcpMobilityAware::GetMobilityLosses());
+        resultsDb->AddMetric("congestionLosses", TcpMobilityAware::GetCongestionLosses());
+        std::cout << "Losses blamed on mobility: " << TcpMobilityAware::GetMobilityLosses() << ", on congestion: "
+                  << TcpMobilityAware::GetCongestionLosses() << std::endl;
+    }
+
+    std::cout << "Dead vehicles: " << lifetimeMonitor->GetNDead() << "/" << lifetimeMonitor->GetNNodes()
+              << ", first node death: " << lifetimeMonitor->GetFirstNodeDeath().GetSeconds()
+              << " s, half network death: " << lifetimeMonitor->GetHalfNetworkDeath().GetSeconds() << " s" << std::endl;
+
+    std::ofstream lifetimeFile;
+    lifetimeFile.open("energystats/lifetime_vehicles.txt", std::ios::app);
+    lifetimeFile << tcpName << "\t" << number_of_vehicles << "\t" << sink_count << "\t" << initialEnergy << "\t"
+                 << averageThroughput << "\t" << lifetimeMonitor->GetFirstNodeDeath().GetSeconds() << "\t"
+                 << lifetimeMonitor->GetHalfNetworkDeath().GetSeconds() << "\t"
+                 << lifetimeMonitor->GetCoverage() << std::endl;
+    lifetimeFile.close();
+
+    if (rateController)
+    {
+        std::ofstream harvestFile;
+        harvestFile.open("energystats/harvest_vehicles.txt", std::ios::app);
+        harvestFile << tcpName << "\t" << number_of_vehicles << "\t" << harvest << "\t"
+                    << rateController->GetMeanRateFraction() << "\t"
+                    << rateController->GetMinEnergyFraction() << "\t"
+                    << rateController->GetLastEnergyFraction() << std::endl;
+        harvestFile.close();
+    }
     
     //Flow monitor code
     monitor->CheckForLostPackets();
     Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier> (flowmon.GetClassifier());
-    std::map<FlowId, FlowMonitor::FlowStats> stats = monitor->GetFlowStats();
 
-    std::ofstream flowStatsFile;
-    
+    // Full per-flow dump for scratch/scenario-support/flow-results
+    resultsDb->AddFlowStats(monitor, classifier);
+    FlowStatsFile::Write(monitor, classifier, "flowstats/flowmon_" + tcpName + fileName.substr(0, fileName.rfind('.')) + ".bin");
+
     std::string flowFileName = "flowstats/flow_stats_" + tcpName +fileName;
-     
-    flowStatsFile.open(flowFileName);
     
-    int total_tx = 0;
-    int total_rx = 0;
-    double delaySum = 0;
-    
-    // Print Flow Monitor statistics for flows terminating at the sink
-    for (std::map<FlowId, FlowMonitor::FlowStats>::const_iterator i = stats.begin (); i != stats.end (); ++i)
-    {
-        Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow (i->first);
-        if (t.destinationAddress == sinkInterface.GetAddress (0))
-        {
-            total_tx+= i->second.txPackets;
-            total_rx+= i->second.rxPackets;
-            delaySum +=  i->second.timeLastRxPacket.GetSeconds()-i->second.timeFirstTxPacket.GetSeconds();
-            flowStatsFile << i->first << "\t"
-                          << t.sourceAddress << "\t"
-                          << t.destinationAddress << "\t"
-                          << i->second.txBytes << "\t"
-                          << i->second.rxBytes << "\t"
-                          << i->second.txPackets << "\t"
-                          << i->second.rxPackets << "\t"
-                          << i->second.lostPackets << "\t"
-                          << i->second.rxBytes * 8.0 / (i->second.timeLastRxPacket.GetSeconds() - i->second.timeFirstTxPacket.GetSeconds()) / 1024 / 1024<< std::endl;
-            
-       
-        }
-    }
-    
-    
-    
-
-    flowStatsFile.close();
+    // Per-flow table of the flows terminating at the sink
+    ScenarioCommon::FlowTotals flowTotals = ScenarioCommon::WriteFlowStats(monitor, classifier, sinkAddress, flowFileName);
+    uint64_t total_tx = flowTotals.txPackets;
+    uint64_t total_rx = flowTotals.rxPackets;
+    double delaySum = flowTotals.delaySum;
     
     std::ofstream delayFile;
     
     delayFile.open("flowstats/delay.txt",std::ios::app);
     
-    delayFile << number_of_vehicles <<"\t" <<sink_count<<"\t"<< tcpName << "\t" << delaySum << std::endl;
+    // Mean one-way delay of the packets that reached the sink (not the flow duration)
+    delayFile << number_of_vehicles <<"\t" <<sink_count<<"\t"<< tcpName << "\t" << (total_rx > 0 ? delaySum / total_rx : 0.0) << std::endl;
     
     delayFile.close();
+    resultsDb->AddMetric("txPackets", total_tx);
+    resultsDb->AddMetric("rxPackets", total_rx);
+    resultsDb->AddMetric("meanDelay", total_rx > 0 ? delaySum / total_rx : 0.0);
+
+    std::ofstream flowDelayFile;
+    flowDelayFile.open("flowstats/delay_" + tcpName + fileName);
+    delayMonitor->WriteFlowStats(flowDelayFile);
+    flowDelayFile.close();
+
+    std::ofstream classDelayFile;
+    classDelayFile.open("flowstats/class_delay.txt", std::ios::app);
+    delayMonitor->WriteClassStats(classDelayFile, tcpName + "\t" + std::to_string(number_of_vehicles) + "\t" + std::to_string(sink_count) + "\t");
+    classDelayFile.close();
+    for (const auto& name : classNames) {
+        LogHistogram classDelays = delayMonitor->GetClassHistogram(name);
+        resultsDb->AddMetric("delay_" + name + "_mean", classDelays.GetMean() / 1e9);
+        resultsDb->AddMetric("delay_" + name + "_p95", classDelays.GetQuantile(0.95) / 1e9);
+        resultsDb->AddMetric("delay_" + name + "_p99", classDelays.GetQuantile(0.99) / 1e9);
+        resultsDb->AddMetric("throughput_" + name,
+                             delayMonitor->GetClassRxBytes(name) * 8.0 / simulationTime.GetMicroSeconds());
+    }
+
+    std::string queuePrefix = tcpName + "\t" + std::to_string(number_of_vehicles) + "\t" + std::to_string(sink_count) + "\t"
+                              + (queueDisc.empty() ? "default" : queueDisc) + "\t";
+    std::ofstream queueStatsFile;
+    queueStatsFile.open("flowstats/queue_stats.txt", std::ios::app);
+    queueMonitor->WriteStats(queueStatsFile, queuePrefix);
+    queueStatsFile.close();
+    std::ofstream queueSojournFile;
+    queueSojournFile.open("flowstats/queue_sojourn.txt", std::ios::app);
+    queueMonitor->WriteHistograms(queueSojournFile, queuePrefix);
+    queueSojournFile.close();
+    LogHistogram sojourn = queueMonitor->GetTotalHistogram();
+    resultsDb->AddMetric("queue_sojourn_mean", sojourn.GetMean() / 1e9);
+    resultsDb->AddMetric("queue_sojourn_p95", sojourn.GetQuantile(0.95) / 1e9);
+    resultsDb->AddMetric("queue_sojourn_p99", sojourn.GetQuantile(0.99) / 1e9);
+    resultsDb->AddMetric("queue_dropped", queueMonitor->GetTotalDropped());
+    resultsDb->AddMetric("queue_marked", queueMonitor->GetTotalMarked());
+
+    if (hopMonitor) {
+        std::ofstream hopDelayFile;
+        hopDelayFile.open("flowstats/hop_delay.txt", std::ios::app);
+        hopMonitor->WriteStats(hopDelayFile, queuePrefix + backhaul + "\t" + backhaulRate + "\t");
+        hopDelayFile.close();
+        for (uint32_t h = 0; h < HopDelayMonitor::HOP_COUNT; h++) {
+            auto hop = static_cast<HopDelayMonitor::Hop>(h);
+            std::string hopName = HopDelayMonitor::GetHopName(hop);
+            std::replace(hopName.begin(), hopName.end(), '-', '_');
+            resultsDb->AddMetric("hop_" + hopName + "_mean", hopMonitor->GetHistogram(hop).GetMean() / 1e9);
+            resultsDb->AddMetric("hop_" + hopName + "_p95", hopMonitor->GetHistogram(hop).GetQuantile(0.95) / 1e9);
+        }
+    }
     
     std::ofstream tpFile;
     tpFile.open("throughput/avg.txt",std::ios::app);
@@ -410,6 +625,8 @@ main(int argc, char *argv[]){
     
     energyFile << tcpName << "\t" << number_of_vehicles << "\t" << sink_count << "\t" << avg_energy_sum << std::endl; 
     energyFile.close();
+    resultsDb->AddMetric("energySum", avg_energy_sum);
+    resultsDb->EndRun();
 
   
     
@@ -0,0 +1,57 @@
+"""Run seventyfivenodes over a grid of TCP variants, vehicle counts and speeds.
+
+Every run records its results in the shared SQLite database (ResultsDatabase), so the
+grid is summarized afterwards with scenario-support's results-summary, e.g.
+
+  python3 sweep.py --variants TcpHybla,TcpLedbat,TcpVegas,TcpVeno,TcpWestwoodPlus,TcpMobilityAware \
+      --vehicles 30,45,60,75,90 --speeds 1,10 --runs 5 --jobs 8
+  ./ns3 run "results-summary --db=results.db --scenario=seventyfivenodes \
+      --keys=tcp,vehicles,speed --output=summary"
+"""
+import argparse
+import itertools
+import os
+import subprocess
+import sys
+from concurrent.futures import ThreadPoolExecutor
+
+
+def run(args, variant, vehicles, speed, rng_run):
+    program = '%s --tcpVariant=%s --vehicles=%d --speed=%g --RngRun=%d --db=%s %s' % (
+        args.program, variant, vehicles, speed, rng_run, os.path.abspath(args.db), args.extra)
+    result = subprocess.run([args.ns3, 'run', '--no-build', program],
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout)
+        raise RuntimeError('%s failed with code %d' % (program, result.returncode))
+    return program
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--ns3', default='./ns3', help='ns3 driver script')
+    parser.add_argument('--program', default='scratch/seventyfivenodes', help='scenario to run')
+    parser.add_argument('--variants', default='TcpHybla,TcpLedbat,TcpVegas,TcpVeno,'
+                        'TcpWestwoodPlus,TcpMobilityAware', help='comma-separated TCP variants')
+    parser.add_argument('--vehicles', default='75', help='comma-separated vehicle counts')
+    parser.add_argument('--speeds', default='1', help='comma-separated vehicle speeds (m/s)')
+    parser.add_argument('--runs', type=int, default=3, help='RngRun values per grid point')
+    parser.add_argument('--jobs', type=int, default=os.cpu_count(), help='parallel runs')
+    parser.add_argument('--db', default='results.db', help='results database')
+    parser.add_argument('--extra', default='', help='more scenario arguments')
+    args = parser.parse_args()
+
+    # Build once up front, the runs themselves must not race on the build tree
+    subprocess.run([args.ns3, 'build'], check=True)
+
+    grid = list(itertools.product(args.variants.split(','),
+                                  [int(v) for v in args.vehicles.split(',')],
+                                  [float(s) for s in args.speeds.split(',')],
+                                  range(1, args.runs + 1)))
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        for i, program in enumerate(pool.map(lambda p: run(args, *p), grid)):
+            print('[%d/%d] %s' % (i + 1, len(grid), program))
+
+
+if __name__ == '__main__':
+    main()
@@ -24,6 +24,7 @@
 #include "ns3/wifi-radio-energy-model-helper.h"
 #include "ns3/aodv-module.h"
 #include "ns3/three-gpp-propagation-loss-model.h"
+#include "connectivity-monitor.h"
 
 
 #include <fstream>
@@ -140,6 +141,7 @@ main(int argc, char *argv[]){
     std::string tcpVariant{"TcpLedbat"}; /* TCP variant type. */
     std::string phyRate{"HtMcs7"};        /* Physical layer bitrate. */
     Time simulationTime{"300s"};           /* Simulation time. */
+    double linkRange = 100.0;              /* Range of a link in the connectivity graph (m). */
 
     /* Command line argument parser setup. */
     CommandLine cmd(__FILE__);
@@ -150,6 +152,7 @@ main(int argc, char *argv[]){
                  tcpVariant);
     cmd.AddValue("phyRate", "Physical layer bitrate", phyRate);
     cmd.AddValue("simulationTime", "Simulation time in seconds", simulationTime);
+    cmd.AddValue("linkRange", "Range of a link in the connectivity graph (m)", linkRange);
     cmd.Parse(argc, argv);
     std::string tcpName = tcpVariant;
 
@@ -284,6 +287,15 @@ main(int argc, char *argv[]){
     
     FlowMonitorHelper flowmon;
     Ptr<FlowMonitor> monitor = flowmon.InstallAll();
+
+    // Components of the neighbor graph and vehicles in reach of the AP, every second
+    Ptr<ConnectivityMonitor> connectivity = CreateObject<ConnectivityMonitor>();
+    connectivity->SetAttribute("Range", DoubleValue(linkRange));
+    connectivity->AddNodes(smartVehicleNodes);
+    connectivity->AddNodes(sinkNodes);
+    connectivity->SetRoot(apWifiNode.Get(0));
+    connectivity->EnableOutput("flowstats/connectivity_" + tcpName + fileName);
+    connectivity->Start(Seconds(0.0));
     
     std :: string throughputFileName = "throughput/throughput_" + tcpName + fileName;
     
@@ -358,6 +370,13 @@ main(int argc, char *argv[]){
         (static_cast<double>(sink->GetTotalRx() * 8  ) / simulationTime.GetMicroSeconds());
     
     std::cout << "\nAverage throughput: " << averageThroughput << " Mbit/s" << std::endl;
+
+    double partition = connectivity->GetFirstPartitionTime().GetSeconds();
+    if (partition >= 0) {
+        std::cout << "First vehicle out of reach of the AP at " << partition << " s" << std::endl;
+    } else {
+        std::cout << "Every vehicle stayed in reach of the AP" << std::endl;
+    }
     
     //Flow monitor code
     monitor->CheckForLostPackets();
@@ -382,7 +401,7 @@ main(int argc, char *argv[]){
         {
             total_tx+= i->second.txPackets;
             total_rx+= i->second.rxPackets;
-            delaySum +=  i->second.timeLastRxPacket.GetSeconds()-i->second.timeFirstTxPacket.GetSeconds();
+            delaySum += i->second.delaySum.GetSeconds();
             flowStatsFile << i->first << "\t"
                           << t.sourceAddress << "\t"
                           << t.destinationAddress << "\t"
@@ -406,7 +425,7 @@ main(int argc, char *argv[]){
     
     delayFile.open("flowstats/delay.txt",std::ios::app);
     
-    delayFile << tcpName << "\t" << delaySum << std::endl;
+    delayFile << tcpName << "\t" << (total_rx > 0 ? delaySum / total_rx : 0.0) << std::endl;
     
     delayFile.close();
     